@@ -7,9 +7,6 @@ layout(location = 1) out vec4 outSpecular;
 uniform layout(binding = 5) sampler1D diffuse_ramp;
 uniform layout(binding = 6) sampler1D specular_ramp;
 
-// The maximum number of lights the shader supports, increasing this will lower performance!
-#define MAX_LIGHTS 8
-
 // Represents a single light source
 struct Light {
 	vec4  PositionIntensity;
@@ -17,21 +14,25 @@ struct Light {
 	vec4  ColorAttenuation;
 };
 
-// Our uniform buffer that will store all our lighting data
-// so that it can be shared between shaders
-layout (std140, binding = 2) uniform b_LightBlock {
-    // Stores ambient light color in rgb, and number
-	// of lights in w, allowing for easier struct packing
-	// on the C++ side
-    vec4  AmbientColAndNumLights;
+// Every light in the scene, in view space
+layout (std430, binding = 3) readonly buffer b_Lights {
+	Light Lights[];
+};
 
-    // Our array of all lights
-    Light Lights[MAX_LIGHTS];
+// The lights for each cluster, as an (offset, count) range in LightIndices
+layout (std430, binding = 4) readonly buffer b_LightClusters {
+	uvec2 Clusters[];
+};
 
-    // The rotation of the skybox/environment map
-	mat3  EnvironmentRotation;
+layout (std430, binding = 5) readonly buffer b_LightIndices {
+	uint LightIndices[];
 };
 
+// The number of clusters along each axis, X and Y are screen tiles and Z is depth slices
+uniform uvec3 u_ClusterCount;
+// Depth slices are exponential, slice = log(depth) * x + y
+uniform vec2  u_ClusterSliceParams;
+
 #include "../fragments/deferred_post_common.glsl"
 
 #include "../fragments/frame_uniforms.glsl"
@@ -77,10 +78,16 @@ void main() {
     
     float specularPow = texture(s_AlbedoSpec, inUV).a;
 
+    // Find which cluster we're in, so we only need to look at the lights that can reach us
+    uvec2 tile = min(uvec2(inUV * vec2(u_ClusterCount.xy)), u_ClusterCount.xy - 1u);
+    float slice = log(max(-viewPos.z, 0.0001)) * u_ClusterSliceParams.x + u_ClusterSliceParams.y;
+    uint  depthSlice = uint(clamp(slice, 0.0, float(u_ClusterCount.z - 1u)));
+    uvec2 cluster = Clusters[tile.x + (tile.y + depthSlice * u_ClusterCount.y) * u_ClusterCount.x];
+
     vec3 diffuse = vec3(0);
     vec3 specular = vec3(0);
-    for (int ix = 0; ix < AmbientColAndNumLights.w && ix < MAX_LIGHTS; ix++) {
-        CalcPointLightContribution(viewPos, normal, Lights[ix], specularPow, diffuse, specular);
+    for (uint ix = 0; ix < cluster.y; ix++) {
+        CalcPointLightContribution(viewPos, normal, Lights[LightIndices[cluster.x + ix]], specularPow, diffuse, specular);
     }
 
     if (IsFlagSet(FLAG_DIFFUSE_WARP))
@@ -6,27 +6,36 @@ layout(location = 1) out vec4 outSpecular;
 
 // Note the use of sampler2DShadow here! This lets us perform
 // linear sampling on a depth buffer (more or less)
-layout (binding = 5) uniform sampler2DShadow s_ShadowDepth;
-
-// Image to project
-layout (binding = 6) uniform sampler2D s_ProjectionMask;
-
-// Matrix to go from view space to shadow clip space
-uniform mat4  u_ViewToShadow;
-// Light's direction in view space
-uniform vec3  u_LightDirViewspace;
-// Light's position in view space
-uniform vec3  u_LightPosViewspace;
-
-// Shadow settings
-uniform float u_ShadowBias;
-uniform float u_NormalBias;
-uniform uint  u_ShadowFlags;
+// Every shadow casting light has a tile in this atlas
+layout (binding = 5) uniform sampler2DShadow s_ShadowAtlas;
+
+// Images to project, lights refer to these by index
+#define MAX_PROJECTION_MASKS 8
+layout (binding = 6) uniform sampler2D s_ProjectionMasks[MAX_PROJECTION_MASKS];
+
+// Matches RenderLayer::ShadowLightData
+struct ShadowLight {
+    // Matrix to go from view space to shadow clip space
+    mat4  ViewToShadow;
+    // The light's tile in the atlas as (x, y, width, height), in UV space
+    vec4  AtlasRect;
+    // Light's position in view space, and intensity in w
+    vec4  PositionIntensity;
+    // Light's color in RGB and attenuation in w
+    vec4  ColorAttenuation;
+    // Light's direction in view space, and the shadow bias in w
+    vec4  DirectionBias;
+    float NormalBias;
+    uint  Flags;
+    // Index into s_ProjectionMasks, or -1 if the light doesn't project anything
+    int   MaskIndex;
+    float Padding;
+};
 
-// Light settings
-uniform float u_Attenuation;
-uniform float u_Intensity;
-uniform vec3  u_LightColor;
+layout (std430, binding = 6) buffer b_ShadowLights {
+    ShadowLight ShadowLights[];
+};
+uniform uint u_ShadowLightCount;
 
 // Flags
 #define FLAG_PROJECTION_ENABLED (1 << 0)
@@ -38,8 +47,8 @@ uniform vec3  u_LightColor;
  * Determines if one of the shadow option flags is set,
  * if multiple flags are provided, checks all of them
  */
-bool ShadowFlagSet(uint flag) {
-    return (u_ShadowFlags & flag) == flag;
+bool ShadowFlagSet(uint flags, uint flag) {
+    return (flags & flag) == flag;
 }
 
 // Represents a single light source
@@ -70,18 +79,20 @@ vec4 GetViewPos(vec2 uv) {
 // @param viewPos   The fragment's position in view space
 // @param normal    The fragment's normal (normalized)
 // @param Light     The light to caluclate the contribution for
+// @param lightDir  The direction the light is facing in view space
+// @param flags     The light's shadow flags
 // @param shininess The specular power for the fragment, between 0 and 1
-void CalcDirectionalLightContribution(vec3 viewPos, vec3 normal, Light light, float shininess, inout vec3 diffuse, inout vec3 specular) {
+void CalcDirectionalLightContribution(vec3 viewPos, vec3 normal, Light light, vec3 lightDir, uint flags, float shininess, inout vec3 diffuse, inout vec3 specular) {
 
         vec3 lightViewPos = light.PositionIntensity.xyz;
         vec3 lightVec = lightViewPos - viewPos;
         float dist = length(lightVec);
-        vec3 lightDir = -u_LightDirViewspace;
+        lightDir = -lightDir;
 
         float attenuation = 1.0;
         // We'll use a modified distance squared attenuation factor to keep it simple
         // We add the one to prevent divide by zero errors
-        if (ShadowFlagSet(FLAG_ENABLE_ATTENUATION)) {
+        if (ShadowFlagSet(flags, FLAG_ENABLE_ATTENUATION)) {
             attenuation = clamp(1.0 / (1.0 + light.ColorAttenuation.w * pow(dist, 2)), 0, 256);
         }
 
@@ -95,19 +106,39 @@ void CalcDirectionalLightContribution(vec3 viewPos, vec3 normal, Light light, fl
         specular += VdotR * light.ColorAttenuation.rgb * shininess * attenuation * light.PositionIntensity.w;
 }
 
+// Takes a single sample from the light's tile in the shadow atlas, samples are kept inside of the
+// tile so that PCF doesn't pick up depth from the neighbouring lights
+// @param fragPos  The position in the shadow's normalized clip space to sample
+// @param offset   The offset from fragPos to sample at, in atlas UV space
+// @param bias     The shadow bias factor to use
+// @param tileRect The light's tile in the atlas, as (x, y, width, height)
+// @param limits   The smallest and largest UVs we can sample inside of the tile, as (min.xy, max.xy)
+float SampleShadow(vec3 fragPos, vec2 offset, float bias, vec4 tileRect, vec4 limits) {
+    vec2 uv = clamp(tileRect.xy + fragPos.xy * tileRect.zw + offset, limits.xy, limits.zw);
+    // Note the use of a vec3 for sample pos! The z is the depth to compare,
+    // OpenGL will take care of the rest and return a value between 0 and 1
+    // as long as the texture is a sampler2DShadow. This is also where bias is
+    // applied.
+    return texture(s_ShadowAtlas, vec3(uv, fragPos.z - bias));
+}
+
 // This function will sample multiple points around our sample, and average the results
 // This gives a slight blur to the edges of the shadows, and helps to soften them up
-// @param fragPos The position in the shadow's normalized clip space to sample
-// @param bias The shadow bias factor to use
-float PCF(vec3 fragPos, float bias) {
+// @param fragPos  The position in the shadow's normalized clip space to sample
+// @param bias     The shadow bias factor to use
+// @param tileRect The light's tile in the atlas, as (x, y, width, height)
+// @param flags    The light's shadow flags
+float PCF(vec3 fragPos, float bias, vec4 tileRect, uint flags) {
+    vec2 texelSize = 1.0 / textureSize(s_ShadowAtlas, 0); // Determine the texel size of the shadow sampler
+    // Stay half a texel away from the edges so linear filtering doesn't bleed into other tiles
+    vec4 limits = vec4(tileRect.xy + texelSize * 0.5, tileRect.xy + tileRect.zw - texelSize * 0.5);
 
     // If we're doing PCF, we want to take multiple samples
-    if (ShadowFlagSet(FLAG_ENABLE_PCF)) {
+    if (ShadowFlagSet(flags, FLAG_ENABLE_PCF)) {
         float result = 0.0; // accumulator
-        vec2 texelSize = 1.0 / textureSize(s_ShadowDepth, 0); // Determine the texel size of the shadow sampler
         
         // 5x5 kernel
-        if (ShadowFlagSet(FLAG_ENABLE_WIDE_PCF)) {
+        if (ShadowFlagSet(flags, FLAG_ENABLE_WIDE_PCF)) {
             // Normalized 5x5 gaussian kernel
             const float kernel[5][5] = {
                 { 1.0/273,  4.0/273,  7.0/273,  4.0/273, 1.0/273 },
@@ -120,15 +151,7 @@ float PCF(vec3 fragPos, float bias) {
             // Iterate over a 5x5 area of texels around our sample location
             for(int x = -2; x <= 2; ++x) { 
                 for(int y = -2; y <= 2; ++y) {
-                    // Note the use of a vec3 for sample pos! The z is the depth to compare,
-                    // OpenGL will take care of the rest and return a value between 0 and 1
-                    // as long as the texture is a sampler2DShadow. This is also where bias is
-                    // applied.
-                    float contrib =
-                        texture(
-                            s_ShadowDepth, 
-                            vec3(fragPos.xy + vec2(x,y) * texelSize, fragPos.z - bias)
-                        );
+                    float contrib = SampleShadow(fragPos, vec2(x,y) * texelSize, bias, tileRect, limits);
                     // Apply kernel weights to the result
                     result += contrib * kernel[x+2][y+2];
                 }    
@@ -146,8 +169,8 @@ float PCF(vec3 fragPos, float bias) {
             // Iterate over a 3x3 area of texels around our sample location
             for(int x = -1; x <= 1; ++x) { 
                 for(int y = -1; y <= 1; ++y) {
-                    // See above notes about texture
-                    float contrib = texture(s_ShadowDepth, vec3(fragPos.xy + vec2(x,y) * texelSize, fragPos.z - bias));
+                    // See above notes about SampleShadow
+                    float contrib = SampleShadow(fragPos, vec2(x,y) * texelSize, bias, tileRect, limits);
                     result += contrib * kernel[x+1][y+1];
                 }    
             }
@@ -157,9 +180,8 @@ float PCF(vec3 fragPos, float bias) {
     }
     // PCF is not enabled, take 1 sample
     else {
-        // See above notes about texture
-        float contrib = texture(s_ShadowDepth, vec3(fragPos.xy, fragPos.z - bias));
-        return contrib; // Perform the depth test, and return the result
+        // Perform the depth test, and return the result
+        return SampleShadow(fragPos, vec2(0), bias, tileRect, limits);
     }
 }
 
@@ -175,65 +197,62 @@ void main() {
     // Make sure the normal is in fact, a normal
     normal = normalize(normal);
 
-    // Get values from the g-buffer
-    vec3 albedo = GetAlbedo(inUV);
-
     // Get viewspace from depth re-construction method (just to show how it works!)
     vec3 viewPos = GetViewPos(inUV).xyz;
 
-    // Determine the position in light clip space
-	vec4 shadowPos = u_ViewToShadow * vec4(viewPos, 1.0);  
-	shadowPos /= shadowPos.w;                // Perspective divide
-	shadowPos = shadowPos * 0.5 + 0.5;       // Normalize from clip space to [0,1]
-    
-    // If pixel on screen is outside the bounds of the light, skip it
-    if (shadowPos.x < 0 || shadowPos.x > 1 || 
-        shadowPos.y < 0 || shadowPos.y > 1 || 
-        shadowPos.z < 0 || shadowPos.z > 1) {
-        //outDiffuse  = vec4(1, 0, 0, 1);
-        //outSpecular = vec4(1, 0, 0, 1);
-        //return;
-        discard;
-    }
-
-    // Calculate a bias based on the dot product between surface normal and light direction
-    float bias = max(u_NormalBias * (1.0 - dot(normal, u_LightDirViewspace)), u_ShadowBias);
-
-    // Determine how much of the pixel on the screen is in shadow
-    float lightContrib = PCF(shadowPos.xyz, bias);
+    // We'll also grab specular power from the G-Buffer
+    float specularPow = texture(s_AlbedoSpec, inUV).a;
 
     vec3 diffuse = vec3(0);
     vec3 specular = vec3(0);
 
-    // We can skip lighting calculation if the pixel is fully in shadow!
-    if (lightContrib > 0) {
-
-        // Create a light structure we can pass to the CalcDirectionalLightContribution function
-        Light l;
-        l.PositionIntensity = vec4(u_LightPosViewspace, u_Intensity);
+    for (uint ix = 0; ix < u_ShadowLightCount; ix++) {
+        ShadowLight light = ShadowLights[ix];
 
-        // If we want to use the projection mask, we sample it and multiply by light color
-        if (ShadowFlagSet(FLAG_PROJECTION_ENABLED)) {
-            vec3 color = texture(s_ProjectionMask, shadowPos.xy).rgb * u_LightColor;
-            l.ColorAttenuation = vec4(color, u_Attenuation);
-        }
-        // We do not want to use the projection mask, just use the light color
-        else {
-            l.ColorAttenuation = vec4(u_LightColor, u_Attenuation);
+        // Determine the position in light clip space
+        vec4 shadowPos = light.ViewToShadow * vec4(viewPos, 1.0);  
+        shadowPos /= shadowPos.w;                // Perspective divide
+        shadowPos = shadowPos * 0.5 + 0.5;       // Normalize from clip space to [0,1]
+    
+        // If pixel on screen is outside the bounds of the light, skip it
+        if (shadowPos.x < 0 || shadowPos.x > 1 || 
+            shadowPos.y < 0 || shadowPos.y > 1 || 
+            shadowPos.z < 0 || shadowPos.z > 1) {
+            continue;
         }
 
-        // We'll also grab specular power from the G-Buffer
-        float specularPow = texture(s_AlbedoSpec, inUV).a;
+        // Calculate a bias based on the dot product between surface normal and light direction
+        vec3 lightDir = light.DirectionBias.xyz;
+        float bias = max(light.NormalBias * (1.0 - dot(normal, lightDir)), light.DirectionBias.w);
+
+        // Determine how much of the pixel on the screen is in shadow
+        float lightContrib = PCF(shadowPos.xyz, bias, light.AtlasRect, light.Flags);
 
-        // Use the structure to calculate a directional light's contribution
-        CalcDirectionalLightContribution(viewPos, normal, l, specularPow, diffuse, specular);
+        // We can skip lighting calculation if the pixel is fully in shadow!
+        if (lightContrib > 0) {
+            // Create a light structure we can pass to the CalcDirectionalLightContribution function
+            Light l;
+            l.PositionIntensity = light.PositionIntensity;
+            l.ColorAttenuation = light.ColorAttenuation;
 
-        // We multiply the final light contribution by the inverse of the shadow
-        diffuse  *= lightContrib;
-        specular *= lightContrib;
+            // If we want to use the projection mask, we sample it and multiply by light color
+            if (ShadowFlagSet(light.Flags, FLAG_PROJECTION_ENABLED) && light.MaskIndex >= 0) {
+                l.ColorAttenuation.rgb *= texture(s_ProjectionMasks[light.MaskIndex], shadowPos.xy).rgb;
+            }
+
+            vec3 lightDiffuse = vec3(0);
+            vec3 lightSpecular = vec3(0);
+
+            // Use the structure to calculate a directional light's contribution
+            CalcDirectionalLightContribution(viewPos, normal, l, lightDir, light.Flags, specularPow, lightDiffuse, lightSpecular);
+
+            // We multiply the final light contribution by the inverse of the shadow
+            diffuse  += lightDiffuse * lightContrib;
+            specular += lightSpecular * lightContrib;
+        }
     }
 
     // Return our results
     outDiffuse = vec4(diffuse, 1);
     outSpecular = vec4(specular, 1);
-}
\ No newline at end of file
+}
@@ -20,18 +20,6 @@ layout (std140, binding = 0) uniform b_FrameLevelUniforms {
     uniform float u_ZFar;
 };
 
-// Stores uniforms that change every object/instance
-layout (std140, binding = 1) uniform b_InstanceLevelUniforms {
-    // Complete MVP
-    uniform mat4 u_ModelViewProjection;
-    // Just the model transform, we'll do worldspace lighting
-    uniform mat4 u_Model;
-    // Just the model * view, for converting to view space
-    uniform mat4 u_ModelView;
-    // Normal Matrix for transforming normals
-    uniform mat4 u_NormalMatrix;
-};
-
 #define FLAG_ENABLE_COLOR_CORRECTION (1 << 0)
 #define FLAG_ENABLE_LIGHTS (1 << 1)
 #define FLAG_ENABLE_SPECULAR (1 << 2)
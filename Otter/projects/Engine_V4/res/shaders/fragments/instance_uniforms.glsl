@@ -0,0 +1,25 @@
+// Stores data that changes every object/instance. The renderer sorts objects
+// that share a mesh and material into instanced draws, and binds the range of
+// this buffer holding that draw's instances
+struct InstanceData {
+    // Just the model transform, we'll do worldspace lighting
+    mat4 Model;
+    // Normal Matrix for transforming normals
+    mat4 NormalMatrix;
+    // The morph animation frame, see MorphClip::FrameState. Only read by morph shaders
+    uvec4 MorphOffsets;
+    vec4 MorphScaleBlend;
+};
+
+layout (std430, binding = 1) readonly buffer b_InstanceData {
+    InstanceData Instances[];
+};
+
+// Keep the old uniform names around, so shaders don't need to care whether they are instanced.
+// Note these require frame_uniforms.glsl to be included first
+#define u_Model               (Instances[gl_InstanceID].Model)
+#define u_NormalMatrix        (Instances[gl_InstanceID].NormalMatrix)
+#define u_ModelView           (u_View * u_Model)
+#define u_ModelViewProjection (u_ViewProjection * u_Model)
+#define u_MorphOffsets        (Instances[gl_InstanceID].MorphOffsets)
+#define u_MorphScale          (Instances[gl_InstanceID].MorphScaleBlend)
@@ -0,0 +1,42 @@
+// Reads morph target animation frames, see Gameplay/MorphClip. Every loaded clip is packed
+// into this buffer, and vertices are looked up by gl_VertexID
+layout (std430, binding = 2) readonly buffer b_MorphData {
+    uint MorphData[];
+};
+
+#define MORPH_ENCODING_FLOAT     0
+#define MORPH_ENCODING_QUANTIZED 1
+
+vec3 _MorphLoadVec3(uint offset) {
+    return vec3(uintBitsToFloat(MorphData[offset]), uintBitsToFloat(MorphData[offset + 1]), uintBitsToFloat(MorphData[offset + 2]));
+}
+
+vec3 _MorphDecodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) {
+        n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(n);
+}
+
+// Gets the blended position and normal of a vertex
+//    offsets: x and y are the frames to blend between, z is the rest pose, w is the encoding
+//    scaleBlend: xyz is the scale of quantized deltas, w is the blend between the frames
+void GetMorphVertex(uint vertex, uvec4 offsets, vec4 scaleBlend, out vec3 position, out vec3 normal) {
+    if (offsets.w == MORPH_ENCODING_FLOAT) {
+        uint a = offsets.x + vertex * 6;
+        uint b = offsets.y + vertex * 6;
+        position = mix(_MorphLoadVec3(a), _MorphLoadVec3(b), scaleBlend.w);
+        normal = normalize(mix(_MorphLoadVec3(a + 3), _MorphLoadVec3(b + 3), scaleBlend.w));
+    } else {
+        uvec2 a = uvec2(MorphData[offsets.x + vertex * 2], MorphData[offsets.x + vertex * 2 + 1]);
+        uvec2 b = uvec2(MorphData[offsets.y + vertex * 2], MorphData[offsets.y + vertex * 2 + 1]);
+        vec3 deltaA = vec3(unpackSnorm2x16(a.x), unpackSnorm2x16(a.y).x);
+        vec3 deltaB = vec3(unpackSnorm2x16(b.x), unpackSnorm2x16(b.y).x);
+        position = _MorphLoadVec3(offsets.z + vertex * 6) + mix(deltaA, deltaB, scaleBlend.w) * scaleBlend.xyz;
+        normal = normalize(mix(
+            _MorphDecodeOctahedral(unpackSnorm4x8(a.y >> 16).xy),
+            _MorphDecodeOctahedral(unpackSnorm4x8(b.y >> 16).xy),
+            scaleBlend.w));
+    }
+}
@@ -17,3 +17,5 @@ layout(location = 4) out mat3 outTBN;
 
 // Include the matrices and frame level parameters
 #include "frame_uniforms.glsl"
+// Include the per-instance matrices
+#include "instance_uniforms.glsl"
@@ -14,11 +14,13 @@
 #include "Utils/FileHelpers.h"
 #include "Utils/ResourceManager/ResourceManager.h"
 #include "Utils/ImGuiHelper.h"
+#include "Utils/JobSystem.h"
 #include "ToneFire.h"
 
 // Graphics
 #include "Graphics/Buffers/IndexBuffer.h"
 #include "Graphics/Buffers/VertexBuffer.h"
+#include "Graphics/Buffers/StreamingBuffer.h"
 #include "Graphics/VertexArrayObject.h"
 #include "Graphics/ShaderProgram.h"
 #include "Graphics/Textures/Texture1D.h"
@@ -32,8 +34,10 @@
 
 // Gameplay
 #include "Gameplay/Material.h"
+#include "Gameplay/MorphClip.h"
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Scene.h"
+#include "Gameplay/SceneBinary.h"
 
 // Components
 #include "Gameplay/Components/IComponent.h"
@@ -80,6 +84,8 @@ std::string Application::_applicationName = "INFR-2350U - DEMO";
 
 #define DEFAULT_WINDOW_WIDTH 1920
 #define DEFAULT_WINDOW_HEIGHT 1080
+// How long we can spend streaming in a binary scene each frame, in milliseconds
+#define SCENE_STREAM_BUDGET_MS 8.0
 
 Application::Application() :
 	_window(nullptr),
@@ -88,7 +94,10 @@ Application::Application() :
 	_isEditor(true),
 	_windowTitle("Vanguard"),
 	_currentScene(nullptr),
-	_targetScene(nullptr)
+	_targetScene(nullptr),
+	_sceneLoader(nullptr),
+	_parallelFrame(false),
+	_frameGraph(TaskGraph())
 { }
 
 Application::~Application() = default; 
@@ -135,6 +144,13 @@ bool Application::LoadScene(const std::string& path) {
 			ResourceManager::LoadManifest(manifestPath);
 		}
 
+		// Binary scenes get streamed in over the next few frames
+		if (Gameplay::SceneBinary::IsBinaryScene(path)) {
+			LOG_INFO("Streaming scene from \"{}\"", path);
+			_sceneLoader = Gameplay::SceneBinaryLoader::Open(path);
+			return _sceneLoader != nullptr;
+		}
+
 		Gameplay::Scene::Sptr scene = Gameplay::Scene::Load(path);
 		LoadScene(scene);
 		return scene != nullptr;
@@ -143,6 +159,8 @@ bool Application::LoadScene(const std::string& path) {
 }
 
 void Application::LoadScene(const Gameplay::Scene::Sptr& scene) {
+	// Switching to a scene directly cancels any scene that is still streaming in
+	_sceneLoader = nullptr;
 	_targetScene = scene;
 }
 
@@ -193,6 +211,10 @@ void Application::_Run()
 	// Register all component and resource types
 	_RegisterClasses();
 
+	// Start up the worker threads, frames only use them if parallel frames are enabled
+	JobSystem::Init();
+	_parallelFrame = JsonGet(_appSettings, "parallel_frame", false);
+
 
 	// Load all layers
 	_Load();
@@ -206,8 +228,21 @@ void Application::_Run()
 	// Infinite loop as long as the application is running
 	while (_isRunning) {
 
+		// Move on to a fresh part of the per-frame upload buffer, fencing off what the last frame used
+		StreamingBuffer::Get().BeginFrame();
+
+		// Parallel frames update audio alongside rendering instead
+		const bool parallelFrame = _parallelFrame && JobSystem::IsInitialized();
+
 		//Updating Audio Engine
-		AudioEngine::studioupdate();
+		if (!parallelFrame) {
+			AudioEngine::studioupdate();
+		}
+
+		// Keep streaming in the scene we're loading, and switch to it once it's done
+		if (_sceneLoader != nullptr && _sceneLoader->Step(SCENE_STREAM_BUDGET_MS)) {
+			LoadScene(_sceneLoader->GetScene());
+		}
 
 		// Handle scene switching
 		if (_targetScene != nullptr) {
@@ -217,6 +252,9 @@ void Application::_Run()
 		// Receive events like input and window position/size changes from GLFW
 		glfwPollEvents();
 
+		// Create any resources that have finished loading in the background
+		ResourceManager::ProcessUploads();
+
 		// Handle closing the app via the close button
 		if (glfwWindowShouldClose(_window)) {
 			_isRunning = false;
@@ -242,11 +280,17 @@ void Application::_Run()
 
 		// Core update loop
 		if (_currentScene != nullptr) {
-			_Update();
-			_LateUpdate();
-			_PreRender();
-			_RenderScene(); 
-			_PostRender();
+			if (parallelFrame) {
+				_RunFrameGraph();
+			} else {
+				_Update();
+				_LateUpdate();
+				_PreRender();
+				_RenderScene(); 
+				_PostRender();
+			}
+		} else if (parallelFrame) {
+			AudioEngine::studioupdate();
 		}
 
 		// Store timing for next loop
@@ -279,6 +323,7 @@ void Application::_RegisterClasses()
 	ResourceManager::RegisterType<ShaderProgram>();
 	ResourceManager::RegisterType<Material>();
 	ResourceManager::RegisterType<MeshResource>();
+	ResourceManager::RegisterType<MorphClip>();
 	ResourceManager::RegisterType<Font>();
 	ResourceManager::RegisterType<Framebuffer>();
 
@@ -376,7 +421,45 @@ void Application::_PostRender() {
 	}
 }
 
+void Application::_RunFrameGraph() {
+	_frameGraph.Clear();
+
+	// Layers can split their update into tasks, anything else is run as a single task that
+	// waits on everything before it, and that everything after it waits on
+	for (const auto& layer : _layers) {
+		if (layer->Enabled && *(layer->Overrides & AppLayerFunctions::OnUpdate)) {
+			if (!layer->OnScheduleUpdate(_frameGraph)) {
+				ApplicationLayer* target = layer.get();
+				_frameGraph.AddTask(layer->Name, FrameResource::All, FrameResource::All, [target]() {
+					target->OnUpdate();
+				}, true);
+			}
+		}
+	}
+
+	// Gameplay code is done playing sounds, so FMOD can update while we render
+	_frameGraph.AddTask("Audio", FrameResource::Audio, FrameResource::Audio, []() {
+		AudioEngine::studioupdate();
+	});
+
+	// Rendering needs everything besides audio to be done, and needs the GL context
+	_frameGraph.AddTask("Render", FrameResource::All ^ FrameResource::Audio, FrameResource::Render | FrameResource::Gui, [this]() {
+		_LateUpdate();
+		_PreRender();
+		_RenderScene();
+		_PostRender();
+	}, true);
+
+	_frameGraph.Execute();
+}
+
 void Application::_Unload() {
+	// Drop any scene that was still streaming in
+	_sceneLoader = nullptr;
+
+	// Stop any background loading, and release our resources while we still have a context
+	ResourceManager::Cleanup();
+
 	// Note that we use a reverse iterator for unloading
 	for (auto it = _layers.crbegin(); it != _layers.crend(); it++) {
 		const auto& layer = *it;
@@ -387,6 +470,11 @@ void Application::_Unload() {
 
 	// Clean up ImGui
 	ImGuiHelper::Cleanup();
+
+	// Release the per-frame upload buffer while we still have a context
+	StreamingBuffer::Uninitialize();
+
+	JobSystem::Cleanup();
 }
 
 void Application::_HandleSceneChange() {
@@ -470,6 +558,7 @@ nlohmann::json Application::_GetDefaultAppSettings()
 
 	result["window_width"]  = DEFAULT_WINDOW_WIDTH;
 	result["window_height"] = DEFAULT_WINDOW_HEIGHT;
+	result["parallel_frame"] = false;
 	return result;
 }
 
@@ -6,9 +6,14 @@
 #include "Application/ApplicationLayer.h"
 #include "Gameplay/Scene.h"
 #include "Gameplay/MeshResource.h"
+#include "Utils/TaskGraph.h"
 
 struct GLFWwindow;
 
+namespace Gameplay {
+	class SceneBinaryLoader;
+}
+
 /**
  * The application will be the main container for all of our shared game engine features,
  * such as windows, input, rendering, etc...
@@ -68,10 +73,11 @@ public:
 	void Quit();
 
 	/**
-	 * Loads a new scene into the application using a path on disk
+	 * Loads a new scene into the application using a path on disk. Binary scenes (.bscene)
+	 * are streamed in over the next few frames, and switched to once they finish loading
 	 * 
 	 * @param path The path to the scene file to load
-	 * @returns True if the file was found and the scene loaded, false if otherwise
+	 * @returns True if the file was found and the scene loaded (or started streaming), false if otherwise
 	 */
 	bool LoadScene(const std::string& path);
 	/**
@@ -109,6 +115,20 @@ public:
 	 */
 	void SaveSettings();
 
+	/**
+	 * Sets whether each frame is run through a task graph, so that layers (and the systems within
+	 * them) that don't touch the same data can run at the same time on the job system's workers.
+	 * When disabled, layers are invoked one after another on the main thread
+	 * 
+	 * @param value True to run frames through the task graph
+	 */
+	void SetParallelFrameEnabled(bool value) { _parallelFrame = value; }
+	bool GetParallelFrameEnabled() const { return _parallelFrame; }
+	/**
+	 * Gets the task graph for the last frame that ran in parallel, which holds the timeline for that frame
+	 */
+	const TaskGraph& GetFrameGraph() const { return _frameGraph; }
+
 protected:
 	// The GL driver layer is a special friend that can access our protected members (mainly window info)
 	friend class GLAppLayer;
@@ -137,10 +157,16 @@ protected:
 	Gameplay::Scene::Sptr _currentScene;
 	// The scene to switch to at the start of the next frame
 	Gameplay::Scene::Sptr _targetScene;
+	// Streams in a binary scene over multiple frames, will switch to the scene once it's loaded
+	std::shared_ptr<Gameplay::SceneBinaryLoader> _sceneLoader;
 
 	// Stores all the layers of the application, in the order they should be invoked
 	std::vector<ApplicationLayer::Sptr> _layers;
 
+	// When enabled, each frame is built into _frameGraph and run across the job system
+	bool      _parallelFrame;
+	TaskGraph _frameGraph;
+
 	void _Run();
 	void _RegisterClasses();
 	void _Load();
@@ -149,6 +175,7 @@ protected:
 	void _PreRender();
 	void _RenderScene();
 	void _PostRender();
+	void _RunFrameGraph();
 	void _Unload();
 	void _HandleSceneChange();
 	void _HandleWindowSizeChanged(const glm::ivec2& newSize);
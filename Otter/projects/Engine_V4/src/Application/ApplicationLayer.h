@@ -6,6 +6,7 @@
 #include <GLM/glm.hpp>
 
 #include "Graphics/Framebuffer.h"
+#include "Utils/TaskGraph.h"
 
 /**
  * Enumeration flags that let the application know what functions a layer has overriden,
@@ -78,6 +79,17 @@ public:
 	 * Invoked when the application updates, at varying time steps (see Timing class)
 	 */
 	virtual void OnUpdate() {};
+	/**
+	 * Allows the layer to split it's update into tasks when the application is running frames
+	 * through a task graph, so that parts of it can run alongside other layers. Each task declares
+	 * the frame resources it reads and writes, and the graph makes sure that tasks that touch the
+	 * same data run in the order they were added. Layers that don't add their own tasks have
+	 * OnUpdate run on the main thread, after everything before them
+	 * 
+	 * @param graph The graph for the current frame
+	 * @returns True if the layer added it's own tasks, false to have OnUpdate run as a single task
+	 */
+	virtual bool OnScheduleUpdate(TaskGraph& graph) { return false; }
 	/**
 	 * Invoked after all layers in an application have been updated
 	 */
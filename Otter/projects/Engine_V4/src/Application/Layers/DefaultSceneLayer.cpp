@@ -39,6 +39,7 @@
 
 // Gameplay
 #include "Gameplay/Material.h"
+#include "Gameplay/MorphClip.h"
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Scene.h"
 #include "Gameplay/Components/Light.h"
@@ -542,18 +543,18 @@ void DefaultSceneLayer::_CreateScene()
 	using namespace Gameplay::Physics;
 
 	
-	//Animation states
-	std::vector <MeshResource::Sptr> goblinAnimationRunning;
-	std::vector <MeshResource::Sptr> goblinAnimationAttacking;
-	std::vector <MeshResource::Sptr> goblinAnimationDying;
+	//Animation states, each clip packs all of it's frames into a single buffer
+	MorphClip::Sptr goblinAnimationRunning;
+	MorphClip::Sptr goblinAnimationAttacking;
+	MorphClip::Sptr goblinAnimationDying;
 
-	std::vector <MeshResource::Sptr> zombieAnimationRunning;
-	std::vector <MeshResource::Sptr> zombieAnimationAttacking;
-	std::vector <MeshResource::Sptr> zombieAnimationDying;
+	MorphClip::Sptr zombieAnimationRunning;
+	MorphClip::Sptr zombieAnimationAttacking;
+	MorphClip::Sptr zombieAnimationDying;
 
-	std::vector <MeshResource::Sptr> oozeAnimationWalk;
+	MorphClip::Sptr oozeAnimationWalk;
 
-	std::vector <MeshResource::Sptr> birdAnimationFly;
+	MorphClip::Sptr birdAnimationFly;
 
 	float universalFrameTime = 0.05; //0.05 is our default
 
@@ -1303,37 +1304,11 @@ void DefaultSceneLayer::_CreateScene()
 			initialMorph->SetMorphMeshRenderer(birdFlyMesh, birdFlyMaterial);
 			MorphAnimator::Sptr afterMorph = birdFly->Add<MorphAnimator>();
 
-			MeshResource::Sptr birdAnimationFrames[] = {
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000001.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000002.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000003.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000004.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000005.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000006.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000007.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000008.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000009.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000010.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000011.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000012.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000013.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000014.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000015.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000016.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000017.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000018.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000019.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Bird/Birdfly_000020.obj")
-				//20 FRAMES OF ANIMATIONS
-			};
-
-			for (int i = 0; i < 20; i++) {
-				birdAnimationFly.push_back(birdAnimationFrames[i]);
-			}
+			birdAnimationFly = ResourceManager::CreateAsset<MorphClip>(MorphClip::GetFrameSequence("models/Animated/Bird/Birdfly_", 20), universalFrameTime);
 
 			afterMorph->SetInitial();
 			afterMorph->SetFrameTime(universalFrameTime);
-			afterMorph->SetFrames(birdAnimationFly);
+			afterMorph->SetClip(birdAnimationFly);
 
 			enemiesParent->AddChild(birdFly);
 		};
@@ -1352,87 +1327,13 @@ void DefaultSceneLayer::_CreateScene()
 			initialMorph->SetMorphMeshRenderer(goblinAttackMesh, animGoblinAttackMaterial);
 			MorphAnimator::Sptr afterMorph = goblinAttack->Add<MorphAnimator>();
 
-			MeshResource::Sptr goblinRunningAnimationFrames[] = {
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000001.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000002.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000003.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000004.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000005.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000006.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000007.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000008.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000009.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000010.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000011.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000012.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000013.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000014.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000015.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000016.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000017.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000018.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000019.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/Run/GoblinRun_000020.obj")
-				//20 FRAMES OF ANIMATIONS
-			};
-
-			MeshResource::Sptr goblinAttackAnimationFrames[] = {
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000001.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000002.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000003.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000004.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000005.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000006.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000007.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000008.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000009.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000010.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000011.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000012.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000013.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000014.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000015.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000016.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000017.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000018.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000019.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/attack/GoblinAttack_000020.obj")
-				//20 FRAMES OF ANIMATIONS
-			};
-
-			MeshResource::Sptr goblinDyingAnimationFrames[] = {
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000001.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000002.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000003.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000004.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000005.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000006.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000007.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000008.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000009.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000010.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000011.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000012.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000013.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000014.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000015.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000016.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000017.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000018.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000019.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Goblin/die/Goblindie_000020.obj")
-				//20 FRAMES OF ANIMATIONS
-			};
-
-			for (int i = 0; i < 20; i++) {
-				goblinAnimationRunning.push_back(goblinRunningAnimationFrames[i]);
-				goblinAnimationAttacking.push_back(goblinAttackAnimationFrames[i]);
-				goblinAnimationDying.push_back(goblinDyingAnimationFrames[i]);
-			}
+			goblinAnimationRunning = ResourceManager::CreateAsset<MorphClip>(MorphClip::GetFrameSequence("models/Animated/Goblin/Run/GoblinRun_", 20), universalFrameTime);
+			goblinAnimationAttacking = ResourceManager::CreateAsset<MorphClip>(MorphClip::GetFrameSequence("models/Animated/Goblin/attack/GoblinAttack_", 20), universalFrameTime);
+			goblinAnimationDying = ResourceManager::CreateAsset<MorphClip>(MorphClip::GetFrameSequence("models/Animated/Goblin/die/Goblindie_", 20), universalFrameTime);
 
 			afterMorph->SetInitial();
 			afterMorph->SetFrameTime(universalFrameTime);
-			afterMorph->SetFrames(goblinAnimationRunning);
+			afterMorph->SetClip(goblinAnimationRunning);
 
 
 			enemiesParent->AddChild(goblinAttack);
@@ -1452,37 +1353,11 @@ void DefaultSceneLayer::_CreateScene()
 			initialMorph->SetMorphMeshRenderer(oozeMesh,animOozeMaterial);
 			MorphAnimator::Sptr afterMorph = oozeWalk->Add<MorphAnimator>();
 
-			MeshResource::Sptr oozeAnimationFrames[] = {
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000001.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000002.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000003.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000004.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000005.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000006.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000007.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000008.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000009.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000010.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000011.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000012.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000013.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000014.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000015.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000016.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000017.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000018.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000019.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Ooze/walk/oozewalk_000020.obj")
-				//20 FRAMES OF ANIMATIONS
-			};
-
-			for (int i = 0; i < 20; i++) {
-				oozeAnimationWalk.push_back(oozeAnimationFrames[i]);
-			}
+			oozeAnimationWalk = ResourceManager::CreateAsset<MorphClip>(MorphClip::GetFrameSequence("models/Animated/Ooze/walk/oozewalk_", 20), universalFrameTime);
 
 			afterMorph->SetInitial();
 			afterMorph->SetFrameTime(universalFrameTime);
-			afterMorph->SetFrames(oozeAnimationWalk);
+			afterMorph->SetClip(oozeAnimationWalk);
 
 			enemiesParent->AddChild(oozeWalk);
 
@@ -1502,88 +1377,13 @@ void DefaultSceneLayer::_CreateScene()
 			initialMorph->SetMorphMeshRenderer(zombieAttackMesh, animZombieAttackMaterial);
 			MorphAnimator::Sptr afterMorph = zombieAttack->Add<MorphAnimator>();
 
-			MeshResource::Sptr zombieRunningAnimationFrames[] = {
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000001.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000002.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000003.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000004.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000005.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000006.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000007.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000008.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000009.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000010.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000011.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000012.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000013.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000014.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000015.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000016.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000017.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000018.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000019.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/run/ZombieRun_000020.obj")
-				//20 FRAMES OF ANIMATIONS
-			};
-
-			MeshResource::Sptr zombieAttackAnimationFrames[] = {
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000001.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000002.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000003.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000004.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000005.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000006.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000007.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000008.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000009.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000010.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000011.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000012.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000013.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000014.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000015.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000016.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000017.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000018.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000019.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/attack/ZombieAttack_000020.obj")
-				//20 FRAMES OF ANIMATIONS
-			};
-
-			MeshResource::Sptr zombieDyingAnimationFrames[] = {
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000001.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000002.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000003.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000004.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000005.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000006.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000007.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000008.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000009.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000010.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000011.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000012.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000013.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000014.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000015.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000016.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000017.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000018.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000019.obj"),
-				ResourceManager::CreateAsset<MeshResource>("models/Animated/Zombie/die/zombieDie_000020.obj")
-				//20 FRAMES OF ANIMATIONS
-				//Does not exist so goblin used as stand in
-			};
-
-			for (int i = 0; i < 20; i++) {
-				zombieAnimationRunning.push_back(zombieRunningAnimationFrames[i]);
-				zombieAnimationAttacking.push_back(zombieAttackAnimationFrames[i]);
-				zombieAnimationDying.push_back(zombieDyingAnimationFrames[i]);
-			}
+			zombieAnimationRunning = ResourceManager::CreateAsset<MorphClip>(MorphClip::GetFrameSequence("models/Animated/Zombie/run/ZombieRun_", 20), universalFrameTime);
+			zombieAnimationAttacking = ResourceManager::CreateAsset<MorphClip>(MorphClip::GetFrameSequence("models/Animated/Zombie/attack/ZombieAttack_", 20), universalFrameTime);
+			zombieAnimationDying = ResourceManager::CreateAsset<MorphClip>(MorphClip::GetFrameSequence("models/Animated/Zombie/die/zombieDie_", 20), universalFrameTime);
 
 			afterMorph->SetInitial();
 			afterMorph->SetFrameTime(universalFrameTime);
-			afterMorph->SetFrames(zombieAnimationDying);
+			afterMorph->SetClip(zombieAnimationDying);
 
 
 			enemiesParent->AddChild(zombieAttack);
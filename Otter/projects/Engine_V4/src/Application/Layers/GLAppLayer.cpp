@@ -2,6 +2,8 @@
 #include "GLFW/glfw3.h"
 #include "Logging.h"
 #include "Application/Application.h"
+#include "Utils/ResourceManager/ResourceManager.h"
+#include "Graphics/Textures/Texture2D.h"
 
 GLAppLayer::GLAppLayer() :
 	ApplicationLayer() {
@@ -31,6 +33,18 @@ void GLAppLayer::OnAppLoad(const nlohmann::json& config) {
 	LOG_ASSERT(gladLoadGLLoader((GLADloadproc)glfwGetProcAddress) != 0, "Failed to initialize glad");
 
 	glEnable(GL_PROGRAM_POINT_SIZE);
+
+	// Textures that are still streaming in via ResourceManager::LoadAsync will show up as plain white
+	Texture2DDescription placeholderDesc;
+	placeholderDesc.Width = 1;
+	placeholderDesc.Height = 1;
+	placeholderDesc.Format = InternalFormat::RGBA8;
+	placeholderDesc.GenerateMipMaps = false;
+	Texture2D::Sptr placeholder = std::make_shared<Texture2D>(placeholderDesc);
+	uint8_t white[4] = { 255, 255, 255, 255 };
+	placeholder->LoadData(1, 1, PixelFormat::RGBA, PixelType::UByte, white);
+	placeholder->SetDebugName("Placeholder");
+	ResourceManager::SetPlaceholder(placeholder);
 }
 
 void GLAppLayer::OnAppUnload()
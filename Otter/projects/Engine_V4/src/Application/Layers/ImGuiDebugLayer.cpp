@@ -15,6 +15,7 @@
 #include "../Windows/DebugWindow.h"
 #include "../Windows/GBufferPreviews.h"
 #include "../Windows/PostProcessingSettingsWindow.h"
+#include "../Windows/BenchmarkWindow.h"
 
 #include "Graphics/DebugDraw.h"
 
@@ -40,6 +41,7 @@ void ImGuiDebugLayer::OnAppLoad(const nlohmann::json& config)
 	RegisterWindow<DebugWindow>();
 	RegisterWindow<GBufferPreviews>();
 	RegisterWindow<PostProcessingSettingsWindow>();
+	RegisterWindow<BenchmarkWindow>();
 }
 
 void ImGuiDebugLayer::OnAppUnload()
@@ -165,7 +167,7 @@ void ImGuiDebugLayer::OnRender(const Framebuffer::Sptr& prevLayer)
 
 				// Load scene item
 				if (ImGui::MenuItem("Load Scene", NULL, false)) {
-					std::optional<std::string> path = FileDialogs::OpenFile("Scene File\0*.json\0\0");
+					std::optional<std::string> path = FileDialogs::OpenFile("Scene File\0*.json;*.bscene\0JSON Scene\0*.json\0Binary Scene\0*.bscene\0\0");
 					if (path.has_value()) {
 						app.LoadScene(path.value());
 					}
@@ -173,7 +175,7 @@ void ImGuiDebugLayer::OnRender(const Framebuffer::Sptr& prevLayer)
 
 				// Save scene item
 				if (ImGui::MenuItem("Save Scene", NULL, false)) {
-					std::optional<std::string> path = FileDialogs::SaveFile("Scene File\0*.json\0\0");
+					std::optional<std::string> path = FileDialogs::SaveFile("JSON Scene\0*.json\0Binary Scene\0*.bscene\0\0");
 					if (path.has_value()) {
 						app.CurrentScene()->Save(path.value());
 
@@ -331,6 +333,14 @@ void ImGuiDebugLayer::_RenderGameWindow()
 
 	ImGui::Text("FPS: %.*0f", 3, 1.0f / Timing::Current().DeltaTime());
 
+	// Show how much of the scene is surviving frustum culling
+	RenderLayer::Sptr renderLayer = app.GetLayer<RenderLayer>();
+	if (renderLayer != nullptr) {
+		const RenderLayer::CullingStats& culling = renderLayer->GetCullingStats();
+		ImGui::SameLine();
+		ImGui::Text(" | Visible: %u Culled: %u | Shadow Visible: %u Culled: %u", culling.Visible, culling.Culled, culling.ShadowVisible, culling.ShadowCulled);
+	}
+
 	// Determine the relative position of the window
 	ImVec2 subPos = ImGui::GetWindowPos();
 	ImVec2 cursorPos = ImGui::GetCursorPos();
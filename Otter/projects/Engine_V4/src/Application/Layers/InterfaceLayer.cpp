@@ -37,6 +37,9 @@ void InterfaceLayer::OnRender(const Framebuffer::Sptr& prevLayer) {
 	glm::mat4 proj = glm::ortho(0.0f, (float)app.GetWindowSize().x, (float)app.GetWindowSize().y, 0.0f, -1.0f, 1.0f);
 	GuiBatcher::SetProjection(proj);
 
+	// The batcher's counters cover a single frame of GUI
+	GuiBatcher::ResetStats();
+
 	// Iterate over and render all the GUI objects
 	app.CurrentScene()->RenderGUI();
 
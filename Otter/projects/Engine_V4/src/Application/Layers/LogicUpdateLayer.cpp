@@ -21,3 +21,36 @@ void LogicUpdateLayer::OnUpdate()
 	// Update our worlds physics!
 	app.CurrentScene()->DoPhysics(Timing::Current().DeltaTime());
 }
+
+bool LogicUpdateLayer::OnScheduleUpdate(TaskGraph& graph)
+{
+	Gameplay::Scene::Sptr scene = Application::Get().CurrentScene();
+	const float dt = Timing::Current().DeltaTime();
+
+	// Components can do anything in their updates, including GL calls, so they stay on the main thread
+	graph.AddTask("Scene Update", FrameResource::Input | FrameResource::Scene,
+		FrameResource::Scene | FrameResource::Transforms | FrameResource::Physics | FrameResource::Animation, [scene, dt]() {
+		scene->UpdateObjects(dt);
+	}, true);
+
+	// Animation only touches animators and their render components, so it can run alongside
+	// the transform update and physics
+	graph.AddTask("Animation", FrameResource::Scene, FrameResource::Animation, [scene, dt]() {
+		scene->UpdateAnimation(dt);
+	});
+	graph.AddTask("Transforms", FrameResource::Scene, FrameResource::Transforms, [scene]() {
+		scene->UpdateTransforms();
+	});
+
+	graph.AddTask("Physics", FrameResource::Scene, FrameResource::Physics | FrameResource::Transforms, [scene, dt]() {
+		scene->StepPhysics(dt);
+	});
+
+	// Trigger callbacks are gameplay code, so they wait on everything else in the scene
+	graph.AddTask("Physics Events", FrameResource::Physics,
+		FrameResource::Scene | FrameResource::Transforms | FrameResource::Physics | FrameResource::Animation, [scene]() {
+		scene->DispatchPhysicsEvents();
+	}, true);
+
+	return true;
+}
@@ -11,6 +11,7 @@ public:
 	// Inherited from ApplicationLayer
 
 	virtual void OnUpdate() override;
+	virtual bool OnScheduleUpdate(TaskGraph& graph) override;
 
 protected:
 
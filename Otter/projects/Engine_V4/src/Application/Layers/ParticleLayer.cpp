@@ -20,7 +20,7 @@ void ParticleLayer::OnUpdate()
 	// Only update the particle systems when the game is playing, so we can edit them in
 	// the inspector
 	if (app.CurrentScene()->IsPlaying) {
-		app.CurrentScene()->Components().Each<ParticleSystem>([](const ParticleSystem::Sptr& system) {
+		app.CurrentScene()->Components().Each<ParticleSystem>([](ParticleSystem* system) {
 			if (system->IsEnabled) {
 				system->Update();
 			}
@@ -28,6 +28,16 @@ void ParticleLayer::OnUpdate()
 	}
 }
 
+bool ParticleLayer::OnScheduleUpdate(TaskGraph& graph)
+{
+	// Emitters follow their objects, so we need to wait for physics to finish moving them.
+	// GPU particle systems dispatch compute shaders, so this needs the main thread
+	graph.AddTask(Name, FrameResource::Scene | FrameResource::Transforms, FrameResource::Particles, [this]() {
+		OnUpdate();
+	}, true);
+	return true;
+}
+
 void ParticleLayer::OnPostRender()
 {
 	Application& app = Application::Get();
@@ -40,7 +50,7 @@ void ParticleLayer::OnPostRender()
 	renderOutput->Bind();
 	glViewport(0, 0, renderOutput->GetWidth(), renderOutput->GetHeight());
 
-	Application::Get().CurrentScene()->Components().Each<ParticleSystem>([](const ParticleSystem::Sptr& system) {
+	Application::Get().CurrentScene()->Components().Each<ParticleSystem>([](ParticleSystem* system) {
 		if (system->IsEnabled) {
 			system->Render(); 
 		}
@@ -9,6 +9,7 @@ public:
 	virtual ~ParticleLayer();
 
 	void OnUpdate() override;
+	bool OnScheduleUpdate(TaskGraph& graph) override;
 	void OnPostRender() override;
 
 };
\ No newline at end of file
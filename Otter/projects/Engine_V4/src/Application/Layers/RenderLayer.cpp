@@ -8,6 +8,7 @@
 #include "Gameplay/Components/ComponentManager.h"
 #include "Gameplay/Components/RenderComponent.h"
 #include "Gameplay/Components/Light.h"
+#include "Gameplay/MorphClip.h"
 
 // GLM math library
 #include <GLM/glm.hpp>
@@ -17,6 +18,9 @@
 #include <GLM/gtx/common.hpp> // for fmod (floating modulus)
 #include "Gameplay/Components/ShadowCamera.h"
 
+#include <algorithm>
+#include <chrono>
+
 
 RenderLayer::RenderLayer() :
 	ApplicationLayer(),
@@ -25,8 +29,36 @@ RenderLayer::RenderLayer() :
 	_frameUniforms(nullptr),
 	_instanceUniforms(nullptr),
 	_renderFlags(RenderFlags::EnableLights | RenderFlags::EnableSpecular | RenderFlags::EnableAmbient),
-	_clearColor({ 0.1f, 0.1f, 0.1f, 1.0f })
+	_clearColor({ 0.1f, 0.1f, 0.1f, 1.0f }),
+	_cullingTree(),
+	_unculledRenderables(),
+	_cullingFrame(0),
+	_cullingEnabled(true),
+	_cullingStats(),
+	_lastCullingStats(),
+	_lightClusters(),
+	_clusterLights(),
+	_clusterLightBounds(),
+	_shadowAtlas(),
+	_shadowAtlasFBO(nullptr),
+	_shadowCacheFBO(nullptr),
+	_shadowLights(),
+	_shadowInvalidations(),
+	_shadowLightData(),
+	_shadowMasks(),
+	_shadowQueries(),
+	_shadowQueryPending(),
+	_shadowQueryHead(0),
+	_shadowQueryTail(0),
+	_shadowGpuMs(0.0f),
+	_shadowStats(),
+	_lastShadowStats()
 {
+	_cullingStats.Reset();
+	_lastCullingStats.Reset();
+	_shadowStats.Reset();
+	_lastShadowStats.Reset();
+
 	Name = "Rendering";
 	Overrides =
 		AppLayerFunctions::OnAppLoad |
@@ -50,6 +82,17 @@ void RenderLayer::OnPreRender()
 		glm::vec4(0.0f)
 	};
 
+	// Start a fresh frame of instance data
+	_lastFrameStats = _renderQueue.GetStats();
+	_renderQueue.BeginFrame();
+
+	// Refit the culling tree to where objects are this frame
+	_lastCullingStats = _cullingStats;
+	_cullingStats.Reset();
+	_lastShadowStats = _shadowStats;
+	_shadowStats.Reset();
+	_UpdateCullingTree();
+
 	_primaryFBO->Bind();
 	// Clear the framebuffer. Note that this also binds and sets the viewport
 	_ClearFramebuffer(_primaryFBO, colors, 4);
@@ -154,6 +197,13 @@ void RenderLayer::OnPostRender() {
 	_outputBuffer->Unbind();
 }
 
+// Streams this frame's copy of some data to the GPU, and binds it to a storage buffer slot
+static void StreamStorageBuffer(uint32_t slot, const void* data, uint32_t elementSize, uint32_t count) {
+	StreamingBuffer& stream = StreamingBuffer::Get();
+	StreamingBuffer::Allocation allocation = stream.Upload(data, elementSize * count, StreamingBuffer::GetStorageAlignment());
+	stream.BindRange(BufferType::ShaderStorage, slot, allocation);
+}
+
 void RenderLayer::_AccumulateLighting()
 {
 	using namespace Gameplay;
@@ -217,113 +267,351 @@ void RenderLayer::_AccumulateLighting()
 	{
 		data.AmbientCol = glm::vec3(0.1f);
 	}
-	int ix = 0;
-	app.CurrentScene()->Components().Each<Light>([&](const Light::Sptr& light) {
-		// Get the light's position in view space, since we're doing view space lighting
+
+	// Gather every light in view space, since we're doing view space lighting
+	_clusterLights.clear();
+	_clusterLightBounds.clear();
+	app.CurrentScene()->Components().Each<Light>([&](Light* light) {
 		glm::vec4 pos = glm::vec4(light->GetGameObject()->GetWorldPosition(), 1.0f);
 		pos = view * pos;
 
-		// Copy to the ubo data
-		data.Lights[ix].Position = (glm::vec3)(pos) / pos.w;
-		data.Lights[ix].Intensity = light->GetIntensity();
-		data.Lights[ix].Color = light->GetColor();
-		data.Lights[ix].Attenuation = 1.0f / (1.0f + light->GetRadius());
+		LightingUboStruct::Light lightData;
+		lightData.Position = (glm::vec3)(pos) / pos.w;
+		lightData.Intensity = light->GetIntensity();
+		lightData.Color = light->GetColor();
+		lightData.Attenuation = 1.0f / (1.0f + light->GetRadius());
 
-		ix++;
+		// Attenuation is 1 / (1 + a * d^2), so solve for where the light's brightest channel drops below the cutoff
+		const float peak = lightData.Intensity * glm::max(lightData.Color.r, glm::max(lightData.Color.g, lightData.Color.b));
+		if (peak <= LIGHT_CUTOFF) {
+			return;
+		}
+		const float range = glm::sqrt((peak / LIGHT_CUTOFF - 1.0f) / lightData.Attenuation);
 
-		// If we've reached the max # of lights the shader supports, draw to the screen and start the next batch
-		if (ix == MAX_LIGHTS) {
-			data.NumLights = MAX_LIGHTS;
+		_clusterLights.push_back(lightData);
+		_clusterLightBounds.push_back({ lightData.Position, range });
+	});
 
-			// Send updated data to OpenGL
-			_lightingUbo->Update();
+	// Forward shaders still use the UBO, so they get the first few lights
+	const uint32_t lightCount = static_cast<uint32_t>(_clusterLights.size());
+	const uint32_t forwardLights = glm::min(lightCount, static_cast<uint32_t>(MAX_LIGHTS));
+	std::copy(_clusterLights.begin(), _clusterLights.begin() + forwardLights, data.Lights);
+	data.NumLights = static_cast<float>(forwardLights);
+	_lightingUbo->Update();
 
-			// Draw the fullscreen quad to accumulate the lights
-			_fullscreenQuad->Draw();
+	// Bin the lights into clusters, so each pixel only pays for the lights that can reach it
+	_lightClusters.SetProjection(camera->GetProjection(), camera->GetNearPlane(), camera->GetFarPlane());
+	_lightClusters.Build(_clusterLightBounds);
 
-			ix = 0;
-		}
-		});
+	if (lightCount > 0) {
+		const std::vector<LightClusterGrid::ClusterRange>& clusters = _lightClusters.GetClusters();
+		const std::vector<uint32_t>& indices = _lightClusters.GetLightIndices();
 
-	// If we have lights left over that haven't been drawn, draw them now
-	if (ix > 0) {
-		data.NumLights = ix;
+		StreamStorageBuffer(LIGHT_SSBO_BINDING, _clusterLights.data(), sizeof(LightingUboStruct::Light), lightCount);
+		StreamStorageBuffer(LIGHT_CLUSTER_SSBO_BINDING, clusters.data(), sizeof(LightClusterGrid::ClusterRange), static_cast<uint32_t>(clusters.size()));
+		StreamStorageBuffer(LIGHT_INDEX_SSBO_BINDING, indices.data(), sizeof(uint32_t), static_cast<uint32_t>(indices.size()));
 
-		// Send updated data to OpenGL
-		_lightingUbo->Update();
+		_lightAccumulationShader->SetUniform("u_ClusterCount", _lightClusters.GetDimensions());
+		_lightAccumulationShader->SetUniform("u_ClusterSliceParams", _lightClusters.GetSliceParams());
 
-		// Draw the fullscreen quad to accumulate the lights
+		// All the lights are accumulated in a single pass
 		_fullscreenQuad->Draw();
 	}
 
-	// Re-render the scene for shadows
-	app.CurrentScene()->Components().Each<ShadowCamera>([&](const ShadowCamera::Sptr& shadowCam) {
-		// Bind the shadow camera's depth buffer and clear it
-		shadowCam->GetDepthBuffer()->Bind();
-		glClear(GL_DEPTH_BUFFER_BIT);
-		glViewport(0, 0, shadowCam->GetBufferResolution().x, shadowCam->GetBufferResolution().y);
-
-		_RenderScene(shadowCam->GetGameObject()->GetInverseTransform(), shadowCam->GetProjection(), shadowCam->GetDepthBuffer()->GetSize());
-		
-		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
-		});
+	// Bring the shadow atlas up to date, this will stomp on our framebuffer and frame uniforms
+	_RenderShadows();
 
 	// Restore frame level uniforms
 	_InitFrameUniforms();
 
 	_lightingFBO->Bind();
 	glViewport(0, 0, _lightingFBO->GetWidth(), _lightingFBO->GetHeight());
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE);
 
-	// Bind our G-Buffer textures so that they're readable
-	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Depth)->Bind(0);  // depth
-	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color0)->Bind(1); // albedo + spec
-	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color1)->Bind(2); // normals + metallic
-	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color2)->Bind(3); // emissive
-	_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color3)->Bind(4); // view pos
+	// Every shadowed light is composited in a single pass, reading from its tile in the atlas
+	const uint32_t shadowLightCount = static_cast<uint32_t>(_shadowLightData.size());
+	if (shadowLightCount > 0) {
+		// Bind our G-Buffer textures so that they're readable
+		_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Depth)->Bind(0);  // depth
+		_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color0)->Bind(1); // albedo + spec
+		_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color1)->Bind(2); // normals + metallic
+		_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color2)->Bind(3); // emissive
+		_primaryFBO->GetTextureAttachment(RenderTargetAttachment::Color3)->Bind(4); // view pos
+
+		// Bind the atlas and projection masks for reading, making sure not to stomp G-Buffer bindings
+		_shadowAtlasFBO->BindAttachment(RenderTargetAttachment::Depth, 5);
+		for (size_t ix = 0; ix < _shadowMasks.size(); ix++) {
+			_shadowMasks[ix]->Bind(6 + static_cast<int>(ix));
+		}
 
-	// Bind shadow composite shader
-	_shadowShader->Bind();
+		StreamStorageBuffer(SHADOW_SSBO_BINDING, _shadowLightData.data(), sizeof(ShadowLightData), shadowLightCount);
 
-	// Add each shadow casting light to the lighting buffers
-	app.CurrentScene()->Components().Each<ShadowCamera>([&](const ShadowCamera::Sptr& shadowCam) {
-		// This gets us the light -> view space matrix, which we'll inverse to go from view space to light space
-		glm::mat4 lightSpaceMatrix = camera->GetView() * shadowCam->GetGameObject()->GetTransform();
+		_shadowShader->Bind();
+		_shadowShader->SetUniform("u_ShadowLightCount", shadowLightCount);
+		_fullscreenQuad->Draw();
+	}
 
-		// Or we have a matrix to go from view space to shadow space
-		glm::mat4 viewToShadow = shadowCam->GetProjection() * glm::inverse(lightSpaceMatrix);
+	// Unbind the lighting FBO so we can read its textures
+	_lightingFBO->Unbind();
+}
 
-		// Calculate light's position and direction in view space
-		glm::vec3 lightDirViewSpace = glm::mat3(lightSpaceMatrix) * glm::vec3(0, 0, -1.0f);
-		glm::vec3 lightPosViewSpace = lightSpaceMatrix * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+// Estimates how much of the screen a light's frustum covers, between 0 and 1, by projecting the
+// corners of the light's frustum into the camera
+static float GetScreenCoverage(const glm::mat4& lightViewProj, const glm::mat4& cameraViewProj, const Frustum& cameraFrustum) {
+	const glm::mat4 inverseLight = glm::inverse(lightViewProj);
+
+	glm::vec3 corners[8];
+	AABB bounds;
+	for (int ix = 0; ix < 8; ix++) {
+		glm::vec4 corner = inverseLight * glm::vec4((ix & 1) ? 1.0f : -1.0f, (ix & 2) ? 1.0f : -1.0f, (ix & 4) ? 1.0f : -1.0f, 1.0f);
+		corners[ix] = glm::vec3(corner) / corner.w;
+		bounds.Encapsulate(corners[ix]);
+	}
+	if (!cameraFrustum.Intersects(bounds)) {
+		return 0.0f;
+	}
 
-		// Bind depth and projection mask for reading, making sure not to stomp G-Buffer bindings
-		shadowCam->GetDepthBuffer()->BindAttachment(RenderTargetAttachment::Depth, 5);
-		if (shadowCam->GetProjectionMask() != nullptr) {
-			shadowCam->GetProjectionMask()->Bind(6);
+	glm::vec2 min = glm::vec2(1.0f);
+	glm::vec2 max = glm::vec2(-1.0f);
+	for (const glm::vec3& corner : corners) {
+		glm::vec4 clip = cameraViewProj * glm::vec4(corner, 1.0f);
+		// Part of the light is behind the camera, so it's probably all around us
+		if (clip.w <= 0.0f) {
+			return 1.0f;
+		}
+		min = glm::min(min, glm::vec2(clip) / clip.w);
+		max = glm::max(max, glm::vec2(clip) / clip.w);
+	}
+	min = glm::clamp(min, glm::vec2(-1.0f), glm::vec2(1.0f));
+	max = glm::clamp(max, glm::vec2(-1.0f), glm::vec2(1.0f));
+	const glm::vec2 size = glm::max(max - min, glm::vec2(0.0f));
+	return size.x * size.y * 0.25f;
+}
+
+void RenderLayer::_RenderShadows()
+{
+	using namespace Gameplay;
+	typedef std::chrono::high_resolution_clock Clock;
+
+	Application& app = Application::Get();
+	Camera::Sptr camera = app.CurrentScene()->MainCamera;
+	const Frustum cameraFrustum = Frustum::FromViewProjection(camera->GetViewProjection());
+	const Texture2D::Sptr atlasTexture = _shadowAtlasFBO->GetTextureAttachment(RenderTargetAttachment::Depth);
+	const Texture2D::Sptr cacheTexture = _shadowCacheFBO->GetTextureAttachment(RenderTargetAttachment::Depth);
+
+	const Clock::time_point start = Clock::now();
+
+	// Grab the GPU time from any queries that have finished, queries finish in the order they
+	// were issued so we can stop at the first one that isn't ready
+	while (_shadowQueryPending[_shadowQueryHead]) {
+		GLuint available = GL_FALSE;
+		glGetQueryObjectuiv(_shadowQueries[_shadowQueryHead], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) {
+			break;
 		}
 
-		//_shadowShader->SetUniformMatrix("u_ClipToShadow", clipToShadow); 
-		_shadowShader->SetUniformMatrix("u_ViewToShadow", viewToShadow);
+		GLuint64 nanoseconds = 0;
+		glGetQueryObjectui64v(_shadowQueries[_shadowQueryHead], GL_QUERY_RESULT, &nanoseconds);
+		_shadowGpuMs = static_cast<float>(nanoseconds / 1000000.0);
+		_shadowQueryPending[_shadowQueryHead] = false;
+		_shadowQueryHead = (_shadowQueryHead + 1) % SHADOW_TIMER_QUERIES;
+	}
+
+	// If every query is still in flight we skip timing this frame rather than waiting on the GPU
+	const int query = _shadowQueryTail;
+	const bool issueQuery = !_shadowQueryPending[query];
+	if (issueQuery) {
+		glBeginQuery(GL_TIME_ELAPSED, _shadowQueries[query]);
+	}
+
+	// Work out how big each light's tile should be, based on how much of the screen it covers
+	std::vector<std::pair<ShadowCamera*, ShadowLightState*>> lights;
+	app.CurrentScene()->Components().Each<ShadowCamera>([&](ShadowCamera* shadowCam) {
+		ShadowLightState& state = _shadowLights[shadowCam];
+		state.Stamp = _cullingFrame;
+
+		// Moving or reshaping the light throws away everything it had rendered
+		const glm::mat4 viewProj = shadowCam->GetViewProjection();
+		if (viewProj != state.ViewProjection) {
+			state.ViewProjection = viewProj;
+			state.ViewFrustum = Frustum::FromViewProjection(viewProj);
+			state.StaticValid = false;
+			state.LiveValid = false;
+		}
+
+		const float coverage = GetScreenCoverage(viewProj, camera->GetViewProjection(), cameraFrustum);
+		const glm::vec4& color = shadowCam->GetColor();
+		const float brightness = shadowCam->Intensity * color.w * glm::max(color.r, glm::max(color.g, color.b));
+
+		int size = 0;
+		if (coverage > 0.0f && brightness > 0.0f) {
+			// Tiles are powers of two, so round our max resolution down to one
+			const int maxResolution = glm::max(shadowCam->GetBufferResolution().x, shadowCam->GetBufferResolution().y);
+			int maxSize = _shadowAtlas.GetTileSize(maxResolution);
+			if (maxSize > maxResolution && maxSize > _shadowAtlas.GetMinTileSize()) {
+				maxSize /= 2;
+			}
+			size = glm::min(_shadowAtlas.GetTileSize(static_cast<int>(maxResolution * glm::sqrt(coverage))), maxSize);
+
+			// Don't drop down a size for small changes, otherwise lights on the edge would re-render every frame
+			if (size < state.RequestedSize && size * 2 >= state.RequestedSize) {
+				size = state.RequestedSize;
+			}
+		}
+		state.Priority = coverage * brightness;
+
+		if (size != state.RequestedSize) {
+			_shadowAtlas.Free(state.Tile);
+			state.Tile = AtlasAllocator::Tile();
+			state.RequestedSize = size;
+			state.StaticValid = false;
+			state.LiveValid = false;
+		}
+
+		lights.push_back({ shadowCam, &state });
+	});
+
+	// Give back the tiles of any lights that have been removed
+	for (auto it = _shadowLights.begin(); it != _shadowLights.end();) {
+		if (it->second.Stamp != _cullingFrame) {
+			_shadowAtlas.Free(it->second.Tile);
+			it = _shadowLights.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	// Hand out tiles to the most important lights first, shrinking them if the atlas is getting full
+	std::sort(lights.begin(), lights.end(), [](const auto& a, const auto& b) {
+		return a.second->Priority > b.second->Priority;
+	});
+	for (auto& [shadowCam, state] : lights) {
+		if (state->RequestedSize == 0 || state->Tile.IsValid()) {
+			continue;
+		}
+		for (int size = state->RequestedSize; size >= _shadowAtlas.GetMinTileSize() && !state->Tile.IsValid(); size /= 2) {
+			state->Tile = _shadowAtlas.Allocate(size);
+		}
+	}
+
+	// Anything that changed inside of a light's frustum needs to be redrawn
+	for (auto& [shadowCam, state] : lights) {
+		if (!state->Tile.IsValid()) {
+			continue;
+		}
+		for (const ShadowInvalidation& change : _shadowInvalidations) {
+			if (change.Everywhere || state->ViewFrustum.Intersects(change.Bounds)) {
+				state->LiveValid = false;
+				state->StaticValid = state->StaticValid && !change.Static;
+			}
+		}
+	}
+	_shadowInvalidations.clear();
+
+	const RenderQueue::Stats drawsBefore = _renderQueue.GetStats();
+	const uint32_t castersBefore = _cullingStats.ShadowVisible;
+
+	// We only touch the tiles we're redrawing
+	glEnable(GL_SCISSOR_TEST);
+	glEnable(GL_DEPTH_TEST);
+	glDepthMask(true);
+	glDisable(GL_BLEND);
+
+	for (auto& [shadowCam, state] : lights) {
+		if (!state->Tile.IsValid() || state->LiveValid) {
+			continue;
+		}
+
+		const AtlasAllocator::Tile& tile = state->Tile;
+		const glm::mat4 view = shadowCam->GetGameObject()->GetInverseTransform();
+		glViewport(tile.Position.x, tile.Position.y, tile.Size, tile.Size);
+		glScissor(tile.Position.x, tile.Position.y, tile.Size, tile.Size);
+
+		// Static casters only get re-rendered when something static in the light's view changes
+		if (!state->StaticValid) {
+			_shadowCacheFBO->Bind();
+			glClear(GL_DEPTH_BUFFER_BIT);
+			_RenderScene(view, shadowCam->GetProjection(), glm::ivec2(tile.Size), true, CasterFilter::Static);
+			state->StaticValid = true;
+			_shadowStats.StaticRedraws++;
+		}
+
+		// Start from the cached static depth, and draw everything that moves on top of it
+		glCopyImageSubData(
+			cacheTexture->GetHandle(), GL_TEXTURE_2D, 0, tile.Position.x, tile.Position.y, 0,
+			atlasTexture->GetHandle(), GL_TEXTURE_2D, 0, tile.Position.x, tile.Position.y, 0,
+			tile.Size, tile.Size, 1
+		);
+		_shadowAtlasFBO->Bind();
+		_RenderScene(view, shadowCam->GetProjection(), glm::ivec2(tile.Size), true, CasterFilter::Dynamic);
+		state->LiveValid = true;
+		_shadowStats.DynamicRedraws++;
+	}
+
+	glDisable(GL_SCISSOR_TEST);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+
+	if (issueQuery) {
+		glEndQuery(GL_TIME_ELAPSED);
+		_shadowQueryPending[query] = true;
+		_shadowQueryTail = (_shadowQueryTail + 1) % SHADOW_TIMER_QUERIES;
+	}
+
+	// Gather up everything the composite pass needs to know about the lights
+	const glm::mat4& cameraView = camera->GetView();
+	const float atlasSize = static_cast<float>(_shadowAtlas.GetSize());
+	_shadowLightData.clear();
+	_shadowMasks.clear();
+	for (auto& [shadowCam, state] : lights) {
+		const AtlasAllocator::Tile& tile = state->Tile;
+		shadowCam->_atlasTile = glm::ivec3(tile.Position, tile.Size);
+		shadowCam->_atlasTexture = atlasTexture;
+		if (!tile.IsValid()) {
+			_shadowStats.Skipped++;
+			continue;
+		}
+
+		// This gets us the light -> view space matrix, which we'll inverse to go from view space to light space
+		const glm::mat4 lightSpaceMatrix = cameraView * shadowCam->GetGameObject()->GetTransform();
 
 		// Get color and normalize it (strip the alpha)
 		glm::vec4 color = shadowCam->GetColor();
 		color *= color.w;
 
-		_shadowShader->SetUniform("u_LightDirViewspace", lightDirViewSpace);
-		_shadowShader->SetUniform("u_ShadowBias", shadowCam->Bias);
-		_shadowShader->SetUniform("u_NormalBias", shadowCam->NormalBias);
-		_shadowShader->SetUniform("u_Attenuation", 1 / shadowCam->Range);
-		_shadowShader->SetUniform("u_Intensity", shadowCam->Intensity);
-		_shadowShader->SetUniform("u_LightColor", (glm::vec3)color);
-		_shadowShader->SetUniform("u_LightPosViewspace", lightPosViewSpace);
-		_shadowShader->SetUniform("u_ShadowFlags", *shadowCam->Flags);
+		ShadowLightData data;
+		data.ViewToShadow = shadowCam->GetProjection() * glm::inverse(lightSpaceMatrix);
+		data.AtlasRect = glm::vec4(glm::vec2(tile.Position), glm::vec2(static_cast<float>(tile.Size))) / atlasSize;
+		data.PositionIntensity = glm::vec4(glm::vec3(lightSpaceMatrix * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)), shadowCam->Intensity);
+		data.ColorAttenuation = glm::vec4(glm::vec3(color), 1.0f / shadowCam->Range);
+		data.DirectionBias = glm::vec4(glm::mat3(lightSpaceMatrix) * glm::vec3(0.0f, 0.0f, -1.0f), shadowCam->Bias);
+		data.NormalBias = shadowCam->NormalBias;
+		data.Flags = *shadowCam->Flags;
+		data.MaskIndex = -1;
+		data.Padding = 0.0f;
+
+		// Lights that share a projection mask share a texture slot, if we run out of slots the light just won't project
+		const Texture2D::Sptr& mask = shadowCam->GetProjectionMask();
+		if (mask != nullptr) {
+			auto it = std::find(_shadowMasks.begin(), _shadowMasks.end(), mask);
+			if (it != _shadowMasks.end()) {
+				data.MaskIndex = static_cast<int32_t>(it - _shadowMasks.begin());
+			} else if (_shadowMasks.size() < MAX_SHADOW_MASKS) {
+				data.MaskIndex = static_cast<int32_t>(_shadowMasks.size());
+				_shadowMasks.push_back(mask);
+			}
+		}
 
-		// Draw the fullscreen quad to accumulate the lights
-		_fullscreenQuad->Draw();
-		});
+		_shadowLightData.push_back(data);
+		_shadowStats.Lights++;
+	}
+	_shadowStats.Cached = _shadowStats.Lights - glm::min(_shadowStats.DynamicRedraws, _shadowStats.Lights);
 
-	// Unbind the lighting FBO so we can read its textures
-	_lightingFBO->Unbind();
+	_shadowStats.Casters = _cullingStats.ShadowVisible - castersBefore;
+	_shadowStats.DrawCalls = _renderQueue.GetStats().DrawCalls - drawsBefore.DrawCalls;
+	_shadowStats.AtlasUsage = _shadowAtlas.GetUsage();
+	_shadowStats.GpuMs = _shadowGpuMs;
+	_shadowStats.CpuMs = static_cast<float>(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
 }
 
 void RenderLayer::_Composite()
@@ -525,6 +813,15 @@ void RenderLayer::OnUpdate()
 
 }
 
+bool RenderLayer::OnScheduleUpdate(TaskGraph& graph)
+{
+	// Our update only handles the lighting toggles, so it can run while the scene is simulating
+	graph.AddTask(Name, FrameResource::Input, FrameResource::Render, [this]() {
+		OnUpdate();
+	}, true);
+	return true;
+}
+
 void RenderLayer::OnAppLoad(const nlohmann::json & config)
 {
 	Application& app = Application::Get();
@@ -566,6 +863,17 @@ void RenderLayer::OnAppLoad(const nlohmann::json & config)
 
 	_outputBuffer = std::make_shared<Framebuffer>(fboDescriptor);
 
+	// Every shadow casting light renders into a tile of the atlas, static casters are cached in
+	// the same tile of the second atlas
+	fboDescriptor.Width = SHADOW_ATLAS_SIZE;
+	fboDescriptor.Height = SHADOW_ATLAS_SIZE;
+	fboDescriptor.RenderTargets.clear();
+	fboDescriptor.RenderTargets[RenderTargetAttachment::Depth] = RenderTargetDescriptor(RenderTargetType::Depth32);
+
+	_shadowAtlasFBO = std::make_shared<Framebuffer>(fboDescriptor);
+	_shadowCacheFBO = std::make_shared<Framebuffer>(fboDescriptor);
+	_shadowAtlas.Reset(SHADOW_ATLAS_SIZE, SHADOW_MIN_TILE_SIZE);
+
 	// We'll use one shader for light accumulation for now
 	_lightAccumulationShader = ShaderProgram::Create();
 	_lightAccumulationShader->LoadShaderPartFromFile("shaders/vertex_shaders/fullscreen_quad.glsl", ShaderPartType::Vertex);
@@ -616,6 +924,9 @@ void RenderLayer::OnAppLoad(const nlohmann::json & config)
 	_frameUniforms = std::make_shared<UniformBuffer<FrameLevelUniforms>>(BufferUsage::DynamicDraw);
 	_instanceUniforms = std::make_shared<UniformBuffer<InstanceLevelUniforms>>(BufferUsage::DynamicDraw);
 	_lightingUbo = std::make_shared<UniformBuffer<LightingUboStruct>>(BufferUsage::DynamicDraw);
+
+	// Timer queries for the shadow pass, read back a few frames later so we never wait on the GPU
+	glGenQueries(SHADOW_TIMER_QUERIES, _shadowQueries);
 }
 
 const Framebuffer::Sptr& RenderLayer::GetPrimaryFBO() const {
@@ -650,6 +961,22 @@ RenderFlags RenderLayer::GetRenderFlags() const {
 	return _renderFlags;
 }
 
+const LightClusterGrid& RenderLayer::GetLightClusters() const {
+	return _lightClusters;
+}
+
+uint32_t RenderLayer::GetLightCount() const {
+	return static_cast<uint32_t>(_clusterLights.size());
+}
+
+const RenderLayer::ShadowStats& RenderLayer::GetShadowStats() const {
+	return _lastShadowStats;
+}
+
+Texture2D::Sptr RenderLayer::GetShadowAtlas() const {
+	return _shadowAtlasFBO != nullptr ? _shadowAtlasFBO->GetTextureAttachment(RenderTargetAttachment::Depth) : nullptr;
+}
+
 const Framebuffer::Sptr& RenderLayer::GetLightingBuffer() const {
 	return _lightingFBO;
 }
@@ -686,17 +1013,100 @@ void RenderLayer::_InitFrameUniforms()
 	_frameUniforms->Update();
 }
 
-void RenderLayer::_RenderScene(const glm::mat4& view, const glm::mat4& projection, const glm::ivec2& screenSize)
+void RenderLayer::_UpdateCullingTree()
 {
 	using namespace Gameplay;
 
 	Application& app = Application::Get();
 
-	glm::mat4 viewProj = projection * view;
+	// Every proxy we touch this frame gets stamped, anything left over belonged to a
+	// component that was removed (or the previous scene) and gets cleaned up below
+	_cullingFrame++;
+	_unculledRenderables.clear();
+
+	app.CurrentScene()->Components().Each<RenderComponent>([&](RenderComponent* renderable) {
+		const MeshResource::Sptr& meshResource = renderable->GetMeshResource();
+		VertexArrayObject* mesh = meshResource != nullptr ? meshResource->Mesh.get() : nullptr;
+		const glm::mat4 transform = renderable->GetGameObject()->GetTransform();
+		const MorphClip::FrameState& morph = renderable->GetMorphState();
+
+		// Anything that moves, animates or swaps meshes needs to be redrawn in the shadow tiles that
+		// can see it. Objects that stay still for long enough move over to the static shadow cache
+		const bool wasStatic = _IsStaticCaster(renderable);
+		const bool changed =
+			renderable->_cullingMesh != mesh || renderable->_cullingTransform != transform ||
+			renderable->_cullingMorphState.Offsets != morph.Offsets || renderable->_cullingMorphState.ScaleBlend != morph.ScaleBlend;
+		const bool becameStatic = !changed && _cullingFrame - renderable->_lastMovedFrame == STATIC_CASTER_FRAMES;
+		const bool hadMesh = renderable->_cullingMesh != nullptr;
+
+		renderable->_cullingMesh = mesh;
+		renderable->_cullingTransform = transform;
+		renderable->_cullingMorphState = morph;
+		if (changed) {
+			renderable->_lastMovedFrame = _cullingFrame;
+		}
 
-	// The current material that is bound for rendering
-	Material::Sptr currentMat = nullptr;
-	ShaderProgram::Sptr shader = nullptr;
+		if (mesh == nullptr) {
+			// If we used to be drawn without bounds, we could have been in any shadow
+			if (hadMesh && renderable->_cullingProxy == -1) {
+				_shadowInvalidations.push_back({ AABB(), true, wasStatic });
+			}
+			renderable->_cullingProxy = -1;
+			return;
+		}
+
+		// Meshes without bounds can't be culled, so we always draw them
+		if (!mesh->GetBounds().IsValid()) {
+			if (changed || becameStatic) {
+				_shadowInvalidations.push_back({ AABB(), true, wasStatic || becameStatic });
+			}
+			renderable->_cullingProxy = -1;
+			_unculledRenderables.push_back(renderable);
+			return;
+		}
+
+		int& proxy = renderable->_cullingProxy;
+
+		// Our proxy may have been destroyed and the ID handed out to someone else
+		if (!_cullingTree.IsValidProxy(proxy) || _cullingTree.GetUserData(proxy) != renderable) {
+			const AABB bounds = mesh->GetBounds().Transformed(transform);
+			proxy = _cullingTree.CreateProxy(bounds, renderable);
+			_shadowInvalidations.push_back({ bounds, false, false });
+		}
+		// Only touch the tree for objects that have actually changed
+		else if (changed) {
+			const AABB bounds = mesh->GetBounds().Transformed(transform);
+			// The shadow we used to cast needs to be cleared too
+			_shadowInvalidations.push_back({ _cullingTree.GetFatBounds(proxy), false, wasStatic });
+			_cullingTree.MoveProxy(proxy, bounds);
+			_shadowInvalidations.push_back({ bounds, false, false });
+		}
+		else if (becameStatic) {
+			_shadowInvalidations.push_back({ _cullingTree.GetFatBounds(proxy), false, true });
+		}
+
+		_cullingTree.SetStamp(proxy, _cullingFrame);
+	});
+
+	// We don't know whether removed objects were static, so play it safe
+	_cullingTree.DestroyUnstamped(_cullingFrame, [&](const AABB& bounds) {
+		_shadowInvalidations.push_back({ bounds, false, true });
+	});
+	_cullingStats.Proxies = _cullingTree.GetProxyCount();
+}
+
+bool RenderLayer::_IsStaticCaster(const RenderComponent* renderable) const
+{
+	return _cullingFrame - renderable->_lastMovedFrame >= STATIC_CASTER_FRAMES;
+}
+
+void RenderLayer::_RenderScene(const glm::mat4& view, const glm::mat4& projection, const glm::ivec2& screenSize, bool shadowPass, CasterFilter casters)
+{
+	using namespace Gameplay;
+
+	Application& app = Application::Get();
+
+	glm::mat4 viewProj = projection * view;
 
 	Material::Sptr defaultMat = app.CurrentScene()->DefaultMaterial;
 
@@ -707,13 +1117,18 @@ void RenderLayer::_RenderScene(const glm::mat4& view, const glm::mat4& projectio
 	frameData.u_CameraPos = view * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
 	_frameUniforms->Update();
 
-	// Render all our objects
-	app.CurrentScene()->Components().Each<RenderComponent>([&](const RenderComponent::Sptr& renderable) {
+	uint32_t visible = 0;
+	auto submit = [&](RenderComponent* renderable) {
 		// Early bail if mesh not set
 		if (renderable->GetMesh() == nullptr) {
 			return;
 		}
 
+		// Shadow tiles draw their static and dynamic casters separately
+		if (casters != CasterFilter::All && _IsStaticCaster(renderable) != (casters == CasterFilter::Static)) {
+			return;
+		}
+
 		// If we don't have a material, try getting the scene's fallback material
 		// If none exists, do not draw anything
 		if (renderable->GetMaterial() == nullptr) {
@@ -725,31 +1140,71 @@ void RenderLayer::_RenderScene(const glm::mat4& view, const glm::mat4& projectio
 			}
 		}
 
-		// If the material has changed, we need to bind the new shader and set up our material and frame data
-		// Note: This is a good reason why we should be sorting the render components in ComponentManager
-		if (renderable->GetMaterial() != currentMat) {
-			currentMat = renderable->GetMaterial();
-			shader = currentMat->GetShader();
+		_renderQueue.Submit(renderable->GetMesh(), renderable->GetMaterial(), renderable->GetGameObject()->GetTransform(), renderable->GetMorphState());
+		visible++;
+	};
 
-			shader->Bind();
-			currentMat->Apply();
+	// Collect all our objects into the render queue, only walking the parts of the culling tree
+	// that overlap the frustum
+	if (_cullingEnabled) {
+		Frustum frustum = Frustum::FromViewProjection(viewProj);
+		_cullingTree.Query(frustum, [&](void* userData) {
+			submit(static_cast<RenderComponent*>(userData));
+		});
+		for (RenderComponent* renderable : _unculledRenderables) {
+			submit(renderable);
 		}
+	} else {
+		app.CurrentScene()->Components().Each<RenderComponent>(submit);
+	}
 
-		// Grab the game object so we can do some stuff with it
-		GameObject* object = renderable->GetGameObject();
+	const uint32_t total = _cullingTree.GetProxyCount() + static_cast<uint32_t>(_unculledRenderables.size());
+	const uint32_t culled = total > visible ? total - visible : 0;
+	if (shadowPass) {
+		_cullingStats.ShadowVisible += visible;
+		_cullingStats.ShadowCulled  += culled;
+	} else {
+		_cullingStats.Visible += visible;
+		_cullingStats.Culled  += culled;
+	}
+
+	// Every animated object reads it's frames out of the same buffer
+	MorphClip::BindPool(MORPH_SSBO_BINDING);
 
-		// Use our uniform buffer for our instance level uniforms
+	// Sort and draw everything. Shaders that don't read from the instance buffer still get our
+	// instance level UBO, one object at a time
+	_renderQueue.Flush(INSTANCE_SSBO_BINDING, [&](const glm::mat4& model) {
 		auto& instanceData = _instanceUniforms->GetData();
-		instanceData.u_Model = object->GetTransform();
-		instanceData.u_ModelViewProjection = viewProj * object->GetTransform();
-		instanceData.u_ModelView = view * object->GetTransform();
-		instanceData.u_NormalMatrix = glm::mat3(glm::transpose(glm::inverse(object->GetTransform())));
+		instanceData.u_Model = model;
+		instanceData.u_ModelViewProjection = viewProj * model;
+		instanceData.u_ModelView = view * model;
+		instanceData.u_NormalMatrix = glm::mat3(glm::transpose(glm::inverse(model)));
 		_instanceUniforms->Update();
+		});
+}
 
-		// Draw the object
-		renderable->GetMesh()->Draw();
+const Gameplay::RenderQueue::Stats& RenderLayer::GetRenderStats() const {
+	return _lastFrameStats;
+}
 
-		});
+void RenderLayer::SetInstancingEnabled(bool value) {
+	_renderQueue.SetInstancingEnabled(value);
+}
+
+bool RenderLayer::GetInstancingEnabled() const {
+	return _renderQueue.GetInstancingEnabled();
+}
+
+const RenderLayer::CullingStats& RenderLayer::GetCullingStats() const {
+	return _lastCullingStats;
+}
+
+void RenderLayer::SetCullingEnabled(bool value) {
+	_cullingEnabled = value;
+}
+
+bool RenderLayer::GetCullingEnabled() const {
+	return _cullingEnabled;
 }
 
 const UniformBuffer<RenderLayer::FrameLevelUniforms>::Sptr& RenderLayer::GetFrameUniforms() const
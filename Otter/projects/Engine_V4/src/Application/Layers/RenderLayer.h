@@ -6,8 +6,17 @@
 #include "Graphics/VertexArrayObject.h"
 #include "Gameplay/InputEngine.h"
 #include "Graphics/Textures/Texture1D.h"
+#include "Gameplay/RenderQueue.h"
+#include "Utils/BoundingVolumeHierarchy.h"
+#include "Utils/LightClusterGrid.h"
+#include "Graphics/Buffers/StreamingBuffer.h"
+#include "Utils/AtlasAllocator.h"
+#include "Utils/Frustum.h"
+#include <unordered_map>
 
 
+// The number of lights forward shaders can see through the lighting UBO, deferred
+// lighting goes through the light cluster grid instead and has no limit
 #define MAX_LIGHTS 8
 
 ENUM_FLAGS(RenderFlags, uint32_t,
@@ -21,6 +30,9 @@ ENUM_FLAGS(RenderFlags, uint32_t,
 
 );
 
+class RenderComponent;
+class ShadowCamera;
+
 class RenderLayer final : public ApplicationLayer {
 public:
 	MAKE_PTRS(RenderLayer); 
@@ -47,8 +59,8 @@ public:
 		float u_ZFar;
 	};
 
-	// Structure for our instance-level uniforms, matches layout from
-	// fragments/frame_uniforms.glsl
+	// Structure for our instance-level uniforms, for shaders that declare their own
+	// b_InstanceLevelUniforms block instead of using fragments/instance_uniforms.glsl
 	// For use with a UBO.
 	struct InstanceLevelUniforms {
 		// Complete MVP
@@ -87,6 +99,51 @@ public:
 		glm::mat4 EnvironmentRotation;
 	};
 
+	/// <summary>
+	/// Counters for how many objects were drawn or skipped by frustum culling in a frame
+	/// </summary>
+	struct CullingStats {
+		// Objects that passed culling for the main camera
+		uint32_t Visible;
+		// Objects that were outside of the main camera's frustum
+		uint32_t Culled;
+		// Objects drawn across all shadow casting cameras
+		uint32_t ShadowVisible;
+		// Objects skipped across all shadow casting cameras
+		uint32_t ShadowCulled;
+		// The number of objects in the culling tree
+		uint32_t Proxies;
+
+		void Reset() { Visible = Culled = ShadowVisible = ShadowCulled = Proxies = 0; }
+	};
+
+	/// <summary>
+	/// Counters for the shadow atlas, and how much work the shadow pass did in a frame
+	/// </summary>
+	struct ShadowStats {
+		// Shadow casting lights that have a tile in the atlas
+		uint32_t Lights;
+		// Shadow casting lights that didn't fit in the atlas, or aren't on screen
+		uint32_t Skipped;
+		// Lights that had to re-render their static casters
+		uint32_t StaticRedraws;
+		// Lights that had to re-render their dynamic casters on top of their cached static depth
+		uint32_t DynamicRedraws;
+		// Lights that reused last frame's tile as-is
+		uint32_t Cached;
+		// Objects drawn across all shadow tiles
+		uint32_t Casters;
+		// Draw calls issued by the shadow pass
+		uint32_t DrawCalls;
+		// Time spent rendering shadow tiles, in milliseconds. The GPU time lags a few frames behind
+		float    CpuMs;
+		float    GpuMs;
+		// The fraction of the atlas that is handed out to lights, between 0 and 1
+		float    AtlasUsage;
+
+		void Reset() { Lights = Skipped = StaticRedraws = DynamicRedraws = Cached = Casters = DrawCalls = 0; CpuMs = GpuMs = AtlasUsage = 0.0f; }
+	};
+
 	RenderLayer();
 	virtual ~RenderLayer();
 
@@ -110,8 +167,47 @@ public:
 
 	const UniformBuffer<FrameLevelUniforms>::Sptr& GetFrameUniforms() const;
 
+	/// <summary>
+	/// Gets the draw call and state change counters for the last frame that was rendered
+	/// </summary>
+	const Gameplay::RenderQueue::Stats& GetRenderStats() const;
+	/// <summary>
+	/// Sets whether objects that share a mesh and material are merged into instanced draws
+	/// </summary>
+	void SetInstancingEnabled(bool value);
+	bool GetInstancingEnabled() const;
+
+	/// <summary>
+	/// Gets the frustum culling counters for the last frame that was rendered
+	/// </summary>
+	const CullingStats& GetCullingStats() const;
+	/// <summary>
+	/// Sets whether objects outside of the camera frustums are skipped before they are submitted for drawing
+	/// </summary>
+	void SetCullingEnabled(bool value);
+	bool GetCullingEnabled() const;
+
+	/// <summary>
+	/// Gets the grid that lights were binned into for the last frame that was rendered
+	/// </summary>
+	const LightClusterGrid& GetLightClusters() const;
+	/// <summary>
+	/// Gets the number of lights that were sent to the lighting pass in the last frame
+	/// </summary>
+	uint32_t GetLightCount() const;
+
+	/// <summary>
+	/// Gets the shadow atlas counters for the last frame that was rendered
+	/// </summary>
+	const ShadowStats& GetShadowStats() const;
+	/// <summary>
+	/// Gets the depth texture that every shadow casting light renders into
+	/// </summary>
+	Texture2D::Sptr GetShadowAtlas() const;
+
 	// Inherited from ApplicationLayer
 	virtual void OnUpdate() override;
+	virtual bool OnScheduleUpdate(TaskGraph& graph) override;
 
 	virtual void OnAppLoad(const nlohmann::json& config) override;
 	virtual void OnPreRender() override;
@@ -120,6 +216,12 @@ public:
 	virtual void OnWindowResize(const glm::ivec2& oldSize, const glm::ivec2& newSize) override;
 
 protected:
+	// Which objects to draw when rendering the scene, see _IsStaticCaster
+	enum class CasterFilter {
+		All,
+		Static,
+		Dynamic
+	};
 
 	bool enable_specular = true;
 	bool lights = true;
@@ -155,8 +257,104 @@ protected:
 	const int LIGHTING_UBO_BINDING = 2;
 	UniformBuffer<LightingUboStruct>::Sptr _lightingUbo;
 
+	// Note that this is a shader storage binding, so it doesn't collide with the instance UBO
+	const int INSTANCE_SSBO_BINDING = 1;
+	// Morph target animation frames, see fragments/morph_targets.glsl
+	const int MORPH_SSBO_BINDING = 2;
+	// Clustered lighting, see fragment_shaders/light_accumulation.glsl
+	const int LIGHT_SSBO_BINDING = 3;
+	const int LIGHT_CLUSTER_SSBO_BINDING = 4;
+	const int LIGHT_INDEX_SSBO_BINDING = 5;
+	// Light contributions below this are dropped, lights only reach as far as they're brighter than this
+	const float LIGHT_CUTOFF = 1.0f / 256.0f;
+	LightClusterGrid _lightClusters;
+	std::vector<LightingUboStruct::Light>      _clusterLights;
+	std::vector<LightClusterGrid::LightBounds> _clusterLightBounds;
+
+	// Every shadow casting light gets a square tile in one big depth atlas, sized by how much of
+	// the screen it covers and how bright it is. Static casters are rendered into a matching tile
+	// of the cache atlas, and only copied back and drawn over with dynamic casters when needed
+	const int SHADOW_ATLAS_SIZE = 2048;
+	const int SHADOW_MIN_TILE_SIZE = 128;
+	const int SHADOW_SSBO_BINDING = 6;
+	// Objects that haven't moved for this many frames are drawn into the static shadow cache
+	const uint32_t STATIC_CASTER_FRAMES = 30;
+	// Projection masks are bound to consecutive texture slots after the atlas, see shadow_composite.glsl
+	static constexpr int MAX_SHADOW_MASKS = 8;
+	static constexpr int SHADOW_TIMER_QUERIES = 4;
+
+	struct ShadowLightState {
+		AtlasAllocator::Tile Tile;
+		// The tile size we asked for, which can be bigger than the tile we got if the atlas is full
+		int       RequestedSize = 0;
+		float     Priority = 0.0f;
+		glm::mat4 ViewProjection = glm::mat4(0.0f);
+		Frustum   ViewFrustum;
+		uint32_t  Stamp = 0;
+		// Whether the cached static depth and the atlas tile are up to date
+		bool      StaticValid = false;
+		bool      LiveValid = false;
+	};
+
+	// A region of the world where something changed, shadow tiles that can see it need re-rendering
+	struct ShadowInvalidation {
+		AABB Bounds;
+		// For objects without bounds, which can be seen from anywhere
+		bool Everywhere;
+		// True if the change affects the static cache, not just dynamic casters
+		bool Static;
+	};
+
+	// Matches the ShadowLight struct in fragment_shaders/shadow_composite.glsl (std430)
+	struct ShadowLightData {
+		// Goes from view space to the light's clip space
+		glm::mat4 ViewToShadow;
+		// The light's tile in the atlas, as (x, y, width, height) in UV space
+		glm::vec4 AtlasRect;
+		glm::vec4 PositionIntensity;
+		glm::vec4 ColorAttenuation;
+		// The light's direction in view space, and the shadow bias in w
+		glm::vec4 DirectionBias;
+		float     NormalBias;
+		uint32_t  Flags;
+		int32_t   MaskIndex;
+		float     Padding;
+	};
+
+	AtlasAllocator    _shadowAtlas;
+	Framebuffer::Sptr _shadowAtlasFBO;
+	Framebuffer::Sptr _shadowCacheFBO;
+	std::unordered_map<const ShadowCamera*, ShadowLightState> _shadowLights;
+	std::vector<ShadowInvalidation> _shadowInvalidations;
+	std::vector<ShadowLightData>    _shadowLightData;
+	std::vector<Texture2D::Sptr>    _shadowMasks;
+	GLuint      _shadowQueries[SHADOW_TIMER_QUERIES];
+	bool        _shadowQueryPending[SHADOW_TIMER_QUERIES];
+	int         _shadowQueryHead;
+	int         _shadowQueryTail;
+	// The most recent GPU time we got back from the timer queries
+	float       _shadowGpuMs;
+	ShadowStats _shadowStats;
+	ShadowStats _lastShadowStats;
+
+	Gameplay::RenderQueue _renderQueue;
+	Gameplay::RenderQueue::Stats _lastFrameStats;
+
+	// Dynamic tree of the world space bounds of all render components, refit once per frame
+	BoundingVolumeHierarchy _cullingTree;
+	// Objects that have no known bounds, these are never culled
+	std::vector<RenderComponent*> _unculledRenderables;
+	uint32_t     _cullingFrame;
+	bool         _cullingEnabled;
+	CullingStats _cullingStats;
+	CullingStats _lastCullingStats;
+
 	void _InitFrameUniforms();
-	void _RenderScene(const glm::mat4& view, const glm::mat4& projection, const glm::ivec2& screenSize);
+	void _UpdateCullingTree();
+	void _RenderScene(const glm::mat4& view, const glm::mat4& projection, const glm::ivec2& screenSize, bool shadowPass = false, CasterFilter casters = CasterFilter::All);
+	bool _IsStaticCaster(const RenderComponent* renderable) const;
+
+	void _RenderShadows();
 
 	void _AccumulateLighting();
 	void _Composite();
@@ -0,0 +1,1169 @@
+#include "BenchmarkWindow.h"
+#include "Application/Application.h"
+#include "Logging.h"
+
+#include "Gameplay/Scene.h"
+#include "Gameplay/SceneBinary.h"
+#include "Gameplay/Components/RotatingBehaviour.h"
+#include "Gameplay/Components/RenderComponent.h"
+#include "Gameplay/Components/ParticleSystem.h"
+#include "Gameplay/MeshResource.h"
+#include "Gameplay/ParticleSimulation.h"
+#include "Gameplay/Physics/RigidBody.h"
+#include "Gameplay/Physics/Colliders/BoxCollider.h"
+#include "Utils/ResourceManager/ResourceTable.h"
+#include "Utils/ObjParser.h"
+#include "Utils/MeshFactory.h"
+#include "Utils/StringUtils.h"
+#include "Utils/FileHelpers.h"
+#include "Utils/JobSystem.h"
+#include "Utils/TaskGraph.h"
+#include "Utils/LightClusterGrid.h"
+#include "Graphics/GuiBatcher.h"
+#include "Graphics/TextLayout.h"
+#include "Graphics/Framebuffer.h"
+
+#include "GLM/gtc/constants.hpp"
+#include "GLM/gtc/matrix_transform.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <thread>
+#include <map>
+#include <typeindex>
+#include <atomic>
+#include <random>
+#include <locale>
+#include <codecvt>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+BenchmarkWindow::BenchmarkWindow() :
+	IEditorWindow(),
+	_results(std::vector<std::string>())
+{
+	Name = "Benchmarks";
+	SplitDirection = ImGuiDir_::ImGuiDir_None;
+	Requirements = EditorWindowRequirements::Window;
+	Open = false;
+}
+
+BenchmarkWindow::~BenchmarkWindow() = default;
+
+void BenchmarkWindow::Render()
+{
+	if (ImGui::CollapsingHeader("Scene Loading")) {
+		if (ImGui::Button("1k Objects")) { _RunSceneLoadBenchmark(1000); }
+		ImGui::SameLine();
+		if (ImGui::Button("10k Objects")) { _RunSceneLoadBenchmark(10000); }
+		ImGui::SameLine();
+		if (ImGui::Button("100k Objects")) { _RunSceneLoadBenchmark(100000); }
+	}
+
+	if (ImGui::CollapsingHeader("Scene Formats")) {
+		if (ImGui::Button("10k Objects##Formats")) { _RunSceneFormatBenchmark(10000); }
+		ImGui::SameLine();
+		if (ImGui::Button("100k Objects##Formats")) { _RunSceneFormatBenchmark(100000); }
+	}
+
+	if (ImGui::CollapsingHeader("OBJ Parsing")) {
+		if (ImGui::Button("100k Triangles")) { _RunObjParseBenchmark(100000); }
+		ImGui::SameLine();
+		if (ImGui::Button("1M Triangles")) { _RunObjParseBenchmark(1000000); }
+	}
+
+	if (ImGui::CollapsingHeader("Resource Lookup")) {
+		if (ImGui::Button("50k Resources")) { _RunResourceLookupBenchmark(50000); }
+	}
+
+	if (ImGui::CollapsingHeader("Physics")) {
+		if (ImGui::Button("2k Boxes")) { _RunPhysicsBenchmark(2000); }
+		ImGui::SameLine();
+		if (ImGui::Button("8k Boxes")) { _RunPhysicsBenchmark(8000); }
+	}
+
+	if (ImGui::CollapsingHeader("Particles")) {
+		if (ImGui::Button("100k Particles")) { _RunParticleBenchmark(100000); }
+		ImGui::SameLine();
+		if (ImGui::Button("1M Particles")) { _RunParticleBenchmark(1000000); }
+		if (ImGui::Button("1 GPU System")) { _RunParticleReadbackBenchmark(1); }
+		ImGui::SameLine();
+		if (ImGui::Button("10 GPU Systems")) { _RunParticleReadbackBenchmark(10); }
+		ImGui::SameLine();
+		if (ImGui::Button("50 GPU Systems")) { _RunParticleReadbackBenchmark(50); }
+	}
+
+	if (ImGui::CollapsingHeader("Frame Graph")) {
+		if (ImGui::Button("10k Objects##Graph")) { _RunFrameGraphBenchmark(10000); }
+		ImGui::SameLine();
+		if (ImGui::Button("40k Objects##Graph")) { _RunFrameGraphBenchmark(40000); }
+	}
+
+	if (ImGui::CollapsingHeader("Light Clusters")) {
+		if (ImGui::Button("1k Lights")) { _RunLightClusterBenchmark(1000); }
+		ImGui::SameLine();
+		if (ImGui::Button("4k Lights")) { _RunLightClusterBenchmark(4000); }
+	}
+
+	if (ImGui::CollapsingHeader("Text Layout")) {
+		if (ImGui::Button("1k Text Elements")) { _RunTextLayoutBenchmark(1000); }
+		ImGui::SameLine();
+		if (ImGui::Button("10k Text Elements")) { _RunTextLayoutBenchmark(10000); }
+	}
+
+	if (ImGui::CollapsingHeader("GUI Batching")) {
+		if (ImGui::Button("20 Panels")) { _RunGuiBatchBenchmark(20); }
+		ImGui::SameLine();
+		if (ImGui::Button("200 Panels")) { _RunGuiBatchBenchmark(200); }
+	}
+
+	ImGui::Separator();
+	if (ImGui::Button("Clear Results")) {
+		_results.clear();
+	}
+	for (const auto& line : _results) {
+		ImGui::TextUnformatted(line.c_str());
+	}
+}
+
+void BenchmarkWindow::_Report(const std::string& line) {
+	LOG_INFO("[Benchmark] {}", line);
+	_results.push_back(line);
+}
+
+double BenchmarkWindow::_MillisecondsSince(const Clock::time_point& start) {
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void BenchmarkWindow::_RunSceneLoadBenchmark(int objectCount) {
+	using namespace Gameplay;
+
+	// Generate a scene where every other object is parented to the one before it, so that
+	// loading needs to resolve object references, and every object has a component
+	Scene::Sptr source = std::make_shared<Scene>();
+	GameObject::Sptr prev = nullptr;
+	for (int ix = 0; ix < objectCount; ix++) {
+		GameObject::Sptr object = source->CreateGameObject("Object " + std::to_string(ix));
+		object->Add<RotatingBehaviour>();
+		if (prev != nullptr && (ix % 2) == 1) {
+			prev->AddChild(object);
+		}
+		prev = object;
+	}
+	prev = nullptr;
+	nlohmann::json blob = source->ToJson();
+	source = nullptr;
+
+	// Collect the IDs we'll be looking up later
+	std::vector<Guid> objectIds;
+	std::vector<Guid> componentIds;
+	for (auto& object : blob["objects"]) {
+		objectIds.push_back(Guid(object["guid"].get<std::string>()));
+		for (auto& [typeName, component] : object["components"].items()) {
+			if (typeName == "RotatingBehaviour") {
+				componentIds.push_back(Guid(component["guid"].get<std::string>()));
+			}
+		}
+	}
+
+	// Time loading the whole scene
+	Clock::time_point start = Clock::now();
+	Scene::Sptr loaded = Scene::FromJson(blob);
+	double loadMs = _MillisecondsSince(start);
+
+	// Time looking up every object and component by ID
+	start = Clock::now();
+	int found = 0;
+	for (const Guid& id : objectIds) {
+		found += loaded->FindObjectByGUID(id) != nullptr ? 1 : 0;
+	}
+	double objectLookupMs = _MillisecondsSince(start);
+
+	start = Clock::now();
+	for (const Guid& id : componentIds) {
+		found += loaded->Components().GetComponentByGUID<RotatingBehaviour>(id) != nullptr ? 1 : 0;
+	}
+	double componentLookupMs = _MillisecondsSince(start);
+
+	// For comparison, time a sample of lookups using a linear scan over the objects
+	const int sampleCount = glm::min(1000, (int)objectIds.size());
+	start = Clock::now();
+	for (int ix = 0; ix < sampleCount; ix++) {
+		const Guid& id = objectIds[(ix * 7919) % objectIds.size()];
+		for (int objIx = 0; objIx < loaded->NumObjects(); objIx++) {
+			if (loaded->GetObjectByIndex(objIx)->GetGUID() == id) {
+				break;
+			}
+		}
+	}
+	double linearLookupMs = _MillisecondsSince(start);
+
+	_Report(fmt::format("Scene load ({} objects): {:.2f} ms", objectCount, loadMs));
+	_Report(fmt::format("  GUID lookups: {:.4f} us/object, {:.4f} us/component ({} found)", 
+		objectLookupMs * 1000.0 / objectIds.size(), componentLookupMs * 1000.0 / glm::max((size_t)1, componentIds.size()), found));
+	_Report(fmt::format("  Linear scan reference: {:.4f} us/object", linearLookupMs * 1000.0 / glm::max(1, sampleCount)));
+}
+
+/**
+ * Gets the amount of physical memory the process is currently using, in bytes
+ */
+static size_t GetWorkingSetBytes() {
+	#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return counters.WorkingSetSize;
+	}
+	return 0;
+	#else
+	size_t totalPages = 0, residentPages = 0;
+	FILE* file = fopen("/proc/self/statm", "r");
+	if (file != nullptr) {
+		if (fscanf(file, "%zu %zu", &totalPages, &residentPages) != 2) {
+			residentPages = 0;
+		}
+		fclose(file);
+	}
+	return residentPages * (size_t)sysconf(_SC_PAGESIZE);
+	#endif
+}
+
+/**
+ * Polls the process's working set on a background thread, to find the most memory used
+ * by an operation on top of what was in use when the sampler was created
+ */
+class PeakMemorySampler {
+public:
+	PeakMemorySampler() :
+		_baseline(GetWorkingSetBytes()),
+		_peak(_baseline),
+		_running(true)
+	{
+		_thread = std::thread([this]() {
+			while (_running) {
+				_Sample();
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		});
+	}
+
+	~PeakMemorySampler() {
+		Stop();
+	}
+
+	/**
+	 * Stops sampling and returns the peak memory used above the baseline, in bytes
+	 */
+	size_t Stop() {
+		if (_thread.joinable()) {
+			_running = false;
+			_thread.join();
+			_Sample();
+		}
+		size_t peak = _peak;
+		return peak > _baseline ? peak - _baseline : 0;
+	}
+
+private:
+	size_t              _baseline;
+	std::atomic<size_t> _peak;
+	std::atomic_bool    _running;
+	std::thread         _thread;
+
+	void _Sample() {
+		size_t current = GetWorkingSetBytes();
+		if (current > _peak) {
+			_peak = current;
+		}
+	}
+};
+
+void BenchmarkWindow::_RunSceneFormatBenchmark(int objectCount) {
+	using namespace Gameplay;
+	static constexpr double MegaByte = 1024.0 * 1024.0;
+	static constexpr double StreamBudgetMs = 8.0;
+
+	// Generate a scene with the same layout as the scene loading benchmark, plus a render component
+	// on every object, and save it in both formats. The binary scene is also saved with every
+	// component as MessagePack, to compare against the packed render components
+	const std::filesystem::path tempDir = std::filesystem::temp_directory_path();
+	const std::string jsonPath = (tempDir / "otter-scene-benchmark.json").string();
+	const std::string binaryPath = (tempDir / ("otter-scene-benchmark" + std::string(SceneBinary::Extension))).string();
+	const std::string msgpackPath = (tempDir / ("otter-scene-benchmark-msgpack" + std::string(SceneBinary::Extension))).string();
+	{
+		Scene::Sptr source = std::make_shared<Scene>();
+		GameObject::Sptr prev = nullptr;
+		for (int ix = 0; ix < objectCount; ix++) {
+			GameObject::Sptr object = source->CreateGameObject("Object " + std::to_string(ix));
+			object->Add<RotatingBehaviour>();
+			object->Add<RenderComponent>();
+			if (prev != nullptr && (ix % 2) == 1) {
+				prev->AddChild(object);
+			}
+			prev = object;
+		}
+		source->Save(jsonPath);
+		source->Save(binaryPath);
+		SceneBinary::Write(source->ToJson(), msgpackPath, false);
+	}
+
+	// JSON, from reading the file through to the loaded scene
+	PeakMemorySampler jsonMemory;
+	Clock::time_point start = Clock::now();
+	Scene::Sptr loaded = Scene::Load(jsonPath);
+	double jsonMs = _MillisecondsSince(start);
+	size_t jsonPeak = jsonMemory.Stop();
+	const int jsonObjects = loaded != nullptr ? loaded->NumObjects() : 0;
+	loaded = nullptr;
+
+	// Binary, loaded all at once
+	PeakMemorySampler binaryMemory;
+	start = Clock::now();
+	loaded = Scene::Load(binaryPath);
+	double binaryMs = _MillisecondsSince(start);
+	size_t binaryPeak = binaryMemory.Stop();
+	const int binaryObjects = loaded != nullptr ? loaded->NumObjects() : 0;
+	loaded = nullptr;
+
+	// Binary with only MessagePack components, how the format stored everything before
+	start = Clock::now();
+	loaded = Scene::Load(msgpackPath);
+	double msgpackMs = _MillisecondsSince(start);
+	loaded = nullptr;
+
+	// Binary, streamed in the same way the application does, to see how many frames it would span
+	int frames = 0;
+	double longestStepMs = 0.0;
+	SceneBinaryLoader::Sptr loader = SceneBinaryLoader::Open(binaryPath);
+	if (loader != nullptr) {
+		bool done = false;
+		while (!done) {
+			start = Clock::now();
+			done = loader->Step(StreamBudgetMs);
+			longestStepMs = glm::max(longestStepMs, _MillisecondsSince(start));
+			frames++;
+		}
+	}
+	loader = nullptr;
+
+	// Make sure converting back to JSON gives us the same scene
+	nlohmann::json original = nlohmann::json::parse(FileHelpers::ReadFile(jsonPath));
+	nlohmann::json converted;
+	bool roundTrip = SceneBinary::Read(binaryPath, converted);
+	if (roundTrip) {
+		// The JSON format also stores each object's children, but they're not used when loading
+		for (auto& object : original["objects"]) {
+			object.erase("children");
+		}
+		roundTrip = original == converted;
+	}
+
+	const double jsonSize = std::filesystem::file_size(jsonPath) / MegaByte;
+	const double binarySize = std::filesystem::file_size(binaryPath) / MegaByte;
+	const double msgpackSize = std::filesystem::file_size(msgpackPath) / MegaByte;
+	std::filesystem::remove(jsonPath);
+	std::filesystem::remove(binaryPath);
+	std::filesystem::remove(msgpackPath);
+
+	_Report(fmt::format("Scene formats ({} objects): JSON {:.2f} MB, binary {:.2f} MB", objectCount, jsonSize, binarySize));
+	_Report(fmt::format("  JSON load:   {:.2f} ms, peak +{:.1f} MB ({} objects)", jsonMs, jsonPeak / MegaByte, jsonObjects));
+	_Report(fmt::format("  Binary load: {:.2f} ms, peak +{:.1f} MB ({} objects)", binaryMs, binaryPeak / MegaByte, binaryObjects));
+	_Report(fmt::format("  Binary load, MessagePack components only: {:.2f} ms, {:.2f} MB ({:.2f}x slower than packed)",
+		msgpackMs, msgpackSize, msgpackMs / glm::max(binaryMs, 0.0001)));
+	_Report(fmt::format("  Binary streaming: {} frames at {:.0f} ms/frame, longest step {:.2f} ms", frames, StreamBudgetMs, longestStepMs));
+	_Report(fmt::format("  Binary to JSON round trip {}", roundTrip ? "matches" : "DOES NOT MATCH"));
+}
+
+/**
+ * The original iostream based OBJ parsing loop, kept as a reference point for the OBJ benchmark
+ */
+static void LegacyParseObj(const std::string& filename, ObjParseResult& result) {
+	std::ifstream file;
+	file.open(filename, std::ios::binary);
+
+	std::unordered_map<uint64_t, uint32_t> vertexMap;
+	std::string line;
+	glm::vec3 vecData;
+	glm::ivec3 vertexIndices;
+
+	while (file.peek() != EOF) {
+		std::string command;
+		file >> command;
+
+		if (command == "#") {
+			std::getline(file, line);
+		}
+		else if (command == "v") {
+			file >> vecData.x >> vecData.y >> vecData.z;
+			result.Positions.push_back(vecData);
+		}
+		else if (command == "vn") {
+			file >> vecData.x >> vecData.y >> vecData.z;
+			result.Normals.push_back(vecData);
+		}
+		else if (command == "vt") {
+			file >> vecData.x >> vecData.y;
+			result.UVs.push_back(vecData);
+		}
+		else if (command == "f") {
+			std::getline(file, line);
+			StringTools::Trim(line);
+			std::stringstream stream = std::stringstream(line);
+
+			uint32_t edges[4];
+			int ix = 0;
+			for (; ix < 4; ix++) {
+				if (stream.peek() != EOF) {
+					char tempChar;
+					vertexIndices = glm::ivec3(0);
+					stream >> vertexIndices.x >> tempChar >> vertexIndices.y >> tempChar >> vertexIndices.z;
+
+					const uint64_t mask = 0b0'000000000000000000000'000000000000000000000'111111111111111111111;
+					uint64_t key = ((vertexIndices.x & mask) << 42) | ((vertexIndices.y & mask) << 21) | (vertexIndices.z & mask);
+
+					auto it = vertexMap.find(key);
+					if (it != vertexMap.end()) {
+						edges[ix] = it->second;
+					} else {
+						result.Vertices.push_back(vertexIndices - glm::ivec3(1));
+						uint32_t index = static_cast<uint32_t>(result.Vertices.size()) - 1;
+						vertexMap[key] = index;
+						edges[ix] = index;
+					}
+				}
+				else { break; }
+			}
+
+			if (ix >= 3) {
+				result.Indices.push_back(edges[0]);
+				result.Indices.push_back(edges[1]);
+				result.Indices.push_back(edges[2]);
+			}
+			if (ix == 4) {
+				result.Indices.push_back(edges[0]);
+				result.Indices.push_back(edges[2]);
+				result.Indices.push_back(edges[3]);
+			}
+		}
+	}
+}
+
+void BenchmarkWindow::_RunObjParseBenchmark(int triangleCount) {
+	// Generate a grid with positions, UVs and normals, using quads for half the rows so both
+	// face types are exercised
+	const int gridSize = glm::max(1, (int)glm::sqrt(triangleCount / 2.0f));
+	std::filesystem::path path = std::filesystem::temp_directory_path() / fmt::format("otter_obj_benchmark_{}.obj", triangleCount);
+	{
+		std::ofstream file(path, std::ios::binary);
+		file << "o benchmark\n";
+		for (int y = 0; y <= gridSize; y++) {
+			for (int x = 0; x <= gridSize; x++) {
+				file << fmt::format("v {} {} {}\n", x * 0.1f, glm::sin(x * 0.05f) * glm::cos(y * 0.05f), y * 0.1f);
+				file << fmt::format("vt {} {}\n", x / (float)gridSize, y / (float)gridSize);
+				file << fmt::format("vn {} {} {}\n", 0.0f, 1.0f, 0.0f);
+			}
+		}
+		for (int y = 0; y < gridSize; y++) {
+			for (int x = 0; x < gridSize; x++) {
+				const int a = y * (gridSize + 1) + x + 1;
+				const int b = a + 1;
+				const int c = a + gridSize + 2;
+				const int d = a + gridSize + 1;
+				if (y % 2 == 0) {
+					file << fmt::format("f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2} {3}/{3}/{3}\n", a, b, c, d);
+				} else {
+					file << fmt::format("f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2}\n", a, b, c);
+					file << fmt::format("f {0}/{0}/{0} {1}/{1}/{1} {2}/{2}/{2}\n", a, c, d);
+				}
+			}
+		}
+	}
+	const double fileMb = std::filesystem::file_size(path) / (1024.0 * 1024.0);
+
+	// Time the original parser
+	ObjParseResult legacy;
+	Clock::time_point start = Clock::now();
+	LegacyParseObj(path.string(), legacy);
+	double legacyMs = _MillisecondsSince(start);
+
+	// Time the new parser on a single thread, and on all threads
+	ObjParseResult singleThreaded;
+	start = Clock::now();
+	ObjParser::Parse(path.string(), singleThreaded, 1);
+	double singleMs = _MillisecondsSince(start);
+
+	ObjParseResult multiThreaded;
+	start = Clock::now();
+	ObjParser::Parse(path.string(), multiThreaded);
+	double multiMs = _MillisecondsSince(start);
+
+	const bool matches =
+		legacy.Vertices == multiThreaded.Vertices &&
+		legacy.Indices == multiThreaded.Indices &&
+		singleThreaded.Indices == multiThreaded.Indices;
+
+	// Compare tangent generation on the same mesh
+	MeshBuilder<VertexPosNormTexColTangents> mesh;
+	ObjParser::BuildMesh(multiThreaded, mesh, false);
+	start = Clock::now();
+	MeshFactory::CalculateTBN(mesh);
+	double legacyTangentMs = _MillisecondsSince(start);
+
+	std::vector<glm::vec3> positions(multiThreaded.Vertices.size());
+	std::vector<glm::vec2> uvs(multiThreaded.Vertices.size());
+	for (size_t ix = 0; ix < multiThreaded.Vertices.size(); ix++) {
+		positions[ix] = multiThreaded.Positions[multiThreaded.Vertices[ix].x];
+		uvs[ix] = multiThreaded.UVs[multiThreaded.Vertices[ix].y];
+	}
+	std::vector<glm::vec3> tangents(positions.size());
+	std::vector<glm::vec3> biTangents(positions.size());
+	start = Clock::now();
+	ObjParser::CalculateTangents(positions.data(), uvs.data(), positions.size(), multiThreaded.Indices.data(), multiThreaded.Indices.size(), tangents.data(), biTangents.data());
+	double tangentMs = _MillisecondsSince(start);
+
+	std::filesystem::remove(path);
+
+	_Report(fmt::format("OBJ parse ({} triangles, {:.1f} MB): iostream {:.2f} ms", multiThreaded.Indices.size() / 3, fileMb, legacyMs));
+	_Report(fmt::format("  ObjParser: {:.2f} ms (1 thread), {:.2f} ms ({} threads), results {}",
+		singleMs, multiMs, JobSystem::GetWorkerCount() + 1, matches ? "match" : "DIFFER"));
+	_Report(fmt::format("  Tangents: {:.2f} ms (MeshFactory), {:.2f} ms (ObjParser SSE)", legacyTangentMs, tangentMs));
+}
+
+void BenchmarkWindow::_RunResourceLookupBenchmark(int resourceCount) {
+	using namespace Gameplay;
+
+	// Mesh resources don't touch OpenGL until they're given a mesh, so they're cheap to make
+	std::vector<IResource::Sptr> resources;
+	resources.reserve(resourceCount);
+	for (int ix = 0; ix < resourceCount; ix++) {
+		resources.push_back(std::make_shared<MeshResource>());
+	}
+
+	// Fill both the old layout and the new table
+	std::map<std::type_index, std::map<Guid, IResource::Sptr>> legacy;
+	ResourceTable table;
+	for (const auto& resource : resources) {
+		legacy[std::type_index(typeid(MeshResource))][resource->GetGUID()] = resource;
+		table.Set(resource->GetGUID(), resource);
+	}
+
+	// Look everything up a few times, in a scattered order
+	const int lookupCount = resourceCount * 4;
+	std::vector<Guid> lookups(lookupCount);
+	for (int ix = 0; ix < lookupCount; ix++) {
+		lookups[ix] = resources[((size_t)ix * 7919) % resourceCount]->GetGUID();
+	}
+
+	int found = 0;
+	Clock::time_point start = Clock::now();
+	for (const Guid& id : lookups) {
+		found += std::dynamic_pointer_cast<MeshResource>(legacy[std::type_index(typeid(MeshResource))][id]) != nullptr ? 1 : 0;
+	}
+	double legacyHitMs = _MillisecondsSince(start);
+
+	start = Clock::now();
+	for (const Guid& id : lookups) {
+		found += std::static_pointer_cast<MeshResource>(table.Find(id, ResourceTable::Hash(id))) != nullptr ? 1 : 0;
+	}
+	double tableHitMs = _MillisecondsSince(start);
+
+	// Misses are what happens on the first Get of anything that lives in the manifest
+	std::vector<Guid> misses(resourceCount);
+	for (auto& id : misses) {
+		id = Guid::New();
+	}
+
+	start = Clock::now();
+	for (const Guid& id : misses) {
+		found += std::dynamic_pointer_cast<MeshResource>(legacy[std::type_index(typeid(MeshResource))][id]) != nullptr ? 1 : 0;
+	}
+	double legacyMissMs = _MillisecondsSince(start);
+
+	start = Clock::now();
+	for (const Guid& id : misses) {
+		found += table.Find(id) != nullptr ? 1 : 0;
+	}
+	double tableMissMs = _MillisecondsSince(start);
+
+	_Report(fmt::format("Resource lookup ({} resources, {} hits found)", resourceCount, found));
+	_Report(fmt::format("  Hits: {:.1f} ns (std::map), {:.1f} ns (ResourceTable)",
+		legacyHitMs * 1e6 / lookupCount, tableHitMs * 1e6 / lookupCount));
+	_Report(fmt::format("  Misses: {:.1f} ns (std::map, now {} entries), {:.1f} ns (ResourceTable, still {} entries)",
+		legacyMissMs * 1e6 / resourceCount, legacy[std::type_index(typeid(MeshResource))].size(), tableMissMs * 1e6 / resourceCount, table.Size()));
+}
+
+void BenchmarkWindow::_RunPhysicsBenchmark(int boxCount) {
+	using namespace Gameplay;
+	using namespace Gameplay::Physics;
+
+	// Boxes are stacked into towers on a square grid, every other layer is offset a little
+	// so that the towers topple into each other and we get lots of contacts between islands
+	const int   stackHeight   = 10;
+	const int   stackCount    = (boxCount + stackHeight - 1) / stackHeight;
+	const int   gridSize      = (int)glm::ceil(glm::sqrt((float)stackCount));
+	const float spacing       = 1.6f;
+	const int   warmupSteps   = 30;
+	const int   measuredSteps = 120;
+
+	_Report(fmt::format("Physics ({} boxes in {} stacks, {} steps)", boxCount, stackCount, measuredSteps));
+	{
+		Scene::Sptr scene = std::make_shared<Scene>();
+
+		GameObject::Sptr ground = scene->CreateGameObject("Ground");
+		const float groundExtents = gridSize * spacing * 0.5f + 10.0f;
+		ground->Add<RigidBody>()->AddCollider(BoxCollider::Create(glm::vec3(groundExtents, groundExtents, 1.0f)))->SetPosition({ 0, 0, -1 });
+
+		for (int ix = 0; ix < boxCount; ix++) {
+			const int stack = ix / stackHeight;
+			const int layer = ix % stackHeight;
+			glm::vec3 position;
+			position.x = ((stack % gridSize) - gridSize * 0.5f) * spacing + (layer % 2) * 0.2f;
+			position.y = ((stack / gridSize) - gridSize * 0.5f) * spacing;
+			position.z = 0.5f + layer * 1.01f;
+
+			GameObject::Sptr box = scene->CreateGameObject("Box " + std::to_string(ix));
+			box->SetPostion(position);
+			box->Add<RigidBody>(RigidBodyType::Dynamic)->AddCollider(BoxCollider::Create(glm::vec3(0.5f)));
+		}
+
+		scene->Components().Each<RigidBody>([](RigidBody* body) {
+			body->Awake();
+		});
+		scene->IsPlaying = true;
+
+		// Let the stacks start falling before we start timing
+		const float timestep = scene->GetPhysicsTimestep();
+		for (int ix = 0; ix < warmupSteps; ix++) {
+			scene->DoPhysics(timestep);
+		}
+
+		double totalMs = 0.0;
+		double longestMs = 0.0;
+		int steps = 0;
+		for (int ix = 0; ix < measuredSteps; ix++) {
+			scene->DoPhysics(timestep);
+			const Scene::PhysicsStats& stats = scene->GetPhysicsStats();
+			totalMs += stats.AverageSubstepMs * stats.Substeps;
+			longestMs = glm::max(longestMs, (double)stats.MaxSubstepMs);
+			steps += stats.Substeps;
+		}
+		scene = nullptr;
+
+		const double averageMs = totalMs / glm::max(1, steps);
+		_Report(fmt::format("  {:.2f} ms/step avg, {:.2f} ms max", averageMs, longestMs));
+	}
+}
+
+void BenchmarkWindow::_RunParticleBenchmark(int particleCount) {
+	using namespace Gameplay;
+
+	// Particles live for 2-4 seconds, so spawn enough to keep the system full at 60 FPS
+	const float timestep      = 1.0f / 60.0f;
+	const int   emitterCount  = 16;
+	const int   warmupSteps   = 240;
+	const int   measuredSteps = 120;
+	const float spawnInterval = 3.0f * emitterCount / particleCount;
+
+	std::vector<ParticleSimulation::Emitter> emitters(emitterCount);
+	for (int ix = 0; ix < emitterCount; ix++) {
+		const float angle = ix * glm::two_pi<float>() / emitterCount;
+		emitters[ix].Position      = glm::vec3(glm::cos(angle), glm::sin(angle), 0.0f) * 5.0f;
+		emitters[ix].Velocity      = glm::vec3(0.0f, 0.0f, 8.0f);
+		emitters[ix].Color         = glm::vec4(1.0f, 0.5f, 0.2f, 1.0f);
+		emitters[ix].SpawnInterval = spawnInterval;
+		emitters[ix].ConeAngle     = glm::radians(30.0f);
+		emitters[ix].LifetimeRange = glm::vec2(2.0f, 4.0f);
+	}
+
+	// The threaded run goes through the job system, so it gets the workers plus this thread
+	const int threadCounts[2] = { 1, JobSystem::IsInitialized() ? JobSystem::GetWorkerCount() + 1 : 1 };
+	std::vector<ParticleSimulation::RenderVertex> results[2];
+
+	_Report(fmt::format("Particles ({} max, {} steps)", particleCount, measuredSteps));
+	double baselineMs = 0.0;
+	for (int run = 0; run < 2; run++) {
+		// Same seed for both runs, so the results should match exactly
+		ParticleSimulation simulation(particleCount, 1234);
+		simulation.SetEmitters(emitters);
+		for (int ix = 0; ix < warmupSteps; ix++) {
+			simulation.Update(timestep, glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -9.81f), threadCounts[run]);
+		}
+
+		double totalMs = 0.0;
+		double longestMs = 0.0;
+		for (int ix = 0; ix < measuredSteps; ix++) {
+			Clock::time_point start = Clock::now();
+			simulation.Update(timestep, glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -9.81f), threadCounts[run]);
+			const double stepMs = _MillisecondsSince(start);
+			totalMs += stepMs;
+			longestMs = glm::max(longestMs, stepMs);
+		}
+
+		results[run].assign(simulation.GetRenderData(), simulation.GetRenderData() + simulation.GetParticleCount());
+
+		const double averageMs = totalMs / measuredSteps;
+		if (run == 0) {
+			baselineMs = averageMs;
+		}
+		_Report(fmt::format("  {} thread{}: {} particles, {:.2f} ms/step avg, {:.2f} ms max ({:.2f}x)",
+			threadCounts[run], threadCounts[run] == 1 ? "" : "s", simulation.GetParticleCount(), averageMs, longestMs, baselineMs / glm::max(averageMs, 0.0001)));
+	}
+
+	const bool deterministic = results[0].size() == results[1].size() &&
+		memcmp(results[0].data(), results[1].data(), results[0].size() * sizeof(ParticleSimulation::RenderVertex)) == 0;
+	_Report(fmt::format("  Results {} between thread counts", deterministic ? "match" : "DIFFER"));
+}
+
+void BenchmarkWindow::_RunParticleReadbackBenchmark(int systemCount) {
+	using namespace Gameplay;
+
+	const int warmupFrames   = 30;
+	const int measuredFrames = 120;
+
+	Scene::Sptr scene = std::make_shared<Scene>();
+	std::vector<ParticleSystem::Sptr> systems;
+	for (int ix = 0; ix < systemCount; ix++) {
+		GameObject::Sptr object = scene->CreateGameObject("Particles " + std::to_string(ix));
+		object->SetPostion(glm::vec3(ix * 2.0f, 0.0f, 0.0f));
+
+		ParticleSystem::Sptr system = object->Add<ParticleSystem>();
+		system->AddEmitter(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 5.0f), 200.0f);
+		system->AddEmitter(glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 5.0f), 200.0f);
+		system->Awake();
+		systems.push_back(system);
+	}
+
+	const bool wasSynchronous = ParticleSystem::GetSynchronousReadback();
+	_Report(fmt::format("Particle readback ({} systems, {} frames)", systemCount, measuredFrames));
+
+	double baselineMs = 0.0;
+	for (int run = 0; run < 2; run++) {
+		const bool synchronous = run == 0;
+		ParticleSystem::SetSynchronousReadback(synchronous);
+
+		// Each frame ends with glFinish to stand in for the buffer swap, so the GPU's work is
+		// included in the frame time either way
+		double totalMs = 0.0;
+		double longestMs = 0.0;
+		for (int frame = 0; frame < warmupFrames + measuredFrames; frame++) {
+			Clock::time_point start = Clock::now();
+			for (const auto& system : systems) {
+				system->Update();
+			}
+			glFinish();
+			const double frameMs = _MillisecondsSince(start);
+
+			if (frame >= warmupFrames) {
+				totalMs += frameMs;
+				longestMs = glm::max(longestMs, frameMs);
+			}
+		}
+
+		const double averageMs = totalMs / measuredFrames;
+		if (synchronous) {
+			baselineMs = averageMs;
+		}
+		_Report(fmt::format("  {}: {:.3f} ms/frame avg, {:.3f} ms max ({:.2f}x)",
+			synchronous ? "Wait for count" : "Query ring    ", averageMs, longestMs, baselineMs / glm::max(averageMs, 0.0001)));
+	}
+
+	ParticleSystem::SetSynchronousReadback(wasSynchronous);
+	systems.clear();
+	scene = nullptr;
+}
+
+void BenchmarkWindow::_RunFrameGraphBenchmark(int objectCount) {
+	using namespace Gameplay;
+	using namespace Gameplay::Physics;
+
+	const int   boxCount      = objectCount / 4;
+	const int   particleCount = objectCount * 10;
+	const float timestep      = 1.0f / 60.0f;
+	const int   warmupFrames  = 30;
+	const int   measuredFrames = 120;
+
+	Scene::Sptr scene = std::make_shared<Scene>();
+	scene->SetBatchedTransformsEnabled(true);
+	scene->SetPhysicsTimestep(timestep);
+
+	const int gridSize = (int)glm::ceil(glm::sqrt((float)objectCount));
+	for (int ix = 0; ix < objectCount; ix++) {
+		GameObject::Sptr object = scene->CreateGameObject("Object " + std::to_string(ix));
+		object->SetPostion(glm::vec3((ix % gridSize) * 2.0f, (ix / gridSize) * 2.0f, 0.0f));
+		object->Add<RotatingBehaviour>()->RotationSpeed = glm::vec3(0.0f, 0.0f, 45.0f + (ix % 90));
+	}
+
+	GameObject::Sptr ground = scene->CreateGameObject("Ground");
+	ground->Add<RigidBody>()->AddCollider(BoxCollider::Create(glm::vec3(200.0f, 200.0f, 1.0f)))->SetPosition({ 0, 0, -1 });
+	const int boxGrid = (int)glm::ceil(glm::sqrt((float)boxCount));
+	for (int ix = 0; ix < boxCount; ix++) {
+		GameObject::Sptr box = scene->CreateGameObject("Box " + std::to_string(ix));
+		box->SetPostion(glm::vec3(((ix % boxGrid) - boxGrid * 0.5f) * 1.1f, ((ix / boxGrid) - boxGrid * 0.5f) * 1.1f, 2.0f + (ix % 7)));
+		box->Add<RigidBody>(RigidBodyType::Dynamic)->AddCollider(BoxCollider::Create(glm::vec3(0.5f)));
+	}
+	scene->Components().Each<RigidBody>([](RigidBody* body) {
+		body->Awake();
+	});
+	scene->IsPlaying = true;
+
+	ParticleSimulation particles(particleCount, 1234);
+	std::vector<ParticleSimulation::Emitter> emitters(4);
+	for (ParticleSimulation::Emitter& emitter : emitters) {
+		emitter.Position      = glm::vec3(0.0f);
+		emitter.Velocity      = glm::vec3(0.0f, 0.0f, 8.0f);
+		emitter.Color         = glm::vec4(1.0f);
+		emitter.SpawnInterval = 3.0f * emitters.size() / particleCount;
+		emitter.ConeAngle     = glm::radians(30.0f);
+		emitter.LifetimeRange = glm::vec2(2.0f, 4.0f);
+	}
+	particles.SetEmitters(emitters);
+
+	// The same tasks as LogicUpdateLayer, plus the particle simulation. The particles are in world
+	// space, so they don't need to wait for transforms
+	TaskGraph graph;
+	graph.AddTask("Scene Update", FrameResource::Scene,
+		FrameResource::Scene | FrameResource::Transforms | FrameResource::Physics | FrameResource::Animation, [&]() {
+		scene->UpdateObjects(timestep);
+	}, true);
+	graph.AddTask("Animation", FrameResource::Scene, FrameResource::Animation, [&]() {
+		scene->UpdateAnimation(timestep);
+	});
+	graph.AddTask("Transforms", FrameResource::Scene, FrameResource::Transforms, [&]() {
+		scene->UpdateTransforms();
+	});
+	graph.AddTask("Physics", FrameResource::Scene, FrameResource::Physics | FrameResource::Transforms, [&]() {
+		scene->StepPhysics(timestep);
+	});
+	graph.AddTask("Physics Events", FrameResource::Physics,
+		FrameResource::Scene | FrameResource::Transforms | FrameResource::Physics | FrameResource::Animation, [&]() {
+		scene->DispatchPhysicsEvents();
+	}, true);
+	graph.AddTask("Particles", FrameResource::None, FrameResource::Particles, [&]() {
+		particles.Update(timestep, glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -9.81f), 1);
+	});
+
+	for (int ix = 0; ix < warmupFrames; ix++) {
+		graph.Execute(false);
+	}
+
+	_Report(fmt::format("Frame Graph ({} objects, {} boxes, {} particles, {} workers)",
+		objectCount, boxCount, particleCount, JobSystem::GetWorkerCount()));
+
+	double serialMs = 0.0;
+	for (int run = 0; run < 2; run++) {
+		const bool parallel = run == 1;
+		double wallMs = 0.0;
+		double taskMs = 0.0;
+		double criticalMs = 0.0;
+		for (int ix = 0; ix < measuredFrames; ix++) {
+			graph.Execute(parallel);
+			wallMs += graph.GetWallMs();
+			taskMs += graph.GetTotalTaskMs();
+			criticalMs += graph.GetCriticalPathMs();
+		}
+		wallMs /= measuredFrames;
+		taskMs /= measuredFrames;
+		criticalMs /= measuredFrames;
+
+		if (!parallel) {
+			serialMs = wallMs;
+		}
+		_Report(fmt::format("  {}: {:.2f} ms/frame, {:.2f} ms of tasks, {:.2f} ms critical path ({:.2f}x)",
+			parallel ? "Parallel" : "Serial  ", wallMs, taskMs, criticalMs, serialMs / glm::max(wallMs, 0.0001)));
+	}
+
+	// Show where everything ran in the last frame, so we can see what's overlapping
+	const std::vector<TaskGraph::TimelineEntry>& timeline = graph.GetTimeline();
+	for (size_t ix = 0; ix < timeline.size(); ix++) {
+		const TaskGraph::TimelineEntry& entry = timeline[ix];
+		const bool critical = std::find(graph.GetCriticalPath().begin(), graph.GetCriticalPath().end(), (int)ix) != graph.GetCriticalPath().end();
+		_Report(fmt::format("    {:<15} thread {}  {:6.2f} - {:6.2f} ms{}",
+			entry.Name, entry.Thread, entry.StartMs, entry.EndMs, critical ? "  (critical)" : ""));
+	}
+
+	scene = nullptr;
+}
+
+void BenchmarkWindow::_RunLightClusterBenchmark(int lightCount) {
+	const int   measuredBuilds = 60;
+	const float zNear = 0.1f;
+	const float zFar  = 1000.0f;
+	const glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, zNear, zFar);
+
+	// Lights scattered through the first few hundred units in front of the camera
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::vector<LightClusterGrid::LightBounds> lights(lightCount);
+	for (LightClusterGrid::LightBounds& light : lights) {
+		const float depth = 1.0f + unit(random) * 300.0f;
+		light.Position = glm::vec3((unit(random) * 2.0f - 1.0f) * depth, (unit(random) * 2.0f - 1.0f) * depth * 0.6f, -depth);
+		light.Radius = 2.0f + unit(random) * 10.0f;
+	}
+
+	LightClusterGrid grids[2];
+	_Report(fmt::format("Light clusters ({} lights, {} builds)", lightCount, measuredBuilds));
+	double baselineMs = 0.0;
+	for (int run = 0; run < 2; run++) {
+		LightClusterGrid& grid = grids[run];
+		grid.SetProjection(projection, zNear, zFar);
+		grid.Build(lights, run == 1);
+
+		Clock::time_point start = Clock::now();
+		for (int ix = 0; ix < measuredBuilds; ix++) {
+			grid.Build(lights, run == 1);
+		}
+		const double averageMs = _MillisecondsSince(start) / measuredBuilds;
+		if (run == 0) {
+			baselineMs = averageMs;
+		}
+
+		const double averagePerCluster = static_cast<double>(grid.GetLightIndices().size()) / grid.GetClusterCount();
+		_Report(fmt::format("  {}: {:.3f} ms/build ({:.2f}x), {} indices, {:.1f} lights/cluster avg, {} max",
+			run == 0 ? "1 thread" : fmt::format("{} threads", JobSystem::GetWorkerCount() + 1), averageMs,
+			baselineMs / glm::max(averageMs, 0.0001), grid.GetLightIndices().size(), averagePerCluster, grid.GetMaxLightsPerCluster()));
+	}
+
+	const bool deterministic = grids[0].GetLightIndices() == grids[1].GetLightIndices();
+	_Report(fmt::format("  Results {} between thread counts", deterministic ? "match" : "DIFFER"));
+
+	// Every light that touches a point has to be in the point's cluster, extra lights are fine
+	const LightClusterGrid& grid = grids[1];
+	const glm::mat4 inverseProjection = glm::inverse(projection);
+	const glm::uvec3& dims = grid.GetDimensions();
+	int missing = 0;
+	int tested = 0;
+	for (int sample = 0; sample < 2000; sample++) {
+		const glm::vec2 ndc = glm::vec2(unit(random), unit(random)) * 2.0f - 1.0f;
+		const float depth = zNear * glm::pow(zFar / zNear, unit(random));
+		glm::vec4 ray = inverseProjection * glm::vec4(ndc, -1.0f, 1.0f);
+		const glm::vec3 point = glm::vec3(ray) / ray.w * (depth / (-ray.z / ray.w));
+
+		const glm::uvec2 tile = glm::min(glm::uvec2((ndc * 0.5f + 0.5f) * glm::vec2(dims)), glm::uvec2(dims) - 1u);
+		const LightClusterGrid::ClusterRange& range = grid.GetClusters()[grid.GetClusterIndex(tile.x, tile.y, grid.GetSlice(depth))];
+		const uint32_t* begin = grid.GetLightIndices().data() + range.Offset;
+		const uint32_t* end = begin + range.Count;
+
+		for (uint32_t ix = 0; ix < static_cast<uint32_t>(lightCount); ix++) {
+			if (glm::distance(point, lights[ix].Position) <= lights[ix].Radius) {
+				tested++;
+				if (std::find(begin, end, ix) == end) {
+					missing++;
+				}
+			}
+		}
+	}
+	_Report(fmt::format("  {} of {} light/point overlaps missing from clusters", missing, tested));
+}
+
+void BenchmarkWindow::_RunTextLayoutBenchmark(int elementCount) {
+	const int measuredFrames = 120;
+	// One in this many elements changes every frame, the rest are menu labels and score lists
+	const int dynamicEvery = 20;
+
+	Font::Sptr font = std::make_shared<Font>("fonts/Roboto-Medium.ttf", 16.0f);
+	font->Bake();
+	if (font->GetAtlas() == nullptr) {
+		_Report("Text layout: failed to load fonts/Roboto-Medium.ttf");
+		return;
+	}
+
+	const char* labels[] = { "Play", "Settings", "Exit", "Highscores", "Vanguard", "Resume Game", "Back to Menu" };
+	std::vector<std::string> text(elementCount);
+	for (int ix = 0; ix < elementCount; ix++) {
+		if (ix % dynamicEvery == 0) {
+			text[ix] = "Score: 0";
+		} else if (ix % 3 == 0) {
+			text[ix] = fmt::format("{}. {}", ix % 10 + 1, 100000 - ix * 7);
+		} else {
+			text[ix] = labels[ix % (sizeof(labels) / sizeof(labels[0]))];
+		}
+	}
+
+	const bool wasCached = GuiBatcher::GetTextCacheEnabled();
+	GuiBatcher::ClearTextCache();
+	GuiBatcher::DiscardBatch();
+
+	_Report(fmt::format("Text layout ({} elements, {} changing per frame, {} frames)", elementCount, elementCount / dynamicEvery, measuredFrames));
+	const char* runNames[] = { "Layout every draw", "Layout cache", "Retained layouts" };
+	double baselineMs = 0.0;
+	for (int run = 0; run < 3; run++) {
+		GuiBatcher::SetTextCacheEnabled(run == 1);
+
+		// Retained layouts are rebuilt only when their text changes, like GuiText::SetText
+		std::vector<TextLayout::Sptr> layouts(elementCount);
+		std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+
+		double totalMs = 0.0;
+		for (int frame = 0; frame < measuredFrames; frame++) {
+			for (int ix = 0; ix < elementCount; ix += dynamicEvery) {
+				text[ix] = fmt::format("Score: {}", frame * 10 + ix);
+				layouts[ix] = nullptr;
+			}
+
+			Clock::time_point start = Clock::now();
+			for (int ix = 0; ix < elementCount; ix++) {
+				const glm::vec2 position = glm::vec2((ix % 20) * 60.0f, (ix / 20) * 20.0f);
+				if (run == 2) {
+					if (layouts[ix] == nullptr) {
+						layouts[ix] = TextLayout::Create(converter.from_bytes(text[ix]), font);
+					}
+					GuiBatcher::RenderText(*layouts[ix], position, glm::vec4(1.0f));
+				} else {
+					GuiBatcher::RenderText(text[ix], font, position, glm::vec4(1.0f));
+				}
+			}
+			totalMs += _MillisecondsSince(start);
+
+			// We only care about building the geometry, not drawing it
+			GuiBatcher::DiscardBatch();
+		}
+
+		const double averageMs = totalMs / measuredFrames;
+		if (run == 0) {
+			baselineMs = averageMs;
+		}
+		_Report(fmt::format("  {:<18} {:.3f} ms/frame ({:.2f}x){}", runNames[run], averageMs, baselineMs / glm::max(averageMs, 0.0001),
+			run == 1 ? fmt::format(", {} cached layouts", GuiBatcher::GetTextCacheSize()) : ""));
+	}
+
+	GuiBatcher::SetTextCacheEnabled(wasCached);
+	GuiBatcher::ClearTextCache();
+}
+
+void BenchmarkWindow::_RunGuiBatchBenchmark(int panelCount) {
+	const int measuredFrames = 120;
+	const glm::ivec2 targetSize = glm::ivec2(1280, 720);
+
+	Font::Sptr titleFont = std::make_shared<Font>("fonts/Roboto-Medium.ttf", 24.0f);
+	Font::Sptr bodyFont = std::make_shared<Font>("fonts/Roboto-Medium.ttf", 14.0f);
+	titleFont->Bake();
+	bodyFont->Bake();
+	if (titleFont->GetAtlas() == nullptr || bodyFont->GetAtlas() == nullptr) {
+		_Report("GUI batching: failed to load fonts/Roboto-Medium.ttf");
+		return;
+	}
+
+	// A handful of small icons, each with it's own texture like a real menu would have
+	const int iconCount = 6;
+	std::vector<Texture2D::Sptr> icons(iconCount);
+	for (int ix = 0; ix < iconCount; ix++) {
+		Texture2DDescription desc;
+		desc.Width = 32;
+		desc.Height = 32;
+		desc.Format = InternalFormat::RGBA8;
+		desc.GenerateMipMaps = false;
+		desc.MinificationFilter = MinFilter::Linear;
+		icons[ix] = std::make_shared<Texture2D>(desc);
+
+		std::vector<glm::u8vec4> pixels(32 * 32);
+		for (int p = 0; p < 32 * 32; p++) {
+			const int x = p % 32 - 16;
+			const int y = p / 32 - 16;
+			pixels[p] = glm::u8vec4(40 * ix, 255 - 40 * ix, 128, x * x + y * y < 15 * 15 ? 255 : 0);
+		}
+		icons[ix]->LoadData(32, 32, PixelFormat::RGBA, PixelType::UByte, pixels.data());
+	}
+
+	// Throw away anything waiting to be drawn, the empty flush makes sure the default texture exists
+	GuiBatcher::DiscardBatch();
+	GuiBatcher::Flush();
+	const Texture2D::Sptr panelTexture = GuiBatcher::GetDefaultTexture();
+	const char* rows[] = { "Play", "Settings", "Highscores", "Exit" };
+
+	auto drawMenu = [&]() {
+		const int columns = 10;
+		for (int ix = 0; ix < panelCount; ix++) {
+			const glm::vec2 min = glm::vec2((ix % columns) * 128.0f, ((ix / columns) % 6) * 120.0f);
+			const glm::vec2 max = min + glm::vec2(120.0f, 112.0f);
+
+			GuiBatcher::PushScissorRect(min, max);
+			GuiBatcher::PushRect(min, max, glm::vec4(0.2f, 0.2f, 0.25f, 0.9f), panelTexture, 4);
+			GuiBatcher::PushRect(min + glm::vec2(4.0f), min + glm::vec2(28.0f), glm::vec4(1.0f), icons[ix % iconCount]);
+			GuiBatcher::RenderText("Menu " + std::to_string(ix % 10), titleFont, min + glm::vec2(32.0f, 24.0f), glm::vec4(1.0f));
+
+			// The list is clipped to the inside of the panel, and is a bit too long for it
+			GuiBatcher::PushScissorRect(min + glm::vec2(4.0f, 32.0f), max - glm::vec2(4.0f));
+			for (int row = 0; row < 4; row++) {
+				const glm::vec2 rowMin = min + glm::vec2(4.0f, 32.0f + row * 22.0f);
+				GuiBatcher::PushRect(rowMin, rowMin + glm::vec2(112.0f, 20.0f), glm::vec4(0.3f, 0.3f, 0.4f, 1.0f), panelTexture, 4);
+				GuiBatcher::PushRect(rowMin + glm::vec2(2.0f), rowMin + glm::vec2(18.0f), glm::vec4(1.0f), icons[(ix + row) % iconCount]);
+				GuiBatcher::RenderText(rows[row], bodyFont, rowMin + glm::vec2(22.0f, 15.0f), glm::vec4(1.0f));
+			}
+			GuiBatcher::PopScissorRect();
+			GuiBatcher::PopScissorRect();
+		}
+	};
+
+	FramebufferDescriptor fboDesc;
+	fboDesc.Width = targetSize.x;
+	fboDesc.Height = targetSize.y;
+	fboDesc.RenderTargets[RenderTargetAttachment::Color0] = RenderTargetDescriptor(RenderTargetType::ColorRgba8);
+	Framebuffer::Sptr target = std::make_shared<Framebuffer>(fboDesc);
+
+	// Hang on to the state that the batcher or the benchmark will change
+	glm::ivec4 prevViewport;
+	glGetIntegerv(GL_VIEWPORT, &prevViewport.x);
+	const bool wasBlending = glIsEnabled(GL_BLEND);
+	const bool wasAtlased = GuiBatcher::GetAtlasEnabled();
+
+	target->Bind();
+	glViewport(0, 0, targetSize.x, targetSize.y);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	GuiBatcher::SetProjection(glm::ortho(0.0f, (float)targetSize.x, (float)targetSize.y, 0.0f, -1.0f, 1.0f));
+
+	_Report(fmt::format("GUI batching ({} panels, {} icons, 2 fonts, {} frames)", panelCount, iconCount, measuredFrames));
+	double baselineMs = 0.0;
+	for (int run = 0; run < 2; run++) {
+		GuiBatcher::SetAtlasEnabled(run == 1);
+
+		// The first frame packs everything into the atlas, we don't want to measure that
+		drawMenu();
+		GuiBatcher::Flush();
+		glFinish();
+		GuiBatcher::ResetStats();
+
+		double totalMs = 0.0;
+		for (int frame = 0; frame < measuredFrames; frame++) {
+			Clock::time_point start = Clock::now();
+			drawMenu();
+			GuiBatcher::Flush();
+			totalMs += _MillisecondsSince(start);
+			glFinish();
+		}
+
+		const GuiBatcher::Stats& stats = GuiBatcher::GetStats();
+		const double averageMs = totalMs / measuredFrames;
+		if (run == 0) {
+			baselineMs = averageMs;
+		}
+		_Report(fmt::format("  {:<10} {:.3f} ms/frame ({:.2f}x), {} commands in {} draws, {} texture changes, {} scissor changes",
+			run == 1 ? "Atlas" : "No atlas", averageMs, baselineMs / glm::max(averageMs, 0.0001),
+			stats.Commands / measuredFrames, stats.DrawCalls / measuredFrames,
+			stats.TextureChanges / measuredFrames, stats.ScissorChanges / measuredFrames));
+	}
+	_Report(fmt::format("  {} atlas pages", GuiBatcher::GetAtlas().GetPageCount()));
+
+	// Free up the atlas space our temporary textures were using
+	GuiBatcher::InvalidateTexture(titleFont->GetAtlas());
+	GuiBatcher::InvalidateTexture(bodyFont->GetAtlas());
+	for (const Texture2D::Sptr& icon : icons) {
+		GuiBatcher::InvalidateTexture(icon);
+	}
+	GuiBatcher::SetAtlasEnabled(wasAtlased);
+	GuiBatcher::ResetStats();
+
+	target->Unbind();
+	glViewport(prevViewport.x, prevViewport.y, prevViewport.z, prevViewport.w);
+	if (!wasBlending) {
+		glDisable(GL_BLEND);
+	}
+}
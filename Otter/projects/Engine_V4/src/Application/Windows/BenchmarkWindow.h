@@ -0,0 +1,119 @@
+#pragma once
+#include "Application/IEditorWindow.h"
+#include <vector>
+#include <chrono>
+
+/**
+ * Handles running engine microbenchmarks from within the editor, results are
+ * displayed in the window and written to the log
+ */
+class BenchmarkWindow final : public IEditorWindow {
+public:
+	MAKE_PTRS(BenchmarkWindow);
+	BenchmarkWindow();
+	virtual ~BenchmarkWindow();
+
+	// Inherited from IEditorWindow
+
+	virtual void Render() override;
+
+protected:
+	typedef std::chrono::high_resolution_clock Clock;
+
+	// The results of all the benchmarks that have been run, oldest first
+	std::vector<std::string> _results;
+
+	/**
+	 * Adds a line to the benchmark results and logs it
+	 * @param line The line of text to report
+	 */
+	void _Report(const std::string& line);
+
+	/**
+	 * Gets the time in milliseconds between a start time and now
+	 */
+	static double _MillisecondsSince(const Clock::time_point& start);
+
+	/**
+	 * Measures how long it takes to load a scene with the given number of objects from
+	 * JSON, as well as the cost of GUID lookups into the loaded scene
+	 * @param objectCount The number of game objects to generate
+	 */
+	void _RunSceneLoadBenchmark(int objectCount);
+
+	/**
+	 * Saves a generated scene as both JSON and binary, and compares the file sizes, load times
+	 * and peak memory used while loading each format. Also compares loading binary components
+	 * from their packed layouts against loading them from MessagePack
+	 * @param objectCount The number of game objects to generate
+	 */
+	void _RunSceneFormatBenchmark(int objectCount);
+
+	/**
+	 * Generates an OBJ file with the given number of triangles, and compares the time taken to
+	 * parse it with the original iostream parser and with ObjParser, as well as tangent generation
+	 * @param triangleCount The approximate number of triangles to generate
+	 */
+	void _RunObjParseBenchmark(int triangleCount);
+
+	/**
+	 * Compares resource lookups by GUID using the resource manager's hash table against the
+	 * nested std::map it used to use, for both hits and misses
+	 * @param resourceCount The number of resources to store
+	 */
+	void _RunResourceLookupBenchmark(int resourceCount);
+
+	/**
+	 * Drops stacks of dynamic boxes onto a ground plane, and measures the average and longest
+	 * physics step times
+	 * @param boxCount The number of boxes to simulate
+	 */
+	void _RunPhysicsBenchmark(int boxCount);
+
+	/**
+	 * Fills a CPU particle simulation up to the given number of particles, and measures the
+	 * average update time with 1 thread and with all cores. Also checks that both runs produce
+	 * exactly the same render data
+	 * @param particleCount The number of live particles to simulate
+	 */
+	void _RunParticleBenchmark(int particleCount);
+
+	/**
+	 * Updates a number of GPU particle systems, and compares the frame time when each system
+	 * waits for it's particle count to when the counts are read back a few frames later
+	 * @param systemCount The number of particle systems to update each frame
+	 */
+	void _RunParticleReadbackBenchmark(int systemCount);
+
+	/**
+	 * Runs a frame's worth of scene work (object updates, animation, batched transforms, physics
+	 * and CPU particles) through a task graph, first one task at a time and then in parallel on
+	 * the job system, and compares the frame times and critical paths. The timeline for the last
+	 * parallel frame is reported as well
+	 * @param objectCount The number of rotating objects to update, a quarter as many boxes are simulated
+	 */
+	void _RunFrameGraphBenchmark(int objectCount);
+
+	/**
+	 * Bins randomly placed lights into a light cluster grid on one thread and then on the job
+	 * system, and checks the results against a brute force test of points in the view frustum
+	 * @param lightCount The number of lights to bin
+	 */
+	void _RunLightClusterBenchmark(int lightCount);
+
+	/**
+	 * Draws a number of GUI text elements every frame, most of which never change and some of
+	 * which change every frame like a score counter. Compares laying the text out on every draw,
+	 * the GUI batcher's layout cache, and layouts that are held on to like GuiText does
+	 * @param elementCount The number of text elements to draw each frame
+	 */
+	void _RunTextLayoutBenchmark(int elementCount);
+
+	/**
+	 * Draws a synthetic menu through the GUI batcher into an offscreen target: 9-sliced panels,
+	 * icons with their own textures, text in two fonts and nested scissor regions. Compares the
+	 * draw calls and CPU time of the batcher with and without the texture atlas
+	 * @param panelCount The number of menu panels to draw each frame
+	 */
+	void _RunGuiBatchBenchmark(int panelCount);
+};
@@ -2,6 +2,7 @@
 #include "Application/Application.h"
 #include "Application/ApplicationLayer.h"
 #include "Application/Layers/RenderLayer.h"
+#include "Graphics/GuiBatcher.h"
 
 DebugWindow::DebugWindow() :
 	IEditorWindow()
@@ -9,11 +10,120 @@ DebugWindow::DebugWindow() :
 	Name = "Debug";
 	SplitDirection = ImGuiDir_::ImGuiDir_None;
 	SplitDepth = 0.5f;
-	Requirements = EditorWindowRequirements::Menubar;
+	Requirements = EditorWindowRequirements::Menubar | EditorWindowRequirements::Window;
 }
 
 DebugWindow::~DebugWindow() = default;
 
+void DebugWindow::Render()
+{
+	Application& app = Application::Get();
+	RenderLayer::Sptr renderLayer = app.GetLayer<RenderLayer>();
+
+	bool instancing = renderLayer->GetInstancingEnabled();
+	if (ImGui::Checkbox("Instanced Rendering", &instancing)) {
+		renderLayer->SetInstancingEnabled(instancing);
+	}
+
+	bool culling = renderLayer->GetCullingEnabled();
+	if (ImGui::Checkbox("Frustum Culling", &culling)) {
+		renderLayer->SetCullingEnabled(culling);
+	}
+
+	// Counters are for all scene passes (including shadows) in the last frame
+	const Gameplay::RenderQueue::Stats& stats = renderLayer->GetRenderStats();
+	ImGui::Text("Objects:          %u", stats.Objects);
+	ImGui::Text("Draw calls:       %u", stats.DrawCalls);
+	ImGui::Text("Instanced draws:  %u", stats.InstancedDrawCalls);
+	ImGui::Text("Shader changes:   %u", stats.ShaderChanges);
+	ImGui::Text("Material changes: %u", stats.MaterialChanges);
+
+	ImGui::Separator();
+
+	const RenderLayer::CullingStats& cullStats = renderLayer->GetCullingStats();
+	ImGui::Text("Culling proxies:  %u", cullStats.Proxies);
+	ImGui::Text("Visible:          %u", cullStats.Visible);
+	ImGui::Text("Culled:           %u", cullStats.Culled);
+	ImGui::Text("Shadow visible:   %u", cullStats.ShadowVisible);
+	ImGui::Text("Shadow culled:    %u", cullStats.ShadowCulled);
+
+	ImGui::Separator();
+
+	const LightClusterGrid& lightClusters = renderLayer->GetLightClusters();
+	ImGui::Text("Lights:           %u", renderLayer->GetLightCount());
+	ImGui::Text("Light clusters:   %u", lightClusters.GetClusterCount());
+	ImGui::Text("Cluster indices:  %u", static_cast<uint32_t>(lightClusters.GetLightIndices().size()));
+	ImGui::Text("Max per cluster:  %u", lightClusters.GetMaxLightsPerCluster());
+
+	ImGui::Separator();
+
+	const RenderLayer::ShadowStats& shadowStats = renderLayer->GetShadowStats();
+	ImGui::Text("Shadow lights:    %u (%u skipped)", shadowStats.Lights, shadowStats.Skipped);
+	ImGui::Text("Shadow redraws:   %u static, %u dynamic, %u cached", shadowStats.StaticRedraws, shadowStats.DynamicRedraws, shadowStats.Cached);
+	ImGui::Text("Shadow casters:   %u", shadowStats.Casters);
+	ImGui::Text("Shadow draws:     %u", shadowStats.DrawCalls);
+	ImGui::Text("Shadow time:      %.3f ms CPU, %.3f ms GPU", shadowStats.CpuMs, shadowStats.GpuMs);
+	ImGui::Text("Atlas usage:      %.1f%%", shadowStats.AtlasUsage * 100.0f);
+
+	ImGui::Separator();
+
+	const StreamingBuffer& stream = StreamingBuffer::Get();
+	const StreamingBuffer::Stats& streamStats = stream.GetStats();
+	ImGui::Text("Streamed:         %.1f KB in %u uploads", streamStats.BytesUsed / 1024.0f, streamStats.Allocations);
+	ImGui::Text("Stream regions:   %u x %u KB (%u used, %u stalls)", stream.GetRegionCount(), stream.GetRegionSize() / 1024, streamStats.RegionsUsed, streamStats.Stalls);
+
+	ImGui::Separator();
+
+	bool guiAtlas = GuiBatcher::GetAtlasEnabled();
+	if (ImGui::Checkbox("GUI Texture Atlas", &guiAtlas)) {
+		GuiBatcher::SetAtlasEnabled(guiAtlas);
+	}
+	const GuiBatcher::Stats& guiStats = GuiBatcher::GetStats();
+	const TextureAtlas& guiAtlasPages = GuiBatcher::GetAtlas();
+	ImGui::Text("GUI draws:        %u (%u commands, %u vertices)", guiStats.DrawCalls, guiStats.Commands, guiStats.Vertices);
+	ImGui::Text("GUI state:        %u texture changes, %u scissor changes", guiStats.TextureChanges, guiStats.ScissorChanges);
+	ImGui::Text("GUI atlas:        %u textures in %u pages (%.1f%%)", static_cast<uint32_t>(guiAtlasPages.GetTextureCount()),
+		static_cast<uint32_t>(guiAtlasPages.GetPageCount()), guiAtlasPages.GetUsage() * 100.0f);
+
+	ImGui::Separator();
+
+	Gameplay::Scene::Sptr scene = app.CurrentScene();
+	int physicsRate = (int)glm::round(1.0f / scene->GetPhysicsTimestep());
+	if (ImGui::DragInt("Physics Rate (Hz)", &physicsRate, 1.0f, 10, 240)) {
+		scene->SetPhysicsTimestep(1.0f / glm::max(1, physicsRate));
+	}
+	int maxSubsteps = scene->GetMaxPhysicsSubsteps();
+	if (ImGui::DragInt("Max Physics Substeps", &maxSubsteps, 0.1f, 1, 16)) {
+		scene->SetMaxPhysicsSubsteps(maxSubsteps);
+	}
+
+	const Gameplay::Scene::PhysicsStats& physicsStats = scene->GetPhysicsStats();
+	ImGui::Text("Physics substeps: %d", physicsStats.Substeps);
+	ImGui::Text("Substep time:     %.3f ms avg, %.3f ms max", physicsStats.AverageSubstepMs, physicsStats.MaxSubstepMs);
+	ImGui::Text("Physics time:     %.3f ms", physicsStats.TotalMs);
+	ImGui::Text("Dropped time:     %.1f ms", physicsStats.DroppedTime * 1000.0f);
+	ImGui::Text("Bodies pushed:    %d", physicsStats.BodiesPushed);
+	ImGui::Text("Bodies pulled:    %d", physicsStats.BodiesPulled);
+	ImGui::Text("Interpolation:    %.2f", scene->GetPhysicsInterpolation());
+
+	ImGui::Separator();
+
+	bool parallelFrame = app.GetParallelFrameEnabled();
+	if (ImGui::Checkbox("Parallel Frame", &parallelFrame)) {
+		app.SetParallelFrameEnabled(parallelFrame);
+	}
+	if (parallelFrame) {
+		// Timeline is from the last frame, since this frame's is still running
+		const TaskGraph& graph = app.GetFrameGraph();
+		ImGui::Text("Frame time:       %.3f ms", graph.GetWallMs());
+		ImGui::Text("Task time:        %.3f ms", graph.GetTotalTaskMs());
+		ImGui::Text("Critical path:    %.3f ms", graph.GetCriticalPathMs());
+		for (const TaskGraph::TimelineEntry& entry : graph.GetTimeline()) {
+			ImGui::Text("  %-16s %d  %7.3f - %7.3f ms", entry.Name.c_str(), entry.Thread, entry.StartMs, entry.EndMs);
+		}
+	}
+}
+
 void DebugWindow::RenderMenuBar() 
 {
 	Application& app = Application::Get();
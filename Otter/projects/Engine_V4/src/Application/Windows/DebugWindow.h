@@ -12,6 +12,7 @@ public:
 
 	// Inherited from IEditorWindow
 
+	virtual void Render() override;
 	virtual void RenderMenuBar() override;
 
 protected:
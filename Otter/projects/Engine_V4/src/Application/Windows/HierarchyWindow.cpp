@@ -88,7 +88,7 @@ void HierarchyWindow::_RenderObjectNode(Gameplay::GameObject::Sptr object, int d
 
 	// Determine the text of the node
 	static char buffer[256];
-	sprintf_s(buffer, 256, "%s###GO_HEADER", object->Name.c_str());
+	sprintf_s(buffer, 256, "%s###GO_HEADER", object->GetName().c_str());
 	bool isOpen = ImGui::TreeNodeEx(buffer, flags);
 	if (ImGui::IsItemClicked()) {
 		// TODO: Properly handle multi-selection
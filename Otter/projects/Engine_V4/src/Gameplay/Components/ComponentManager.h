@@ -1,6 +1,7 @@
 #pragma once
 #include <functional>
 #include "IComponent.h"
+#include "ComponentPool.h"
 #include <typeindex>
 #include <optional>
 #include <Logging.h>
@@ -17,7 +18,7 @@ namespace Gameplay {
 		typedef std::function<IComponent::Sptr()> CreateComponentFunc;
 
 		inline void Clear() {
-			_Components.clear();
+			_Pools.clear();
 		}
 
 		/// <summary>
@@ -29,28 +30,52 @@ namespace Gameplay {
 		/// <param name="blob">The JSON blob to decode</param>
 		/// <returns>The component as decoded from the JSON data, or nullptr</returns>
 		inline IComponent::Sptr Load(const std::string& typeName, const nlohmann::json& blob) {
-			// Try and get the type index from the name
-			std::optional<std::type_index> typeIndex = _TypeNameMap[typeName];
+			IComponent::Sptr result = _Parse(typeName, blob);
+			if (result != nullptr) {
+				// Also load additional component data, the GUID needs to be set before
+				// we add it to the pool so that the pool can index it
+				IComponent::LoadBaseJson(result, blob);
 
-			// If we have a value for type index, this component type was registered!
-			if (typeIndex.has_value()) {
-				// Get the load callback and make sure it exists
-				LoadComponentFunc callback = _TypeLoadRegistry[typeIndex.value()];
-				if (callback) {
-					// Invoke the loader, also load additional component data
-					IComponent::Sptr result = callback(blob);
-					IComponent::LoadBaseJson(result, blob);
+				// Add the component to the global pools
+				_AddToPool(result.get());
+			}
+			return result;
+		}
 
-					// Make sure the component knows it's own type
-					result->_realType = typeIndex.value();
-					result->_weakSelfPtr = result;
+		/// <summary>
+		/// Loads a component with the given type name from a JSON blob, where the base component
+		/// data (GUID and enabled state) is stored separately from the blob
+		/// If the type name does not correspond to a registered type, will
+		/// return nullptr
+		/// </summary>
+		/// <param name="typeName">The name of the type to load (taken from GetComponentTypeName of component)</param>
+		/// <param name="blob">The JSON blob to decode</param>
+		/// <param name="id">The GUID to give the component</param>
+		/// <param name="enabled">Whether the component should start enabled</param>
+		/// <returns>The component as decoded from the JSON data, or nullptr</returns>
+		inline IComponent::Sptr Load(const std::string& typeName, const nlohmann::json& blob, const Guid& id, bool enabled) {
+			IComponent::Sptr result = _Parse(typeName, blob);
+			if (result != nullptr) {
+				result->OverrideGUID(id);
+				result->IsEnabled = enabled;
 
-					// Add the component to the global pools
-					_Components[result->_realType].push_back(result);
-					return result;
-				}
+				// Add the component to the global pools
+				_AddToPool(result.get());
+			}
+			return result;
+		}
+
+		/// <summary>
+		/// Reserves space in the pool for the given component type, so that bulk loading a
+		/// known number of components does not need to grow the pool repeatedly
+		/// </summary>
+		/// <param name="typeName">The name of the type to reserve space for</param>
+		/// <param name="count">The number of components to make room for</param>
+		inline void Reserve(const std::string& typeName, size_t count) {
+			auto it = _TypeNameMap.find(typeName);
+			if (it != _TypeNameMap.end() && it->second.has_value()) {
+				_Pools[it->second.value()].Reserve(count);
 			}
-			return nullptr;
 		}
 
 		/// <summary>
@@ -75,7 +100,7 @@ namespace Gameplay {
 					result->_realType = typeIndex.value();
 					result->_weakSelfPtr = result;
 					// Add the component to the global pools
-					_Components[result->_realType].push_back(result);
+					_AddToPool(result.get());
 					return result;
 				}
 			}
@@ -102,7 +127,7 @@ namespace Gameplay {
 				result->_realType = type;
 				result->_weakSelfPtr = result;
 				// Add the component to the global pools
-				_Components[result->_realType].push_back(result);
+				_AddToPool(result.get());
 				return result;
 			}
 			return nullptr;
@@ -143,13 +168,43 @@ namespace Gameplay {
 			// Give the component a weak pointer to itself that it can upcast to a shared pointer when needed
 			component->_weakSelfPtr = component;
 
-			// Add to global component list for that type
-			_Components[type].push_back(component);
+			// Add to global component pool for that type
+			_AddToPool(component.get());
 
 			// Return the result
 			return component;
 		}
 
+		/// <summary>
+		/// Creates a component that is being loaded from something other than JSON, where the base
+		/// component data is already known, and adds it to the global component pools
+		/// </summary>
+		/// <typeparam name="ComponentType">Type type of component to create</typeparam>
+		/// <typeparam name="...TArgs">The types of params to forward to the component's constructor</typeparam>
+		/// <param name="id">The GUID to give the component</param>
+		/// <param name="enabled">Whether the component should start enabled</param>
+		/// <param name="...args">The arguments to forward to the constructor</param>
+		/// <returns>The new component that has been created</returns>
+		template <
+			typename ComponentType,
+			typename ... TArgs,
+			typename = typename std::enable_if<std::is_base_of<IComponent, ComponentType>::value>::type>
+		std::shared_ptr<ComponentType> CreateLoaded(const Guid& id, bool enabled, TArgs&& ... args) {
+			std::type_index type = std::type_index(typeid(ComponentType));
+			LOG_ASSERT(_TypeLoadRegistry[type] != nullptr, "You must register component types before creating them!");
+
+			std::shared_ptr<ComponentType> component = std::make_shared<ComponentType>(std::forward<TArgs>(args)...);
+			component->_realType = type;
+			component->_weakSelfPtr = component;
+
+			// The GUID needs to be set before we add it to the pool so that the pool can index it
+			component->OverrideGUID(id);
+			component->IsEnabled = enabled;
+			_AddToPool(component.get());
+
+			return component;
+		}
+
 		/// <summary>
 		/// Searches for a component with the given GUID, allowing components to cross reference each other
 		/// and survive scene serialization
@@ -165,50 +220,50 @@ namespace Gameplay {
 			std::type_index type = std::type_index(typeid(ComponentType));
 			LOG_ASSERT(_TypeLoadRegistry[type] != nullptr, "You must register component types before creating them!");
 
-			// Clear any dead weak pointers
-			auto removeIt = std::remove_if(_Components[type].begin(), _Components[type].end(), [](const std::weak_ptr<IComponent>& ptr) {
-				return ptr.expired();
-			});
-			_Components[type].erase(removeIt, _Components[type].end());
-
-			// Search the component store for a component that matches that ID
-			auto& it = std::find_if(_Components[type].begin(), _Components[type].end(), [&](const std::weak_ptr<IComponent>& ptr) {
-				return (ptr.lock())->GetGUID() == id;
-			});
-
-			// If the component was found, return it. Otherwise return nullptr
-			if (it != _Components[type].end()) {
-				// We need to lock the weak pointer to convert it to a shared ptr
-				return std::dynamic_pointer_cast<ComponentType>((*it).lock());
-			} else {
-				return nullptr;
+			// Look up the component in the pool's GUID index
+			auto it = _Pools.find(type);
+			if (it != _Pools.end()) {
+				IComponent* component = it->second.Find(id);
+				if (component != nullptr) {
+					// We need to lock the self pointer to convert it to a shared ptr, we know the 
+					// concrete type from the pool so no need for a dynamic cast
+					return std::static_pointer_cast<ComponentType>(component->_weakSelfPtr.lock());
+				}
 			}
+			return nullptr;
 		}
 
 		/// <summary>
 		/// Iterates over all components of the given type and invokes a method with them
+		/// 
+		/// Components are passed as raw pointers straight out of the packed pool, so the
+		/// callback should not hold on to them past the end of the call (use SelfRef for that)
 		/// </summary>
 		/// <typeparam name="ComponentType">The type of component to iterate on</typeparam>
-		/// <param name="callback">The callback to invoke with the components</param>
+		/// <param name="callback">The callback to invoke with the components, takes a ComponentType*</param>
 		/// <param name="includeDisabled">True to include disabled components, false if otherwise</param>
 		template <
 			typename ComponentType,
+			typename Func,
 			typename = typename std::enable_if<std::is_base_of<IComponent, ComponentType>::value>::type>
-		void Each(std::function<void(const std::shared_ptr<ComponentType>&)> callback, bool includeDisabled = false) {
+		void Each(Func&& callback, bool includeDisabled = false) {
 			// We can use typeid and type_index to get a unique ID for our types
 			std::type_index type = std::type_index(typeid(ComponentType));
 			LOG_ASSERT(_TypeLoadRegistry[type] != nullptr, "You must register component types before creating them!");
 
-			// Iterate over all the components in the store
-			for (auto& wptr : _Components[type]) {
-				// Lock the weak pointer to get a shared pointer (maybe)
-				std::shared_ptr<IComponent> sptr = wptr.lock();
-				// If the pointer is alive and matches our enabled criteria, invoke the callback
-				if (sptr && sptr->IsEnabled | includeDisabled) {
-					// Upcast to component type and invoke the callback
-					callback(std::dynamic_pointer_cast<ComponentType>(sptr));
-				}
+			// If no components of this type were ever made, there's nothing to do
+			auto it = _Pools.find(type);
+			if (it == _Pools.end()) {
+				return;
 			}
+
+			// Iterate over the packed component storage, the pool only contains components of
+			// exactly this type so we can safely static cast
+			it->second.Each([&](IComponent* component) {
+				if (component->IsEnabled || includeDisabled) {
+					callback(static_cast<ComponentType*>(component));
+				}
+			});
 		}
 
 		/// <summary>
@@ -238,7 +293,7 @@ namespace Gameplay {
 		/// Removes all components of all types from the registry, whether they are referenced elsewhere or not
 		/// </summary>
 		inline void FlushAll() {
-			_Components = std::unordered_map<std::type_index, std::vector<std::weak_ptr<IComponent>>>();
+			_Pools = std::unordered_map<std::type_index, ComponentPool>();
 		}
 
 	private:
@@ -254,10 +309,44 @@ namespace Gameplay {
 		// Stores functions to load components from JSON, indexed on the type that they load
 		inline static std::unordered_map<std::type_index, CreateComponentFunc> _TypeCreateRegistry;
 
-		// Weak pointers let us store a reference to an object stored by a shared pointer, without
-		// actually increasing the reference count. Thus components will be destroyed at the correct
-		// time (when the only reference is the one stored here).
-		std::unordered_map<std::type_index, std::vector<std::weak_ptr<IComponent>>> _Components;  
+		// Packed pools of raw component pointers, one per concrete type. The pools do not own the
+		// components (game objects do), components will remove themselves from their pool when they
+		// are destroyed, so everything in a pool is always alive
+		std::unordered_map<std::type_index, ComponentPool> _Pools;
+
+		/// <summary>
+		/// Adds a component to the pool for it's concrete type, and stores the pool handle in the component
+		/// </summary>
+		/// <param name="component">The component to add, must have it's real type set</param>
+		inline void _AddToPool(IComponent* component) {
+			component->_poolHandle = _Pools[component->_realType].Add(component);
+		}
+
+		/// <summary>
+		/// Invokes the loader for the given type name, without loading the base component data
+		/// or adding the component to a pool
+		/// </summary>
+		/// <returns>The component as decoded from the JSON data, or nullptr if the type is not registered</returns>
+		inline IComponent::Sptr _Parse(const std::string& typeName, const nlohmann::json& blob) {
+			// Try and get the type index from the name
+			std::optional<std::type_index> typeIndex = _TypeNameMap[typeName];
+
+			// If we have a value for type index, this component type was registered!
+			if (typeIndex.has_value()) {
+				// Get the load callback and make sure it exists
+				LoadComponentFunc callback = _TypeLoadRegistry[typeIndex.value()];
+				if (callback) {
+					// Invoke the loader
+					IComponent::Sptr result = callback(blob);
+
+					// Make sure the component knows it's own type
+					result->_realType = typeIndex.value();
+					result->_weakSelfPtr = result;
+					return result;
+				}
+			}
+			return nullptr;
+		}
 
 		template <typename T>
 		static IComponent::Sptr ParseTypeFromBlob(const nlohmann::json& blob) {
@@ -289,21 +378,18 @@ namespace Gameplay {
 		/// <param name="component">A raw pointer to the component to remove (should be called from IComponent destructor)</param>
 		/// <returns>True if the element was removed, false if not</returns>
 		inline void Remove(const IComponent* component) {
-			if (_Components.size() == 0) return;
+			if (_Pools.size() == 0) return;
 
 			// Make sure the component's type was one that was registered
 			LOG_ASSERT(_TypeLoadRegistry[component->_realType] != nullptr, "You must register component types before creating them!");
 
-			
-			// Get a reference to the vector of components for easy access
-			std::vector<std::weak_ptr<IComponent>>& componentStore = _Components[component->_realType];
+			// The pool may have been flushed already, in which case there's nothing to remove
+			auto it = _Pools.find(component->_realType);
+			if (it == _Pools.end()) return;
 
-			// Clear any dead weak pointers
-			auto it = std::remove_if(componentStore.begin(), componentStore.end(), [](const std::weak_ptr<IComponent>& ptr) {
-				return ptr.expired();
-				});
-			if (it != componentStore.end()) {
-				componentStore.erase(it);
+			// Make sure the handle still refers to this component (it may be stale after a flush)
+			if (it->second.Get(component->_poolHandle) == component) {
+				it->second.Remove(component->_poolHandle);
 			}
 		}
 	};
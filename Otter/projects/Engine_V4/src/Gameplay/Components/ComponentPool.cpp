@@ -0,0 +1,143 @@
+#include "Gameplay/Components/ComponentPool.h"
+#include "Gameplay/Components/IComponent.h"
+
+namespace Gameplay {
+	ComponentPool::ComponentPool() :
+		_dense(std::vector<IComponent*>()),
+		_denseToSlot(std::vector<uint32_t>()),
+		_slots(std::vector<Slot>()),
+		_freeHead(ComponentHandle::InvalidIndex),
+		_guidIndex(std::unordered_map<Guid, ComponentHandle>()),
+		_iterationDepth(0),
+		_hasHoles(false)
+	{ }
+
+	ComponentHandle ComponentPool::Add(IComponent* component) {
+		// Grab a slot from the free list, or grow the slot array if there's none available
+		uint32_t slotIx;
+		if (_freeHead != ComponentHandle::InvalidIndex) {
+			slotIx = _freeHead;
+			_freeHead = _slots[slotIx].DenseIndex;
+		} else {
+			slotIx = static_cast<uint32_t>(_slots.size());
+			_slots.push_back({ 0, 0 });
+		}
+
+		// Append the component to the end of the packed storage
+		Slot& slot = _slots[slotIx];
+		slot.DenseIndex = static_cast<uint32_t>(_dense.size());
+		_dense.push_back(component);
+		_denseToSlot.push_back(slotIx);
+
+		ComponentHandle result;
+		result.Index = slotIx;
+		result.Generation = slot.Generation;
+
+		_guidIndex[component->GetGUID()] = result;
+		return result;
+	}
+
+	bool ComponentPool::Remove(const ComponentHandle& handle) {
+		if (Get(handle) == nullptr) {
+			return false;
+		}
+
+		Slot& slot = _slots[handle.Index];
+		uint32_t denseIx = slot.DenseIndex;
+
+		// Drop the GUID lookup, as long as it's still pointing at this component
+		auto it = _guidIndex.find(_dense[denseIx]->GetGUID());
+		if (it != _guidIndex.end() && it->second == handle) {
+			_guidIndex.erase(it);
+		}
+
+		// If we're iterating, we can't shuffle the dense array around, so leave a hole that
+		// will be packed when the iteration completes
+		if (_iterationDepth > 0) {
+			_dense[denseIx] = nullptr;
+			_denseToSlot[denseIx] = ComponentHandle::InvalidIndex;
+			_hasHoles = true;
+		}
+		// Otherwise swap the last element into the removed element's place
+		else {
+			uint32_t lastIx = static_cast<uint32_t>(_dense.size() - 1);
+			if (denseIx != lastIx) {
+				_dense[denseIx] = _dense[lastIx];
+				_denseToSlot[denseIx] = _denseToSlot[lastIx];
+				_slots[_denseToSlot[denseIx]].DenseIndex = denseIx;
+			}
+			_dense.pop_back();
+			_denseToSlot.pop_back();
+		}
+
+		// Bump the generation so that old handles are rejected, and return the slot to the free list
+		slot.Generation++;
+		slot.DenseIndex = _freeHead;
+		_freeHead = handle.Index;
+		return true;
+	}
+
+	IComponent* ComponentPool::Get(const ComponentHandle& handle) const {
+		if (handle.Index >= _slots.size()) {
+			return nullptr;
+		}
+		const Slot& slot = _slots[handle.Index];
+		if (slot.Generation != handle.Generation || slot.DenseIndex >= _dense.size() || _denseToSlot[slot.DenseIndex] != handle.Index) {
+			return nullptr;
+		}
+		return _dense[slot.DenseIndex];
+	}
+
+	IComponent* ComponentPool::Find(const Guid& id) const {
+		auto it = _guidIndex.find(id);
+		if (it != _guidIndex.end()) {
+			// Make sure the component still has the ID it was indexed with
+			IComponent* result = Get(it->second);
+			if (result != nullptr && result->GetGUID() == id) {
+				return result;
+			}
+		}
+		return nullptr;
+	}
+
+	void ComponentPool::Reserve(size_t count) {
+		_dense.reserve(count);
+		_denseToSlot.reserve(count);
+		_slots.reserve(count);
+		_guidIndex.reserve(count);
+	}
+
+	void ComponentPool::Clear() {
+		// Bump every live slot's generation so outstanding handles go stale
+		for (Slot& slot : _slots) {
+			slot.Generation++;
+		}
+		_dense.clear();
+		_denseToSlot.clear();
+		_guidIndex.clear();
+
+		// Rebuild the free list over all slots
+		_freeHead = ComponentHandle::InvalidIndex;
+		for (uint32_t ix = static_cast<uint32_t>(_slots.size()); ix > 0; ix--) {
+			_slots[ix - 1].DenseIndex = _freeHead;
+			_freeHead = ix - 1;
+		}
+		_hasHoles = false;
+	}
+
+	void ComponentPool::_Compact() {
+		// Pack the live components towards the front, preserving their order
+		size_t writeIx = 0;
+		for (size_t readIx = 0; readIx < _dense.size(); readIx++) {
+			if (_dense[readIx] != nullptr) {
+				_dense[writeIx] = _dense[readIx];
+				_denseToSlot[writeIx] = _denseToSlot[readIx];
+				_slots[_denseToSlot[writeIx]].DenseIndex = static_cast<uint32_t>(writeIx);
+				writeIx++;
+			}
+		}
+		_dense.resize(writeIx);
+		_denseToSlot.resize(writeIx);
+		_hasHoles = false;
+	}
+}
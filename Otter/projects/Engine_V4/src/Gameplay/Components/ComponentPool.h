@@ -0,0 +1,130 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+
+#include "Utils/GUID.hpp"
+
+namespace Gameplay {
+	class IComponent;
+
+	/// <summary>
+	/// A stable handle to a component stored in a ComponentPool. Handles stay valid while
+	/// the component is alive, even as the pool's dense storage is shuffled around
+	/// </summary>
+	struct ComponentHandle {
+		uint32_t Index      = InvalidIndex;
+		uint32_t Generation = 0;
+
+		static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+		bool IsValid() const { return Index != InvalidIndex; }
+		bool operator ==(const ComponentHandle& other) const { return Index == other.Index && Generation == other.Generation; }
+		bool operator !=(const ComponentHandle& other) const { return !(*this == other); }
+	};
+
+	/// <summary>
+	/// Stores all components of a single type in a packed, contiguous array (a sparse set)
+	///
+	/// The pool does not own the components, they are still owned by their game objects.
+	/// Components remove themselves from their pool when they are destroyed, so the pool
+	/// never needs to lock or validate pointers while iterating
+	/// </summary>
+	class ComponentPool {
+	public:
+		ComponentPool();
+
+		/// <summary>
+		/// Adds a component to the pool and returns a handle to it
+		/// </summary>
+		/// <param name="component">The component to add, must not be null</param>
+		ComponentHandle Add(IComponent* component);
+		/// <summary>
+		/// Removes the component with the given handle from the pool, this is O(1)
+		/// </summary>
+		/// <param name="handle">The handle returned by Add</param>
+		/// <returns>True if the handle was valid and the component was removed</returns>
+		bool Remove(const ComponentHandle& handle);
+		/// <summary>
+		/// Gets the component for the given handle, or nullptr if the handle is stale
+		/// </summary>
+		IComponent* Get(const ComponentHandle& handle) const;
+		/// <summary>
+		/// Finds the component with the given GUID in this pool, or nullptr if none exists
+		/// Note that components are indexed by the GUID they have when they are added, so
+		/// any GUID overrides should happen before that (as ComponentManager::Load does)
+		/// </summary>
+		/// <param name="id">The ID of the component to find</param>
+		IComponent* Find(const Guid& id) const;
+
+		/// <summary>
+		/// Gets the number of slots in the dense storage. Note that while iterating, some of
+		/// these slots may be null if components were removed during iteration
+		/// </summary>
+		size_t Size() const { return _dense.size(); }
+		/// <summary>
+		/// Gets the component in the given dense slot (may be null during iteration)
+		/// </summary>
+		IComponent* At(size_t index) const { return _dense[index]; }
+
+		/// <summary>
+		/// Reserves space for the given number of components, so that adding that many
+		/// components will not need to re-allocate the pool's storage
+		/// </summary>
+		/// <param name="count">The total number of components to make room for</param>
+		void Reserve(size_t count);
+
+		/// <summary>
+		/// Removes all components from the pool, invalidating all handles
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// Iterates over all the components in the pool. Components may be safely added or
+		/// removed from within the callback, components added will not be visited until the
+		/// next iteration
+		/// </summary>
+		/// <param name="callback">The callback to invoke, takes an IComponent*</param>
+		template <typename Func>
+		void Each(Func&& callback) {
+			_iterationDepth++;
+			const size_t count = _dense.size();
+			for (size_t ix = 0; ix < count; ix++) {
+				IComponent* component = _dense[ix];
+				if (component != nullptr) {
+					callback(component);
+				}
+			}
+			_iterationDepth--;
+
+			// Removals during iteration leave holes behind, we can pack them now that we're done
+			if (_iterationDepth == 0 && _hasHoles) {
+				_Compact();
+			}
+		}
+
+	private:
+		struct Slot {
+			// Index into the dense storage, or next free slot when unused
+			uint32_t DenseIndex;
+			uint32_t Generation;
+		};
+
+		// Packed component pointers, what we iterate over
+		std::vector<IComponent*> _dense;
+		// Maps dense indices back to the slot that references them
+		std::vector<uint32_t>    _denseToSlot;
+		// Sparse slots, indexed by the handle
+		std::vector<Slot>        _slots;
+		// Head of the free slot list
+		uint32_t                 _freeHead;
+		// Lookup table for finding components by their GUID
+		std::unordered_map<Guid, ComponentHandle> _guidIndex;
+
+		int  _iterationDepth;
+		bool _hasHoles;
+
+		void _Compact();
+	};
+}
@@ -49,12 +49,6 @@ void GuiPanel::StartGUI() {
 	Texture2D::Sptr tex = _texture != nullptr ? _texture : GuiBatcher::GetDefaultTexture();
 
 	GuiBatcher::PushRect(glm::vec2(0,0), _transform->GetSize(), _color, tex, _borderRadius < 0 ? GuiBatcher::GetDefaultBorderRadius() : _borderRadius);
-
-	GuiBatcher::Flush();
-}
-
-void GuiPanel::FinishGUI() {
-	GuiBatcher::Flush();
 }
 
 void GuiPanel::RenderImGui()
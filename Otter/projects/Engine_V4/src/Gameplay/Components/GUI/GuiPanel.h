@@ -47,7 +47,6 @@ public:
 public:
 	virtual void Awake() override;
 	virtual void StartGUI() override;
-	virtual void FinishGUI() override;
 	virtual void RenderImGui() override;
 	MAKE_TYPENAME(GuiPanel);
 	virtual nlohmann::json ToJson() const override;
@@ -13,8 +13,8 @@ GuiText::GuiText() :
 	_text(LR"()"), // The LR and parenthesis tell us it's a unicode string (wide string)
 	_color(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)),
 	_font(nullptr),
-	_textSize(glm::vec2(0.0f)),
-	_textScale(1.0f)
+	_textScale(1.0f),
+	_layout(nullptr)
 { }
 
 GuiText::~GuiText() = default;
@@ -40,11 +40,12 @@ const std::wstring& GuiText::GetTextUnicode() const {
 }
 
 void GuiText::SetTextUnicode(const std::wstring& value) {
-	_text = value;
-	
-	if (_font != nullptr) {
-		_textSize = _font->MeausureString(_text, _textScale);
+	// Text is often set every frame, so don't throw away our layout if nothing changed
+	if (value == _text) {
+		return;
 	}
+	_text = value;
+	_InvalidateLayout();
 }
 
 const float GuiText::GetTextScale() const {
@@ -52,7 +53,10 @@ const float GuiText::GetTextScale() const {
 }
 
 void GuiText::SetTextScale(float value) {
-	_textScale = value;
+	if (value != _textScale) {
+		_textScale = value;
+		_InvalidateLayout();
+	}
 }
 
 const Font::Sptr& GuiText::GetFont() const {
@@ -61,9 +65,7 @@ const Font::Sptr& GuiText::GetFont() const {
 
 void GuiText::SetFont(const Font::Sptr& font) {
 	_font = font;
-	if (_font != nullptr) {
-		_textSize = _font->MeausureString(_text, _textScale);
-	}
+	_InvalidateLayout();
 }
 
 void GuiText::Awake() {
@@ -77,9 +79,13 @@ void GuiText::Awake() {
 void GuiText::RenderGUI()
 {
 	if (_font != nullptr && !_text.empty()) {
+		if (_layout == nullptr) {
+			_layout = TextLayout::Create(_text, _font, _textScale);
+		}
+
 		glm::vec2 position = _transform->GetSize() / 2.0f;
-		position -= _textSize / 2.0f;
-		GuiBatcher::RenderText(_text, _font, position, _color, _textScale);
+		position -= _layout->GetSize() / 2.0f;
+		GuiBatcher::RenderText(*_layout, position, _color);
 	}
 }
 
@@ -91,18 +97,18 @@ void GuiText::RenderImGui()
 
 	if (LABEL_LEFT(ImGui::InputTextMultiline, "Text", buffer, 4096)) {
 		_text = StringConvert.from_bytes(buffer);
-		if (_font != nullptr) {
-			_textSize = _font->MeausureString(_text, _textScale);
-		}
+		_InvalidateLayout();
 	}
 	LABEL_LEFT(ImGui::ColorEdit4, "Color", &_color.x);
 	if (LABEL_LEFT(ImGui::DragFloat, "Scale", &_textScale, 0.01f)) {
-		if (_font != nullptr) {
-			_textSize = _font->MeausureString(_text, _textScale);
-		}
+		_InvalidateLayout();
 	}
 }
 
+void GuiText::_InvalidateLayout() {
+	_layout = nullptr;
+}
+
 nlohmann::json GuiText::ToJson() const {
 	return {
 		{ "color", _color },
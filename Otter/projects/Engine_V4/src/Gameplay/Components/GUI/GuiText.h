@@ -2,9 +2,13 @@
 #include "Gameplay/Components/IComponent.h"
 #include "Gameplay/Components/GUI/RectTransform.h"
 #include "Graphics/Font.h"
+#include "Graphics/TextLayout.h"
 
 /// <summary>
 /// Renders text for UI components
+///
+/// The text is laid out once and re-used every frame, the layout is only rebuilt when the
+/// text, scale or font changes
 /// </summary>
 class GuiText : public Gameplay::IComponent {
 public:
@@ -78,8 +82,15 @@ protected:
 	std::wstring    _text;
 	glm::vec4       _color;
 	Font::Sptr      _font;
-	glm::vec2       _textSize;
 	float           _textScale;
+	// Null when the layout needs to be rebuilt
+	TextLayout::Sptr _layout;
 
 	RectTransform::Sptr _transform;
+
+	/// <summary>
+	/// Drops our layout so it's rebuilt the next time we render, should be called whenever the
+	/// text, scale or font changes
+	/// </summary>
+	void _InvalidateLayout();
 };
\ No newline at end of file
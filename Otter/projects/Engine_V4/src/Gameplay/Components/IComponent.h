@@ -9,6 +9,8 @@
 #include "Utils/ResourceManager/IResource.h"
 #include "Utils/TypeHelpers.h"
 
+#include "Gameplay/Components/ComponentPool.h"
+
 namespace Gameplay {
 	// We pre-declare GameObject to avoid circular dependencies in the headers
 	class GameObject;
@@ -162,6 +164,8 @@ namespace Gameplay {
 
 		std::type_index _realType;
 		GameObject* _context;
+		// Our handle into the component manager's pool for our type
+		ComponentHandle _poolHandle;
 
 		// By storing a weak pointer to ourselves, we can pass a pointer to this
 		// for things like bullet user pointers
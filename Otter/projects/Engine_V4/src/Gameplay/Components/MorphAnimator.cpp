@@ -12,14 +12,18 @@
 
 MorphAnimator::AnimData::AnimData()
 {
-	frames.push_back(nullptr);
-	frames.push_back(nullptr);
+	clip = nullptr;
 	frameTime = 1.0f;
 
 }
 
 MorphAnimator::MorphAnimator() :
-	IComponent()
+	IComponent(),
+	m_data(nullptr),
+	m_timer(0.0f),
+	m_phase(0.0f),
+	m_forwards(true),
+	m_renderer()
 { }
 MorphAnimator::~MorphAnimator() = default;
 void MorphAnimator::Awake()
@@ -31,8 +35,8 @@ void MorphAnimator::SetInitial()
 {
 	m_data = std::make_unique<AnimData>();
 	m_timer = 0.0f;
+	m_phase = 0.0f;
 	m_forwards = true;
-	m_segmentIndex = 0;
 }
 
 void MorphAnimator::OnTriggerVolumeEntered(const std::shared_ptr<Gameplay::Physics::RigidBody>& body)
@@ -49,39 +53,33 @@ void MorphAnimator::RenderImGui()
 
 void MorphAnimator::Update(float deltaTime)
 {
-	if (m_data->frameTime > 0)
-	{
-		m_timer += deltaTime;
-		while (m_timer > m_data->frameTime)
-		{
-			m_timer -= m_data->frameTime;
-
-			m_segmentIndex += 1;
-
-			
-		}
-		if (m_segmentIndex >= m_data->frames.size())
-			m_segmentIndex = 0;
-		float t = m_timer / m_data->frameTime;
+	// Handled by UpdateAll, so that every animator is advanced in one pass
+}
 
-		if (m_data->frames.size() < 2)
-		{
+void MorphAnimator::UpdateAll(ComponentManager& components, float deltaTime)
+{
+	components.Each<MorphAnimator>([deltaTime](MorphAnimator* animator) {
+		const AnimData* data = animator->m_data.get();
+		if (data == nullptr || data->frameTime <= 0 || data->clip == nullptr || data->clip->GetFrameCount() == 0) {
 			return;
 		}
-		size_t p0_index, p1_index;
-
-		p1_index = m_segmentIndex;
-		p0_index = (p1_index == 0) ? m_data->frames.size() - 1 : p1_index - 1;
 
-		float garb;
+		RenderComponent::Sptr renderer = animator->m_renderer.lock();
+		if (renderer == nullptr) {
+			renderer = animator->GetGameObject()->Get<RenderComponent>();
+			if (renderer == nullptr) {
+				return;
+			}
+			animator->m_renderer = renderer;
+		}
 
-		GetGameObject()->Get<MorphMeshRenderer>()->UpdateData(m_data->frames[p0_index], m_data->frames[p1_index], glm::modf(t, garb));
+		// Wrap the timer so it doesn't lose precision over time
+		const float duration = data->frameTime * data->clip->GetFrameCount();
+		animator->m_timer = glm::mod(animator->m_timer + deltaTime, duration);
 
-	}
-	else
-	{
-		return;
-	}
+		const float time = glm::mod(animator->m_timer + animator->m_phase, duration);
+		renderer->SetMorphState(data->clip->GetFrameState(time / data->frameTime));
+	});
 }
 
 
@@ -90,17 +88,27 @@ void MorphAnimator::SetFrameTime(float t)
 	m_data->frameTime = t;
 }
 
-void MorphAnimator::SetFrames(std::vector<MeshResource::Sptr>& f)
+void MorphAnimator::SetClip(const MorphClip::Sptr& clip)
 {
-	m_data->frames.clear();
-	m_data->frames.reserve(f.size());
+	m_data->clip = clip;
 
-	for (int i = 0; i < f.size(); i++)
-	{
-		m_data->frames.push_back(f[i]);
+	// Clip vertices are matched up with the mesh by index, so they need to line up
+	RenderComponent::Sptr renderer = GetGameObject()->Get<RenderComponent>();
+	if (clip != nullptr && renderer != nullptr && renderer->GetMesh() != nullptr && renderer->GetMesh()->GetVertexCount() != clip->GetVertexCount()) {
+		LOG_WARN("Morph clip has {} vertices, but \"{}\"'s mesh has {}", clip->GetVertexCount(), GetGameObject()->GetName(), renderer->GetMesh()->GetVertexCount());
 	}
 }
 
+const MorphClip::Sptr& MorphAnimator::GetClip() const
+{
+	return m_data->clip;
+}
+
+void MorphAnimator::SetPhaseOffset(float seconds)
+{
+	m_phase = seconds;
+}
+
 nlohmann::json MorphAnimator::ToJson() const {
 
 	return {};
@@ -10,6 +10,7 @@
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Scene.h"
 #include "Utils/ImGuiHelper.h"
+#include "Gameplay/MorphClip.h"
 
 #include <memory>
 
@@ -37,7 +38,24 @@ public:
 	virtual void OnTriggerVolumeLeaving(const std::shared_ptr<Gameplay::Physics::RigidBody>& body) override;
 	virtual void RenderImGui() override;
 	void SetFrameTime(float t);
-	void SetFrames(std::vector<MeshResource::Sptr>& f);
+	void SetClip(const MorphClip::Sptr& clip);
+	const MorphClip::Sptr& GetClip() const;
+	/// <summary>
+	/// Sets how far into the clip this animator is, in seconds. Giving objects that share a clip
+	/// different offsets stops them all moving in lockstep
+	/// </summary>
+	void SetPhaseOffset(float seconds);
+	float GetPhaseOffset() const { return m_phase; }
+
+	/// <summary>
+	/// Advances every enabled animator in the scene and writes their frames into their render
+	/// components' instance data. Animators don't do any work in their own Update, the scene calls
+	/// this once per frame instead so that large crowds don't pay for a virtual call and a
+	/// component lookup on every object
+	/// </summary>
+	/// <param name="components">The scene's components</param>
+	/// <param name="deltaTime">The time since the last update, in seconds</param>
+	static void UpdateAll(ComponentManager& components, float deltaTime);
 
 	virtual nlohmann::json ToJson() const override;
 	static MorphAnimator::Sptr FromJson(const nlohmann::json& blob);
@@ -49,12 +67,8 @@ protected:
 	{
 	public:
 
-		//TODO: You'll need to define a way to store and manage full
-		//animation clips for the exercise.
-		//make a vector
-		std::vector<MeshResource::Sptr> frames;
-		//const Mesh* frame0;
-		//const Mesh* frame1;
+		//All the frames of the animation, packed together on the GPU
+		MorphClip::Sptr clip;
 
 		//The time inbetween frames.
 		float frameTime;
@@ -64,7 +78,10 @@ protected:
 	};
 	std::unique_ptr<AnimData> m_data;
 	float m_timer;
+	float m_phase;
 	bool m_forwards;
-	size_t m_segmentIndex;
+
+	// The render component we write frames to, looked up the first time we update
+	std::weak_ptr<RenderComponent> m_renderer;
 
 };
\ No newline at end of file
@@ -15,39 +15,27 @@ MorphMeshRenderer::MorphMeshRenderer() :
 void MorphMeshRenderer::SetMorphMeshRenderer(MeshResource::Sptr baseMesh, Material::Sptr mat)
 {
 	m_mat = mat;
-	m_vao = baseMesh->Mesh;
 
-	UpdateData(baseMesh, baseMesh, 0.0f);
+	SetFrameState(MorphClip::FrameState());
 }
 
 MorphMeshRenderer::~MorphMeshRenderer() = default;
 
 
-void MorphMeshRenderer::UpdateData(MeshResource::Sptr frame0, MeshResource::Sptr frame1, float t)
+void MorphMeshRenderer::SetFrameState(const MorphClip::FrameState& state)
 {
-	m_vao = frame0->Mesh;
-	
-	VertexBuffer::Sptr vbo = VertexBuffer::Create();
-	VertexBuffer::Sptr vbo2 = VertexBuffer::Create();
-	vbo = frame1->Mesh->GetBufferBinding(AttribUsage::Position)->GetBuffer();
-	vbo2 = frame1->Mesh->GetBufferBinding(AttribUsage::Normal)->GetBuffer();
-	VertexArrayObject::VertexDeclaration newvd = frame1->Mesh->GetVDecl();
-	//std::cout << newvd[0].Usage << std::endl; //position
-	//std::cout << newvd[1].Usage << std::endl; //color
-	//std::cout << newvd[2].Usage << std::endl; //normal
-	//std::cout << newvd[3].Usage << std::endl; //texture
-	//std::cout << newvd.size() << std::endl; =4
-	BufferAttribute ba1 = BufferAttribute(6, 3, AttributeType::Float, newvd[0].Stride, newvd[0].Offset, AttribUsage::Position);
-	BufferAttribute ba2 = BufferAttribute(7, 3, AttributeType::Float, newvd[2].Stride, newvd[2].Offset, AttribUsage::Normal);
-	m_vao->AddVertexBuffer(vbo, std::vector<BufferAttribute>{ba1});
-	m_vao->AddVertexBuffer(vbo2, std::vector<BufferAttribute>{ba2});
-	
-	GetGameObject()->Get<RenderComponent>()->GetMeshResource()->Mesh = m_vao;
-	//GetGameObject()->Get<RenderComponent>()->GetMesh()->AddVertexBuffer(vbo, std::vector<BufferAttribute>{ba1});
-	//GetGameObject()->Get<RenderComponent>()->GetMesh()->AddVertexBuffer(vbo2, std::vector<BufferAttribute>{ba2});
-	
-	m_t = t;
-	GetGameObject()->Get<RenderComponent>()->GetMaterial()->Set("t", m_t);
+	// The state goes into the object's instance data rather than it's material, so objects
+	// sharing a material can still be drawn together. Only morph shaders will read it
+	RenderComponent::Sptr renderer = GetGameObject()->Get<RenderComponent>();
+	if (renderer != nullptr) {
+		renderer->SetMorphState(state);
+	}
+}
+
+MorphClip::FrameState MorphMeshRenderer::GetFrameState() const
+{
+	RenderComponent::Sptr renderer = GetGameObject()->Get<RenderComponent>();
+	return renderer != nullptr ? renderer->GetMorphState() : MorphClip::FrameState();
 }
 
 void MorphMeshRenderer::Draw()
@@ -10,6 +10,7 @@
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Scene.h"
 #include "Utils/ImGuiHelper.h"
+#include "Gameplay/MorphClip.h"
 
 #include <memory>
 
@@ -39,7 +40,12 @@ public:
 	//MorphMeshRenderer(MorphMeshRenderer&&) = default;
 	//MorphMeshRenderer& operator=(MorphMeshRenderer&&) = default;
 
-	void UpdateData(MeshResource::Sptr frame0, MeshResource::Sptr frame1, float t);
+	/// <summary>
+	/// Sets the frames of a morph clip to draw, this only updates the object's instance data
+	/// (see RenderComponent::SetMorphState) so the mesh and it's buffers are never touched
+	/// </summary>
+	void SetFrameState(const MorphClip::FrameState& state);
+	MorphClip::FrameState GetFrameState() const;
 	virtual void Draw();
 	virtual void Update(float deltaTime) override;
 	virtual void OnTriggerVolumeEntered(const std::shared_ptr<Gameplay::Physics::RigidBody>& body) override;
@@ -52,13 +58,6 @@ public:
 
 protected:
 
-	//Pointers to the frames we're currently in between.
-	MeshResource::Sptr m_frame0;
-	MeshResource::Sptr m_frame1;
-	//The t-value for interpolating between our frames.
-	float m_t;
-
 	Material::Sptr m_mat;
-	VertexArrayObject::Sptr m_vao;
 
 };
\ No newline at end of file
@@ -3,35 +3,98 @@
 #include "Application/Timing.h"
 #include "Application/Application.h"
 #include "Utils/ImGuiHelper.h"
+#include "Graphics/Buffers/StreamingBuffer.h"
+
+bool ParticleSystem::_synchronousReadback = false;
 
 ParticleSystem::ParticleSystem() :
 	IComponent(),
 	_hasInit(false),
+	_backend(ParticleBackend::GPU),
 	_maxParticles(1000),
 	_numParticles(0),
 	_particleBuffers(),
 	_feedbackBuffers(),
-	_query(0),
+	_queries(),
+	_queryPending(),
+	_queryHead(0),
+	_queryTail(0),
 	_currentVertexBuffer(0),
 	_currentFeedbackBuffer(1),
 	_updateShader(nullptr),
 	_renderShader(nullptr),
 	_gravity({ 0, 0, -9.81f }),
-	_emitters()
+	_emitters(),
+	_simulation(nullptr),
+	_renderVao(nullptr),
+	_renderBinding(nullptr)
 { }
 
 ParticleSystem::~ParticleSystem()
 {
 	if (_hasInit) {
-		glDeleteBuffers(2, _particleBuffers);
-		glDeleteTransformFeedbacks(2, _feedbackBuffers);
-		glDeleteQueries(1, &_query);
+		if (_backend == ParticleBackend::GPU) {
+			glDeleteBuffers(2, _particleBuffers);
+			glDeleteTransformFeedbacks(2, _feedbackBuffers);
+			glDeleteQueries(QueryRingSize, _queries);
+		}
+		_renderVao = nullptr;
 		_updateShader = nullptr;
 		_renderShader = nullptr;
 	}
 }
 
+void ParticleSystem::SetBackend(ParticleBackend value)
+{
+	LOG_ASSERT(!_hasInit, "Cannot change the backend after the particle system has been initialized");
+	_backend = value;
+}
+
 void ParticleSystem::Update()
+{
+	if (_backend == ParticleBackend::CPU) {
+		_UpdateCpu();
+	} else {
+		_UpdateGpu();
+	}
+}
+
+void ParticleSystem::_UpdateCpu()
+{
+	if (!_hasInit) {
+		std::vector<Gameplay::ParticleSimulation::Emitter> emitters;
+		emitters.reserve(_emitters.size());
+		for (const auto& data : _emitters) {
+			Gameplay::ParticleSimulation::Emitter emitter;
+			emitter.Position      = data.Position;
+			emitter.Velocity      = data.Velocity;
+			emitter.Color         = data.Color;
+			emitter.SpawnInterval = data.Metadata.x;
+			emitter.ConeAngle     = data.Metadata.y;
+			emitter.LifetimeRange = { data.Metadata.z, data.Metadata.w };
+			emitters.push_back(emitter);
+		}
+
+		_simulation = std::make_unique<Gameplay::ParticleSimulation>(_maxParticles);
+		_simulation->SetEmitters(emitters);
+
+		// Only the packed render data is uploaded, and the type is the same for all of them so
+		// it's left as a constant attribute, see Render
+		typedef Gameplay::ParticleSimulation::RenderVertex RenderVertex;
+		_renderVao = VertexArrayObject::Create();
+		_renderBinding = _renderVao->AddStreamedVertexBuffer({
+			BufferAttribute(1, 3, AttributeType::Float, sizeof(RenderVertex), offsetof(RenderVertex, Position), AttribUsage::Position),
+			BufferAttribute(3, 4, AttributeType::UByte, sizeof(RenderVertex), offsetof(RenderVertex, Color), AttribUsage::Color, true)
+		});
+
+		_hasInit = true;
+	}
+
+	_simulation->Update(Timing::Current().DeltaTime(), GetGameObject()->GetTransform(), _gravity);
+	_numParticles = _simulation->GetParticleCount();
+}
+
+void ParticleSystem::_UpdateGpu()
 {
 	// If we haven't previously initialized our data, initialize it now
 	if (!_hasInit) {
@@ -61,8 +124,8 @@ void ParticleSystem::Update()
 		glBufferData(GL_ARRAY_BUFFER, dataSize, data, GL_DYNAMIC_DRAW);
 		glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, _particleBuffers[1]);
 
-		// We create a query object to track the number of particles we're simulating
-		glGenQueries(1, &_query);
+		// We create query objects to track the number of particles we're simulating
+		glGenQueries(QueryRingSize, _queries);
 
 		// We no longer need the CPU copy
 		delete[] data;
@@ -99,8 +162,15 @@ void ParticleSystem::Update()
 	_updateShader->SetUniform("u_Gravity", _gravity); 
 	_updateShader->SetUniformMatrix("u_ModelMatrix", GetGameObject()->GetTransform()); 
 
+	// If the GPU has fallen so far behind that every query is still in flight, we skip counting
+	// this frame rather than waiting for it
+	const int query = _queryTail;
+	const bool issueQuery = !_queryPending[query];
+	if (issueQuery) {
+		glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, _queries[query]);
+	}
+
 	// Our particles are points that we're simulating
-	glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, _query);
 	glBeginTransformFeedback(GL_POINTS);
 
 	// If this is our first pass, we use drawArrays to get the initial state, otherwise we use transform feedback for rendering
@@ -113,17 +183,15 @@ void ParticleSystem::Update()
 
 	// End of transform feedback
 	glEndTransformFeedback();
-	glEndQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
-
-	// Use our query to get the number of particles
-	glGetQueryObjectuiv(_query, GL_QUERY_RESULT, &_numParticles);
-	if (_numParticles >= _emitters.size()) {
-		_numParticles -= _emitters.size();
-	}
-	else {
-		_numParticles = 0;
+	if (issueQuery) {
+		glEndQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
+		_queryPending[query] = true;
+		_queryTail = (_queryTail + 1) % QueryRingSize;
 	}
 
+	// Grab the particle counts from any queries that have finished
+	_PollQueries();
+
 	// Clean up our state
 	glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
 
@@ -144,10 +212,52 @@ void ParticleSystem::Update()
 	_currentFeedbackBuffer = (_currentFeedbackBuffer + 1) & 0x01;
 }
 
+void ParticleSystem::_PollQueries()
+{
+	// Queries finish in the order they were issued, so we can stop at the first one that isn't ready
+	while (_queryPending[_queryHead]) {
+		GLuint available = GL_TRUE;
+		if (!_synchronousReadback) {
+			glGetQueryObjectuiv(_queries[_queryHead], GL_QUERY_RESULT_AVAILABLE, &available);
+		}
+		if (!available) {
+			break;
+		}
+
+		GLuint primitives = 0;
+		glGetQueryObjectuiv(_queries[_queryHead], GL_QUERY_RESULT, &primitives);
+		_numParticles = primitives >= _emitters.size() ? primitives - (GLuint)_emitters.size() : 0;
+
+		_queryPending[_queryHead] = false;
+		_queryHead = (_queryHead + 1) % QueryRingSize;
+	}
+}
+
 void ParticleSystem::Render()
 {
 	// Make sure that we've actually initialized our stuff
-	if (_hasInit) {
+	if (_hasInit && _backend == ParticleBackend::CPU) {
+		if (_numParticles == 0) {
+			return;
+		}
+
+		// Streamed ranges are only good for the frame they were made in, so we upload here rather
+		// than in Update, which doesn't run while the scene is paused
+		StreamingBuffer::Allocation vertices = StreamingBuffer::Get().Upload(_simulation->GetRenderData(),
+			_numParticles * sizeof(Gameplay::ParticleSimulation::RenderVertex));
+
+		_renderShader->Bind();
+
+		glEnablei(GL_BLEND, 0);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		// The CPU simulation only uploads live particles, so the type is the same for all of them
+		glVertexAttribI1ui(0, (GLuint)ParticleType::Particle);
+
+		_renderVao->SetVertexBufferRange(_renderBinding, vertices);
+		_renderVao->DrawRange(_numParticles, DrawMode::Points);
+	}
+	else if (_hasInit) {
 
 		// We're using our particle rendering shader
 		_renderShader->Bind();
@@ -199,6 +309,13 @@ void ParticleSystem::RenderImGui()
 
 	Application& app = Application::Get();
 
+	// Swapping backends would mean rebuilding all of our buffers, so only allow it before we start
+	if (!_hasInit) {
+		ENUM_COMBO("Backend", &_backend, ParticleBackend);
+	} else {
+		LABEL_LEFT(ImGui::LabelText, "Backend   ", "%s", (~_backend).c_str());
+	}
+
 	ImGui::Separator();
 	ImGui::Text("Emitters:");
 
@@ -275,7 +392,8 @@ void ParticleSystem::Awake()
 nlohmann::json ParticleSystem::ToJson() const {
 	nlohmann::json result = {
 		{ "gravity", _gravity },
-		{ "max_particles", _maxParticles }
+		{ "max_particles", _maxParticles },
+		{ "backend", ~_backend }
 	};
 
 	// Add emitters to the JSON data
@@ -300,6 +418,7 @@ ParticleSystem::Sptr ParticleSystem::FromJson(const nlohmann::json& blob) {
 
 	result->_gravity = JsonGet(blob, "gravity", result->_gravity);
 	result->_maxParticles = JsonGet(blob, "max_particled", result->_maxParticles);
+	result->_backend = JsonParseEnum(ParticleBackend, blob, "backend", ParticleBackend::GPU);
 
 	if (blob.contains("emitters") && blob["emitters"].is_array()) {
 		for (const auto& data : blob["emitters"]) {
@@ -1,12 +1,19 @@
 #pragma once
 #include "Gameplay/Components/IComponent.h"
 #include "Graphics/ShaderProgram.h"
+#include "Graphics/VertexArrayObject.h"
+#include "Gameplay/ParticleSimulation.h"
 
 ENUM(ParticleType, uint32_t,
 	Emitter       = 0,
 	Particle      = 1
 );
 
+ENUM(ParticleBackend, uint32_t,
+	GPU           = 0, // Simulated with transform feedback
+	CPU           = 1  // Simulated with Gameplay::ParticleSimulation, only the render data is uploaded
+);
+
 class ParticleSystem : public Gameplay::IComponent{
 public:
 	MAKE_PTRS(ParticleSystem);
@@ -17,6 +24,21 @@ public:
 	void Update();
 	void Render();
 
+	/// <summary>
+	/// Sets whether particles are simulated on the GPU or the CPU, can only be changed before
+	/// the system has been initialized
+	/// </summary>
+	void SetBackend(ParticleBackend value);
+	ParticleBackend GetBackend() const { return _backend; }
+
+	/// <summary>
+	/// If true, GPU particle systems wait for their particle count at the end of every update
+	/// instead of reading it back a few frames later. This stalls the CPU until the GPU catches
+	/// up, and is only meant for comparing against the default behaviour
+	/// </summary>
+	static void SetSynchronousReadback(bool value) { _synchronousReadback = value; }
+	static bool GetSynchronousReadback() { return _synchronousReadback; }
+
 	void AddEmitter(const glm::vec3& position, const glm::vec3& direction, float emitRate = 1.0f, const glm::vec4& color = glm::vec4(1.0f));
 
 	// Inherited from IComponent
@@ -40,13 +62,24 @@ protected:
 	};
 
 	bool _hasInit;
+	ParticleBackend _backend;
 
 	uint32_t _maxParticles;
 	GLuint _numParticles;
 
 	uint32_t _particleBuffers[2];
 	uint32_t _feedbackBuffers[2];
-	uint32_t _query;
+	// The number of frames that a particle count query can be in flight for before we stop
+	// issuing new ones, the GPU is rarely more than 2-3 frames behind
+	static constexpr int QueryRingSize = 4;
+	static bool _synchronousReadback;
+
+	// Particle counts are only used for bookkeeping, rendering always uses glDrawTransformFeedback,
+	// so we poll a ring of queries and keep the last count that the GPU gave us
+	uint32_t _queries[QueryRingSize];
+	bool     _queryPending[QueryRingSize];
+	int      _queryHead; // The oldest query that may still be pending
+	int      _queryTail; // The next query to issue
 
 	uint32_t _currentVertexBuffer;
 	uint32_t _currentFeedbackBuffer;
@@ -56,4 +89,15 @@ protected:
 	glm::vec3           _gravity;
 
 	std::vector<ParticleData> _emitters;
+
+	// Only used by the CPU backend
+	std::unique_ptr<Gameplay::ParticleSimulation> _simulation;
+	// The live particles are streamed into a new range every frame, so we only keep the layout
+	VertexArrayObject::Sptr _renderVao;
+	VertexArrayObject::VertexBufferBinding* _renderBinding;
+
+	void _UpdateGpu();
+	void _UpdateCpu();
+	// Reads back any particle count queries that the GPU has finished, without waiting
+	void _PollQueries();
 };
\ No newline at end of file
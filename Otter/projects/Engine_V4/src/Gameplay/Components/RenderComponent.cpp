@@ -7,13 +7,23 @@
 RenderComponent::RenderComponent(const Gameplay::MeshResource::Sptr& mesh, const Gameplay::Material::Sptr& material) :
 	_mesh(mesh), 
 	_material(material), 
-	_meshBuilderParams(std::vector<MeshBuilderParam>()) 
+	_meshBuilderParams(std::vector<MeshBuilderParam>()),
+	_cullingProxy(-1),
+	_cullingTransform(glm::mat4(0.0f)),
+	_cullingMesh(nullptr),
+	_cullingMorphState(),
+	_lastMovedFrame(0)
 { }
 
 RenderComponent::RenderComponent() : 
 	_mesh(nullptr), 
 	_material(nullptr), 
-	_meshBuilderParams(std::vector<MeshBuilderParam>())
+	_meshBuilderParams(std::vector<MeshBuilderParam>()),
+	_cullingProxy(-1),
+	_cullingTransform(glm::mat4(0.0f)),
+	_cullingMesh(nullptr),
+	_cullingMorphState(),
+	_lastMovedFrame(0)
 { }
 
 RenderComponent* RenderComponent::SetMesh(const Gameplay::MeshResource::Sptr& mesh) {
@@ -38,6 +48,15 @@ const Gameplay::Material::Sptr& RenderComponent::GetMaterial() const {
 	return _material;
 }
 
+RenderComponent* RenderComponent::SetMorphState(const Gameplay::MorphClip::FrameState& state) {
+	_morphState = state;
+	return this;
+}
+
+const Gameplay::MorphClip::FrameState& RenderComponent::GetMorphState() const {
+	return _morphState;
+}
+
 nlohmann::json RenderComponent::ToJson() const {
 	nlohmann::json result;
 	result["mesh"] = _mesh ? _mesh->GetGUID().str() : "null";
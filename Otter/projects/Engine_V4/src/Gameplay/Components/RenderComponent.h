@@ -3,6 +3,7 @@
 #include "Gameplay/MeshResource.h"
 #include "Gameplay/Material.h"
 #include "Utils/MeshFactory.h"
+#include "Gameplay/MorphClip.h"
 
 /// <summary>
 /// Provides information for a object to be rendered
@@ -42,6 +43,18 @@ public:
 	/// <param name="mat">The material for this object</param>
 	RenderComponent* SetMaterial(const Gameplay::Material::Sptr& mat);
 
+	/// <summary>
+	/// Sets the morph animation state that will be drawn for this object. This is stored with the
+	/// object's instance data rather than in it's material, so objects sharing a mesh and material
+	/// can all be drawn in a single instanced call while each plays their own frame
+	/// </summary>
+	/// <param name="state">The frame state from the clip being played</param>
+	RenderComponent* SetMorphState(const Gameplay::MorphClip::FrameState& state);
+	/// <summary>
+	/// Gets the morph animation state that will be drawn for this object
+	/// </summary>
+	const Gameplay::MorphClip::FrameState& GetMorphState() const;
+
 	// Inherited from IComponent
 
 	virtual void RenderImGui() override;
@@ -54,7 +67,21 @@ protected:
 	Gameplay::MeshResource::Sptr _mesh;
 	// The object's material
 	Gameplay::Material::Sptr      _material;
+	// The frame of the morph animation to draw, only used by morph shaders
+	Gameplay::MorphClip::FrameState _morphState;
 
 	// If we want to use MeshFactory, we can populate this list
 	std::vector<MeshBuilderParam> _meshBuilderParams;
+
+private:
+	friend class RenderLayer;
+
+	// State used by the render layer to keep this object's culling proxy up to date
+	int                _cullingProxy;
+	glm::mat4          _cullingTransform;
+	VertexArrayObject* _cullingMesh;
+	Gameplay::MorphClip::FrameState _cullingMorphState;
+	// The culling frame that the object last moved or animated on, objects that have been
+	// still for a while are treated as static shadow casters
+	uint32_t           _lastMovedFrame;
 };
\ No newline at end of file
@@ -12,11 +12,12 @@ ShadowCamera::ShadowCamera() :
 	NormalBias(0.0001f),
 	Intensity(1.0f),
 	Range(100.0f),
-	_depthBuffer(nullptr),
 	_projectionMask(nullptr),
 	_color(glm::vec4(1.0f)),
 	_bufferResolution(glm::ivec2(512)),
-	_projectionMatrix(glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f))
+	_projectionMatrix(glm::perspective(glm::radians(90.0f), 1.0f, 0.1f, 100.0f)),
+	_atlasTile(glm::ivec3(0)),
+	_atlasTexture(nullptr)
 { }
 
 ShadowCamera::~ShadowCamera() = default;
@@ -32,9 +33,6 @@ const glm::vec4& ShadowCamera::GetColor() const {
 void ShadowCamera::SetBufferResolution(const glm::ivec2 & value) {
 	LOG_ASSERT(value.x * value.y > 0, "Buffer size must be > 0");
 	_bufferResolution = value;
-	if (_depthBuffer != nullptr) {
-		_depthBuffer->Resize(value);
-	}
 }
 
 const glm::ivec2& ShadowCamera::GetBufferResolution() const {
@@ -65,18 +63,6 @@ const Texture2D::Sptr& ShadowCamera::GetProjectionMask() const {
 	return _projectionMask;
 }
 
-void ShadowCamera::OnLoad()
-{
-	LOG_ASSERT(_bufferResolution.x * _bufferResolution.y > 0, "Buffer size must be > 0");
-
-	FramebufferDescriptor desc;
-	desc.Width = _bufferResolution.x;
-	desc.Height = _bufferResolution.y;
-	desc.RenderTargets[RenderTargetAttachment::Depth] = RenderTargetDescriptor(RenderTargetType::Depth32);
-
-	_depthBuffer = std::make_shared<Framebuffer>(desc);
-}
-
 nlohmann::json ShadowCamera::ToJson() const
 {
 	return {
@@ -108,9 +94,9 @@ ShadowCamera::Sptr ShadowCamera::FromJson(const nlohmann::json & data)
 	return result;
 }
 
-const Framebuffer::Sptr& ShadowCamera::GetDepthBuffer() const
+const glm::ivec3& ShadowCamera::GetAtlasTile() const
 {
-	return _depthBuffer;
+	return _atlasTile;
 }
 
 void ShadowCamera::RenderImGui()
@@ -131,7 +117,7 @@ void ShadowCamera::RenderImGui()
 	}
 	ImGui::DragFloat("Bias", &Bias, 0.000001f, 0.0f, 0.1f, "%.9f");
 	ImGui::DragFloat("Normal Bias", &NormalBias, 0.000001f, 0.0f, 0.1f, "%.9f");
-	if (ImGui::DragInt2("Resolution", &_bufferResolution.x, 1.0f, 1, 1024)) {
+	if (ImGui::DragInt2("Max Resolution", &_bufferResolution.x, 1.0f, 1, 4096)) {
 		SetBufferResolution(_bufferResolution);
 	}
 
@@ -169,13 +155,21 @@ void ShadowCamera::RenderImGui()
 		if (ImGui::Checkbox("Show Depth", &checked)) {
 			ImGui::GetStateStorage()->SetBool(ImGui::GetID("show_depth"), checked);
 		}
-		if (_depthBuffer != nullptr && checked) {
-			Texture2D::Sptr depth = _depthBuffer->GetTextureAttachment(RenderTargetAttachment::Depth);
-
+		if (_atlasTile.z > 0) {
+			ImGui::Text("Atlas tile: %dx%d at (%d, %d)", _atlasTile.z, _atlasTile.z, _atlasTile.x, _atlasTile.y);
+		} else {
+			ImGui::Text("Atlas tile: none");
+		}
+		if (_atlasTexture != nullptr && _atlasTile.z > 0 && checked) {
 			int width = ImGui::GetContentRegionAvailWidth();
 
+			// Only show our part of the atlas
+			const glm::vec2 atlasSize = glm::vec2(_atlasTexture->GetWidth(), _atlasTexture->GetHeight());
+			const glm::vec2 uvMin = glm::vec2(_atlasTile.x, _atlasTile.y) / atlasSize;
+			const glm::vec2 uvMax = uvMin + glm::vec2(static_cast<float>(_atlasTile.z)) / atlasSize;
+
 			ImGui::Columns(1);
-			ImGuiHelper::DrawLinearDepthTexture(depth, glm::ivec2(width, width), 0.1f, 100.0f);
+			ImGuiHelper::DrawLinearDepthTexture(_atlasTexture, glm::ivec2(width, width), 0.1f, 100.0f, uvMin, uvMax);
 		}
 	}
 
@@ -13,8 +13,8 @@ ENUM_FLAGS(ShadowFlags, uint32_t,
 );
 
 /**
- * A camera with a depth buffer that lets us render shadows like a camera
- * Also contains color and projector mask info
+ * A camera that renders depth into a tile of the render layer's shadow atlas, so it can
+ * cast shadows. Also contains color and projector mask info
  */
 class ShadowCamera final : public Gameplay::IComponent {
 public:
@@ -45,12 +45,14 @@ public:
 	const glm::vec4& GetColor() const;
 
 	/// <summary>
-	/// Resizes this light's depth buffer, both dimensions must be non-zero
+	/// Sets the largest shadow map this light can have, both dimensions must be non-zero. Shadow
+	/// maps are square, so the larger dimension is used. The light may be given a smaller tile
+	/// in the shadow atlas when it covers less of the screen
 	/// </summary>
 	/// <param name="value">The new size of the buffer, in pixels</param>
 	void SetBufferResolution(const glm::ivec2& value);
 	/// <summary>
-	/// Returns the resolution of this light's depth buffer in pixels
+	/// Returns the largest resolution of this light's shadow map in pixels
 	/// </summary>
 	const glm::ivec2& GetBufferResolution() const;
 
@@ -80,27 +82,32 @@ public:
 	const Texture2D::Sptr& GetProjectionMask() const;
 
 	/// <summary>
-	/// Gets the shadow camera's depth buffer that it renders to
+	/// Gets the tile of the shadow atlas that this light rendered into last frame, as
+	/// (x, y, size) in pixels. The size is 0 if the light did not get a tile
 	/// </summary>
-	const Framebuffer::Sptr& GetDepthBuffer() const;
+	const glm::ivec3& GetAtlasTile() const;
 
 	// Inherited from IComponent
 
-	virtual void OnLoad();
 	virtual void RenderImGui() override;
 	virtual nlohmann::json ToJson() const override;
 	static ShadowCamera::Sptr FromJson(const nlohmann::json& data);
 	MAKE_TYPENAME(ShadowCamera);
 
 protected:
-	// Framebuffer we render into to get depth
-	Framebuffer::Sptr _depthBuffer;
 	// The image to project from this light
 	Texture2D::Sptr   _projectionMask;
 	// The color of the light
 	glm::vec4         _color;
-	// The resolution of _depthBuffer in pixels
+	// The largest resolution of the shadow map in pixels
 	glm::ivec2        _bufferResolution;
 	// The projection matrix of the light
 	glm::mat4         _projectionMatrix;
+
+private:
+	friend class RenderLayer;
+
+	// Where the render layer put us in the shadow atlas, for debugging
+	glm::ivec3        _atlasTile;
+	Texture2D::Sptr   _atlasTexture;
 };
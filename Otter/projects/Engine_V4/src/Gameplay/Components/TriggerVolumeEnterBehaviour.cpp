@@ -10,12 +10,12 @@ TriggerVolumeEnterBehaviour::~TriggerVolumeEnterBehaviour() = default;
 
 void TriggerVolumeEnterBehaviour::OnTriggerVolumeEntered(const std::shared_ptr<Gameplay::Physics::RigidBody>& body)
 {
-	LOG_INFO("Body has entered {} trigger volume: {}", GetGameObject()->Name, body->GetGameObject()->Name);
+	LOG_INFO("Body has entered {} trigger volume: {}", GetGameObject()->GetName(), body->GetGameObject()->GetName());
 	_playerInTrigger = true;
 }
 
 void TriggerVolumeEnterBehaviour::OnTriggerVolumeLeaving(const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
-	LOG_INFO("Body has left {} trigger volume: {}", GetGameObject()->Name, body->GetGameObject()->Name);
+	LOG_INFO("Body has left {} trigger volume: {}", GetGameObject()->GetName(), body->GetGameObject()->GetName());
 	_playerInTrigger = false;
 }
 
@@ -18,10 +18,11 @@
 namespace Gameplay {
 	GameObject::GameObject() :
 		IResource(),
-		Name("Unknown"),
 		HideInHierarchy(false),
 		_components(std::vector<IComponent::Sptr>()),
 		_scene(nullptr),
+		_name("Unknown"),
+		_sceneOrder(0),
 		_position(ZERO),
 		_rotation(glm::quat(glm::vec3(0.0f))),
 		_scale(ONE),
@@ -31,6 +32,8 @@ namespace Gameplay {
 		_worldTransform(MAT4_IDENTITY),
 		_inverseWorldTransform(MAT4_IDENTITY),
 		_isWorldTransformDirty(true),
+		_transformGeneration(1),
+		_transformHandle(TransformSystem::InvalidHandle),
 		_parent(WeakRef()),
 		_children(std::vector<WeakRef>())
 	{ }
@@ -76,6 +79,14 @@ namespace Gameplay {
 		}
 	}
 
+	void GameObject::_OnLocalTransformChanged() {
+		_isLocalTransformDirty = true;
+		_transformGeneration++;
+		if (_transformHandle != TransformSystem::InvalidHandle) {
+			_scene->_transforms.SetLocal(_transformHandle, _position, _rotation, _scale);
+		}
+	}
+
 	void GameObject::_PurgeDeletedChildren() {
 		auto it = std::remove_if(_children.begin(), _children.end(), [](WeakRef child) { 
 			return child == nullptr; 
@@ -115,7 +126,7 @@ namespace Gameplay {
 
 	void GameObject::SetPostion(const glm::vec3& position) {
 		_position = position;
-		_isLocalTransformDirty = true;
+		_OnLocalTransformChanged();
 	}
 
 	const glm::vec3& GameObject::GetPosition() const {
@@ -128,7 +139,7 @@ namespace Gameplay {
 
 	void GameObject::SetRotation(const glm::quat& value) {
 		_rotation = value;
-		_isLocalTransformDirty = true;
+		_OnLocalTransformChanged();
 	}
 
 	const glm::quat& GameObject::GetRotation() const {
@@ -137,7 +148,7 @@ namespace Gameplay {
 
 	void GameObject::SetRotation(const glm::vec3& eulerAngles) {
 		_rotation = glm::quat(glm::radians(eulerAngles));
-		_isLocalTransformDirty = true;
+		_OnLocalTransformChanged();
 	}
 
 	glm::vec3 GameObject::GetRotationEuler() const {
@@ -146,30 +157,50 @@ namespace Gameplay {
 
 	void GameObject::SetScale(const glm::vec3& value) {
 		_scale = value;
-		_isLocalTransformDirty = true;
+		_OnLocalTransformChanged();
 	}
 
 	const glm::vec3& GameObject::GetScale() const {
 		return _scale;
 	}
 
-	const glm::mat4& GameObject::GetTransform() const {
+	void GameObject::SetName(const std::string& name) {
+		if (_scene != nullptr) {
+			_scene->_RenameObject(this, name);
+		} else {
+			_name = name;
+		}
+	}
+
+	glm::mat4 GameObject::GetTransform() const {
+		if (_transformHandle != TransformSystem::InvalidHandle) {
+			return _scene->_transforms.GetWorldTransform(_transformHandle);
+		}
 		_RecalcWorldTransform();
 		return _worldTransform;
 	}
 
-	const glm::mat4& GameObject::GetInverseTransform() const {
+	glm::mat4 GameObject::GetInverseTransform() const {
+		if (_transformHandle != TransformSystem::InvalidHandle) {
+			return _scene->_transforms.GetInverseWorldTransform(_transformHandle);
+		}
 		_RecalcWorldTransform();
 		return _inverseWorldTransform;
 	}
 
-	const glm::mat4& GameObject::GetLocalTransform() const
+	glm::mat4 GameObject::GetLocalTransform() const
 	{
+		if (_transformHandle != TransformSystem::InvalidHandle) {
+			return _scene->_transforms.GetLocalTransform(_transformHandle);
+		}
 		_RecalcLocalTransform();
 		return _localTransform;
 	}
 
-	const glm::mat4& GameObject::GetInverseLocalTransform() const {
+	glm::mat4 GameObject::GetInverseLocalTransform() const {
+		if (_transformHandle != TransformSystem::InvalidHandle) {
+			return _scene->_transforms.GetInverseLocalTransform(_transformHandle);
+		}
 		_RecalcLocalTransform();
 		return _inverseLocalTransform;
 	}
@@ -236,8 +267,11 @@ namespace Gameplay {
 			}
 		}
 
-		_RecalcLocalTransform();
-		_RecalcWorldTransform();
+		// When using batched transforms, the scene will update all our transforms in one go
+		if (_transformHandle == TransformSystem::InvalidHandle) {
+			_RecalcLocalTransform();
+			_RecalcWorldTransform();
+		}
 		_PurgeDeletedChildren();
 	}
 
@@ -300,8 +334,11 @@ namespace Gameplay {
 			_children.push_back(child);
 			child->_parent = _selfRef.lock();
 			child->_isWorldTransformDirty = true;
+			if (child->_transformHandle != TransformSystem::InvalidHandle && _transformHandle != TransformSystem::InvalidHandle) {
+				_scene->_transforms.SetParent(child->_transformHandle, _transformHandle);
+			}
 		} else {
-			LOG_WARN("Attempting to add same child twice, ignoring: {}", child->Name);
+			LOG_WARN("Attempting to add same child twice, ignoring: {}", child->_name);
 		}
 	}
 
@@ -312,6 +349,10 @@ namespace Gameplay {
 		if (it != _children.end()) { 
 			// Clear the object's parent and remove from our list of children
 			child->_parent.Reset();
+			child->_isWorldTransformDirty = true;
+			if (child->_transformHandle != TransformSystem::InvalidHandle) {
+				_scene->_transforms.SetParent(child->_transformHandle, TransformSystem::InvalidHandle);
+			}
 			_children.erase(it);
 			return true;
 		} else {
@@ -335,16 +376,16 @@ namespace Gameplay {
 		ImGui::PushID(this); // Push a new ImGui ID scope for this object
 		// Since we're allowing names to change, we need to use the ### to have a static ID for the header
 		static char buffer[256];
-		sprintf_s(buffer, 256, "%s###GO_HEADER", Name.c_str());
+		sprintf_s(buffer, 256, "%s###GO_HEADER", _name.c_str());
 		if (ImGui::CollapsingHeader(buffer)) {
 			ImGui::Indent();
 
 			// Draw a textbox for our name
 			static char nameBuff[256];
-			memcpy(nameBuff, Name.c_str(), Name.size());
-			nameBuff[Name.size()] = '\0';
+			memcpy(nameBuff, _name.c_str(), _name.size());
+			nameBuff[_name.size()] = '\0';
 			if (ImGui::InputText("", nameBuff, 256)) {
-				Name = nameBuff;
+				SetName(nameBuff);
 			}
 			ImGui::SameLine();
 			if (ImGuiHelper::WarningButton("Delete")) {
@@ -374,7 +415,9 @@ namespace Gameplay {
 			}
 
 			// Render position label
-			_isLocalTransformDirty |= LABEL_LEFT(ImGui::DragFloat3, "Position", &_position.x, 0.01f);
+			if (LABEL_LEFT(ImGui::DragFloat3, "Position", &_position.x, 0.01f)) {
+				_OnLocalTransformChanged();
+			}
 			
 			// Get the ImGui storage state so we can avoid gimbal locking issues by storing euler angles in the editor
 			glm::vec3 euler = GetRotationEuler();
@@ -400,7 +443,9 @@ namespace Gameplay {
 			}
 			
 			// Draw the scale
-			_isLocalTransformDirty |= LABEL_LEFT(ImGui::DragFloat3, "Scale   ", &_scale.x, 0.01f, 0.0f);
+			if (LABEL_LEFT(ImGui::DragFloat3, "Scale   ", &_scale.x, 0.01f, 0.0f)) {
+				_OnLocalTransformChanged();
+			}
 
 			ImGui::Separator();
 			ImGui::TextUnformatted("Components");
@@ -460,8 +505,10 @@ namespace Gameplay {
 		ImGui::PopID(); // Pop the ImGui ID scope for the object
 
 		// For if we're not in play mode
-		_RecalcLocalTransform();
-		_RecalcWorldTransform();
+		if (_transformHandle == TransformSystem::InvalidHandle) {
+			_RecalcLocalTransform();
+			_RecalcWorldTransform();
+		}
 	}
 
 	std::shared_ptr<GameObject> GameObject::SelfRef() {
@@ -476,7 +523,7 @@ namespace Gameplay {
 		result->_scene = scene;
 
 		// Load in basic info
-		result->Name = data["name"];
+		result->_name = data["name"];
 		result->_guid = Guid(data["guid"]);
 		result->_parent = WeakRef(Guid(data.contains("parent") ? data["parent"] : "null"), nullptr);
 		result->_position = (data["position"]);
@@ -494,20 +541,24 @@ namespace Gameplay {
 			// based on the type name (note that all component types need to be
 			// registered at the start of the application)
 			IComponent::Sptr component = scene->Components().Load(typeName, value);
-			component->_context = result.get();
-
-			// Add component to object and allow it to perform self initialization
-			result->_components.push_back(component);
-			component->OnLoad();
+			result->_AttachLoadedComponent(component);
 		}
 
 		return result;
 	}
 
+	void GameObject::_AttachLoadedComponent(const IComponent::Sptr& component) {
+		component->_context = this;
+
+		// Add component to object and allow it to perform self initialization
+		_components.push_back(component);
+		component->OnLoad();
+	}
+
 	nlohmann::json GameObject::ToJson() const {
 		GameObject::Sptr parent = _parent;
 		nlohmann::json result = {
-			{ "name", Name },
+			{ "name", _name },
 			{ "guid", _guid.str() },
 			{ "position", _position },
 			{ "rotation", _rotation },
@@ -11,6 +11,7 @@
 // Others
 #include "Gameplay/Components/IComponent.h"
 #include "Gameplay/Components/ComponentManager.h"
+#include "Gameplay/TransformSystem.h"
 #include "Utils/ResourceManager/IResource.h"
 
 class InspectorWindow;
@@ -133,12 +134,18 @@ namespace Gameplay {
 			void Reset();
 		};
 
-		// Human readable name for the object
-		std::string             Name;
-
 		// Hack to hide instances from the hierarchy (like when adding lots of instances)
 		bool HideInHierarchy = false;
 
+		/// <summary>
+		/// Gets the human readable name for the object
+		/// </summary>
+		const std::string& GetName() const { return _name; }
+		/// <summary>
+		/// Renames the object, and updates the scene's name lookup if the object is in a scene
+		/// </summary>
+		void SetName(const std::string& name);
+
 		/// <summary>
 		/// Rotates this object to look at the given point in world coordinates
 		/// </summary>
@@ -212,19 +219,29 @@ namespace Gameplay {
 		/// </summary>
 		const glm::vec3& GetScale() const;
 
+		/// <summary>
+		/// Gets a counter that is incremented every time this object's position, rotation or
+		/// scale changes. Systems that mirror the transform (ex: physics) can store this value
+		/// and compare against it later to tell whether the object has moved
+		/// </summary>
+		uint32_t GetTransformGeneration() const { return _transformGeneration; }
+
 		/// <summary>
 		/// Gets or recalculates and gets the object's world transform
 		/// This matrix transforms points from local space to world space
+		///
+		/// Transforms are returned by value, since the scene's transform storage moves whenever
+		/// an object is created
 		/// </summary>
-		const glm::mat4& GetTransform() const;
+		glm::mat4 GetTransform() const;
 		/// <summary>
 		/// Gets or recalculates the inverse of this object's world transform
 		/// This matrix transforms points from world space to local space
 		/// </summary>
-		const glm::mat4& GetInverseTransform() const;
+		glm::mat4 GetInverseTransform() const;
 
-		const glm::mat4& GetLocalTransform() const;
-		const glm::mat4& GetInverseLocalTransform() const;
+		glm::mat4 GetLocalTransform() const;
+		glm::mat4 GetInverseLocalTransform() const;
 
 		/// <summary>
 		/// Allows components to render GUI elements to the screen
@@ -338,6 +355,7 @@ namespace Gameplay {
 
 	private:
 		friend class Scene;
+		friend class SceneBinaryLoader;
 		friend class InspectorWindow;
 		friend class HierarchyWindow;
 
@@ -357,6 +375,13 @@ namespace Gameplay {
 		mutable glm::mat4 _inverseWorldTransform;
 		mutable bool _isWorldTransformDirty;
 
+		// Incremented whenever our local transform is changed
+		uint32_t _transformGeneration;
+
+		// Handle to our transform in the scene's transform system, when the scene is using
+		// batched transforms. While this is valid, the transform matrices above are unused
+		TransformSystem::Handle _transformHandle;
+
 		// For the hierarchy
 		WeakRef _parent;
 		std::vector<WeakRef> _children;
@@ -370,6 +395,11 @@ namespace Gameplay {
 		// or load, we don't need to worry about ref counting
 		Scene* _scene;
 
+		// Human readable name for the object, see SetName
+		std::string _name;
+		// The order the object was added to the scene in, so the scene can resolve duplicate names
+		uint64_t    _sceneOrder;
+
 		/// <summary>
 		/// Only scenes will be allowed to create gameobjects
 		/// </summary>
@@ -378,8 +408,16 @@ namespace Gameplay {
 		// Recalculates the transform matrix for the object when required
 		void _RecalcLocalTransform() const;
 		void _RecalcWorldTransform() const;
+		// Marks our local transform as dirty, and pushes our TRS values to the transform system if required
+		void _OnLocalTransformChanged();
 
 		void _PurgeDeletedChildren();
+
+		/// <summary>
+		/// Attaches a component that was just loaded to this object, and lets it perform
+		/// self initialization
+		/// </summary>
+		void _AttachLoadedComponent(const IComponent::Sptr& component);
 	};
 
 }
\ No newline at end of file
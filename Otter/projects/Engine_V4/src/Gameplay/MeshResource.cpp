@@ -1,7 +1,9 @@
 #include "MeshResource.h"
 #include <filesystem>
 
-#include "Utils/ObjLoader.h"
+#include "Utils/OptimizedObjLoader.h"
+#include "Utils/ObjParser.h"
+#include "Gameplay/Physics/CollisionMeshCache.h"
 
 namespace Gameplay {
 	MeshResource::MeshResource() :
@@ -9,7 +11,9 @@ namespace Gameplay {
 		Filename(""),
 		MeshBuilderParams(std::vector<MeshBuilderParam>()),
 		Mesh(nullptr),
-		BulletTriMesh(nullptr)
+		CollisionHull(nullptr),
+		CollisionPositions(std::vector<glm::vec3>()),
+		CollisionIndices(std::vector<uint32_t>())
 	{ }
 
 	MeshResource::MeshResource(const std::string& filename) :
@@ -17,9 +21,11 @@ namespace Gameplay {
 		Filename(filename),
 		MeshBuilderParams(std::vector<MeshBuilderParam>()),
 		Mesh(nullptr),
-		BulletTriMesh(nullptr)
+		CollisionHull(nullptr),
+		CollisionPositions(std::vector<glm::vec3>()),
+		CollisionIndices(std::vector<uint32_t>())
 	{
-		Mesh = ObjLoader::LoadFromFile(filename);
+		_LoadFromFile(filename);
 	}
 
 	MeshResource::~MeshResource() = default;
@@ -41,27 +47,41 @@ namespace Gameplay {
 
 	MeshResource::Sptr MeshResource::FromJson(const nlohmann::json & blob)
 	{
-		MeshResource::Sptr result = std::make_shared<MeshResource>();
+		return FromDecoded(blob, DecodeFromJson(blob));
+	}
+
+	std::shared_ptr<MeshResource::DecodedData> MeshResource::DecodeFromJson(const nlohmann::json& blob) {
+		std::shared_ptr<DecodedData> result = std::make_shared<DecodedData>();
 		if (blob.contains("params") && blob["params"].is_array()) {
 			std::vector<nlohmann::json> meshbuilderParams = blob["params"].get<std::vector<nlohmann::json>>();
-			MeshBuilder<VertexPosNormTexColTangents> mesh;
 			for (int ix = 0; ix < meshbuilderParams.size(); ix++) {
 				MeshBuilderParam p = MeshBuilderParam::FromJson(meshbuilderParams[ix]);
-				result->MeshBuilderParams.push_back(p);
-				MeshFactory::AddParameterized(mesh, p);
+				result->Params.push_back(p);
+				MeshFactory::AddParameterized(result->Mesh, p);
 			}
-			MeshFactory::CalculateTBN(mesh);
-			result->Mesh = mesh.Bake();
+			MeshFactory::CalculateTBN(result->Mesh);
+			result->HasMesh = true;
+			_ExtractCollisionData(result->Mesh, result->Positions, result->Indices);
 		} else {
 			result->Filename = JsonGet<std::string>(blob, "filename", "null");
-			if (result->Filename != "null" && std::filesystem::exists(result->Filename)) {
-				#ifdef OPTIMIZED_OBJ_LOADER
-				result->Mesh = OptimizedObjLoader::LoadFromFile(result->Filename);
-				#else
-				result->Mesh = ObjLoader::LoadFromFile(result->Filename);
-				#endif
+		}
+		return result;
+	}
 
-			}
+	MeshResource::Sptr MeshResource::FromDecoded(const nlohmann::json& blob, const std::shared_ptr<DecodedData>& decoded) {
+		MeshResource::Sptr result = std::make_shared<MeshResource>();
+		result->MeshBuilderParams = decoded->Params;
+		if (decoded->Params.empty()) {
+			result->Filename = decoded->Filename;
+		}
+
+		if (decoded->HasMesh) {
+			result->Mesh = decoded->Mesh.Bake();
+			result->CollisionPositions = std::move(decoded->Positions);
+			result->CollisionIndices = std::move(decoded->Indices);
+		}
+		else if (result->Filename != "null" && std::filesystem::exists(result->Filename)) {
+			result->_LoadFromFile(result->Filename);
 		}
 		return result;
 	}
@@ -73,9 +93,43 @@ namespace Gameplay {
 		}
 		MeshFactory::CalculateTBN(mesh);
 		Mesh = mesh.Bake();
+		_ExtractCollisionData(mesh, CollisionPositions, CollisionIndices);
+		CollisionHull = nullptr;
 	}
 
 	void MeshResource::AddParam(const MeshBuilderParam & param) {
 		MeshBuilderParams.push_back(param);
 	}
-}
\ No newline at end of file
+
+	void MeshResource::_LoadFromFile(const std::string& filename) {
+		// The binary loader throws if it can't open the file, ex: if the converted file couldn't be written
+		try {
+			Mesh = OptimizedObjLoader::LoadFromFile(filename);
+		} catch (const std::exception& e) {
+			LOG_WARN("Failed to load binary mesh for \"{}\": {}", filename, e.what());
+			Mesh = nullptr;
+		}
+		if (Mesh != nullptr) {
+			// Colliders will be cooked from the source file, see CollisionMeshCache
+			return;
+		}
+
+		LOG_WARN("Falling back to parsing \"{}\" as an OBJ file", filename);
+		ObjParseResult data;
+		if (ObjParser::Parse(filename, data)) {
+			MeshBuilder<VertexPosNormTexColTangents> mesh;
+			ObjParser::BuildMesh(data, mesh);
+			Mesh = mesh.Bake();
+			_ExtractCollisionData(mesh, CollisionPositions, CollisionIndices);
+		}
+	}
+
+	void MeshResource::_ExtractCollisionData(const MeshBuilder<VertexPosNormTexColTangents>& mesh, std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices) {
+		const VertexPosNormTexColTangents* vertices = mesh.GetVertexDataPtr();
+		positions.resize(mesh.GetVertexCount());
+		for (size_t ix = 0; ix < positions.size(); ix++) {
+			positions[ix] = vertices[ix].Position;
+		}
+		indices.assign(mesh.GetIndexDataPtr(), mesh.GetIndexDataPtr() + mesh.GetIndexCount());
+	}
+}
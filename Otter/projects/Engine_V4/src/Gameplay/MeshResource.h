@@ -3,10 +3,11 @@
 #include "Graphics/VertexArrayObject.h"
 #include "Utils/MeshFactory.h"
 
-// bullet triangle mesh pre-declaration
-class btTriangleMesh;
-
 namespace Gameplay {
+	namespace Physics {
+		struct CookedHull;
+	}
+
 	/// <summary>
 	/// A mesh resource contains information on how to generate a VAO at runtime
 	/// It can either load a VAO from a file, or generate one using the mesh 
@@ -49,9 +50,15 @@ namespace Gameplay {
 		/// </summary>
 		MeshResource::Sptr             ColliderMeshData;
 		/// <summary>
-		/// Allows for bullet to generate a triangle mesh from this mesh and cache it
+		/// The convex hull cooked from this mesh for mesh colliders, see CollisionMeshCache
 		/// </summary>
-		std::shared_ptr<btTriangleMesh> BulletTriMesh;
+		std::shared_ptr<Physics::CookedHull> CollisionHull;
+		/// <summary>
+		/// Vertex positions and triangle indices kept on the CPU, so that colliders can be cooked
+		/// without reading the mesh back from OpenGL. Empty if the mesh was loaded straight into OpenGL
+		/// </summary>
+		std::vector<glm::vec3>          CollisionPositions;
+		std::vector<uint32_t>           CollisionIndices;
 
 		/// <summary>
 		/// Generates a new mesh from the mesh builder parameters
@@ -62,10 +69,49 @@ namespace Gameplay {
 		/// </summary>
 		/// <param name="param">The parameter to add</param>
 		void AddParam(const MeshBuilderParam& param);
+		/// <summary>
+		/// Gets the object-space bounds of the mesh, or an invalid box if the mesh has not been loaded
+		/// </summary>
+		AABB GetBounds() const { return Mesh != nullptr ? Mesh->GetBounds() : AABB(); }
+
+		/// <summary>
+		/// Mesh data that has been loaded or generated on the CPU, but not yet uploaded to OpenGL
+		/// </summary>
+		struct DecodedData {
+			std::string                              Filename;
+			std::vector<MeshBuilderParam>            Params;
+			MeshBuilder<VertexPosNormTexColTangents> Mesh;
+			// True if Mesh contains the data to upload
+			bool                                     HasMesh = false;
+			// The positions and indices to keep for cooking colliders
+			std::vector<glm::vec3>                   Positions;
+			std::vector<uint32_t>                    Indices;
+		};
 
 		// Inherited from IResource
 
 		virtual nlohmann::json ToJson() const override;
 		static MeshResource::Sptr FromJson(const nlohmann::json& blob);
+		/// <summary>
+		/// Runs the mesh builder params from a JSON blob, without touching OpenGL so it is safe to
+		/// call from any thread. Meshes from files are loaded in FromDecoded, since binary meshes
+		/// are mapped straight into their buffers
+		/// </summary>
+		static std::shared_ptr<DecodedData> DecodeFromJson(const nlohmann::json& blob);
+		/// <summary>
+		/// Creates the mesh resource from data produced by DecodeFromJson, must be called on the main thread
+		/// </summary>
+		static MeshResource::Sptr FromDecoded(const nlohmann::json& blob, const std::shared_ptr<DecodedData>& decoded);
+
+	protected:
+		/// <summary>
+		/// Loads the mesh from a file through the binary mesh loader, converting OBJ files to binary
+		/// meshes the first time they are loaded. Falls back to parsing the OBJ file if that fails
+		/// </summary>
+		void _LoadFromFile(const std::string& filename);
+		/// <summary>
+		/// Copies the positions and indices out of a mesh builder, for cooking colliders later
+		/// </summary>
+		static void _ExtractCollisionData(const MeshBuilder<VertexPosNormTexColTangents>& mesh, std::vector<glm::vec3>& positions, std::vector<uint32_t>& indices);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,323 @@
+#include "Gameplay/MorphClip.h"
+
+#include <fstream>
+#include <cstring>
+
+#include "Utils/ObjParser.h"
+#include "Utils/JsonGlmHelpers.h"
+#include "Logging.h"
+
+namespace Gameplay {
+	ShaderStorageBuffer::Sptr MorphClip::_pool = nullptr;
+	uint32_t MorphClip::_poolSize = 0;
+	uint32_t MorphClip::_poolCapacity = 0;
+	uint32_t MorphClip::_liveClips = 0;
+
+	// Packs a float in the -1 to 1 range into a signed normalized integer, same as GLSL's packSnorm
+	static uint32_t PackSnorm(float value, float maxValue) {
+		const int result = static_cast<int>(glm::round(glm::clamp(value, -1.0f, 1.0f) * maxValue));
+		return static_cast<uint32_t>(result);
+	}
+
+	// Encodes a unit vector onto an octahedron, so that it can be stored in 2 components
+	static glm::vec2 EncodeOctahedral(const glm::vec3& normal) {
+		glm::vec3 n = normal / glm::max(glm::abs(normal.x) + glm::abs(normal.y) + glm::abs(normal.z), 0.0001f);
+		glm::vec2 result = glm::vec2(n.x, n.y);
+		if (n.z < 0.0f) {
+			const glm::vec2 sign = glm::vec2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+			result = (1.0f - glm::abs(glm::vec2(n.y, n.x))) * sign;
+		}
+		return result;
+	}
+
+	MorphClip::MorphClip() :
+		IResource(),
+		Filename(""),
+		FrameFiles(std::vector<std::string>()),
+		_vertexCount(0),
+		_frameCount(0),
+		_frameTime(1.0f),
+		_encoding(MorphClipEncoding::Float),
+		_scale(glm::vec3(0.0f)),
+		_data(std::vector<uint32_t>()),
+		_poolOffset(0),
+		_wordCount(0),
+		_isUploaded(false)
+	{ }
+
+	MorphClip::MorphClip(const std::string& filename) :
+		MorphClip()
+	{
+		Filename = filename;
+		if (_Load(filename)) {
+			_Upload();
+		}
+	}
+
+	MorphClip::MorphClip(const std::vector<std::string>& frameFiles, float frameTime, MorphClipEncoding encoding) :
+		MorphClip()
+	{
+		FrameFiles = frameFiles;
+		if (_PackObjFrames(frameFiles, frameTime, encoding)) {
+			_Upload();
+		}
+	}
+
+	MorphClip::~MorphClip() {
+		if (!_isUploaded) {
+			return;
+		}
+
+		// We don't move other clips around, but if we were the last clip to be added we can give
+		// our space back. Once every clip is gone the whole pool can be reused
+		if (_poolOffset + _wordCount == _poolSize) {
+			_poolSize = _poolOffset;
+		}
+		_liveClips--;
+		if (_liveClips == 0) {
+			_poolSize = 0;
+		}
+	}
+
+	MorphClip::FrameState MorphClip::GetFrameState(float frame, bool loop) const {
+		FrameState result;
+		if (!_isUploaded) {
+			return result;
+		}
+
+		uint32_t frame0 = 0, frame1 = 0;
+		float blend = 0.0f;
+		if (loop) {
+			const float wrapped = glm::mod(glm::max(frame, 0.0f), static_cast<float>(_frameCount));
+			frame0 = glm::min(static_cast<uint32_t>(wrapped), _frameCount - 1);
+			frame1 = (frame0 + 1) % _frameCount;
+			blend  = wrapped - frame0;
+		} else {
+			const float clamped = glm::clamp(frame, 0.0f, static_cast<float>(_frameCount - 1));
+			frame0 = static_cast<uint32_t>(clamped);
+			frame1 = glm::min(frame0 + 1, _frameCount - 1);
+			blend  = clamped - frame0;
+		}
+
+		result.Offsets = glm::uvec4(_GetFrameOffset(frame0), _GetFrameOffset(frame1), _poolOffset, static_cast<uint32_t>(_encoding));
+		result.ScaleBlend = glm::vec4(_scale, blend);
+		return result;
+	}
+
+	std::vector<std::string> MorphClip::GetFrameSequence(const std::string& prefix, int count, int first, int digits, const std::string& suffix) {
+		std::vector<std::string> result;
+		result.reserve(count);
+		for (int ix = 0; ix < count; ix++) {
+			result.push_back(fmt::format("{}{:0{}}{}", prefix, first + ix, digits, suffix));
+		}
+		return result;
+	}
+
+	bool MorphClip::Convert(const std::vector<std::string>& frameFiles, float frameTime, MorphClipEncoding encoding, const std::string& outPath) {
+		MorphClip clip;
+		if (!clip._PackObjFrames(frameFiles, frameTime, encoding)) {
+			return false;
+		}
+		if (!clip._Save(outPath)) {
+			LOG_ERROR("Failed to write morph clip \"{}\"", outPath);
+			return false;
+		}
+		LOG_INFO("Packed {} frames ({} vertices) into \"{}\" ({} KB)", clip._frameCount, clip._vertexCount, outPath, clip._data.size() * sizeof(uint32_t) / 1024);
+		return true;
+	}
+
+	void MorphClip::BindPool(uint32_t slot) {
+		if (_pool != nullptr) {
+			_pool->Bind(slot);
+		}
+	}
+
+	nlohmann::json MorphClip::ToJson() const {
+		nlohmann::json result;
+		if (!Filename.empty()) {
+			result["filename"] = Filename;
+		} else {
+			result["frames"] = FrameFiles;
+			result["frame_time"] = _frameTime;
+			result["encoding"] = ~_encoding;
+		}
+		return result;
+	}
+
+	MorphClip::Sptr MorphClip::FromJson(const nlohmann::json& blob) {
+		if (blob.contains("filename")) {
+			return std::make_shared<MorphClip>(blob["filename"].get<std::string>());
+		}
+		return std::make_shared<MorphClip>(
+			JsonGet(blob, "frames", std::vector<std::string>()),
+			JsonGet(blob, "frame_time", 1.0f),
+			JsonParseEnum(MorphClipEncoding, blob, "encoding", MorphClipEncoding::Quantized));
+	}
+
+	bool MorphClip::_PackObjFrames(const std::vector<std::string>& frameFiles, float frameTime, MorphClipEncoding encoding) {
+		if (frameFiles.empty()) {
+			LOG_WARN("Morph clip has no frames");
+			return false;
+		}
+
+		// Pull out the positions and normals for each frame, in the same order that ObjParser::BuildMesh
+		// gives the mesh's vertices
+		std::vector<std::vector<glm::vec3>> positions(frameFiles.size());
+		std::vector<std::vector<glm::vec3>> normals(frameFiles.size());
+		for (size_t frame = 0; frame < frameFiles.size(); frame++) {
+			ObjParseResult data;
+			if (!ObjParser::Parse(frameFiles[frame], data)) {
+				LOG_WARN("Failed to open morph frame \"{}\"", frameFiles[frame]);
+				return false;
+			}
+			if (frame > 0 && data.Vertices.size() != positions[0].size()) {
+				LOG_WARN("Morph frame \"{}\" has {} vertices, expected {}", frameFiles[frame], data.Vertices.size(), positions[0].size());
+				return false;
+			}
+
+			positions[frame].resize(data.Vertices.size());
+			normals[frame].resize(data.Vertices.size());
+			for (size_t ix = 0; ix < data.Vertices.size(); ix++) {
+				const glm::ivec3& vertexIndices = data.Vertices[ix];
+				positions[frame][ix] = vertexIndices.x >= 0 ? data.Positions[vertexIndices.x] : glm::vec3(0.0f);
+				normals[frame][ix]   = vertexIndices.z >= 0 ? data.Normals[vertexIndices.z] : glm::vec3(0.0f, 0.0f, 1.0f);
+			}
+		}
+
+		_vertexCount = static_cast<uint32_t>(positions[0].size());
+		_frameCount  = static_cast<uint32_t>(frameFiles.size());
+		_frameTime   = frameTime;
+		_encoding    = encoding;
+		_scale       = glm::vec3(0.0f);
+
+		// Writes a full precision position and normal
+		auto writeFloat = [](uint32_t* out, const glm::vec3& position, const glm::vec3& normal) {
+			memcpy(out, &position, sizeof(glm::vec3));
+			memcpy(out + 3, &normal, sizeof(glm::vec3));
+		};
+
+		if (encoding == MorphClipEncoding::Float) {
+			_data.resize(static_cast<size_t>(_frameCount) * _vertexCount * FloatVertexWords);
+			for (uint32_t frame = 0; frame < _frameCount; frame++) {
+				uint32_t* out = _data.data() + static_cast<size_t>(frame) * _vertexCount * FloatVertexWords;
+				for (uint32_t ix = 0; ix < _vertexCount; ix++) {
+					writeFloat(out + ix * FloatVertexWords, positions[frame][ix], normals[frame][ix]);
+				}
+			}
+		} else {
+			// Store the first frame at full precision, every frame is stored as a delta from it
+			const std::vector<glm::vec3>& rest = positions[0];
+			for (uint32_t frame = 1; frame < _frameCount; frame++) {
+				for (uint32_t ix = 0; ix < _vertexCount; ix++) {
+					_scale = glm::max(_scale, glm::abs(positions[frame][ix] - rest[ix]));
+				}
+			}
+			_scale = glm::max(_scale, glm::vec3(0.000001f));
+
+			_data.resize(static_cast<size_t>(_vertexCount) * FloatVertexWords + static_cast<size_t>(_frameCount) * _vertexCount * QuantizedVertexWords);
+			for (uint32_t ix = 0; ix < _vertexCount; ix++) {
+				writeFloat(_data.data() + ix * FloatVertexWords, rest[ix], normals[0][ix]);
+			}
+			for (uint32_t frame = 0; frame < _frameCount; frame++) {
+				uint32_t* out = _data.data() + static_cast<size_t>(_vertexCount) * FloatVertexWords + static_cast<size_t>(frame) * _vertexCount * QuantizedVertexWords;
+				for (uint32_t ix = 0; ix < _vertexCount; ix++) {
+					const glm::vec3 delta  = (positions[frame][ix] - rest[ix]) / _scale;
+					const glm::vec2 normal = EncodeOctahedral(glm::normalize(normals[frame][ix]));
+
+					// x | y, then z | octahedral normal as 2 bytes
+					out[ix * 2 + 0] = (PackSnorm(delta.x, 32767.0f) & 0xFFFF) | (PackSnorm(delta.y, 32767.0f) << 16);
+					out[ix * 2 + 1] = (PackSnorm(delta.z, 32767.0f) & 0xFFFF) |
+						((PackSnorm(normal.x, 127.0f) & 0xFF) << 16) | ((PackSnorm(normal.y, 127.0f) & 0xFF) << 24);
+				}
+			}
+		}
+
+		_wordCount = static_cast<uint32_t>(_data.size());
+		return true;
+	}
+
+	bool MorphClip::_Load(const std::string& path) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			LOG_WARN("Failed to open morph clip \"{}\"", path);
+			return false;
+		}
+
+		MorphFileHeader header;
+		MorphFileHeader expected;
+		file.read(reinterpret_cast<char*>(&header), sizeof(MorphFileHeader));
+		if (!file || memcmp(header.HeaderBytes, expected.HeaderBytes, 4) != 0 || header.Version != Version) {
+			LOG_WARN("\"{}\" is not a valid morph clip, or was packed with an older version", path);
+			return false;
+		}
+
+		_data.resize(header.WordCount);
+		file.read(reinterpret_cast<char*>(_data.data()), header.WordCount * sizeof(uint32_t));
+		if (!file) {
+			LOG_WARN("Morph clip \"{}\" is truncated", path);
+			_data.clear();
+			return false;
+		}
+
+		_vertexCount = header.VertexCount;
+		_frameCount  = header.FrameCount;
+		_frameTime   = header.FrameTime;
+		_encoding    = header.Encoding;
+		_scale       = header.Scale;
+		_wordCount   = header.WordCount;
+		return true;
+	}
+
+	bool MorphClip::_Save(const std::string& path) const {
+		std::ofstream file(path, std::ios::binary);
+		if (!file) {
+			return false;
+		}
+
+		MorphFileHeader header;
+		header.Encoding    = _encoding;
+		header.VertexCount = _vertexCount;
+		header.FrameCount  = _frameCount;
+		header.FrameTime   = _frameTime;
+		header.Scale       = _scale;
+		header.WordCount   = static_cast<uint32_t>(_data.size());
+		file.write(reinterpret_cast<const char*>(&header), sizeof(MorphFileHeader));
+		file.write(reinterpret_cast<const char*>(_data.data()), _data.size() * sizeof(uint32_t));
+		return static_cast<bool>(file);
+	}
+
+	void MorphClip::_Upload() {
+		if (_pool == nullptr) {
+			_pool = ShaderStorageBuffer::Create(BufferUsage::StaticDraw);
+		}
+
+		// Grow the pool, copying the clips we already have over to the new buffer
+		if (_poolSize + _wordCount > _poolCapacity) {
+			const uint32_t capacity = glm::max(_poolSize + _wordCount, _poolCapacity * 2);
+			ShaderStorageBuffer::Sptr pool = ShaderStorageBuffer::Create(BufferUsage::StaticDraw);
+			pool->LoadData<uint32_t>(nullptr, capacity);
+			if (_poolSize > 0) {
+				glCopyNamedBufferSubData(_pool->GetHandle(), pool->GetHandle(), 0, 0, _poolSize * sizeof(uint32_t));
+			}
+			_pool = pool;
+			_poolCapacity = capacity;
+		}
+
+		_poolOffset = _poolSize;
+		glNamedBufferSubData(_pool->GetHandle(), _poolOffset * sizeof(uint32_t), _wordCount * sizeof(uint32_t), _data.data());
+		_poolSize += _wordCount;
+		_liveClips++;
+		_isUploaded = true;
+
+		// The GPU has it's own copy now
+		_data.clear();
+		_data.shrink_to_fit();
+	}
+
+	uint32_t MorphClip::_GetFrameOffset(uint32_t frame) const {
+		if (_encoding == MorphClipEncoding::Float) {
+			return _poolOffset + frame * _vertexCount * FloatVertexWords;
+		}
+		return _poolOffset + _vertexCount * FloatVertexWords + frame * _vertexCount * QuantizedVertexWords;
+	}
+}
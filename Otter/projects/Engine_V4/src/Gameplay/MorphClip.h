@@ -0,0 +1,173 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include <EnumToString.h>
+#include "GLM/glm.hpp"
+
+#include "Utils/ResourceManager/IResource.h"
+#include "Graphics/Buffers/ShaderStorageBuffer.h"
+
+ENUM(MorphClipEncoding, int,
+	Float     = 0, // Full precision positions and normals, 24 bytes per vertex per frame
+	Quantized = 1  // 16 bit position deltas from the first frame and 8 bit octahedral normals, 8 bytes per vertex per frame
+);
+
+namespace Gameplay {
+	/// <summary>
+	/// A morph target animation clip, with the positions and normals for every keyframe packed
+	/// into a single buffer on the GPU
+	///
+	/// All clips share one shader storage buffer (b_MorphData in fragments/morph_targets.glsl),
+	/// so switching between clips or animating an object only changes a few offsets, the mesh
+	/// being drawn is never touched. Vertices are looked up by gl_VertexID, so the clip must
+	/// have the same vertices in the same order as the mesh it is drawn with. This is the case
+	/// for OBJ frame sequences exported from the same model
+	///
+	/// Clips can be packed from OBJ frame sequences when they are loaded, or converted ahead of
+	/// time into .morph files with Convert (see --pack-morph in entry_point.cpp)
+	/// </summary>
+	class MorphClip : public IResource {
+	public:
+		typedef std::shared_ptr<MorphClip> Sptr;
+
+		// The version of the .morph files we write, files with other versions will not be loaded
+		static constexpr uint32_t Version = 1;
+		// The file extension used for packed clips
+		static constexpr const char* Extension = ".morph";
+
+		/// <summary>
+		/// The state needed to draw a single frame of the clip, matches the layout that
+		/// fragments/morph_targets.glsl expects
+		/// </summary>
+		struct FrameState {
+			// x and y are the offsets of the two frames we are blending between, z is the offset of
+			// the rest pose for quantized clips, and w is the encoding
+			glm::uvec4 Offsets = glm::uvec4(0);
+			// xyz is the scale for quantized position deltas, w is the blend between the frames
+			glm::vec4  ScaleBlend = glm::vec4(0.0f);
+		};
+
+		MorphClip();
+		/// <summary>
+		/// Loads a clip from a packed .morph file
+		/// </summary>
+		MorphClip(const std::string& filename);
+		/// <summary>
+		/// Packs a clip from a sequence of OBJ files, one per frame
+		/// </summary>
+		/// <param name="frameFiles">The OBJ files for each frame, in order</param>
+		/// <param name="frameTime">The time between frames, in seconds</param>
+		/// <param name="encoding">How to store the frames on the GPU</param>
+		MorphClip(const std::vector<std::string>& frameFiles, float frameTime, MorphClipEncoding encoding = MorphClipEncoding::Quantized);
+		virtual ~MorphClip();
+
+		/// <summary>
+		/// The .morph file the clip was loaded from, or empty if it was packed from FrameFiles
+		/// </summary>
+		std::string              Filename;
+		/// <summary>
+		/// The OBJ files that the clip was packed from, if it wasn't loaded from a .morph file
+		/// </summary>
+		std::vector<std::string> FrameFiles;
+
+		uint32_t GetVertexCount() const { return _vertexCount; }
+		uint32_t GetFrameCount() const { return _frameCount; }
+		MorphClipEncoding GetEncoding() const { return _encoding; }
+		/// <summary>
+		/// Gets or sets the default time between frames, in seconds
+		/// </summary>
+		float GetFrameTime() const { return _frameTime; }
+		void SetFrameTime(float value) { _frameTime = value; }
+		/// <summary>
+		/// Gets the size of the packed frames on the GPU, in bytes
+		/// </summary>
+		size_t GetSizeInBytes() const { return _wordCount * sizeof(uint32_t); }
+
+		/// <summary>
+		/// Gets the state for drawing the clip at the given point in time
+		/// </summary>
+		/// <param name="frame">The frame to draw, the fractional part blends into the next frame</param>
+		/// <param name="loop">True if the last frame should blend back into the first</param>
+		FrameState GetFrameState(float frame, bool loop = true) const;
+
+		/// <summary>
+		/// Builds a list of numbered frame files, ex: GetFrameSequence("Birdfly_", 20) gives
+		/// Birdfly_000001.obj to Birdfly_000020.obj
+		/// </summary>
+		/// <param name="prefix">The path up to the frame number</param>
+		/// <param name="count">The number of frames</param>
+		/// <param name="first">The number of the first frame</param>
+		/// <param name="digits">The number of digits to pad the frame number to</param>
+		/// <param name="suffix">The text after the frame number</param>
+		static std::vector<std::string> GetFrameSequence(const std::string& prefix, int count, int first = 1, int digits = 6, const std::string& suffix = ".obj");
+
+		/// <summary>
+		/// Packs a sequence of OBJ files into a .morph file, without needing an OpenGL context
+		/// </summary>
+		/// <returns>True if the clip was packed and saved</returns>
+		static bool Convert(const std::vector<std::string>& frameFiles, float frameTime, MorphClipEncoding encoding, const std::string& outPath);
+
+		/// <summary>
+		/// Binds the buffer holding every loaded clip to the given shader storage slot
+		/// </summary>
+		static void BindPool(uint32_t slot);
+
+		// Inherited from IResource
+
+		virtual nlohmann::json ToJson() const override;
+		static MorphClip::Sptr FromJson(const nlohmann::json& blob);
+
+	protected:
+		struct MorphFileHeader {
+			char              HeaderBytes[4] = { 'O', 'M', 'P', 'H' };
+			uint32_t          Version = MorphClip::Version;
+			MorphClipEncoding Encoding = MorphClipEncoding::Float;
+			uint32_t          VertexCount = 0;
+			uint32_t          FrameCount = 0;
+			float             FrameTime = 0.0f;
+			glm::vec3         Scale = glm::vec3(0.0f);
+			uint32_t          WordCount = 0;
+		};
+
+		// The number of 32 bit words used by a vertex in a single frame
+		static constexpr uint32_t FloatVertexWords = 6;
+		static constexpr uint32_t QuantizedVertexWords = 2;
+
+		uint32_t              _vertexCount;
+		uint32_t              _frameCount;
+		float                 _frameTime;
+		MorphClipEncoding     _encoding;
+		// The range of the quantized position deltas
+		glm::vec3             _scale;
+
+		// The packed frames, only kept on the CPU until they have been uploaded
+		std::vector<uint32_t> _data;
+		// Where our data lives in the pool, in 32 bit words
+		uint32_t              _poolOffset;
+		uint32_t              _wordCount;
+		bool                  _isUploaded;
+
+		// Every clip's frames are packed into this buffer, back to back
+		static ShaderStorageBuffer::Sptr _pool;
+		static uint32_t                  _poolSize;
+		static uint32_t                  _poolCapacity;
+		static uint32_t                  _liveClips;
+
+		/// <summary>
+		/// Parses the OBJ frames and packs them into _data, does not touch OpenGL
+		/// </summary>
+		bool _PackObjFrames(const std::vector<std::string>& frameFiles, float frameTime, MorphClipEncoding encoding);
+		bool _Load(const std::string& path);
+		bool _Save(const std::string& path) const;
+		/// <summary>
+		/// Copies our packed data to the end of the pool, growing it if needed
+		/// </summary>
+		void _Upload();
+		/// <summary>
+		/// Gets the offset of a frame within the pool, in 32 bit words
+		/// </summary>
+		uint32_t _GetFrameOffset(uint32_t frame) const;
+	};
+}
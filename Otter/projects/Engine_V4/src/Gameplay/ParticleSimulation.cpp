@@ -0,0 +1,311 @@
+#include "Gameplay/ParticleSimulation.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <emmintrin.h>
+
+#include "GLM/gtc/constants.hpp"
+#include "Utils/JobSystem.h"
+
+namespace Gameplay {
+	// Rounds a particle count up to a whole number of SIMD lanes
+	static size_t RoundUpLanes(size_t count) {
+		return (count + 3) & ~(size_t)3;
+	}
+
+	// The number of set bits in each 4 bit mask from _mm_movemask_ps
+	static const int LaneCounts[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+	void ParticleSimulation::Streams::Resize(size_t size) {
+		PosX.assign(size, 0.0f);
+		PosY.assign(size, 0.0f);
+		PosZ.assign(size, 0.0f);
+		VelX.assign(size, 0.0f);
+		VelY.assign(size, 0.0f);
+		VelZ.assign(size, 0.0f);
+		Life.assign(size, 0.0f);
+		InvLifetime.assign(size, 0.0f);
+		Color.assign(size, 0);
+	}
+
+	ParticleSimulation::ParticleSimulation(uint32_t maxParticles, uint32_t seed) :
+		_maxParticles(maxParticles),
+		_count(0),
+		_rngState(0),
+		_emitters(std::vector<Emitter>()),
+		_emitterTimers(std::vector<float>()),
+		_streams(),
+		_current(0),
+		_renderData(std::vector<RenderVertex>()),
+		_chunkOffsets(std::vector<size_t>())
+	{
+		SetMaxParticles(maxParticles);
+		Reset(seed);
+	}
+
+	void ParticleSimulation::Reset(uint32_t seed) {
+		// Xorshift can't have a state of 0, so mix the seed into a non-zero value
+		_rngState = (seed * 0x9E3779B9u) ^ 0xA511E9B3u;
+		if (_rngState == 0) {
+			_rngState = 1;
+		}
+
+		_count = 0;
+		for (Streams& streams : _streams) {
+			std::fill(streams.Life.begin(), streams.Life.end(), 0.0f);
+		}
+
+		// Emitters spawn their first particle after one interval, same as the GPU simulation
+		for (size_t ix = 0; ix < _emitters.size(); ix++) {
+			_emitterTimers[ix] = _emitters[ix].SpawnInterval;
+		}
+	}
+
+	void ParticleSimulation::SetMaxParticles(uint32_t value) {
+		_maxParticles = value;
+		const size_t capacity = RoundUpLanes(value);
+		_streams[0].Resize(capacity);
+		_streams[1].Resize(capacity);
+		_renderData.resize(capacity);
+		_count = 0;
+	}
+
+	void ParticleSimulation::SetEmitters(const std::vector<Emitter>& emitters) {
+		_emitters = emitters;
+		_emitterTimers.resize(_emitters.size());
+		for (size_t ix = 0; ix < _emitters.size(); ix++) {
+			_emitterTimers[ix] = _emitters[ix].SpawnInterval;
+		}
+	}
+
+	void ParticleSimulation::Update(float dt, const glm::mat4& transform, const glm::vec3& gravity, int threadCount) {
+		// Chunks are a fixed size so that the work is split the same way no matter how many threads we have
+		const size_t chunkCount = (_count + ChunkSize - 1) / ChunkSize;
+		if (chunkCount > 0) {
+			// Work out where each chunk's survivors will end up, so chunks can write their output
+			// in parallel and the particles stay in the same order
+			_chunkOffsets.resize(chunkCount + 1);
+			_ParallelFor(chunkCount, threadCount, [&](size_t chunk) {
+				const size_t begin = chunk * ChunkSize;
+				_chunkOffsets[chunk + 1] = _CountSurvivors(begin, std::min<size_t>(begin + ChunkSize, _count), dt);
+			});
+			_chunkOffsets[0] = 0;
+			for (size_t ix = 1; ix <= chunkCount; ix++) {
+				_chunkOffsets[ix] += _chunkOffsets[ix - 1];
+			}
+
+			_ParallelFor(chunkCount, threadCount, [&](size_t chunk) {
+				const size_t begin = chunk * ChunkSize;
+				_IntegrateChunk(begin, std::min<size_t>(begin + ChunkSize, _count), _chunkOffsets[chunk], dt, gravity);
+			});
+
+			_count = static_cast<uint32_t>(_chunkOffsets[chunkCount]);
+		}
+		_current ^= 1;
+
+		_Spawn(dt, transform);
+
+		// Make sure the lanes past the end are dead, they may have old particles in them
+		Streams& streams = _streams[_current];
+		for (size_t ix = _count; ix < RoundUpLanes(_count); ix++) {
+			streams.Life[ix] = 0.0f;
+		}
+	}
+
+	float ParticleSimulation::_Random() {
+		// Xorshift32, we take the top 24 bits to get an evenly distributed float
+		_rngState ^= _rngState << 13;
+		_rngState ^= _rngState >> 17;
+		_rngState ^= _rngState << 5;
+		return (_rngState >> 8) * (1.0f / 16777216.0f);
+	}
+
+	glm::vec3 ParticleSimulation::_RandomInCone(const glm::vec3& direction, float angle) {
+		const float length = glm::length(direction);
+		if (angle <= 0.0f || length <= 0.0f) {
+			return direction;
+		}
+
+		// Pick a point on the spherical cap around +Z, then rotate it to face the direction
+		const float cosTheta = glm::mix(glm::cos(angle), 1.0f, _Random());
+		const float sinTheta = glm::sqrt(glm::max(0.0f, 1.0f - cosTheta * cosTheta));
+		const float phi = _Random() * glm::two_pi<float>();
+		const glm::vec3 local = glm::vec3(glm::cos(phi) * sinTheta, glm::sin(phi) * sinTheta, cosTheta);
+
+		const glm::vec3 forward = direction / length;
+		const glm::vec3 helper = glm::abs(forward.z) < 0.999f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+		const glm::vec3 right = glm::normalize(glm::cross(helper, forward));
+		const glm::vec3 up = glm::cross(forward, right);
+		return (right * local.x + up * local.y + forward * local.z) * length;
+	}
+
+	size_t ParticleSimulation::_CountSurvivors(size_t begin, size_t end, float dt) const {
+		const Streams& src = _streams[_current];
+		const __m128 dtv = _mm_set1_ps(dt);
+		const __m128 zero = _mm_setzero_ps();
+
+		size_t result = 0;
+		for (size_t ix = begin; ix < end; ix += 4) {
+			const __m128 life = _mm_sub_ps(_mm_loadu_ps(&src.Life[ix]), dtv);
+			result += LaneCounts[_mm_movemask_ps(_mm_cmpgt_ps(life, zero))];
+		}
+		return result;
+	}
+
+	void ParticleSimulation::_IntegrateChunk(size_t begin, size_t end, size_t out, float dt, const glm::vec3& gravity) {
+		const Streams& src = _streams[_current];
+		Streams& dst = _streams[_current ^ 1];
+
+		const __m128 dtv = _mm_set1_ps(dt);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 one = _mm_set1_ps(1.0f);
+		const __m128 gx = _mm_set1_ps(gravity.x * dt);
+		const __m128 gy = _mm_set1_ps(gravity.y * dt);
+		const __m128 gz = _mm_set1_ps(gravity.z * dt);
+		const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+
+		for (size_t ix = begin; ix < end; ix += 4) {
+			__m128 life = _mm_sub_ps(_mm_loadu_ps(&src.Life[ix]), dtv);
+			const int alive = _mm_movemask_ps(_mm_cmpgt_ps(life, zero));
+			if (alive == 0) {
+				continue;
+			}
+
+			// Move with the old velocity, then apply gravity (same order as the GPU simulation)
+			__m128 vx = _mm_loadu_ps(&src.VelX[ix]);
+			__m128 vy = _mm_loadu_ps(&src.VelY[ix]);
+			__m128 vz = _mm_loadu_ps(&src.VelZ[ix]);
+			__m128 px = _mm_add_ps(_mm_loadu_ps(&src.PosX[ix]), _mm_mul_ps(vx, dtv));
+			__m128 py = _mm_add_ps(_mm_loadu_ps(&src.PosY[ix]), _mm_mul_ps(vy, dtv));
+			__m128 pz = _mm_add_ps(_mm_loadu_ps(&src.PosZ[ix]), _mm_mul_ps(vz, dtv));
+			vx = _mm_add_ps(vx, gx);
+			vy = _mm_add_ps(vy, gy);
+			vz = _mm_add_ps(vz, gz);
+			const __m128 invLifetime = _mm_loadu_ps(&src.InvLifetime[ix]);
+			const __m128i color = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&src.Color[ix]));
+
+			// Fade the color's alpha by the remaining life
+			const __m128 fade = _mm_min_ps(_mm_max_ps(_mm_mul_ps(life, invLifetime), zero), one);
+			const __m128 alpha = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(color, 24)), fade);
+			const __m128i packed = _mm_or_si128(_mm_and_si128(color, rgbMask), _mm_slli_epi32(_mm_cvtps_epi32(alpha), 24));
+
+			// The common case, all 4 particles survive and can be written out together
+			if (alive == 0xF) {
+				_mm_storeu_ps(&dst.PosX[out], px);
+				_mm_storeu_ps(&dst.PosY[out], py);
+				_mm_storeu_ps(&dst.PosZ[out], pz);
+				_mm_storeu_ps(&dst.VelX[out], vx);
+				_mm_storeu_ps(&dst.VelY[out], vy);
+				_mm_storeu_ps(&dst.VelZ[out], vz);
+				_mm_storeu_ps(&dst.Life[out], life);
+				_mm_storeu_ps(&dst.InvLifetime[out], invLifetime);
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(&dst.Color[out]), color);
+
+				// Transposing x, y, z, color gives us 4 packed render vertices
+				__m128 r0 = px, r1 = py, r2 = pz, r3 = _mm_castsi128_ps(packed);
+				_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+				float* render = reinterpret_cast<float*>(&_renderData[out]);
+				_mm_storeu_ps(render + 0, r0);
+				_mm_storeu_ps(render + 4, r1);
+				_mm_storeu_ps(render + 8, r2);
+				_mm_storeu_ps(render + 12, r3);
+				out += 4;
+			}
+			// Otherwise copy out the survivors one at a time
+			else {
+				alignas(16) float lanes[10][4];
+				_mm_store_ps(lanes[0], px);
+				_mm_store_ps(lanes[1], py);
+				_mm_store_ps(lanes[2], pz);
+				_mm_store_ps(lanes[3], vx);
+				_mm_store_ps(lanes[4], vy);
+				_mm_store_ps(lanes[5], vz);
+				_mm_store_ps(lanes[6], life);
+				_mm_store_ps(lanes[7], invLifetime);
+				_mm_store_si128(reinterpret_cast<__m128i*>(lanes[8]), color);
+				_mm_store_si128(reinterpret_cast<__m128i*>(lanes[9]), packed);
+
+				for (int lane = 0; lane < 4; lane++) {
+					if (alive & (1 << lane)) {
+						dst.PosX[out] = lanes[0][lane];
+						dst.PosY[out] = lanes[1][lane];
+						dst.PosZ[out] = lanes[2][lane];
+						dst.VelX[out] = lanes[3][lane];
+						dst.VelY[out] = lanes[4][lane];
+						dst.VelZ[out] = lanes[5][lane];
+						dst.Life[out] = lanes[6][lane];
+						dst.InvLifetime[out] = lanes[7][lane];
+						memcpy(&dst.Color[out], &lanes[8][lane], sizeof(uint32_t));
+
+						RenderVertex& vertex = _renderData[out];
+						vertex.Position = glm::vec3(lanes[0][lane], lanes[1][lane], lanes[2][lane]);
+						memcpy(&vertex.Color, &lanes[9][lane], sizeof(uint32_t));
+						out++;
+					}
+				}
+			}
+		}
+	}
+
+	void ParticleSimulation::_Spawn(float dt, const glm::mat4& transform) {
+		Streams& streams = _streams[_current];
+		const glm::mat3 rotation = glm::mat3(transform);
+
+		for (size_t ix = 0; ix < _emitters.size(); ix++) {
+			const Emitter& emitter = _emitters[ix];
+			float& timer = _emitterTimers[ix];
+			timer -= dt;
+
+			while (timer < 0.0f && _count < _maxParticles) {
+				// The particle should have spawned part way through the step, so move it forward
+				// by the time it's been alive
+				const float age = -timer;
+				const glm::vec3 velocity = _RandomInCone(emitter.Velocity, emitter.ConeAngle);
+				const glm::vec3 position = glm::vec3(transform * glm::vec4(emitter.Position + velocity * age, 1.0f));
+				const glm::vec3 worldVelocity = rotation * velocity;
+				const float lifetime = glm::max(glm::mix(emitter.LifetimeRange.x, emitter.LifetimeRange.y, _Random()), 0.0001f);
+				const glm::uvec4 color = glm::uvec4(glm::clamp(emitter.Color, 0.0f, 1.0f) * 255.0f + 0.5f);
+
+				streams.PosX[_count] = position.x;
+				streams.PosY[_count] = position.y;
+				streams.PosZ[_count] = position.z;
+				streams.VelX[_count] = worldVelocity.x;
+				streams.VelY[_count] = worldVelocity.y;
+				streams.VelZ[_count] = worldVelocity.z;
+				streams.Life[_count] = lifetime;
+				streams.InvLifetime[_count] = 1.0f / lifetime;
+				streams.Color[_count] = color.r | (color.g << 8) | (color.b << 16) | (color.a << 24);
+
+				// New particles start fully opaque
+				RenderVertex& vertex = _renderData[_count];
+				vertex.Position = position;
+				vertex.Color = streams.Color[_count];
+
+				_count++;
+				timer += glm::max(emitter.SpawnInterval, 0.0001f);
+			}
+
+			// If we've hit the particle limit, don't build up a backlog of particles to spawn
+			timer = glm::max(timer, 0.0f);
+		}
+	}
+
+	template <typename Func>
+	void ParticleSimulation::_ParallelFor(size_t chunkCount, int threadCount, Func&& func) {
+		// Headless tools may not have started the job system, so we just run the chunks in order
+		if (threadCount == 1 || chunkCount == 1 || !JobSystem::IsInitialized()) {
+			for (size_t chunk = 0; chunk < chunkCount; chunk++) {
+				func(chunk);
+			}
+			return;
+		}
+
+		// The chunks are still our fixed size ones, the job system just decides who runs them
+		JobSystem::ParallelFor(chunkCount, 1, [&](size_t begin, size_t end) {
+			for (size_t chunk = begin; chunk < end; chunk++) {
+				func(chunk);
+			}
+		});
+	}
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+#include "GLM/glm.hpp"
+
+namespace Gameplay {
+	/// <summary>
+	/// Simulates particles on the CPU, as an alternative to simulating them on the GPU with
+	/// transform feedback
+	///
+	/// Particles are stored as a structure of arrays, so that gravity, velocity and lifetimes
+	/// can be integrated 4 particles at a time with SSE. Each update reads from one set of arrays
+	/// and writes the surviving particles into the other, so dead particles are removed without
+	/// any extra passes. Large systems are split into fixed size chunks that are updated across
+	/// the job system's threads
+	///
+	/// All random numbers come from a seeded generator and are only used on the calling thread,
+	/// so the same seed and timesteps give the same results no matter how many threads are used.
+	/// Nothing in here touches OpenGL, the owner is expected to upload GetRenderData each frame
+	/// </summary>
+	class ParticleSimulation {
+	public:
+		/// <summary>
+		/// Describes where and how often particles are spawned
+		/// </summary>
+		struct Emitter {
+			// Position in the simulation's local space
+			glm::vec3 Position;
+			// The initial velocity of spawned particles, in local space
+			glm::vec3 Velocity;
+			glm::vec4 Color;
+			// The time between particles, in seconds
+			float     SpawnInterval;
+			// The max angle between a particle's velocity and the emitter's velocity, in radians
+			float     ConeAngle;
+			// The min and max lifetimes of spawned particles, in seconds
+			glm::vec2 LifetimeRange;
+		};
+
+		/// <summary>
+		/// The packed vertex that is uploaded for rendering, 16 bytes per particle
+		/// </summary>
+		struct RenderVertex {
+			glm::vec3 Position;
+			// RGBA8, the alpha fades out over the particle's lifetime
+			uint32_t  Color;
+		};
+
+		// The number of particles in each chunk of work, must be a multiple of 4
+		static constexpr size_t ChunkSize = 16384;
+
+		/// <param name="maxParticles">The most particles that can be alive at once</param>
+		/// <param name="seed">The seed for the random number generator</param>
+		ParticleSimulation(uint32_t maxParticles = 1000, uint32_t seed = 0);
+		~ParticleSimulation() = default;
+
+		/// <summary>
+		/// Removes all particles, and restarts the random number generator and emitters
+		/// </summary>
+		/// <param name="seed">The new seed for the random number generator</param>
+		void Reset(uint32_t seed);
+
+		/// <summary>
+		/// Sets the most particles that can be alive at once, this will reset the simulation
+		/// </summary>
+		void SetMaxParticles(uint32_t value);
+		uint32_t GetMaxParticles() const { return _maxParticles; }
+
+		/// <summary>
+		/// Replaces the emitters in the simulation, existing particles are kept
+		/// </summary>
+		void SetEmitters(const std::vector<Emitter>& emitters);
+		const std::vector<Emitter>& GetEmitters() const { return _emitters; }
+
+		/// <summary>
+		/// Steps the simulation forward
+		/// </summary>
+		/// <param name="dt">The time to step forward by, in seconds</param>
+		/// <param name="transform">The local to world transform to spawn particles with</param>
+		/// <param name="gravity">The acceleration applied to all particles, in world space</param>
+		/// <param name="threadCount">1 to update on the calling thread, anything else spreads the chunks across the job system</param>
+		void Update(float dt, const glm::mat4& transform, const glm::vec3& gravity, int threadCount = 0);
+
+		/// <summary>
+		/// Gets the number of live particles
+		/// </summary>
+		uint32_t GetParticleCount() const { return _count; }
+		/// <summary>
+		/// Gets the packed render data for the live particles, the first GetParticleCount() vertices are valid
+		/// </summary>
+		const RenderVertex* GetRenderData() const { return _renderData.data(); }
+
+	protected:
+		// Particle attributes, stored as one array per component. The arrays are padded to a
+		// multiple of 4, and padding lanes always have a lifetime of 0 so they are never kept
+		struct Streams {
+			std::vector<float>    PosX, PosY, PosZ;
+			std::vector<float>    VelX, VelY, VelZ;
+			// Remaining lifetime, and 1 / the starting lifetime for fading out
+			std::vector<float>    Life, InvLifetime;
+			// RGBA8, the alpha is multiplied by the remaining life when packed for rendering
+			std::vector<uint32_t> Color;
+
+			void Resize(size_t size);
+		};
+
+		uint32_t                  _maxParticles;
+		uint32_t                  _count;
+		uint32_t                  _rngState;
+
+		std::vector<Emitter>      _emitters;
+		// Time until each emitter spawns it's next particle
+		std::vector<float>        _emitterTimers;
+
+		// We read from one set of streams and write the survivors to the other
+		Streams                   _streams[2];
+		int                       _current;
+		std::vector<RenderVertex> _renderData;
+
+		// Scratch space for the number of survivors in each chunk
+		std::vector<size_t>       _chunkOffsets;
+
+		// Returns a random number in the 0-1 range
+		float _Random();
+		// Returns a random direction within a cone around the given direction
+		glm::vec3 _RandomInCone(const glm::vec3& direction, float angle);
+
+		/// <summary>
+		/// Counts how many particles in the chunk survive the next dt seconds
+		/// </summary>
+		size_t _CountSurvivors(size_t begin, size_t end, float dt) const;
+		/// <summary>
+		/// Integrates the particles in the given range, writing the survivors to the other streams
+		/// and the render data starting at the given index
+		/// </summary>
+		void _IntegrateChunk(size_t begin, size_t end, size_t out, float dt, const glm::vec3& gravity);
+		/// <summary>
+		/// Spawns new particles from the emitters into the current streams
+		/// </summary>
+		void _Spawn(float dt, const glm::mat4& transform);
+		/// <summary>
+		/// Invokes a function for every chunk in [0, chunkCount), through JobSystem::ParallelFor unless
+		/// threadCount is 1 or the job system isn't running
+		/// </summary>
+		template <typename Func>
+		static void _ParallelFor(size_t chunkCount, int threadCount, Func&& func);
+	};
+}
@@ -1,10 +1,13 @@
 #pragma once
 
 #include "Gameplay/Physics/ICollider.h"
+#include "Gameplay/Physics/CollisionMeshCache.h"
 
 namespace Gameplay::Physics {
 	/// <summary>
 	/// A complex collider type that allows us to construct collision hulls from arbitrary convex meshes
+	/// 
+	/// The hull is cooked from the mesh on the CPU and cached on disk, see CollisionMeshCache
 	/// </summary>
 	class ConvexMeshCollider final : public ICollider {
 	public:
@@ -19,7 +22,7 @@ namespace Gameplay::Physics {
 		virtual void FromJson(const nlohmann::json& data) override;
 
 	protected:
-		btTriangleMesh* _triMesh;
+		CookedHull::Sptr _hull;
 		ConvexMeshCollider();
 
 		virtual btCollisionShape* CreateShape() const override;
@@ -0,0 +1,261 @@
+#include "Gameplay/Physics/CollisionMeshCache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+
+#include <btBulletCollisionCommon.h>
+#include <BulletCollision/CollisionShapes/btShapeHull.h>
+
+#include "Gameplay/MeshResource.h"
+#include "Utils/MappedFile.h"
+#include "Utils/ObjParser.h"
+#include "Utils/StringUtils.h"
+#include "Logging.h"
+
+namespace fs = std::filesystem;
+
+namespace Gameplay::Physics {
+	std::string CollisionMeshCache::_cacheDirectory = "cache/collision";
+
+	void CollisionMeshCache::SetCacheDirectory(const std::string& path) {
+		_cacheDirectory = path;
+	}
+
+	const std::string& CollisionMeshCache::GetCacheDirectory() {
+		return _cacheDirectory;
+	}
+
+	CookedHull::Sptr CollisionMeshCache::GetHull(MeshResource& mesh) {
+		// Already cooked for another collider
+		if (mesh.CollisionHull != nullptr) {
+			return mesh.CollisionHull;
+		}
+
+		uint64_t key = 0;
+		const bool hasKey = _GetKey(mesh, key);
+		if (hasKey) {
+			mesh.CollisionHull = _ReadCache(key);
+			if (mesh.CollisionHull != nullptr) {
+				return mesh.CollisionHull;
+			}
+		}
+
+		// Not in the cache, cook from the data the mesh kept on the CPU, or from the source file
+		if (!mesh.CollisionPositions.empty()) {
+			mesh.CollisionHull = Cook(mesh.CollisionPositions.data(), mesh.CollisionPositions.size(),
+				mesh.CollisionIndices.empty() ? nullptr : mesh.CollisionIndices.data(), mesh.CollisionIndices.size());
+		} else if (!mesh.Filename.empty() && mesh.Filename != "null") {
+			mesh.CollisionHull = _CookObjFile(mesh.Filename);
+		} else {
+			LOG_WARN("Mesh has no CPU data or source file to cook a collider from");
+		}
+
+		if (mesh.CollisionHull != nullptr && hasKey) {
+			_WriteCache(key, *mesh.CollisionHull);
+		}
+		return mesh.CollisionHull;
+	}
+
+	bool CollisionMeshCache::CookFile(const std::string& meshPath) {
+		uint64_t key = 0;
+		if (!_GetFileKey(meshPath, key)) {
+			LOG_ERROR("Failed to open \"{}\" for cooking", meshPath);
+			return false;
+		}
+
+		if (_ReadCache(key) != nullptr) {
+			LOG_INFO("Collision hull for \"{}\" is up to date", meshPath);
+			return true;
+		}
+
+		CookedHull::Sptr hull = _CookObjFile(meshPath);
+		if (hull == nullptr) {
+			return false;
+		}
+		_WriteCache(key, *hull);
+		LOG_INFO("Cooked collision hull for \"{}\" ({} points)", meshPath, hull->Points.size());
+		return true;
+	}
+
+	CookedHull::Sptr CollisionMeshCache::Cook(const glm::vec3* positions, size_t vertexCount, const uint32_t* indices, size_t indexCount) {
+		const size_t triangleCount = (indices != nullptr ? indexCount : vertexCount) / 3;
+		if (triangleCount == 0) {
+			return nullptr;
+		}
+
+		// Build a bullet triangle mesh, we don't need to weld vertices since we only want the hull
+		btTriangleMesh triMesh(true, false);
+		triMesh.preallocateVertices(static_cast<int>(triangleCount * 3));
+		for (size_t ix = 0; ix < triangleCount; ix++) {
+			btVector3 corners[3];
+			for (int corner = 0; corner < 3; corner++) {
+				const size_t vertIx = indices != nullptr ? indices[ix * 3 + corner] : ix * 3 + corner;
+				if (vertIx >= vertexCount) {
+					LOG_WARN("Mesh index {} is out of range ({} vertices), unable to cook collider", vertIx, vertexCount);
+					return nullptr;
+				}
+				const glm::vec3& pos = positions[vertIx];
+				corners[corner] = btVector3(pos.x, pos.y, pos.z);
+			}
+			triMesh.addTriangle(corners[0], corners[1], corners[2]);
+		}
+
+		// The shape hull samples the mesh's support points in a fixed set of directions, which
+		// reduces meshes with any number of triangles down to a few dozen hull points
+		// The support points include the shape's margin, and the hull shape will add the margin again,
+		// so we sample the bare mesh and just remember the margin for later
+		btConvexTriangleMeshShape shape(&triMesh);
+		const float margin = shape.getMargin();
+		shape.setMargin(0.0f);
+		btShapeHull hull(&shape);
+		if (!hull.buildHull(0.0f)) {
+			LOG_WARN("Failed to build hull for convex mesh");
+			return nullptr;
+		}
+
+		CookedHull::Sptr result = std::make_shared<CookedHull>();
+		result->Margin = margin;
+		result->Points.resize(hull.numVertices());
+		for (int ix = 0; ix < hull.numVertices(); ix++) {
+			const btVector3& point = hull.getVertexPointer()[ix];
+			result->Points[ix] = glm::vec3(point.x(), point.y(), point.z());
+		}
+
+		// The hull is made of points on the mesh, so it should never reach outside of the mesh's bounds
+		btVector3 meshMin, meshMax;
+		triMesh.calculateAabbBruteForce(meshMin, meshMax);
+		glm::vec3 hullMin = result->Points[0];
+		glm::vec3 hullMax = result->Points[0];
+		for (const glm::vec3& point : result->Points) {
+			hullMin = glm::min(hullMin, point);
+			hullMax = glm::max(hullMax, point);
+		}
+		const float tolerance = 1e-4f * glm::max(1.0f, glm::length(hullMax - hullMin));
+		if (glm::any(glm::lessThan(hullMin, glm::vec3(meshMin.x(), meshMin.y(), meshMin.z()) - tolerance)) ||
+			glm::any(glm::greaterThan(hullMax, glm::vec3(meshMax.x(), meshMax.y(), meshMax.z()) + tolerance))) {
+			LOG_WARN("Cooked hull extents ({}, {}, {}) - ({}, {}, {}) are outside of the mesh bounds ({}, {}, {}) - ({}, {}, {})",
+				hullMin.x, hullMin.y, hullMin.z, hullMax.x, hullMax.y, hullMax.z,
+				meshMin.x(), meshMin.y(), meshMin.z(), meshMax.x(), meshMax.y(), meshMax.z());
+		}
+		return result;
+	}
+
+	uint64_t CollisionMeshCache::_Hash(const void* data, size_t size, uint64_t seed) {
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+		uint64_t hash = seed ^ (size * 0x9E3779B97F4A7C15ull);
+
+		// Mix in 8 bytes at a time, then the leftovers
+		size_t ix = 0;
+		for (; ix + 8 <= size; ix += 8) {
+			uint64_t word;
+			memcpy(&word, bytes + ix, sizeof(word));
+			word *= 0xFF51AFD7ED558CCDull;
+			word ^= word >> 33;
+			hash = (hash ^ word) * 0xC4CEB9FE1A85EC53ull;
+		}
+		uint64_t tail = 0;
+		memcpy(&tail, bytes + ix, size - ix);
+		hash = (hash ^ tail) * 0xC4CEB9FE1A85EC53ull;
+
+		// Finish with the MurmurHash3 mixer
+		hash ^= hash >> 33;
+		hash *= 0xFF51AFD7ED558CCDull;
+		hash ^= hash >> 33;
+		return hash;
+	}
+
+	bool CollisionMeshCache::_GetKey(const MeshResource& mesh, uint64_t& key) {
+		// Generated meshes are keyed by the parameters used to make them
+		if (!mesh.MeshBuilderParams.empty()) {
+			std::string params;
+			for (const auto& param : mesh.MeshBuilderParams) {
+				params += param.ToJson().dump();
+			}
+			key = _Hash(params.data(), params.size(), Version);
+			return true;
+		}
+		if (!mesh.Filename.empty() && mesh.Filename != "null") {
+			return _GetFileKey(mesh.Filename, key);
+		}
+		return false;
+	}
+
+	bool CollisionMeshCache::_GetFileKey(const std::string& path, uint64_t& key) {
+		MappedFile file;
+		if (!file.Open(path)) {
+			return false;
+		}
+		key = _Hash(file.GetData(), file.GetSize(), Version);
+		return true;
+	}
+
+	std::string CollisionMeshCache::_GetCachePath(uint64_t key) {
+		return (fs::path(_cacheDirectory) / fmt::format("{:016x}{}", key, Extension)).string();
+	}
+
+	CookedHull::Sptr CollisionMeshCache::_ReadCache(uint64_t key) {
+		std::ifstream file(_GetCachePath(key), std::ios::binary);
+		if (!file) {
+			return nullptr;
+		}
+
+		HullFileHeader header;
+		HullFileHeader expected;
+		file.read(reinterpret_cast<char*>(&header), sizeof(HullFileHeader));
+		if (!file || memcmp(header.HeaderBytes, expected.HeaderBytes, 4) != 0 || header.Version != Version || header.Key != key) {
+			LOG_WARN("Ignoring invalid or outdated collision cache file \"{}\"", _GetCachePath(key));
+			return nullptr;
+		}
+
+		CookedHull::Sptr result = std::make_shared<CookedHull>();
+		result->Margin = header.Margin;
+		result->Points.resize(header.NumPoints);
+		file.read(reinterpret_cast<char*>(result->Points.data()), header.NumPoints * sizeof(glm::vec3));
+		if (!file) {
+			LOG_WARN("Collision cache file \"{}\" is truncated", _GetCachePath(key));
+			return nullptr;
+		}
+		return result;
+	}
+
+	void CollisionMeshCache::_WriteCache(uint64_t key, const CookedHull& hull) {
+		std::error_code error;
+		fs::create_directories(_cacheDirectory, error);
+
+		std::ofstream file(_GetCachePath(key), std::ios::binary);
+		if (!file) {
+			LOG_WARN("Failed to write collision cache file \"{}\"", _GetCachePath(key));
+			return;
+		}
+
+		HullFileHeader header;
+		header.Key = key;
+		header.NumPoints = static_cast<uint32_t>(hull.Points.size());
+		header.Margin = hull.Margin;
+		file.write(reinterpret_cast<const char*>(&header), sizeof(HullFileHeader));
+		file.write(reinterpret_cast<const char*>(hull.Points.data()), hull.Points.size() * sizeof(glm::vec3));
+	}
+
+	CookedHull::Sptr CollisionMeshCache::_CookObjFile(const std::string& path) {
+		std::string extension = fs::path(path).extension().string();
+		StringTools::ToLower(extension);
+		if (extension != ".obj") {
+			LOG_WARN("Can only cook colliders from OBJ files, not \"{}\"", path);
+			return nullptr;
+		}
+
+		ObjParseResult data;
+		if (!ObjParser::Parse(path, data)) {
+			LOG_WARN("Failed to open \"{}\" for cooking", path);
+			return nullptr;
+		}
+
+		// The hull only cares about positions, so we can index them directly
+		std::vector<uint32_t> indices(data.Indices.size());
+		for (size_t ix = 0; ix < data.Indices.size(); ix++) {
+			indices[ix] = static_cast<uint32_t>(data.Vertices[data.Indices[ix]].x);
+		}
+		return Cook(data.Positions.data(), data.Positions.size(), indices.data(), indices.size());
+	}
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "GLM/glm.hpp"
+
+namespace Gameplay {
+	class MeshResource;
+
+	namespace Physics {
+		/// <summary>
+		/// A simplified convex hull that has been cooked from a mesh, ready to be handed to bullet
+		/// </summary>
+		struct CookedHull {
+			typedef std::shared_ptr<CookedHull> Sptr;
+
+			// The points on the hull, in the mesh's object space, without the margin applied
+			std::vector<glm::vec3> Points;
+			// The collision margin that bullet should add around the points
+			float                  Margin;
+		};
+
+		/// <summary>
+		/// Cooks convex collision hulls from mesh data, and caches them on disk so that later loads
+		/// don't need to rebuild them
+		///
+		/// Hulls are cooked entirely on the CPU from the positions and indices that mesh resources
+		/// keep around, so no OpenGL context is needed. Mesh files are keyed by a hash of the file's
+		/// contents, so editing a mesh will cook a new hull for it. Cooked hulls are also shared
+		/// between all the colliders that use the same mesh resource
+		/// </summary>
+		class CollisionMeshCache {
+		public:
+			// The version of the cache files we write, files with other versions will be re-cooked
+			// Version 2: hull points no longer have the margin baked in
+			static constexpr uint32_t Version = 2;
+			// The file extension used for cooked hulls
+			static constexpr const char* Extension = ".hull";
+
+			/// <summary>
+			/// Sets the directory that cooked hulls are stored in, default is "cache/collision"
+			/// </summary>
+			static void SetCacheDirectory(const std::string& path);
+			/// <summary>
+			/// Gets the directory that cooked hulls are stored in
+			/// </summary>
+			static const std::string& GetCacheDirectory();
+
+			/// <summary>
+			/// Gets the convex hull for a mesh resource. Uses the hull stored in the resource if it has one,
+			/// otherwise loads it from the cache, or cooks it and adds it to the cache
+			/// </summary>
+			/// <param name="mesh">The mesh to get the hull for</param>
+			/// <returns>The hull, or nullptr if the mesh has no data that we can cook from</returns>
+			static CookedHull::Sptr GetHull(MeshResource& mesh);
+
+			/// <summary>
+			/// Cooks the hull for a mesh file and writes it to the cache, without needing an OpenGL
+			/// context. Useful for cooking assets ahead of time
+			/// </summary>
+			/// <param name="meshPath">The path to the OBJ file to cook</param>
+			/// <returns>True if the hull was cooked (or was already up to date in the cache)</returns>
+			static bool CookFile(const std::string& meshPath);
+
+			/// <summary>
+			/// Builds a simplified convex hull from a triangle list
+			/// </summary>
+			/// <param name="positions">The vertex positions</param>
+			/// <param name="vertexCount">The number of vertex positions</param>
+			/// <param name="indices">Triangle list indices into positions, or nullptr if positions is a triangle list</param>
+			/// <param name="indexCount">The number of indices</param>
+			/// <returns>The hull, or nullptr if the hull could not be built</returns>
+			static CookedHull::Sptr Cook(const glm::vec3* positions, size_t vertexCount, const uint32_t* indices, size_t indexCount);
+
+		protected:
+			CollisionMeshCache() = default;
+			~CollisionMeshCache() = default;
+
+			struct HullFileHeader {
+				char     HeaderBytes[4] = { 'O', 'H', 'U', 'L' };
+				uint32_t Version = CollisionMeshCache::Version;
+				// The key of the mesh that the hull was cooked from
+				uint64_t Key = 0;
+				uint32_t NumPoints = 0;
+				float    Margin = 0.0f;
+			};
+
+			static std::string _cacheDirectory;
+
+			/// <summary>
+			/// Hashes a block of memory, 8 bytes at a time
+			/// </summary>
+			static uint64_t _Hash(const void* data, size_t size, uint64_t seed);
+			/// <summary>
+			/// Calculates the key that a mesh's hull is cached under
+			/// </summary>
+			/// <returns>True if we could calculate a key for the mesh</returns>
+			static bool _GetKey(const MeshResource& mesh, uint64_t& key);
+			/// <summary>
+			/// Calculates the key for a mesh file from the contents of the file
+			/// </summary>
+			static bool _GetFileKey(const std::string& path, uint64_t& key);
+			/// <summary>
+			/// Gets the path that the hull for the given key is stored at
+			/// </summary>
+			static std::string _GetCachePath(uint64_t key);
+
+			static CookedHull::Sptr _ReadCache(uint64_t key);
+			static void _WriteCache(uint64_t key, const CookedHull& hull);
+			/// <summary>
+			/// Parses an OBJ file and cooks it's hull
+			/// </summary>
+			static CookedHull::Sptr _CookObjFile(const std::string& path);
+		};
+	}
+}
@@ -18,7 +18,9 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 		_isShapeDirty(true),
 		_collisionGroup(0x01),
 		_collisionMask(0xFFFFFFFF),
-		_prevScale(glm::vec3(1.0f))
+		_prevScale(glm::vec3(1.0f)),
+		_syncedGeneration(0),
+		_physicsHandle(-1)
 	{ }
 
 	PhysicsBase::~PhysicsBase() {
@@ -238,4 +240,27 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 		context->SetPostion(ToGlm(transform.getOrigin()));
 		context->SetRotation(ToGlm(transform.getRotation()));
 	}
+
+	bool PhysicsBase::_IsTransformOutOfSync() const {
+		// Generations start at 1, so a new component will always sync the first time
+		return GetGameObject()->GetTransformGeneration() != _syncedGeneration;
+	}
+
+	void PhysicsBase::_MarkTransformSynced() {
+		_syncedGeneration = GetGameObject()->GetTransformGeneration();
+	}
+
+	void PhysicsBase::_RegisterPhysicsHandle(btCollisionObject* object) {
+		if (_physicsHandle < 0) {
+			_physicsHandle = _scene->_RegisterPhysicsBody(this);
+		}
+		object->setUserIndex(_physicsHandle);
+	}
+
+	void PhysicsBase::_UnregisterPhysicsHandle() {
+		if (_physicsHandle >= 0) {
+			_scene->_UnregisterPhysicsBody(_physicsHandle);
+			_physicsHandle = -1;
+		}
+	}
 }
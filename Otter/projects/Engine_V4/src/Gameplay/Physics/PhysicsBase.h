@@ -3,6 +3,7 @@
 #include "Gameplay/Physics/ICollider.h"
 
 class btTransform;
+class btCollisionObject;
 
 namespace Gameplay {
 	class Scene;
@@ -69,19 +70,27 @@ namespace Gameplay {
 			/// <param name="collider">The collider to remove</param>
 			void RemoveCollider(const ICollider::Sptr& collider);
 
+			/// <summary>
+			/// Gets the handle that identifies this body in the scene and in bullet (via the
+			/// collision object's user index), or -1 if the body has not been awoken yet
+			/// </summary>
+			int GetPhysicsHandle() const { return _physicsHandle; }
+
 
 			/// <summary>
 			/// Invoked for each RigidBody before the physics world is stepped forward a frame,
 			/// handles body initialization, shape changes, mass changes, etc...
 			/// </summary>
 			/// <param name="dt">The time in seconds since the last frame</param>
-			virtual void PhysicsPreStep(float dt) = 0;
+			/// <returns>True if the gameobject's transform was copied to bullet</returns>
+			virtual bool PhysicsPreStep(float dt) = 0;
 			/// <summary>
 			/// Invoked for each RigidBody after the physics world is stepped forward a frame,
 			/// handles copying transform to the OpenGL state
 			/// </summary>
 			/// <param name="dt">The time in seconds since the last frame</param>
-			virtual void PhysicsPostStep(float dt) = 0;
+			/// <returns>True if the body's transform was copied back from bullet</returns>
+			virtual bool PhysicsPostStep(float dt) = 0;
 
 			// Delete awake to ensure derived classes override it
 
@@ -103,6 +112,12 @@ namespace Gameplay {
 
 			glm::vec3 _prevScale;
 
+			// The gameobject's transform generation when we last synced with bullet
+			uint32_t _syncedGeneration;
+
+			// Our handle in the scene, see Scene::GetPhysicsBody
+			int _physicsHandle;
+
 			PhysicsBase();
 
 			void _RenderImGuiBase();
@@ -122,6 +137,16 @@ namespace Gameplay {
 			void _CopyGameobjectTransformTo(btTransform& transform);
 			void _CopyGameobjectTransformFrom(const btTransform& transform);
 
+			// Checks whether the gameobject has been moved since we last synced with bullet
+			bool _IsTransformOutOfSync() const;
+			// Marks the gameobject's current transform as being in sync with bullet
+			void _MarkTransformSynced();
+
+			// Registers this body with the scene, and stores the handle in the bullet object
+			void _RegisterPhysicsHandle(btCollisionObject* object);
+			// Releases our handle, should be called when removing our object from the world
+			void _UnregisterPhysicsHandle();
+
 			// Gets the bullet broadphase proxy that we can use for clearing collisions
 			virtual btBroadphaseProxy* _GetBroadphaseHandle() = 0;
 
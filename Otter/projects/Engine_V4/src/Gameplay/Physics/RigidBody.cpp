@@ -27,13 +27,17 @@ namespace Gameplay::Physics {
 		_angularVelocity(btVector3(0, 0, 0)),
 		_angularVelocityDirty(false),
 		_angularFactor(btVector3(1,1,1)),
-		_angularFactorDirty(false)
+		_angularFactorDirty(false),
+		_previousTransform(btTransform::getIdentity()),
+		_currentTransform(btTransform::getIdentity()),
+		_needsInterpolation(false)
 	{ }
 
 	RigidBody::~RigidBody() {
 		if (_body != nullptr) {
 			// Remove from the physics world
 			_scene->GetPhysicsWorld()->removeRigidBody(_body);
+			_UnregisterPhysicsHandle();
 
 			// Clean up all our memory
 			delete _motionState;
@@ -154,33 +158,76 @@ namespace Gameplay::Physics {
 		return _type;
 	}
 
-	void RigidBody::PhysicsPreStep(float dt) {
+	bool RigidBody::PhysicsPreStep(float dt) {
 		// Update any dirty state that may have changed
 		_HandleStateDirty();
 
-		if (_type != RigidBodyType::Static) {		
-			btTransform transform;
-			_CopyGameobjectTransformTo(transform);
+		// Statics don't move, and we only need to push the transform if something has moved
+		// the object since we last synced. Note that we can't copy dynamics every time, since
+		// the object is at an interpolated position that is behind the body's real state
+		if (_type == RigidBodyType::Static || !_IsTransformOutOfSync()) {
+			return false;
+		}
 
-			// Copy to body and to it's motion state
-			if (_type == RigidBodyType::Dynamic) {
-				_body->setWorldTransform(transform);
-			} else {
-				// Kinematics prefer to be driven my motion state for some reason :|
-				_body->getMotionState()->setWorldTransform(transform); 
-			}
+		btTransform transform;
+		_CopyGameobjectTransformTo(transform);
+
+		// Copy to body and to it's motion state
+		if (_type == RigidBodyType::Dynamic) {
+			_body->setWorldTransform(transform);
+
+			// The body was teleported, so there's nothing to interpolate from
+			_previousTransform = transform;
+			_currentTransform = transform;
+			_needsInterpolation = false;
+		} else {
+			// Kinematics prefer to be driven my motion state for some reason :|
+			_body->getMotionState()->setWorldTransform(transform); 
 		}
+
+		_MarkTransformSynced();
+		return true;
 	}
 
-	void RigidBody::PhysicsPostStep(float dt) {
+	bool RigidBody::PhysicsPostStep(float dt) {
 		// Kinematics are driven externally and statics don't move, so only need to get data out for dynamics!
-		if (_type == RigidBodyType::Dynamic && _body->isActive()) {
-			btTransform transform = _body->getWorldTransform();
-			_CopyGameobjectTransformFrom(transform);
+		if (_type != RigidBodyType::Dynamic) {
+			return false;
+		}
+
+		_previousTransform = _currentTransform;
+
+		// Bullet only updates the motion states of bodies that moved during the step
+		if (!_motionState->HasMoved) {
+			return false;
+		}
+		_motionState->HasMoved = false;
+
+		_currentTransform = _body->getWorldTransform();
+		_needsInterpolation = true;
+
+		// Store a copy of our velocities
+		_linearVelocity = _body->getLinearVelocity();
+		_angularVelocity = _body->getAngularVelocity();
+		return true;
+	}
+
+	void RigidBody::PhysicsInterpolate(float alpha) {
+		if (_type != RigidBodyType::Dynamic || !_needsInterpolation) {
+			return;
+		}
+
+		btTransform transform;
+		transform.setOrigin(_previousTransform.getOrigin().lerp(_currentTransform.getOrigin(), alpha));
+		transform.setRotation(_previousTransform.getRotation().slerp(_currentTransform.getRotation(), alpha));
+		_CopyGameobjectTransformFrom(transform);
+
+		// We moved the object ourselves, so we don't want to push it back to bullet next step
+		_MarkTransformSynced();
 
-			// Store a copy of our velocities
-			_linearVelocity = _body->getLinearVelocity();
-			_angularVelocity = _body->getAngularVelocity();
+		// Once both states match, the body has stopped and the object is already where it needs to be
+		if (_previousTransform == _currentTransform) {
+			_needsInterpolation = false;
 		}
 	}
 
@@ -207,8 +254,8 @@ namespace Gameplay::Physics {
 		_shape->calculateLocalInertia(_mass, _inertia);
 		_isMassDirty = false;
 
-		// Create a default motion state instance for tracking the bodies motion
-		_motionState = new btDefaultMotionState();
+		// Create a motion state instance for tracking the bodies motion
+		_motionState = new MotionState();
 
 		// Get the object's starting transform, create a bullet representation for it
 		btTransform transform; 
@@ -216,11 +263,13 @@ namespace Gameplay::Physics {
 		transform.setOrigin(ToBt(context->GetPosition()));
 		transform.setRotation(ToBt(context->GetRotation()));
 		_motionState->setWorldTransform(transform);
+		_previousTransform = transform;
+		_currentTransform = transform;
 
 		// Create the bullet rigidbody and add it to the physics scene
 		_body = new btRigidBody(_mass, _motionState, _shape, _inertia);
-		// Add a pointer to our own weak reference to allow getting this component as a shared_ptr later
-		_body->setUserPointer(&SelfRef());
+		// Store our handle so that we can find this component from bullet later
+		_RegisterPhysicsHandle(_body);
 
 		_scene->GetPhysicsWorld()->addRigidBody(_body);
 
@@ -157,13 +157,19 @@ namespace Gameplay::Physics {
 		/// handles body initialization, shape changes, mass changes, etc...
 		/// </summary>
 		/// <param name="dt">The time in seconds since the last frame</param>
-		virtual void PhysicsPreStep(float dt) override;
+		virtual bool PhysicsPreStep(float dt) override;
 		/// <summary>
 		/// Invoked for each RigidBody after the physics world is stepped forward a frame,
-		/// handles copying transform to the OpenGL state
+		/// stores the body's new state so it can be interpolated
 		/// </summary>
 		/// <param name="dt">The time in seconds since the last frame</param>
-		virtual void PhysicsPostStep(float dt) override;
+		virtual bool PhysicsPostStep(float dt) override;
+		/// <summary>
+		/// Invoked for each RigidBody once all physics steps for a frame are done, copies the
+		/// body's transform to the gameobject, blended between it's last two physics states
+		/// </summary>
+		/// <param name="alpha">How far between the previous and current state to place the object, 0-1</param>
+		void PhysicsInterpolate(float alpha);
 
 		// Inherited from IComponent
 		virtual void Awake() override;
@@ -174,6 +180,19 @@ namespace Gameplay::Physics {
 
 
 	protected:
+		/// <summary>
+		/// A motion state that records when bullet moves the body, bullet only does this for
+		/// active bodies so we can skip copying transforms back for everything else
+		/// </summary>
+		struct MotionState : public btDefaultMotionState {
+			bool HasMoved = false;
+
+			virtual void setWorldTransform(const btTransform& transform) override {
+				btDefaultMotionState::setWorldTransform(transform);
+				HasMoved = true;
+			}
+		};
+
 		// The physics update mode for the body (static, dynamic, kinematic)
 		RigidBodyType _type;
 
@@ -189,7 +208,7 @@ namespace Gameplay::Physics {
 
 		// Our bullet state stuff
 		btRigidBody*     _body;
-		btMotionState*   _motionState;
+		MotionState*     _motionState;
 		btVector3        _inertia;
 		btVector3        _linearVelocity;
 		bool             _linearVelocityDirty;
@@ -198,6 +217,12 @@ namespace Gameplay::Physics {
 		btVector3        _angularFactor;
 		bool             _angularFactorDirty;
 
+		// The body's transform after the last two physics steps, for interpolating between
+		btTransform      _previousTransform;
+		btTransform      _currentTransform;
+		// True while the states above differ, and the object needs to be moved between them
+		bool             _needsInterpolation;
+
 		// Handles resolving any dirty state stuff for our object
 		void _HandleStateDirty();
 
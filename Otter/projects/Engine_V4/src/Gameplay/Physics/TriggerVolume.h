@@ -5,6 +5,7 @@
 #include "EnumToString.h"
 
 class btPairCachingGhostObject;
+class btCollisionObject;
 
 namespace Gameplay::Physics {
 
@@ -17,6 +18,10 @@ namespace Gameplay::Physics {
 	/// <summary>
 	/// A trigger volume defines a shape in 3D space that allows us to respond to rigid bodies
 	/// entering a volume in 3D space. Handles invoking Trigger events on gameobjects
+	/// 
+	/// The scene tells each trigger which bodies are touching it after every physics step,
+	/// the trigger compares that against the bodies that were touching it in the previous step
+	/// to find enter and exit events. Events are dispatched by the scene once stepping is done
 	/// </summary>
 	class TriggerVolume : public PhysicsBase {
 	public:
@@ -31,17 +36,23 @@ namespace Gameplay::Physics {
 		/// handles body initialization, shape changes, mass changes, etc...
 		/// </summary>
 		/// <param name="dt">The time in seconds since the last frame</param>
-		virtual void PhysicsPreStep(float dt) override;
+		virtual bool PhysicsPreStep(float dt) override;
 		/// <summary>
 		/// Invoked for each RigidBody after the physics world is stepped forward a frame,
 		/// handles copying transform to the OpenGL state
 		/// </summary>
 		/// <param name="dt">The time in seconds since the last frame</param>
-		virtual void PhysicsPostStep(float dt) override;
+		virtual bool PhysicsPostStep(float dt) override;
 
 		void SetFlags(TriggerTypeFlags flags);
 		TriggerTypeFlags GetFlags() const;
 
+		/// <summary>
+		/// Gets the handles of the bodies that are currently inside the trigger, sorted in
+		/// ascending order. Use Scene::GetPhysicsBody to get the bodies
+		/// </summary>
+		const std::vector<int>& GetOverlaps() const { return _overlaps; }
+
 		// Inherited from IComponent
 
 		virtual void Awake() override;
@@ -51,10 +62,20 @@ namespace Gameplay::Physics {
 		MAKE_TYPENAME(TriggerVolume);
 
 	protected:
+		friend class Gameplay::Scene;
+
 		btPairCachingGhostObject*   _ghost;
 		TriggerTypeFlags            _typeFlags;
 
-		std::vector<std::weak_ptr<RigidBody>> _currentCollisions;
+		// Handles of the bodies that were inside the trigger after the last step, sorted
+		std::vector<int> _overlaps;
+		// Handles of the bodies touching the trigger in this step, may contain duplicates
+		std::vector<int> _pendingOverlaps;
+
+		/// <summary>
+		/// Invoked by the scene for each body that has contacts with our ghost object
+		/// </summary>
+		void _AddContact(const btCollisionObject* other);
 
 		virtual btBroadphaseProxy* _GetBroadphaseHandle() override;
 
@@ -0,0 +1,185 @@
+#include "Gameplay/RenderQueue.h"
+
+#include <algorithm>
+#include <numeric>
+#include <GLM/gtc/matrix_inverse.hpp>
+
+namespace Gameplay {
+	RenderQueue::RenderQueue() :
+		_packets(std::vector<DrawPacket>()),
+		_transforms(std::vector<glm::mat4>()),
+		_morphStates(std::vector<MorphClip::FrameState>()),
+		_instanceData(std::vector<InstanceData>()),
+		_instanceAlignment(1),
+		_instancingEnabled(true),
+		_stats(Stats())
+	{ }
+
+	void RenderQueue::BeginFrame() {
+		// Lazy init, since we need a GL context to be around to query the alignment
+		_instanceAlignment = StreamingBuffer::GetStorageAlignment();
+
+		_stats.Reset();
+	}
+
+	void RenderQueue::Submit(const VertexArrayObject::Sptr& mesh, const Material::Sptr& material, const glm::mat4& transform,
+		const MorphClip::FrameState& morph) {
+		uint64_t shaderId   = _GetId(_shaderIds, material->GetShader().get());
+		uint64_t materialId = _GetId(_materialIds, material.get());
+		uint64_t meshId     = _GetId(_meshIds, mesh.get());
+
+		// Keep a reference to any new resources so we can get back to them from the sort key
+		if (materialId == _materials.size()) {
+			_materials.push_back(material);
+		}
+		if (meshId == _meshes.size()) {
+			_meshes.push_back(mesh);
+		}
+
+		DrawPacket packet;
+		packet.SortKey =
+			(shaderId << (MaterialBits + MeshBits)) |
+			(materialId << MeshBits) |
+			meshId;
+		packet.TransformIndex = static_cast<uint32_t>(_transforms.size());
+
+		_packets.push_back(packet);
+		_transforms.push_back(transform);
+		_morphStates.push_back(morph);
+	}
+
+	void RenderQueue::Flush(uint32_t instanceSlot, const ObjectUniformCallback& uploadObjectUniforms) {
+		if (!_packets.empty()) {
+			std::sort(_packets.begin(), _packets.end(), [](const DrawPacket& a, const DrawPacket& b) {
+				return a.SortKey < b.SortKey;
+			});
+
+			// A run of packets that can be drawn with a single bind of the shader, material and mesh
+			struct Batch {
+				size_t   FirstPacket;
+				size_t   PacketCount;
+				uint32_t FirstInstance;
+				bool     Instanced;
+			};
+			std::vector<Batch> batches;
+
+			const uint64_t materialMask = (1ull << MaterialBits) - 1;
+			const uint64_t meshMask     = (1ull << MeshBits) - 1;
+			// The smallest number of instances that is a multiple of the offset alignment, InstanceData
+			// is not a power of two in size so we can't just divide
+			const size_t   alignInstances = _instanceAlignment / std::gcd<size_t, size_t>(_instanceAlignment, sizeof(InstanceData));
+			_instanceData.clear();
+
+			// Build our batches, and fill in the instance data for the ones that can be instanced
+			for (size_t ix = 0; ix < _packets.size();) {
+				size_t end = ix + 1;
+				if (_instancingEnabled) {
+					while (end < _packets.size() && _packets[end].SortKey == _packets[ix].SortKey) {
+						end++;
+					}
+				}
+
+				const Material::Sptr& material = _materials[(_packets[ix].SortKey >> MeshBits) & materialMask];
+
+				Batch batch;
+				batch.FirstPacket = ix;
+				batch.PacketCount = end - ix;
+				batch.Instanced = material->GetShader()->GetStorageBlockBinding(InstanceBlockName) >= 0;
+				batch.FirstInstance = 0;
+
+				if (batch.Instanced) {
+					// Pad so that the range we bind starts on a valid offset
+					size_t aligned = ((_instanceData.size() + alignInstances - 1) / alignInstances) * alignInstances;
+					_instanceData.resize(aligned);
+					batch.FirstInstance = static_cast<uint32_t>(aligned);
+
+					for (size_t p = ix; p < end; p++) {
+						const glm::mat4& model = _transforms[_packets[p].TransformIndex];
+						const MorphClip::FrameState& morph = _morphStates[_packets[p].TransformIndex];
+						InstanceData data;
+						data.Model = model;
+						// Only need the inverse of the upper 3x3 for the normal matrix
+						data.NormalMatrix = glm::mat4(glm::inverseTranspose(glm::mat3(model)));
+						data.MorphOffsets = morph.Offsets;
+						data.MorphScaleBlend = morph.ScaleBlend;
+						_instanceData.push_back(data);
+					}
+				}
+
+				batches.push_back(batch);
+				ix = end;
+			}
+
+			// All of this flush's instances go up in a single upload, the batches bind ranges of it. Since the
+			// upload is aligned, the padded FirstInstance offsets are too. The per-object uniforms streamed
+			// below can grow the buffer, but the allocation holds on to the buffer it was made in
+			StreamingBuffer& stream = StreamingBuffer::Get();
+			StreamingBuffer::Allocation instances;
+			if (!_instanceData.empty()) {
+				instances = stream.Upload(_instanceData.data(), static_cast<uint32_t>(_instanceData.size() * sizeof(InstanceData)), _instanceAlignment);
+			}
+
+			// Draw our batches, only changing state when we need to
+			ShaderProgram* boundShader = nullptr;
+			Material*      boundMaterial = nullptr;
+			for (const Batch& batch : batches) {
+				const uint64_t key = _packets[batch.FirstPacket].SortKey;
+				Material* material = _materials[(key >> MeshBits) & materialMask].get();
+				const VertexArrayObject::Sptr& mesh = _meshes[key & meshMask];
+
+				ShaderProgram* shader = material->GetShader().get();
+				if (shader != boundShader) {
+					shader->Bind();
+					boundShader = shader;
+					boundMaterial = nullptr;
+					_stats.ShaderChanges++;
+				}
+				if (material != boundMaterial) {
+					material->Apply();
+					boundMaterial = material;
+					_stats.MaterialChanges++;
+				}
+
+				if (batch.Instanced) {
+					StreamingBuffer::Allocation range = instances;
+					range.Offset += batch.FirstInstance * sizeof(InstanceData);
+					range.Size = static_cast<uint32_t>(batch.PacketCount * sizeof(InstanceData));
+					stream.BindRange(BufferType::ShaderStorage, instanceSlot, range);
+					mesh->DrawInstanced(static_cast<uint32_t>(batch.PacketCount));
+					_stats.DrawCalls++;
+					if (batch.PacketCount > 1) {
+						_stats.InstancedDrawCalls++;
+					}
+				} else {
+					for (size_t p = batch.FirstPacket; p < batch.FirstPacket + batch.PacketCount; p++) {
+						uploadObjectUniforms(_transforms[_packets[p].TransformIndex]);
+						mesh->Draw();
+						_stats.DrawCalls++;
+					}
+				}
+			}
+
+			_stats.Objects += static_cast<uint32_t>(_packets.size());
+		}
+
+		// Reset for the next batch of submissions, we hang on to the capacity of our containers
+		_packets.clear();
+		_transforms.clear();
+		_morphStates.clear();
+		_shaderIds.clear();
+		_materialIds.clear();
+		_meshIds.clear();
+		_materials.clear();
+		_meshes.clear();
+	}
+
+	uint32_t RenderQueue::_GetId(std::unordered_map<const void*, uint32_t>& ids, const void* key) {
+		auto it = ids.find(key);
+		if (it != ids.end()) {
+			return it->second;
+		}
+		uint32_t result = static_cast<uint32_t>(ids.size());
+		ids[key] = result;
+		return result;
+	}
+}
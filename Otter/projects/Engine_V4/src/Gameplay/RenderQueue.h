@@ -0,0 +1,121 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+#include <GLM/glm.hpp>
+
+#include "Gameplay/Material.h"
+#include "Gameplay/MorphClip.h"
+#include "Graphics/VertexArrayObject.h"
+#include "Graphics/Buffers/StreamingBuffer.h"
+
+namespace Gameplay {
+	/// <summary>
+	/// Collects draw packets for a frame, sorts them by shader, material and mesh, and merges
+	/// objects that share a mesh and material into instanced draws
+	///
+	/// Per-instance data for each flush is written to the shared StreamingBuffer, each instanced
+	/// draw binds it's range of that upload to the b_InstanceData block (see
+	/// fragments/instance_uniforms.glsl). Shaders that do not declare that block are drawn one
+	/// object at a time, with the per-object uniforms provided by a callback
+	/// </summary>
+	class RenderQueue {
+	public:
+		// The name of the storage block that instanced shaders read from
+		static constexpr const char* InstanceBlockName = "b_InstanceData";
+
+		// Per-instance data, matches the std430 layout of b_InstanceData
+		struct InstanceData {
+			glm::mat4  Model;
+			glm::mat4  NormalMatrix;
+			// The morph animation frame for this instance, see MorphClip::FrameState
+			glm::uvec4 MorphOffsets;
+			glm::vec4  MorphScaleBlend;
+		};
+
+		// Counters for the work done by the queue, for comparing against unsorted rendering
+		struct Stats {
+			uint32_t Objects            = 0;
+			uint32_t DrawCalls          = 0;
+			uint32_t InstancedDrawCalls = 0;
+			uint32_t ShaderChanges      = 0;
+			uint32_t MaterialChanges    = 0;
+
+			void Reset() { *this = Stats(); }
+		};
+
+		// Callback for uploading per-object uniforms for shaders that don't support instancing
+		typedef std::function<void(const glm::mat4& model)> ObjectUniformCallback;
+
+		RenderQueue();
+		~RenderQueue() = default;
+
+		/// <summary>
+		/// Resets the stats, should be called once at the start of each frame
+		/// </summary>
+		void BeginFrame();
+
+		/// <summary>
+		/// Adds an object to be drawn the next time the queue is flushed
+		/// </summary>
+		/// <param name="mesh">The mesh to draw, must not be null</param>
+		/// <param name="material">The material to draw with, must not be null</param>
+		/// <param name="transform">The object's world transform</param>
+		/// <param name="morph">The object's morph animation frame, only read by morph shaders</param>
+		void Submit(const VertexArrayObject::Sptr& mesh, const Material::Sptr& material, const glm::mat4& transform,
+			const MorphClip::FrameState& morph = MorphClip::FrameState());
+
+		/// <summary>
+		/// Sorts and draws all the packets submitted since the last flush, then clears the queue
+		/// </summary>
+		/// <param name="instanceSlot">The shader storage slot that b_InstanceData is bound to</param>
+		/// <param name="uploadObjectUniforms">Invoked before drawing objects whose shaders don't support instancing</param>
+		void Flush(uint32_t instanceSlot, const ObjectUniformCallback& uploadObjectUniforms);
+
+		/// <summary>
+		/// Sets whether objects sharing a mesh and material are merged into instanced draws.
+		/// When disabled, every object gets it's own draw call (packets are still sorted)
+		/// </summary>
+		void SetInstancingEnabled(bool value) { _instancingEnabled = value; }
+		bool GetInstancingEnabled() const { return _instancingEnabled; }
+
+		/// <summary>
+		/// Gets the counters for everything drawn since BeginFrame was called
+		/// </summary>
+		const Stats& GetStats() const { return _stats; }
+
+	protected:
+		// A single object to be drawn. The sort key packs the shader, material and mesh IDs
+		// so that sorting the packets groups objects by state, most expensive state first
+		struct DrawPacket {
+			uint64_t SortKey;
+			uint32_t TransformIndex;
+		};
+
+		static constexpr int MeshBits     = 24;
+		static constexpr int MaterialBits = 24;
+		static constexpr int ShaderBits   = 16;
+
+		std::vector<DrawPacket> _packets;
+		std::vector<glm::mat4>  _transforms;
+		std::vector<MorphClip::FrameState> _morphStates;
+
+		// Maps the resources referenced by this flush's packets to the IDs used in the sort keys
+		std::unordered_map<const void*, uint32_t> _shaderIds;
+		std::unordered_map<const void*, uint32_t> _materialIds;
+		std::unordered_map<const void*, uint32_t> _meshIds;
+		std::vector<Material::Sptr>               _materials;
+		std::vector<VertexArrayObject::Sptr>      _meshes;
+
+		// CPU side copy of the current flush's instance data, streamed to the GPU in one go
+		std::vector<InstanceData>    _instanceData;
+		uint32_t                     _instanceAlignment;
+
+		bool  _instancingEnabled;
+		Stats _stats;
+
+		static uint32_t _GetId(std::unordered_map<const void*, uint32_t>& ids, const void* key);
+	};
+}
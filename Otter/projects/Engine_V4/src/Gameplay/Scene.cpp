@@ -3,14 +3,20 @@
 #include <GLFW/glfw3.h>
 #include <locale>
 #include <codecvt>
+#include <unordered_set>
+#include <chrono>
 
 #include "Utils/FileHelpers.h"
 #include "Utils/GlmBulletConversions.h"
+#include "LinearMath/btQuickprof.h"
+#include "Utils/JsonGlmHelpers.h"
 
 #include "Gameplay/Physics/RigidBody.h"
 #include "Gameplay/Physics/TriggerVolume.h"
+#include "Gameplay/Components/MorphAnimator.h"
 #include "Gameplay/MeshResource.h"
 #include "Gameplay/Material.h"
+#include "Gameplay/SceneBinary.h"
 
 #include "Graphics/DebugDraw.h"
 #include "Graphics/Textures/TextureCube.h"
@@ -21,6 +27,11 @@ namespace Gameplay {
 	Scene::Scene() :
 		_objects(std::vector<GameObject::Sptr>()),
 		_deletionQueue(std::vector<std::weak_ptr<GameObject>>()),
+		_objectsByGuid(std::unordered_map<Guid, GameObject::Sptr>()),
+		_objectsByName(std::unordered_multimap<std::string, GameObject*>()),
+		_nextObjectOrder(0),
+		_transforms(),
+		_batchedTransforms(false),
 		IsPlaying(false),
 		IsDestroyed(false),
 		MainCamera(nullptr),
@@ -32,8 +43,17 @@ namespace Gameplay {
 		_skyboxTexture(nullptr),
 		_skyboxRotation(glm::mat3(1.0f)),
 		_ambientLight(glm::vec3(0.1f)),
-		_gravity(glm::vec3(0.0f, 0.0f, -9.81f))
+		_gravity(glm::vec3(0.0f, 0.0f, -9.81f)),
+		_physicsTimestep(1.0f / 60.0f),
+		_maxPhysicsSubsteps(4),
+		_physicsAccumulator(0.0f),
+		_physicsAlpha(0.0f),
+		_physicsStats(PhysicsStats()),
+		_physicsHandles(std::vector<PhysicsHandleSlot>()),
+		_freePhysicsHandles(std::vector<int>()),
+		_triggerEvents(std::vector<TriggerEvent>())
 	{
+		_physicsStats.Reset();
 		GameObject::Sptr mainCam = CreateGameObject("Main Camera");		
 		MainCamera = mainCam->Add<Camera>();
 
@@ -47,6 +67,8 @@ namespace Gameplay {
 		_skyboxShader = nullptr;
 		_skyboxMesh = nullptr;
 		_skyboxTexture = nullptr;
+		_objectsByGuid.clear();
+		_objectsByName.clear();
 		_objects.clear();
 		_components.Clear();
 		_CleanupPhysics();
@@ -96,10 +118,14 @@ namespace Gameplay {
 	GameObject::Sptr Scene::CreateGameObject(const std::string& name)
 	{
 		GameObject::Sptr result(new GameObject());
-		result->Name = name;
+		result->_name = name;
 		result->_scene = this;
 		result->_selfRef = result;
 		_objects.push_back(result);
+		_IndexObject(result);
+		if (_batchedTransforms) {
+			_AttachTransform(result);
+		}
 		return result;
 	}
 
@@ -111,17 +137,13 @@ namespace Gameplay {
 	}
 
 	GameObject::Sptr Scene::FindObjectByName(const std::string name) const {
-		auto it = std::find_if(_objects.begin(), _objects.end(), [&](const GameObject::Sptr& obj) {
-			return obj->Name == name;
-		});
-		return it == _objects.end() ? nullptr : *it;
+		GameObject* result = _FindIndexedName(name);
+		return result == nullptr ? nullptr : result->SelfRef();
 	}
 
 	GameObject::Sptr Scene::FindObjectByGUID(Guid id) const {
-		auto it = std::find_if(_objects.begin(), _objects.end(), [&](const GameObject::Sptr& obj) {
-			return obj->_guid == id;
-		});
-		return it == _objects.end() ? nullptr : *it;
+		auto it = _objectsByGuid.find(id);
+		return it == _objectsByGuid.end() ? nullptr : it->second;
 	}
 
 	void Scene::SetAmbientLight(const glm::vec3& value) {
@@ -156,25 +178,96 @@ namespace Gameplay {
 		_isAwake = true;
 	}
 
+	void Scene::SetPhysicsTimestep(float seconds) {
+		LOG_ASSERT(seconds > 0.0f, "Physics timestep must be greater than 0");
+		_physicsTimestep = seconds;
+	}
+
+	void Scene::SetMaxPhysicsSubsteps(int value) {
+		_maxPhysicsSubsteps = glm::max(1, value);
+	}
+
 	void Scene::DoPhysics(float dt) {
-		_components.Each<Gameplay::Physics::RigidBody>([=](const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
-			body->PhysicsPreStep(dt);
-		});
-		_components.Each<Gameplay::Physics::TriggerVolume>([=](const std::shared_ptr<Gameplay::Physics::TriggerVolume>& body) {
-			body->PhysicsPreStep(dt);
-		});
+		StepPhysics(dt);
+		DispatchPhysicsEvents();
+	}
 
-		if (IsPlaying) {
+	void Scene::StepPhysics(float dt) {
+		using Clock = std::chrono::high_resolution_clock;
+		const Clock::time_point frameStart = Clock::now();
+		_physicsStats.Reset();
+
+		// When we're not playing, we still want bodies to follow their objects around in the editor
+		if (!IsPlaying) {
+			_components.Each<Gameplay::Physics::RigidBody>([&](Gameplay::Physics::RigidBody* body) {
+				_physicsStats.BodiesPushed += body->PhysicsPreStep(dt) ? 1 : 0;
+			});
+			_components.Each<Gameplay::Physics::TriggerVolume>([&](Gameplay::Physics::TriggerVolume* body) {
+				_physicsStats.BodiesPushed += body->PhysicsPreStep(dt) ? 1 : 0;
+			});
+			_physicsAccumulator = 0.0f;
+			_physicsAlpha = 0.0f;
+			return;
+		}
 
-			_physicsWorld->stepSimulation(dt, 1);
+		_physicsAccumulator += dt;
 
-			_components.Each<Gameplay::Physics::RigidBody>([=](const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
-				body->PhysicsPostStep(dt);
+		// Figure out how many steps we need to catch up, if we'd need more than we're allowed
+		// we throw away the extra time, otherwise a slow frame would make the next one even slower
+		int steps = static_cast<int>(_physicsAccumulator / _physicsTimestep);
+		if (steps > _maxPhysicsSubsteps) {
+			_physicsStats.DroppedTime = _physicsAccumulator - _maxPhysicsSubsteps * _physicsTimestep;
+			_physicsAccumulator -= _physicsStats.DroppedTime;
+			steps = _maxPhysicsSubsteps;
+		}
+
+		for (int ix = 0; ix < steps; ix++) {
+			BT_PROFILE("Scene::PhysicsSubstep");
+			const Clock::time_point stepStart = Clock::now();
+
+			// Only objects that have moved since the last step get pushed to bullet
+			_components.Each<Gameplay::Physics::RigidBody>([&](Gameplay::Physics::RigidBody* body) {
+				_physicsStats.BodiesPushed += body->PhysicsPreStep(_physicsTimestep) ? 1 : 0;
+			});
+			_components.Each<Gameplay::Physics::TriggerVolume>([&](Gameplay::Physics::TriggerVolume* body) {
+				_physicsStats.BodiesPushed += body->PhysicsPreStep(_physicsTimestep) ? 1 : 0;
+			});
+
+			// With no max substeps, bullet will do exactly one step of the given length
+			_physicsWorld->stepSimulation(_physicsTimestep, 0);
+			_CollectTriggerContacts();
+
+			// And only bodies that bullet moved get pulled back
+			_components.Each<Gameplay::Physics::RigidBody>([&](Gameplay::Physics::RigidBody* body) {
+				_physicsStats.BodiesPulled += body->PhysicsPostStep(_physicsTimestep) ? 1 : 0;
 			});
-			_components.Each<Gameplay::Physics::TriggerVolume>([=](const std::shared_ptr<Gameplay::Physics::TriggerVolume>& body) {
-				body->PhysicsPostStep(dt);
+			_components.Each<Gameplay::Physics::TriggerVolume>([&](Gameplay::Physics::TriggerVolume* body) {
+				body->PhysicsPostStep(_physicsTimestep);
 			});
+
+			_physicsAccumulator -= _physicsTimestep;
+
+			const float stepMs = static_cast<float>(std::chrono::duration<double, std::milli>(Clock::now() - stepStart).count());
+			_physicsStats.MaxSubstepMs = glm::max(_physicsStats.MaxSubstepMs, stepMs);
+			_physicsStats.AverageSubstepMs += stepMs;
+			_physicsStats.Substeps++;
 		}
+		if (_physicsStats.Substeps > 0) {
+			_physicsStats.AverageSubstepMs /= _physicsStats.Substeps;
+		}
+
+		// Place our bodies between their last two states, based on how much time is left over
+		_physicsAlpha = glm::clamp(_physicsAccumulator / _physicsTimestep, 0.0f, 1.0f);
+		_components.Each<Gameplay::Physics::RigidBody>([=](Gameplay::Physics::RigidBody* body) {
+			body->PhysicsInterpolate(_physicsAlpha);
+		});
+
+		_physicsStats.TotalMs = static_cast<float>(std::chrono::duration<double, std::milli>(Clock::now() - frameStart).count());
+	}
+
+	void Scene::DispatchPhysicsEvents() {
+		// Now that all the steps are done it's safe to let gameplay code respond to triggers
+		_DispatchTriggerEvents();
 	}
 
 	void Scene::DrawPhysicsDebug() {
@@ -185,6 +278,12 @@ namespace Gameplay {
 	}
 
 	void Scene::Update(float dt) {
+		UpdateObjects(dt);
+		UpdateAnimation(dt);
+		UpdateTransforms();
+	}
+
+	void Scene::UpdateObjects(float dt) {
 		_FlushDeleteQueue();
 		if (IsPlaying) {
 			for (int i = 0; i < _objects.size(); i++) {
@@ -194,6 +293,20 @@ namespace Gameplay {
 		_FlushDeleteQueue();
 	}
 
+	void Scene::UpdateAnimation(float dt) {
+		// Morph animators are advanced all at once rather than per object
+		if (IsPlaying) {
+			MorphAnimator::UpdateAll(_components, dt);
+		}
+	}
+
+	void Scene::UpdateTransforms() {
+		// Objects don't update their own transforms when batching, so do them all in one go
+		if (_batchedTransforms) {
+			_transforms.Update();
+		}
+	}
+
 	void Scene::RenderGUI()
 	{
 		for (auto& obj : _objects) {
@@ -208,47 +321,158 @@ namespace Gameplay {
 		return _physicsWorld;
 	}
 
+	Physics::PhysicsBase* Scene::GetPhysicsBody(int handle) const {
+		if (handle < 0) {
+			return nullptr;
+		}
+		const size_t slot = handle & ((1 << PhysicsHandleSlotBits) - 1);
+		if (slot >= _physicsHandles.size() || _physicsHandles[slot].Generation != (handle >> PhysicsHandleSlotBits)) {
+			return nullptr;
+		}
+		return _physicsHandles[slot].Body;
+	}
+
+	int Scene::_RegisterPhysicsBody(Physics::PhysicsBase* body) {
+		int slot;
+		if (!_freePhysicsHandles.empty()) {
+			slot = _freePhysicsHandles.back();
+			_freePhysicsHandles.pop_back();
+		} else {
+			LOG_ASSERT(_physicsHandles.size() < (1 << PhysicsHandleSlotBits), "Too many physics bodies in scene!");
+			slot = static_cast<int>(_physicsHandles.size());
+			_physicsHandles.push_back({ nullptr, 0 });
+		}
+		_physicsHandles[slot].Body = body;
+		return (_physicsHandles[slot].Generation << PhysicsHandleSlotBits) | slot;
+	}
+
+	void Scene::_UnregisterPhysicsBody(int handle) {
+		if (GetPhysicsBody(handle) == nullptr) {
+			return;
+		}
+		// Bump the generation so that any copies of the handle stop resolving, keeping it positive
+		const int slot = handle & ((1 << PhysicsHandleSlotBits) - 1);
+		_physicsHandles[slot].Body = nullptr;
+		_physicsHandles[slot].Generation = (_physicsHandles[slot].Generation + 1) & ((1 << (31 - PhysicsHandleSlotBits)) - 1);
+		_freePhysicsHandles.push_back(slot);
+	}
+
+	void Scene::_CollectTriggerContacts() {
+		// The world has already generated contacts for everything overlapping our ghost objects,
+		// so a single pass over the manifolds gives us every trigger's contents
+		btDispatcher* dispatcher = _physicsWorld->getDispatcher();
+		const int manifoldCount = dispatcher->getNumManifolds();
+		for (int ix = 0; ix < manifoldCount; ix++) {
+			const btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(ix);
+			if (manifold->getNumContacts() == 0) {
+				continue;
+			}
+
+			// Only trigger volumes register ghost objects with the scene
+			const btCollisionObject* a = manifold->getBody0();
+			const btCollisionObject* b = manifold->getBody1();
+			if (a->getInternalType() == btCollisionObject::CO_GHOST_OBJECT) {
+				Physics::TriggerVolume* trigger = static_cast<Physics::TriggerVolume*>(GetPhysicsBody(a->getUserIndex()));
+				if (trigger != nullptr) {
+					trigger->_AddContact(b);
+				}
+			}
+			if (b->getInternalType() == btCollisionObject::CO_GHOST_OBJECT) {
+				Physics::TriggerVolume* trigger = static_cast<Physics::TriggerVolume*>(GetPhysicsBody(b->getUserIndex()));
+				if (trigger != nullptr) {
+					trigger->_AddContact(a);
+				}
+			}
+		}
+	}
+
+	void Scene::_DispatchTriggerEvents() {
+		for (size_t ix = 0; ix < _triggerEvents.size(); ix++) {
+			const TriggerEvent event = _triggerEvents[ix];
+
+			// Either side may have been destroyed by an earlier callback, or since the event was found
+			Physics::PhysicsBase* triggerBase = GetPhysicsBody(event.Trigger);
+			Physics::PhysicsBase* bodyBase = GetPhysicsBody(event.Body);
+			if (triggerBase == nullptr || bodyBase == nullptr || triggerBase->GetGameObject() == bodyBase->GetGameObject()) {
+				continue;
+			}
+			Physics::TriggerVolume::Sptr trigger = std::static_pointer_cast<Physics::TriggerVolume>(triggerBase->SelfRef().lock());
+			Physics::RigidBody::Sptr body = std::static_pointer_cast<Physics::RigidBody>(bodyBase->SelfRef().lock());
+			if (trigger == nullptr || body == nullptr) {
+				continue;
+			}
+
+			if (event.Entered) {
+				body->GetGameObject()->OnEnteredTrigger(trigger);
+				trigger->GetGameObject()->OnTriggerVolumeEntered(body);
+			} else {
+				body->GetGameObject()->OnLeavingTrigger(trigger);
+				trigger->GetGameObject()->OnTriggerVolumeLeaving(body);
+			}
+		}
+		_triggerEvents.clear();
+	}
+
 	Scene::Sptr Scene::FromJson(const nlohmann::json& data)
 	{
-
 		Scene::Sptr result = std::make_shared<Scene>();
-		result->MainCamera = nullptr;
-		result->_objects.clear();
-		result->DefaultMaterial = ResourceManager::Get<Material>(Guid(data["default_material"]));
+		result->_LoadSettings(data);
+
+		// Make sure the scene has objects, then load them all in!
+		LOG_ASSERT(data["objects"].is_array(), "Objects not present in scene!");
+		for (auto& object : data["objects"]) {
+			result->_AddLoadedObject(GameObject::FromJson(result.get(), object));
+		}
+
+		result->_FinishLoad(data);
+		return result;
+	}
+
+	void Scene::_LoadSettings(const nlohmann::json& data) {
+		MainCamera = nullptr;
+		_objectsByGuid.clear();
+		_objectsByName.clear();
+		_objects.clear();
+		DefaultMaterial = ResourceManager::Get<Material>(Guid(data["default_material"]));
 
 		if (data.contains("ambient")) {
-			result->SetAmbientLight((data["ambient"]));
+			SetAmbientLight((data["ambient"]));
 		}
 
+		SetPhysicsTimestep(JsonGet(data, "physics_timestep", 1.0f / 60.0f));
+		SetMaxPhysicsSubsteps(JsonGet(data, "max_physics_substeps", 4));
+
 		if (data.contains("skybox") && data["skybox"].is_object()) {
 			nlohmann::json& blob = data["skybox"].get<nlohmann::json>();
-			result->_skyboxMesh = ResourceManager::Get<MeshResource>(Guid(blob["mesh"]));
-			result->SetSkyboxShader(ResourceManager::Get<ShaderProgram>(Guid(blob["shader"])));
-			result->SetSkyboxTexture(ResourceManager::Get<TextureCube>(Guid(blob["texture"])));
-			result->SetSkyboxRotation(glm::mat3_cast((glm::quat)(blob["orientation"])));
+			_skyboxMesh = ResourceManager::Get<MeshResource>(Guid(blob["mesh"]));
+			SetSkyboxShader(ResourceManager::Get<ShaderProgram>(Guid(blob["shader"])));
+			SetSkyboxTexture(ResourceManager::Get<TextureCube>(Guid(blob["texture"])));
+			SetSkyboxRotation(glm::mat3_cast((glm::quat)(blob["orientation"])));
 		}
+	}
 
-		// Make sure the scene has objects, then load them all in!
-		LOG_ASSERT(data["objects"].is_array(), "Objects not present in scene!");
-		for (auto& object : data["objects"]) {
-			GameObject::Sptr obj = GameObject::FromJson(result.get(), object);
-			obj->_scene = result.get();
-			obj->_parent.SceneContext = result.get();
-			obj->_selfRef = obj;
-			result->_objects.push_back(obj);
-		}
+	void Scene::_AddLoadedObject(const GameObject::Sptr& object) {
+		object->_scene = this;
+		object->_parent.SceneContext = this;
+		object->_selfRef = object;
+		_objects.push_back(object);
+		_IndexObject(object);
+	}
 
+	void Scene::_FinishLoad(const nlohmann::json& data) {
 		// Re-build the parent hierarchy 
-		for (const auto& object : result->_objects) {
+		for (const auto& object : _objects) {
 			if (object->GetParent() != nullptr) {
 				object->GetParent()->AddChild(object);
 			}
 		}
 
+		if (JsonGet(data, "batched_transforms", false)) {
+			SetBatchedTransformsEnabled(true);
+		}
+
 		// Create and load camera config
-		result->MainCamera = result->_components.GetComponentByGUID<Camera>(Guid(data["main_camera"]));
-	
-		return result;
+		MainCamera = _components.GetComponentByGUID<Camera>(Guid(data["main_camera"]));
 	}
 
 	nlohmann::json Scene::ToJson() const
@@ -258,6 +482,9 @@ namespace Gameplay {
 		blob["default_material"] = DefaultMaterial ? DefaultMaterial->GetGUID().str() : "null";
 
 		blob["ambient"] = GetAmbientLight();
+		blob["batched_transforms"] = _batchedTransforms;
+		blob["physics_timestep"] = _physicsTimestep;
+		blob["max_physics_substeps"] = _maxPhysicsSubsteps;
 
 		blob["skybox"] = nlohmann::json();
 		blob["skybox"]["mesh"] = _skyboxMesh ? _skyboxMesh->GetGUID().str() : "null";
@@ -282,13 +509,28 @@ namespace Gameplay {
 	void Scene::Save(const std::string& path) {
 		_filePath = path;
 		// Save data to file
-		FileHelpers::WriteContentsToFile(path, ToJson().dump(1, '\t'));
+		if (SceneBinary::IsBinaryScene(path)) {
+			SceneBinary::Write(ToJson(), path);
+		} else {
+			FileHelpers::WriteContentsToFile(path, ToJson().dump(1, '\t'));
+		}
 		LOG_INFO("Saved scene to \"{}\"", path);
 	}
 
 	Scene::Sptr Scene::Load(const std::string& path)
 	{
 		LOG_INFO("Loading scene from \"{}\"", path);
+
+		// Binary scenes get loaded all in one go
+		if (SceneBinary::IsBinaryScene(path)) {
+			SceneBinaryLoader::Sptr loader = SceneBinaryLoader::Open(path);
+			if (loader == nullptr) {
+				return nullptr;
+			}
+			loader->Step(-1.0);
+			return loader->GetScene();
+		}
+
 		std::string content = FileHelpers::ReadFile(path);
 		nlohmann::json blob = nlohmann::json::parse(content);
 		Scene::Sptr result = FromJson(blob);
@@ -331,18 +573,117 @@ namespace Gameplay {
 		delete _ghostCallback;
 		delete _collisionDispatcher;
 		delete _collisionConfig;
+		delete _bulletDebugDraw;
 	}
 
-
 	void Scene::_FlushDeleteQueue() {
+		if (_deletionQueue.empty()) return;
+
+		// Collect the objects to remove and drop them from the lookup tables
+		std::unordered_set<GameObject*> toRemove;
 		for (auto& weakPtr : _deletionQueue) {
-			if (weakPtr.expired()) continue;
-			auto& it = std::find(_objects.begin(), _objects.end(), weakPtr.lock());
-			if (it != _objects.end()) {
-				_objects.erase(it);
+			GameObject::Sptr object = weakPtr.lock();
+			if (object != nullptr && toRemove.insert(object.get()).second) {
+				_UnindexObject(object);
+				_DetachTransform(object);
 			}
 		}
 		_deletionQueue.clear();
+
+		// Remove all the objects in a single pass over the object list
+		auto it = std::remove_if(_objects.begin(), _objects.end(), [&](const GameObject::Sptr& object) {
+			return toRemove.count(object.get()) > 0;
+		});
+		_objects.erase(it, _objects.end());
+	}
+
+	void Scene::SetBatchedTransformsEnabled(bool enabled) {
+		if (enabled == _batchedTransforms) {
+			return;
+		}
+		_batchedTransforms = enabled;
+
+		if (enabled) {
+			// Create all the transforms first, so that parents have handles when we link up the hierarchy
+			for (const auto& object : _objects) {
+				_AttachTransform(object);
+			}
+			for (const auto& object : _objects) {
+				GameObject::Sptr parent = object->GetParent();
+				if (parent != nullptr && parent->_transformHandle != TransformSystem::InvalidHandle) {
+					_transforms.SetParent(object->_transformHandle, parent->_transformHandle);
+				}
+			}
+			_transforms.Update();
+		} else {
+			for (const auto& object : _objects) {
+				object->_transformHandle = TransformSystem::InvalidHandle;
+				object->_isLocalTransformDirty = true;
+			}
+			_transforms.Clear();
+		}
+	}
+
+	void Scene::_AttachTransform(const GameObject::Sptr& object) {
+		object->_transformHandle = _transforms.Create(object->_position, object->_rotation, object->_scale);
+	}
+
+	void Scene::_DetachTransform(const GameObject::Sptr& object) {
+		if (object->_transformHandle != TransformSystem::InvalidHandle) {
+			_transforms.Destroy(object->_transformHandle);
+			object->_transformHandle = TransformSystem::InvalidHandle;
+			// The object may still be referenced elsewhere, so make sure it can calculate it's own transform
+			object->_isLocalTransformDirty = true;
+		}
+	}
+
+	void Scene::_IndexObject(const GameObject::Sptr& object) {
+		object->_sceneOrder = _nextObjectOrder++;
+		_objectsByGuid[object->_guid] = object;
+		_objectsByName.emplace(object->_name, object.get());
+	}
+
+	void Scene::_UnindexObject(const GameObject::Sptr& object) {
+		auto it = _objectsByGuid.find(object->_guid);
+		if (it != _objectsByGuid.end() && it->second == object) {
+			_objectsByGuid.erase(it);
+		}
+		_RemoveNameIndex(object.get());
+	}
+
+	void Scene::_RemoveNameIndex(GameObject* object) {
+		auto range = _objectsByName.equal_range(object->_name);
+		for (auto it = range.first; it != range.second; it++) {
+			if (it->second == object) {
+				_objectsByName.erase(it);
+				return;
+			}
+		}
+	}
+
+	void Scene::_RenameObject(GameObject* object, const std::string& name) {
+		// Objects that aren't in our lookup tables yet (ex: while loading) only need the new name
+		auto it = _objectsByGuid.find(object->_guid);
+		const bool indexed = it != _objectsByGuid.end() && it->second.get() == object;
+		if (indexed) {
+			_RemoveNameIndex(object);
+		}
+		object->_name = name;
+		if (indexed) {
+			_objectsByName.emplace(object->_name, object);
+		}
+	}
+
+	GameObject* Scene::_FindIndexedName(const std::string& name) const {
+		GameObject* result = nullptr;
+		auto range = _objectsByName.equal_range(name);
+		for (auto it = range.first; it != range.second; it++) {
+			// Prefer the object that was added first
+			if (result == nullptr || it->second->_sceneOrder < result->_sceneOrder) {
+				result = it->second;
+			}
+		}
+		return result;
 	}
 
 	void Scene::DrawAllGameObjectGUIs()
@@ -20,7 +20,9 @@ class HierarchyWindow;
 
 namespace Gameplay {
 	namespace Physics {
+		class PhysicsBase;
 		class RigidBody;
+		class TriggerVolume;
 	}
 
 	class MeshResource;
@@ -34,6 +36,26 @@ namespace Gameplay {
 	class Scene {
 	public:
 		typedef std::shared_ptr<Scene> Sptr;
+
+		/// <summary>
+		/// Timing info for the physics steps taken in the last frame
+		/// </summary>
+		struct PhysicsStats {
+			// The number of fixed steps that were simulated
+			int   Substeps;
+			// The average and longest time spent simulating a single step, in milliseconds
+			float AverageSubstepMs;
+			float MaxSubstepMs;
+			// The total time spent in DoPhysics, in milliseconds
+			float TotalMs;
+			// Simulation time that was thrown away because we hit the substep limit, in seconds
+			float DroppedTime;
+			// The number of transforms copied from objects to bullet, and from bullet back to objects
+			int   BodiesPushed;
+			int   BodiesPulled;
+
+			void Reset() { Substeps = BodiesPushed = BodiesPulled = 0; AverageSubstepMs = MaxSubstepMs = TotalMs = DroppedTime = 0.0f; }
+		};
 		
 		// The camera for our scene
 		Camera::Sptr               MainCamera;
@@ -87,6 +109,8 @@ namespace Gameplay {
 		/// Searches all objects in the scene and returns the first
 		/// one who's name matches the one given, or nullptr if no object
 		/// is found
+		/// 
+		/// Lookups go through a name index, which GameObject::SetName keeps up to date
 		/// </summary>
 		/// <param name="name">The name of the object to find</param>
 		GameObject::Sptr FindObjectByName(const std::string name) const;
@@ -108,6 +132,18 @@ namespace Gameplay {
 		/// </summary>
 		const glm::vec3& GetAmbientLight() const;
 
+		/// <summary>
+		/// Sets whether this scene stores it's object transforms in a batched transform system,
+		/// which updates all dirty transforms in a single pass per frame. Objects already in the
+		/// scene will be moved into or out of the transform system
+		/// </summary>
+		/// <param name="enabled">True to use batched transforms, false to have objects calculate their own</param>
+		void SetBatchedTransformsEnabled(bool enabled);
+		/// <summary>
+		/// Gets whether this scene is using batched transforms
+		/// </summary>
+		bool GetBatchedTransformsEnabled() const { return _batchedTransforms; }
+
 		/// <summary>
 		/// Gets the file path that this scene was saved to or loaded from
 		/// </summary>
@@ -119,15 +155,63 @@ namespace Gameplay {
 		/// </summary>
 		void Awake();
 
+		/// <summary>
+		/// Sets the fixed timestep that physics is simulated with
+		/// </summary>
+		/// <param name="seconds">The length of a single physics step in seconds, default is 1/60</param>
+		void SetPhysicsTimestep(float seconds);
+		/// <summary>
+		/// Gets the fixed timestep that physics is simulated with, in seconds
+		/// </summary>
+		float GetPhysicsTimestep() const { return _physicsTimestep; }
+
+		/// <summary>
+		/// Sets the most physics steps that can be simulated in a single frame. If a frame takes
+		/// longer than this many steps, the extra time is dropped so that slow frames don't cause
+		/// even more physics work in the next frame
+		/// </summary>
+		/// <param name="value">The max number of steps per frame, at least 1</param>
+		void SetMaxPhysicsSubsteps(int value);
+		/// <summary>
+		/// Gets the most physics steps that can be simulated in a single frame
+		/// </summary>
+		int GetMaxPhysicsSubsteps() const { return _maxPhysicsSubsteps; }
+
+		/// <summary>
+		/// Gets how far the rendered rigidbody transforms are between the last two physics
+		/// steps, in the 0-1 range
+		/// </summary>
+		float GetPhysicsInterpolation() const { return _physicsAlpha; }
+		/// <summary>
+		/// Gets timing info for the physics steps that were simulated in the last frame
+		/// </summary>
+		const PhysicsStats& GetPhysicsStats() const { return _physicsStats; }
+
 		/// <summary>
 		/// Performs physics updates for all physics bodies in this scene,
 		/// should be called after Update in the main loop
 		/// 
+		/// Physics is stepped with a fixed timestep, running as many steps as fit into
+		/// the time since the last frame (up to the substep limit). Rigidbodies are then
+		/// placed between their last two states, so motion is smooth at any frame rate
+		/// 
 		/// Only invokes events if IsPlaying is true
 		/// </summary>
 		/// <param name="dt">The time in seconds since the last frame</param>
 		void DoPhysics(float dt);
 		/// <summary>
+		/// The first half of DoPhysics, steps the physics world and moves bodies to their new
+		/// positions, but holds on to trigger events. Does not run any gameplay code, so it is
+		/// safe to run alongside other work that doesn't touch transforms or physics
+		/// </summary>
+		/// <param name="dt">The time in seconds since the last frame</param>
+		void StepPhysics(float dt);
+		/// <summary>
+		/// The second half of DoPhysics, invokes the trigger callbacks for the events from the
+		/// last StepPhysics
+		/// </summary>
+		void DispatchPhysicsEvents();
+		/// <summary>
 		/// Renders debug information for the physics scene
 		/// </summary>
 		void DrawPhysicsDebug();
@@ -140,6 +224,13 @@ namespace Gameplay {
 		/// </summary>
 		/// <param name="dt">The time in seconds since the last frame</param>
 		void Update(float dt);
+		/// <summary>
+		/// The parts of Update, which can be called separately so they can be scheduled as
+		/// different tasks. Update is the same as calling these in order
+		/// </summary>
+		void UpdateObjects(float dt);
+		void UpdateAnimation(float dt);
+		void UpdateTransforms();
 
 		/// <summary>
 		/// Draws all GUI objects in the scene
@@ -158,6 +249,13 @@ namespace Gameplay {
 		/// Gets the scene's Bullet physics world
 		/// </summary>
 		btDynamicsWorld* GetPhysicsWorld() const;
+		/// <summary>
+		/// Gets the RigidBody or TriggerVolume with the given handle. Handles are stored in the
+		/// user index of each body's bullet collision object
+		/// </summary>
+		/// <param name="handle">The handle of the body to get</param>
+		/// <returns>The body, or nullptr if the handle is invalid or the body has been destroyed</returns>
+		Physics::PhysicsBase* GetPhysicsBody(int handle) const;
 
 		/// <summary>
 		/// Loads a scene from a JSON blob
@@ -172,15 +270,17 @@ namespace Gameplay {
 		const ComponentManager& Components() const { return _components; }
 
 		/// <summary>
-		/// Saves this scene to an output JSON file
+		/// Saves this scene to an output file. Paths with the .bscene extension are saved
+		/// in the binary scene format, everything else is saved as JSON
 		/// </summary>
 		/// <param name="path">The path of the file to write to</param>
 		void Save(const std::string& path);
 		/// <summary>
-		/// Loads a scene from an input JSON file
+		/// Loads a scene from an input file, either JSON or binary (.bscene). Binary scenes
+		/// can also be streamed in over multiple frames with a SceneBinaryLoader
 		/// </summary>
 		/// <param name="path">The path of the file to read from</param>
-		/// <returns>A new scene loaded from the file</returns>
+		/// <returns>A new scene loaded from the file, or nullptr if a binary scene could not be read</returns>
 		static Scene::Sptr Load(const std::string& path);
 
 
@@ -190,6 +290,9 @@ namespace Gameplay {
 	protected:
 		friend class HierarchyWindow;
 		friend class GameObject;
+		friend class SceneBinaryLoader;
+		friend class Physics::PhysicsBase;
+		friend class Physics::TriggerVolume;
 
 		// The component manager will store all components for objects in this scene
 		ComponentManager _components;
@@ -215,10 +318,46 @@ namespace Gameplay {
 		// Our physics scene's global gravity, default matches earth's gravity (m/s^2)
 		glm::vec3 _gravity;
 
+		// Physics is simulated in fixed steps, the accumulator stores time that has not
+		// been simulated yet
+		float        _physicsTimestep;
+		int          _maxPhysicsSubsteps;
+		float        _physicsAccumulator;
+		float        _physicsAlpha;
+		PhysicsStats _physicsStats;
+
+		// Handles are the slot index in the low bits, and the slot's generation in the high
+		// bits so that handles to destroyed bodies don't resolve to whatever replaced them
+		static constexpr int PhysicsHandleSlotBits = 20;
+		struct PhysicsHandleSlot {
+			Physics::PhysicsBase* Body;
+			int                   Generation;
+		};
+		std::vector<PhysicsHandleSlot> _physicsHandles;
+		std::vector<int>               _freePhysicsHandles;
+
+		// Trigger enter and exit events found while stepping, dispatched once stepping is done
+		struct TriggerEvent {
+			bool Entered;
+			int  Trigger;
+			int  Body;
+		};
+		std::vector<TriggerEvent> _triggerEvents;
+
 		// Stores all the objects in our scene
 		std::vector<GameObject::Sptr>  _objects;
 		std::vector<std::weak_ptr<GameObject>>  _deletionQueue;
 
+		// Lookup tables for finding objects, these are kept in sync with _objects
+		std::unordered_map<Guid, GameObject::Sptr>                   _objectsByGuid;
+		std::unordered_multimap<std::string, GameObject*>           _objectsByName;
+		// Incremented for each object added, so name lookups can return the first match
+		uint64_t                                                     _nextObjectOrder;
+
+		// Stores the transforms for all our objects when batched transforms are enabled
+		TransformSystem           _transforms;
+		bool                      _batchedTransforms;
+
 		// Info for rendering our skybox will be stored in the scene itself
 		std::shared_ptr<ShaderProgram>       _skyboxShader;
 		std::shared_ptr<MeshResource> _skyboxMesh;
@@ -240,7 +379,68 @@ namespace Gameplay {
 		/// Handles cleaning up bullet physics for this scene
 		/// </summary>
 		void _CleanupPhysics();
+		/// <summary>
+		/// Gives a physics body a handle that can be stored in bullet
+		/// </summary>
+		int _RegisterPhysicsBody(Physics::PhysicsBase* body);
+		/// <summary>
+		/// Releases a handle given out by _RegisterPhysicsBody
+		/// </summary>
+		void _UnregisterPhysicsBody(int handle);
+		/// <summary>
+		/// Walks the contact manifolds from the last step, and tells each trigger volume
+		/// which bodies are touching it
+		/// </summary>
+		void _CollectTriggerContacts();
+		/// <summary>
+		/// Invokes the trigger callbacks for all the events from this frame's steps
+		/// </summary>
+		void _DispatchTriggerEvents();
 
 		void _FlushDeleteQueue();
+
+		/// <summary>
+		/// Clears the scene's objects and loads the scene settings (default material, ambient
+		/// light and skybox) from a scene's JSON representation
+		/// </summary>
+		void _LoadSettings(const nlohmann::json& data);
+		/// <summary>
+		/// Adds an object that was just loaded to the scene
+		/// </summary>
+		void _AddLoadedObject(const GameObject::Sptr& object);
+		/// <summary>
+		/// Re-builds the object hierarchy and resolves the main camera once all objects
+		/// and components have been loaded
+		/// </summary>
+		void _FinishLoad(const nlohmann::json& data);
+
+		/// <summary>
+		/// Adds an object to the GUID and name lookup tables
+		/// </summary>
+		void _IndexObject(const GameObject::Sptr& object);
+		/// <summary>
+		/// Removes an object from the GUID and name lookup tables
+		/// </summary>
+		void _UnindexObject(const GameObject::Sptr& object);
+		/// <summary>
+		/// Removes an object from the name lookup table
+		/// </summary>
+		void _RemoveNameIndex(GameObject* object);
+		/// <summary>
+		/// Changes an object's name, moving it in the name lookup table if it has been indexed
+		/// </summary>
+		void _RenameObject(GameObject* object, const std::string& name);
+		/// <summary>
+		/// Creates a transform for the object in our transform system
+		/// </summary>
+		void _AttachTransform(const GameObject::Sptr& object);
+		/// <summary>
+		/// Removes the object's transform from our transform system, if it has one
+		/// </summary>
+		void _DetachTransform(const GameObject::Sptr& object);
+		/// <summary>
+		/// Finds the earliest created object in the name index with the given name
+		/// </summary>
+		GameObject* _FindIndexedName(const std::string& name) const;
 	};
 }
\ No newline at end of file
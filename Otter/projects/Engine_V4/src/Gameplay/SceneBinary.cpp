@@ -0,0 +1,747 @@
+#include "Gameplay/SceneBinary.h"
+
+#include <map>
+#include <fstream>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <unordered_map>
+
+#include "Logging.h"
+#include "Utils/FileHelpers.h"
+#include "Utils/JsonGlmHelpers.h"
+#include "Utils/ResourceManager/ResourceManager.h"
+#include "Gameplay/Components/RenderComponent.h"
+
+namespace Gameplay {
+	static constexpr uint32_t MakeChunkId(char a, char b, char c, char d) {
+		return (uint32_t)(uint8_t)a | ((uint32_t)(uint8_t)b << 8) | ((uint32_t)(uint8_t)c << 16) | ((uint32_t)(uint8_t)d << 24);
+	}
+
+	static const char FileMagic[4] = { 'O', 'S', 'C', 'N' };
+
+	// Scene settings, MessagePack encoded
+	static constexpr uint32_t ChunkMeta       = MakeChunkId('M', 'E', 'T', 'A');
+	// All object names and component type names, back to back with no terminators
+	static constexpr uint32_t ChunkStrings    = MakeChunkId('S', 'T', 'R', 'S');
+	// An array of ObjectRecords
+	static constexpr uint32_t ChunkObjects    = MakeChunkId('O', 'B', 'J', 'S');
+	// A SectionHeader followed by the component records for a single type
+	static constexpr uint32_t ChunkComponents = MakeChunkId('C', 'O', 'M', 'P');
+
+	struct FileHeader {
+		char     Magic[4];
+		uint32_t Version;
+		uint32_t ChunkCount;
+		uint32_t Reserved;
+	};
+
+	struct ChunkHeader {
+		uint32_t Id;
+		uint32_t Reserved;
+		// Size of the chunk's data, not including the header or padding
+		uint64_t Size;
+	};
+
+	struct SectionHeader {
+		uint32_t TypeNameOffset;
+		uint32_t TypeNameLength;
+		uint32_t Count;
+		uint32_t Reserved;
+	};
+
+	// Chunks are padded so that the next chunk header starts on an 8 byte boundary
+	static constexpr size_t ChunkAlignment = 8;
+	// Component payloads are padded so that the next record starts on a 4 byte boundary
+	static constexpr size_t PayloadAlignment = 4;
+
+	static size_t AlignUp(size_t value, size_t alignment) {
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	static Guid GuidFromBytes(const uint8_t* bytes) {
+		unsigned char copy[16];
+		memcpy(copy, bytes, 16);
+		return Guid::FromBytes(copy);
+	}
+
+	static std::string GuidStringFromBytes(const uint8_t* bytes) {
+		Guid guid = GuidFromBytes(bytes);
+		return guid.isValid() ? guid.str() : "null";
+	}
+
+	// Stores a GUID string as bytes, returns false if the string would not come back out the same
+	static bool PackGuid(const nlohmann::json& value, uint8_t* bytes) {
+		if (!value.is_string()) {
+			return false;
+		}
+		const std::string text = value.get<std::string>();
+		Guid guid = Guid(text);
+		if (guid.isValid() ? guid.str() != text : text != "null") {
+			return false;
+		}
+		memcpy(bytes, guid.bytes(), 16);
+		return true;
+	}
+
+	template <typename T>
+	static std::shared_ptr<T> ResourceFromBytes(const uint8_t* bytes) {
+		Guid guid = GuidFromBytes(bytes);
+		return guid.isValid() ? ResourceManager::Get<T>(guid) : nullptr;
+	}
+
+	/// <summary>
+	/// A component type with a fixed binary layout, so the loader can skip decoding JSON for it
+	/// </summary>
+	struct SceneBinary::ComponentCodec {
+		const char* TypeName;
+		// Packs the component's JSON data (without the base component data), returns false if the
+		// data doesn't fit the layout, in which case it's stored as MessagePack instead
+		bool (*Pack)(const nlohmann::json& data, std::vector<uint8_t>& payload);
+		// Rebuilds the component's JSON data from a payload, returns false if the payload is invalid
+		bool (*Unpack)(const uint8_t* payload, size_t size, nlohmann::json& data);
+		// Creates the component from a payload, returns nullptr if the payload is invalid
+		IComponent::Sptr (*Load)(ComponentManager& components, const uint8_t* payload, size_t size, const Guid& id, bool enabled);
+	};
+
+	struct PackedRenderComponent {
+		uint8_t Mesh[16];
+		uint8_t Material[16];
+	};
+
+	static bool PackRenderComponent(const nlohmann::json& data, std::vector<uint8_t>& payload) {
+		if (data.size() != 2 || !data.contains("mesh") || !data.contains("material")) {
+			return false;
+		}
+		PackedRenderComponent packed;
+		if (!PackGuid(data["mesh"], packed.Mesh) || !PackGuid(data["material"], packed.Material)) {
+			return false;
+		}
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&packed);
+		payload.assign(bytes, bytes + sizeof(PackedRenderComponent));
+		return true;
+	}
+
+	static bool UnpackRenderComponent(const uint8_t* payload, size_t size, nlohmann::json& data) {
+		if (size != sizeof(PackedRenderComponent)) {
+			return false;
+		}
+		PackedRenderComponent packed;
+		memcpy(&packed, payload, sizeof(PackedRenderComponent));
+		data = {
+			{ "mesh", GuidStringFromBytes(packed.Mesh) },
+			{ "material", GuidStringFromBytes(packed.Material) }
+		};
+		return true;
+	}
+
+	static IComponent::Sptr LoadRenderComponent(ComponentManager& components, const uint8_t* payload, size_t size, const Guid& id, bool enabled) {
+		if (size != sizeof(PackedRenderComponent)) {
+			return nullptr;
+		}
+		PackedRenderComponent packed;
+		memcpy(&packed, payload, sizeof(PackedRenderComponent));
+		return components.CreateLoaded<RenderComponent>(id, enabled,
+			ResourceFromBytes<MeshResource>(packed.Mesh), ResourceFromBytes<Material>(packed.Material));
+	}
+
+	/// <summary>
+	/// Builds a binary scene in memory
+	/// </summary>
+	class SceneWriter {
+	public:
+		std::vector<uint8_t> Data;
+		uint32_t             ChunkCount = 0;
+
+		void WriteBytes(const void* data, size_t size) {
+			const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+			Data.insert(Data.end(), bytes, bytes + size);
+		}
+
+		template <typename T>
+		void Write(const T& value) {
+			WriteBytes(&value, sizeof(T));
+		}
+
+		void Pad(size_t alignment) {
+			Data.resize(AlignUp(Data.size(), alignment), 0);
+		}
+
+		// Returns the offset of the chunk header, so the size can be filled in by EndChunk
+		size_t BeginChunk(uint32_t id) {
+			size_t offset = Data.size();
+			ChunkHeader header = { id, 0, 0 };
+			Write(header);
+			ChunkCount++;
+			return offset;
+		}
+
+		void EndChunk(size_t headerOffset) {
+			ChunkHeader header;
+			memcpy(&header, Data.data() + headerOffset, sizeof(ChunkHeader));
+			header.Size = Data.size() - headerOffset - sizeof(ChunkHeader);
+			memcpy(Data.data() + headerOffset, &header, sizeof(ChunkHeader));
+			Pad(ChunkAlignment);
+		}
+	};
+
+	bool SceneBinary::IsBinaryScene(const std::string& path) {
+		return std::filesystem::path(path).extension() == Extension;
+	}
+
+	bool SceneBinary::Write(const nlohmann::json& sceneBlob, const std::string& path, bool packComponents) {
+		static_assert(sizeof(ObjectRecord) == 88, "Object records must be tightly packed");
+		static_assert(sizeof(ComponentRecord) == 28, "Component records must be tightly packed");
+
+		if (!sceneBlob.contains("objects") || !sceneBlob["objects"].is_array()) {
+			LOG_ERROR("Cannot save binary scene to \"{}\", objects not present in scene!", path);
+			return false;
+		}
+		const nlohmann::json& objects = sceneBlob["objects"];
+
+		// Names are de-duplicated, since lots of objects tend to share the same name
+		std::string strings;
+		std::unordered_map<std::string, uint32_t> stringOffsets;
+		auto addString = [&](const std::string& value) {
+			auto it = stringOffsets.find(value);
+			if (it != stringOffsets.end()) {
+				return it->second;
+			}
+			uint32_t offset = static_cast<uint32_t>(strings.size());
+			strings += value;
+			stringOffsets[value] = offset;
+			return offset;
+		};
+
+		// Gather the object records, and sort the components into sections by type. The sections are
+		// ordered by type name, which matches the order that JSON scenes load components in
+		std::vector<ObjectRecord> records(objects.size());
+		std::map<std::string, std::vector<std::pair<uint32_t, const nlohmann::json*>>> sections;
+		for (size_t ix = 0; ix < objects.size(); ix++) {
+			const nlohmann::json& object = objects[ix];
+			ObjectRecord& record = records[ix];
+			memset(&record, 0, sizeof(ObjectRecord));
+
+			const std::string name = object["name"].get<std::string>();
+			record.NameOffset = addString(name);
+			record.NameLength = static_cast<uint32_t>(name.size());
+
+			Guid guid = Guid(object["guid"].get<std::string>());
+			memcpy(record.Guid, guid.bytes(), 16);
+			Guid parent = Guid(JsonGet<std::string>(object, "parent", "null"));
+			memcpy(record.Parent, parent.bytes(), 16);
+
+			glm::vec3 position = object["position"];
+			glm::quat rotation = object["rotation"];
+			glm::vec3 scale    = object["scale"];
+			memcpy(record.Position, &position[0], sizeof(float) * 3);
+			record.Rotation[0] = rotation.x;
+			record.Rotation[1] = rotation.y;
+			record.Rotation[2] = rotation.z;
+			record.Rotation[3] = rotation.w;
+			memcpy(record.Scale, &scale[0], sizeof(float) * 3);
+
+			record.Flags = JsonGet(object, "hide_in_inspector", false) ? FlagHideInHierarchy : 0;
+
+			if (object.contains("components")) {
+				for (auto& [typeName, value] : object["components"].items()) {
+					sections[typeName].emplace_back(static_cast<uint32_t>(ix), &value);
+				}
+			}
+		}
+		for (auto& [typeName, components] : sections) {
+			addString(typeName);
+		}
+
+		// Everything except for the objects goes into the settings
+		nlohmann::json settings = nlohmann::json::object();
+		for (auto& [key, value] : sceneBlob.items()) {
+			if (key != "objects") {
+				settings[key] = value;
+			}
+		}
+
+		SceneWriter writer;
+		FileHeader header;
+		memcpy(header.Magic, FileMagic, 4);
+		header.Version = Version;
+		header.ChunkCount = 0;
+		header.Reserved = 0;
+		writer.Write(header);
+
+		size_t chunk = writer.BeginChunk(ChunkMeta);
+		nlohmann::json::to_msgpack(settings, writer.Data);
+		writer.EndChunk(chunk);
+
+		chunk = writer.BeginChunk(ChunkStrings);
+		writer.WriteBytes(strings.data(), strings.size());
+		writer.EndChunk(chunk);
+
+		chunk = writer.BeginChunk(ChunkObjects);
+		writer.WriteBytes(records.data(), records.size() * sizeof(ObjectRecord));
+		writer.EndChunk(chunk);
+
+		std::vector<uint8_t> payload;
+		for (auto& [typeName, components] : sections) {
+			chunk = writer.BeginChunk(ChunkComponents);
+
+			SectionHeader section;
+			section.TypeNameOffset = stringOffsets[typeName];
+			section.TypeNameLength = static_cast<uint32_t>(typeName.size());
+			section.Count = static_cast<uint32_t>(components.size());
+			section.Reserved = 0;
+			writer.Write(section);
+
+			const ComponentCodec* codec = packComponents ? _FindCodec(typeName) : nullptr;
+			for (auto& [objectIndex, blob] : components) {
+				// The base component data has it's own fields in the record
+				ComponentRecord record;
+				memset(&record, 0, sizeof(ComponentRecord));
+				record.ObjectIndex = objectIndex;
+				record.Flags = JsonGet(*blob, "enabled", true) ? FlagEnabled : 0;
+				Guid guid = Guid(JsonGet<std::string>(*blob, "guid", "null"));
+				memcpy(record.Guid, guid.bytes(), 16);
+
+				nlohmann::json data = *blob;
+				data.erase("guid");
+				data.erase("enabled");
+				payload.clear();
+				if (codec != nullptr && codec->Pack(data, payload)) {
+					record.Flags |= FlagPacked;
+				} else {
+					payload.clear();
+					nlohmann::json::to_msgpack(data, payload);
+				}
+
+				record.PayloadSize = static_cast<uint32_t>(payload.size());
+				writer.Write(record);
+				writer.WriteBytes(payload.data(), payload.size());
+				writer.Pad(PayloadAlignment);
+			}
+
+			writer.EndChunk(chunk);
+		}
+
+		// Now that we know how many chunks there are, we can finish the header
+		header.ChunkCount = writer.ChunkCount;
+		memcpy(writer.Data.data(), &header, sizeof(FileHeader));
+
+		std::ofstream file(path, std::ios::binary);
+		if (!file.is_open()) {
+			LOG_ERROR("Cannot open \"{}\" for writing", path);
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(writer.Data.data()), writer.Data.size());
+		return file.good();
+	}
+
+	bool SceneBinary::Read(const std::string& path, nlohmann::json& sceneBlob) {
+		MappedFile file;
+		if (!file.Open(path)) {
+			LOG_ERROR("Cannot open binary scene \"{}\"", path);
+			return false;
+		}
+
+		Layout layout;
+		if (!_ParseLayout(file.GetData(), file.GetSize(), layout)) {
+			LOG_ERROR("\"{}\" is not a valid binary scene!", path);
+			return false;
+		}
+
+		try {
+			sceneBlob = nlohmann::json::from_msgpack(layout.Meta, layout.Meta + layout.MetaSize);
+
+			std::vector<nlohmann::json> objects(layout.ObjectCount);
+			for (uint32_t ix = 0; ix < layout.ObjectCount; ix++) {
+				const ObjectRecord& record = layout.Objects[ix];
+				Guid parent = GuidFromBytes(record.Parent);
+
+				glm::quat rotation;
+				rotation.x = record.Rotation[0];
+				rotation.y = record.Rotation[1];
+				rotation.z = record.Rotation[2];
+				rotation.w = record.Rotation[3];
+
+				objects[ix] = {
+					{ "name", std::string(layout.Strings + record.NameOffset, record.NameLength) },
+					{ "guid", GuidFromBytes(record.Guid).str() },
+					{ "position", glm::vec3(record.Position[0], record.Position[1], record.Position[2]) },
+					{ "rotation", rotation },
+					{ "scale", glm::vec3(record.Scale[0], record.Scale[1], record.Scale[2]) },
+					{ "parent", parent.isValid() ? parent.str() : "null" },
+					{ "hide_in_inspector", (record.Flags & FlagHideInHierarchy) != 0 }
+				};
+				objects[ix]["components"] = nlohmann::json::object();
+			}
+
+			for (const ComponentSection& section : layout.Sections) {
+				const uint8_t* cursor = section.Data;
+				const ComponentRecord* record;
+				const uint8_t* payload;
+				while (cursor < section.End) {
+					if (!_ReadComponent(cursor, section.End, record, payload) || record->ObjectIndex >= layout.ObjectCount) {
+						LOG_ERROR("Binary scene \"{}\" is corrupt or truncated!", path);
+						return false;
+					}
+
+					nlohmann::json blob;
+					if ((record->Flags & FlagPacked) == 0) {
+						blob = nlohmann::json::from_msgpack(payload, payload + record->PayloadSize);
+					} else if (section.Codec == nullptr || !section.Codec->Unpack(payload, record->PayloadSize, blob)) {
+						LOG_ERROR("Binary scene \"{}\" has a {} that can't be unpacked!", path, section.TypeName);
+						return false;
+					}
+					blob["guid"] = GuidFromBytes(record->Guid).str();
+					blob["enabled"] = (record->Flags & FlagEnabled) != 0;
+					objects[record->ObjectIndex]["components"][section.TypeName] = std::move(blob);
+				}
+			}
+
+			sceneBlob["objects"] = std::move(objects);
+		} catch (const nlohmann::json::exception& e) {
+			LOG_ERROR("Failed to decode binary scene \"{}\": {}", path, e.what());
+			return false;
+		}
+		return true;
+	}
+
+	bool SceneBinary::ConvertJsonToBinary(const std::string& jsonPath, const std::string& binaryPath) {
+		if (!std::filesystem::exists(jsonPath)) {
+			LOG_ERROR("Cannot convert \"{}\", file does not exist", jsonPath);
+			return false;
+		}
+		nlohmann::json blob = nlohmann::json::parse(FileHelpers::ReadFile(jsonPath));
+		return Write(blob, binaryPath);
+	}
+
+	bool SceneBinary::ConvertBinaryToJson(const std::string& binaryPath, const std::string& jsonPath) {
+		nlohmann::json blob;
+		if (!Read(binaryPath, blob)) {
+			return false;
+		}
+		FileHelpers::WriteContentsToFile(jsonPath, blob.dump(1, '\t'));
+		return true;
+	}
+
+	bool SceneBinary::_ParseLayout(const uint8_t* data, size_t size, Layout& layout) {
+		layout = Layout();
+		layout.Meta = nullptr;
+		layout.MetaSize = 0;
+		layout.Strings = nullptr;
+		layout.StringsSize = 0;
+		layout.Objects = nullptr;
+		layout.ObjectCount = 0;
+
+		if (data == nullptr || size < sizeof(FileHeader)) {
+			return false;
+		}
+
+		FileHeader header;
+		memcpy(&header, data, sizeof(FileHeader));
+		if (memcmp(header.Magic, FileMagic, 4) != 0) {
+			return false;
+		}
+		if (header.Version < MinVersion || header.Version > Version) {
+			LOG_ERROR("Unknown binary scene version {}", header.Version);
+			return false;
+		}
+
+		size_t offset = sizeof(FileHeader);
+		for (uint32_t ix = 0; ix < header.ChunkCount; ix++) {
+			if (size - offset < sizeof(ChunkHeader)) {
+				return false;
+			}
+			ChunkHeader chunk;
+			memcpy(&chunk, data + offset, sizeof(ChunkHeader));
+			offset += sizeof(ChunkHeader);
+
+			if (chunk.Size > size - offset) {
+				return false;
+			}
+			const uint8_t* chunkData = data + offset;
+			const size_t chunkSize = static_cast<size_t>(chunk.Size);
+
+			switch (chunk.Id) {
+				case ChunkMeta:
+					layout.Meta = chunkData;
+					layout.MetaSize = chunkSize;
+					break;
+				case ChunkStrings:
+					layout.Strings = reinterpret_cast<const char*>(chunkData);
+					layout.StringsSize = chunkSize;
+					break;
+				case ChunkObjects:
+					if (chunkSize % sizeof(ObjectRecord) != 0) {
+						return false;
+					}
+					layout.Objects = reinterpret_cast<const ObjectRecord*>(chunkData);
+					layout.ObjectCount = static_cast<uint32_t>(chunkSize / sizeof(ObjectRecord));
+					break;
+				case ChunkComponents:
+				{
+					if (chunkSize < sizeof(SectionHeader)) {
+						return false;
+					}
+					SectionHeader sectionHeader;
+					memcpy(&sectionHeader, chunkData, sizeof(SectionHeader));
+
+					// The string table always comes before the component sections
+					if (layout.Strings == nullptr || (size_t)sectionHeader.TypeNameOffset + sectionHeader.TypeNameLength > layout.StringsSize) {
+						return false;
+					}
+
+					ComponentSection section;
+					section.TypeName = std::string(layout.Strings + sectionHeader.TypeNameOffset, sectionHeader.TypeNameLength);
+					section.Count = sectionHeader.Count;
+					section.Codec = _FindCodec(section.TypeName);
+					section.Data = chunkData + sizeof(SectionHeader);
+					section.End = chunkData + chunkSize;
+					layout.Sections.push_back(section);
+					break;
+				}
+				default:
+					// Skip over chunks we don't know about
+					break;
+			}
+
+			offset = std::min(AlignUp(offset + chunkSize, ChunkAlignment), size);
+		}
+
+		if (layout.Meta == nullptr || layout.Objects == nullptr) {
+			return false;
+		}
+
+		// Make sure all the object names are in the string table, so the loaders don't need to check
+		for (uint32_t ix = 0; ix < layout.ObjectCount; ix++) {
+			const ObjectRecord& record = layout.Objects[ix];
+			if ((size_t)record.NameOffset + record.NameLength > layout.StringsSize) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool SceneBinary::_ReadComponent(const uint8_t*& cursor, const uint8_t* end, const ComponentRecord*& record, const uint8_t*& payload) {
+		if ((size_t)(end - cursor) < sizeof(ComponentRecord)) {
+			return false;
+		}
+		record = reinterpret_cast<const ComponentRecord*>(cursor);
+		payload = cursor + sizeof(ComponentRecord);
+
+		const size_t remaining = static_cast<size_t>(end - payload);
+		if (remaining < record->PayloadSize) {
+			return false;
+		}
+		cursor = payload + std::min(AlignUp(record->PayloadSize, PayloadAlignment), remaining);
+		return true;
+	}
+
+	const SceneBinary::ComponentCodec* SceneBinary::_FindCodec(const std::string& typeName) {
+		static const ComponentCodec codecs[] = {
+			{ "RenderComponent", &PackRenderComponent, &UnpackRenderComponent, &LoadRenderComponent }
+		};
+		for (const ComponentCodec& codec : codecs) {
+			if (typeName == codec.TypeName) {
+				return &codec;
+			}
+		}
+		return nullptr;
+	}
+
+	SceneBinaryLoader::SceneBinaryLoader() :
+		_path(""),
+		_file(),
+		_layout(),
+		_settings(nlohmann::json()),
+		_scene(nullptr),
+		_objects(std::vector<GameObject*>()),
+		_stage(Stage::Objects),
+		_index(0),
+		_cursor(nullptr),
+		_itemsLoaded(0),
+		_itemCount(0)
+	{ }
+
+	SceneBinaryLoader::Sptr SceneBinaryLoader::Open(const std::string& path) {
+		// Constructor is protected, so we can't use make_shared
+		SceneBinaryLoader::Sptr result(new SceneBinaryLoader());
+		result->_path = path;
+
+		if (!result->_file.Open(path)) {
+			LOG_ERROR("Cannot open binary scene \"{}\"", path);
+			return nullptr;
+		}
+
+		SceneBinary::Layout& layout = result->_layout;
+		if (!SceneBinary::_ParseLayout(result->_file.GetData(), result->_file.GetSize(), layout)) {
+			LOG_ERROR("\"{}\" is not a valid binary scene!", path);
+			return nullptr;
+		}
+
+		try {
+			result->_settings = nlohmann::json::from_msgpack(layout.Meta, layout.Meta + layout.MetaSize);
+		} catch (const nlohmann::json::exception& e) {
+			LOG_ERROR("Failed to decode settings for binary scene \"{}\": {}", path, e.what());
+			return nullptr;
+		}
+
+		result->_scene = std::make_shared<Scene>();
+		result->_scene->_LoadSettings(result->_settings);
+
+		// We know exactly how much we're going to load, so we can size everything up front
+		result->_objects.reserve(layout.ObjectCount);
+		result->_scene->_objects.reserve(layout.ObjectCount);
+		result->_scene->_objectsByGuid.reserve(layout.ObjectCount);
+		result->_itemCount = layout.ObjectCount;
+		for (const SceneBinary::ComponentSection& section : layout.Sections) {
+			result->_scene->Components().Reserve(section.TypeName, section.Count);
+			result->_itemCount += section.Count;
+		}
+
+		return result;
+	}
+
+	bool SceneBinaryLoader::Step(double budgetMs) {
+		using Clock = std::chrono::high_resolution_clock;
+		const Clock::time_point start = Clock::now();
+
+		// Checking the clock costs more than loading most objects, so we only check every few items
+		static constexpr int BatchSize = 32;
+
+		while (!IsDone()) {
+			for (int ix = 0; ix < BatchSize && !IsDone(); ix++) {
+				bool success = true;
+				switch (_stage) {
+					case Stage::Objects:    success = _LoadObject();    break;
+					case Stage::Components: success = _LoadComponent(); break;
+					case Stage::Finalize:   _Finalize();                break;
+					default: break;
+				}
+
+				if (!success) {
+					LOG_ERROR("Binary scene \"{}\" is corrupt or truncated!", _path);
+					_stage = Stage::Failed;
+					_scene = nullptr;
+					_objects.clear();
+					_file.Close();
+				}
+			}
+
+			if (budgetMs >= 0.0 && std::chrono::duration<double, std::milli>(Clock::now() - start).count() >= budgetMs) {
+				break;
+			}
+		}
+		return IsDone();
+	}
+
+	float SceneBinaryLoader::GetProgress() const {
+		if (_stage == Stage::Done || _itemCount == 0) {
+			return _stage == Stage::Done ? 1.0f : 0.0f;
+		}
+		return static_cast<float>(_itemsLoaded) / static_cast<float>(_itemCount);
+	}
+
+	bool SceneBinaryLoader::_LoadObject() {
+		if (_index >= _layout.ObjectCount) {
+			// Move on to the components
+			_stage = Stage::Components;
+			_index = 0;
+			_cursor = _layout.Sections.empty() ? nullptr : _layout.Sections[0].Data;
+			return true;
+		}
+
+		const SceneBinary::ObjectRecord& record = _layout.Objects[_index];
+
+		// We need to manually construct since the GameObject constructor is
+		// protected, we are a friend of GameObject so we can call it here
+		GameObject::Sptr object(new GameObject());
+		object->_scene = _scene.get();
+		object->_name.assign(_layout.Strings + record.NameOffset, record.NameLength);
+		object->OverrideGUID(GuidFromBytes(record.Guid));
+		object->_parent = GameObject::WeakRef(GuidFromBytes(record.Parent), nullptr);
+		object->_position = glm::vec3(record.Position[0], record.Position[1], record.Position[2]);
+		object->_rotation.x = record.Rotation[0];
+		object->_rotation.y = record.Rotation[1];
+		object->_rotation.z = record.Rotation[2];
+		object->_rotation.w = record.Rotation[3];
+		object->_scale = glm::vec3(record.Scale[0], record.Scale[1], record.Scale[2]);
+		object->HideInHierarchy = (record.Flags & SceneBinary::FlagHideInHierarchy) != 0;
+		object->_isLocalTransformDirty = true;
+		object->_isWorldTransformDirty = true;
+
+		_scene->_AddLoadedObject(object);
+		_objects.push_back(object.get());
+
+		_index++;
+		_itemsLoaded++;
+		return true;
+	}
+
+	bool SceneBinaryLoader::_LoadComponent() {
+		// Skip ahead to the next section with components left in it
+		while (_index < _layout.Sections.size() && _cursor >= _layout.Sections[_index].End) {
+			_index++;
+			_cursor = _index < _layout.Sections.size() ? _layout.Sections[_index].Data : nullptr;
+		}
+		if (_index >= _layout.Sections.size()) {
+			_stage = Stage::Finalize;
+			return true;
+		}
+
+		const SceneBinary::ComponentSection& section = _layout.Sections[_index];
+		const SceneBinary::ComponentRecord* record;
+		const uint8_t* payload;
+		if (!SceneBinary::_ReadComponent(_cursor, section.End, record, payload) || record->ObjectIndex >= _objects.size()) {
+			return false;
+		}
+
+		const Guid id = GuidFromBytes(record->Guid);
+		const bool enabled = (record->Flags & SceneBinary::FlagEnabled) != 0;
+		IComponent::Sptr component = nullptr;
+		if ((record->Flags & SceneBinary::FlagPacked) != 0) {
+			// Packed types are always registered, so a null result means the payload was bad
+			if (section.Codec == nullptr) {
+				LOG_ERROR("Component type \"{}\" has no binary layout", section.TypeName);
+				return false;
+			}
+			component = section.Codec->Load(_scene->Components(), payload, record->PayloadSize, id, enabled);
+			if (component == nullptr) {
+				LOG_ERROR("Failed to unpack {}", section.TypeName);
+				return false;
+			}
+		} else {
+			nlohmann::json blob;
+			try {
+				blob = nlohmann::json::from_msgpack(payload, payload + record->PayloadSize);
+			} catch (const nlohmann::json::exception& e) {
+				LOG_ERROR("Failed to decode {}: {}", section.TypeName, e.what());
+				return false;
+			}
+			component = _scene->Components().Load(section.TypeName, blob, id, enabled);
+		}
+		if (component == nullptr) {
+			// The whole section is the same type, so we can skip the rest of it
+			LOG_WARN("Component type \"{}\" is not registered, skipping {} components", section.TypeName, section.Count);
+			_itemsLoaded += section.Count;
+			_cursor = section.End;
+			return true;
+		}
+		_objects[record->ObjectIndex]->_AttachLoadedComponent(component);
+
+		_itemsLoaded++;
+		return true;
+	}
+
+	void SceneBinaryLoader::_Finalize() {
+		_scene->_FinishLoad(_settings);
+		_scene->_filePath = _path;
+
+		// We're done with the file, all the pointers into it are about to be invalid
+		_objects.clear();
+		_layout.Sections.clear();
+		_file.Close();
+
+		_stage = Stage::Done;
+	}
+}
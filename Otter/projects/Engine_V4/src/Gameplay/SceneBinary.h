@@ -0,0 +1,229 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "json.hpp"
+#include "Utils/MappedFile.h"
+#include "Gameplay/Scene.h"
+
+namespace Gameplay {
+	/// <summary>
+	/// Reads and writes the binary scene format (.bscene), a compact alternative to JSON scenes
+	///
+	/// A file is a small header followed by a list of chunks. The chunks hold the scene settings,
+	/// a string table, a packed array of fixed size object records, and then one section per
+	/// component type. A component section stores every component of that type back to back, so
+	/// the loader can size the type's component pool once and then fill it in a single pass
+	///
+	/// Components only know how to serialize themselves to JSON, so most component data is stored
+	/// as MessagePack encoded JSON. Types that show up on most objects (like RenderComponent) have
+	/// a fixed binary layout instead, which the loader can create the component from without going
+	/// through JSON at all. Object transforms are always stored in the object records. All values
+	/// are little endian
+	/// </summary>
+	class SceneBinary {
+	public:
+		// The version of the format that we write, files with other versions will be rejected
+		static constexpr uint32_t Version = 2;
+		// The oldest version we can still read, version 1 files only have MessagePack payloads
+		static constexpr uint32_t MinVersion = 1;
+		// The file extension used for binary scenes
+		static constexpr const char* Extension = ".bscene";
+
+		/// <summary>
+		/// Checks whether the given path has the binary scene extension
+		/// </summary>
+		static bool IsBinaryScene(const std::string& path);
+
+		/// <summary>
+		/// Writes a scene to a binary scene file
+		/// </summary>
+		/// <param name="sceneBlob">The scene's JSON representation, as returned by Scene::ToJson</param>
+		/// <param name="path">The path of the file to write to</param>
+		/// <param name="packComponents">False to store every component as MessagePack, even if it's type has a binary layout</param>
+		/// <returns>True if the file was written</returns>
+		static bool Write(const nlohmann::json& sceneBlob, const std::string& path, bool packComponents = true);
+		/// <summary>
+		/// Reads a binary scene file back into the scene's JSON representation
+		/// </summary>
+		/// <param name="path">The path of the file to read</param>
+		/// <param name="sceneBlob">The JSON representation of the scene will be stored here</param>
+		/// <returns>True if the file could be opened and was valid</returns>
+		static bool Read(const std::string& path, nlohmann::json& sceneBlob);
+
+		/// <summary>
+		/// Converts a JSON scene file into a binary scene file
+		/// </summary>
+		static bool ConvertJsonToBinary(const std::string& jsonPath, const std::string& binaryPath);
+		/// <summary>
+		/// Converts a binary scene file into a JSON scene file
+		/// </summary>
+		static bool ConvertBinaryToJson(const std::string& binaryPath, const std::string& jsonPath);
+
+	protected:
+		friend class SceneBinaryLoader;
+
+		SceneBinary() = default;
+		~SceneBinary() = default;
+
+		// Object record flags
+		static constexpr uint32_t FlagHideInHierarchy = 1 << 0;
+		// Component record flags
+		static constexpr uint32_t FlagEnabled = 1 << 0;
+		// The payload uses the type's binary layout rather than MessagePack
+		static constexpr uint32_t FlagPacked  = 1 << 1;
+
+		// Converts a single component type to and from it's binary layout, see SceneBinary.cpp
+		struct ComponentCodec;
+
+		struct ObjectRecord {
+			uint8_t  Guid[16];
+			// All zero when the object has no parent
+			uint8_t  Parent[16];
+			// The object's name in the string table
+			uint32_t NameOffset;
+			uint32_t NameLength;
+			float    Position[3];
+			// Stored as x, y, z, w
+			float    Rotation[4];
+			float    Scale[3];
+			uint32_t Flags;
+			uint32_t Reserved;
+		};
+
+		struct ComponentRecord {
+			// The index of the object that owns the component in the object records
+			uint32_t ObjectIndex;
+			uint32_t Flags;
+			uint8_t  Guid[16];
+			// Size of the payload that follows the record, the data is padded to 4 bytes
+			uint32_t PayloadSize;
+		};
+
+		struct ComponentSection {
+			std::string    TypeName;
+			uint32_t       Count;
+			// The binary layout for the section's type, or nullptr if it only has MessagePack payloads
+			const ComponentCodec* Codec;
+			// The records for the section, these are variable length since they include their payloads
+			const uint8_t* Data;
+			const uint8_t* End;
+		};
+
+		/// <summary>
+		/// Pointers into a mapped binary scene file
+		/// </summary>
+		struct Layout {
+			const uint8_t*                Meta;
+			size_t                        MetaSize;
+			const char*                   Strings;
+			size_t                        StringsSize;
+			const ObjectRecord*           Objects;
+			uint32_t                      ObjectCount;
+			std::vector<ComponentSection> Sections;
+		};
+
+		/// <summary>
+		/// Validates the file header and chunk table, and extracts the location of each chunk
+		/// </summary>
+		/// <returns>True if the data is a valid binary scene</returns>
+		static bool _ParseLayout(const uint8_t* data, size_t size, Layout& layout);
+		/// <summary>
+		/// Reads the next component record in a section, advancing the cursor past it's payload
+		/// </summary>
+		/// <returns>True if a full record and payload were read</returns>
+		static bool _ReadComponent(const uint8_t*& cursor, const uint8_t* end, const ComponentRecord*& record, const uint8_t*& payload);
+		/// <summary>
+		/// Gets the binary layout for a component type, or nullptr if the type is always stored as MessagePack
+		/// </summary>
+		static const ComponentCodec* _FindCodec(const std::string& typeName);
+	};
+
+	/// <summary>
+	/// Loads a binary scene incrementally, so that large scenes can be streamed in across several
+	/// frames instead of stalling a single one
+	///
+	/// Objects are created first, then each component section is bulk loaded into the scene's
+	/// component pools, and finally the hierarchy and main camera are resolved. The scene is only
+	/// handed out once everything has loaded
+	/// </summary>
+	class SceneBinaryLoader {
+	public:
+		typedef std::shared_ptr<SceneBinaryLoader> Sptr;
+
+		~SceneBinaryLoader() = default;
+
+		SceneBinaryLoader(const SceneBinaryLoader& other) = delete;
+		SceneBinaryLoader& operator=(const SceneBinaryLoader& other) = delete;
+
+		/// <summary>
+		/// Opens a binary scene file for loading
+		/// </summary>
+		/// <param name="path">The path to the scene file</param>
+		/// <returns>A new loader, or nullptr if the file could not be opened or was invalid</returns>
+		static Sptr Open(const std::string& path);
+
+		/// <summary>
+		/// Loads as much of the scene as we can within the given time budget
+		/// </summary>
+		/// <param name="budgetMs">The time to spend loading, in milliseconds. Use a negative value to load everything</param>
+		/// <returns>True once the scene has finished loading (or failed)</returns>
+		bool Step(double budgetMs);
+
+		/// <summary>
+		/// Gets whether the scene has finished loading (or failed)
+		/// </summary>
+		bool IsDone() const { return _stage == Stage::Done || _stage == Stage::Failed; }
+		/// <summary>
+		/// Gets whether the file contained invalid data
+		/// </summary>
+		bool HasFailed() const { return _stage == Stage::Failed; }
+		/// <summary>
+		/// Gets how much of the scene has been loaded, in the 0-1 range
+		/// </summary>
+		float GetProgress() const;
+		/// <summary>
+		/// Gets the loaded scene, or nullptr if the scene is still loading or failed to load
+		/// </summary>
+		Scene::Sptr GetScene() const { return _stage == Stage::Done ? _scene : nullptr; }
+		/// <summary>
+		/// Gets the path of the file being loaded
+		/// </summary>
+		const std::string& GetPath() const { return _path; }
+
+	protected:
+		enum class Stage {
+			Objects,
+			Components,
+			Finalize,
+			Done,
+			Failed
+		};
+
+		SceneBinaryLoader();
+
+		std::string         _path;
+		MappedFile          _file;
+		SceneBinary::Layout _layout;
+		nlohmann::json      _settings;
+
+		Scene::Sptr         _scene;
+		// The objects in the order they appear in the file, so components can find their owners
+		std::vector<GameObject*> _objects;
+
+		Stage               _stage;
+		// Index of the next object, or the current component section
+		size_t              _index;
+		// Read position within the current component section
+		const uint8_t*      _cursor;
+		// Number of objects and components loaded so far, and the total
+		size_t              _itemsLoaded;
+		size_t              _itemCount;
+
+		bool _LoadObject();
+		bool _LoadComponent();
+		void _Finalize();
+	};
+}
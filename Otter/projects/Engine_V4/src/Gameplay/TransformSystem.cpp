@@ -0,0 +1,301 @@
+#include "Gameplay/TransformSystem.h"
+
+#include <algorithm>
+#include <type_traits>
+
+namespace Gameplay {
+	TransformSystem::TransformSystem() :
+		_orderDirty(false)
+	{ }
+
+	TransformSystem::Handle TransformSystem::Create(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+		// Grab a free handle, or make a new one
+		Handle handle;
+		if (!_freeHandles.empty()) {
+			handle = _freeHandles.back();
+			_freeHandles.pop_back();
+		} else {
+			handle = static_cast<Handle>(_handleToSlot.size());
+			_handleToSlot.push_back(InvalidHandle);
+		}
+
+		// Root transforms don't depend on anything, so they can go at the end without breaking
+		// our parent-first ordering
+		uint32_t slot = static_cast<uint32_t>(_slotToHandle.size());
+		_handleToSlot[handle] = slot;
+
+		_positions.push_back(position);
+		_rotations.push_back(rotation);
+		_scales.push_back(scale);
+		_localTransforms.push_back(glm::mat4(1.0f));
+		_inverseLocalTransforms.push_back(glm::mat4(1.0f));
+		_worldTransforms.push_back(glm::mat4(1.0f));
+		_inverseWorldTransforms.push_back(glm::mat4(1.0f));
+		_parents.push_back(InvalidHandle);
+		_flags.push_back(FlagLocalDirty | FlagWorldDirty);
+		_worldVersions.push_back(0);
+		_parentVersions.push_back(0);
+		_slotToHandle.push_back(handle);
+
+		return handle;
+	}
+
+	void TransformSystem::Destroy(Handle handle) {
+		if (handle >= _handleToSlot.size() || _handleToSlot[handle] == InvalidHandle) {
+			return;
+		}
+
+		// We leave the slot in place so that we don't disturb the ordering, it will be
+		// dropped the next time we rebuild
+		uint32_t slot = _handleToSlot[handle];
+		_flags[slot] = FlagFree;
+		_slotToHandle[slot] = InvalidHandle;
+		_handleToSlot[handle] = InvalidHandle;
+
+		_pendingFree.push_back(handle);
+		_orderDirty = true;
+	}
+
+	void TransformSystem::Clear() {
+		_positions.clear();
+		_rotations.clear();
+		_scales.clear();
+		_localTransforms.clear();
+		_inverseLocalTransforms.clear();
+		_worldTransforms.clear();
+		_inverseWorldTransforms.clear();
+		_parents.clear();
+		_flags.clear();
+		_worldVersions.clear();
+		_parentVersions.clear();
+		_slotToHandle.clear();
+		_handleToSlot.clear();
+		_freeHandles.clear();
+		_pendingFree.clear();
+		_orderDirty = false;
+	}
+
+	void TransformSystem::SetParent(Handle child, Handle parent) {
+		uint32_t slot = _handleToSlot[child];
+		if (_parents[slot] == parent) {
+			return;
+		}
+		_parents[slot] = parent;
+		_flags[slot] |= FlagWorldDirty;
+
+		// The parent may now be after the child in our storage, so we'll need to re-sort. Note
+		// that getters still work until then, since they walk up the hierarchy
+		if (parent != InvalidHandle && _handleToSlot[parent] > slot) {
+			_orderDirty = true;
+		}
+	}
+
+	void TransformSystem::SetLocal(Handle handle, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+		uint32_t slot = _handleToSlot[handle];
+		_positions[slot] = position;
+		_rotations[slot] = rotation;
+		_scales[slot] = scale;
+		_flags[slot] |= FlagLocalDirty;
+	}
+
+	const glm::mat4& TransformSystem::GetLocalTransform(Handle handle) {
+		uint32_t slot = _handleToSlot[handle];
+		if (_flags[slot] & FlagLocalDirty) {
+			_UpdateWorld(slot);
+		}
+		return _localTransforms[slot];
+	}
+
+	const glm::mat4& TransformSystem::GetInverseLocalTransform(Handle handle) {
+		uint32_t slot = _handleToSlot[handle];
+		if (_flags[slot] & FlagLocalDirty) {
+			_UpdateWorld(slot);
+		}
+		return _inverseLocalTransforms[slot];
+	}
+
+	const glm::mat4& TransformSystem::GetWorldTransform(Handle handle) {
+		uint32_t slot = _handleToSlot[handle];
+		_UpdateWorld(slot);
+		return _worldTransforms[slot];
+	}
+
+	const glm::mat4& TransformSystem::GetInverseWorldTransform(Handle handle) {
+		uint32_t slot = _handleToSlot[handle];
+		_UpdateWorld(slot);
+		return _inverseWorldTransforms[slot];
+	}
+
+	void TransformSystem::Update() {
+		if (_orderDirty) {
+			_Rebuild();
+		}
+
+		// Parents are always sorted before their children, so by the time we reach a slot
+		// it's parent is already up to date
+		const uint32_t count = static_cast<uint32_t>(_slotToHandle.size());
+		for (uint32_t slot = 0; slot < count; slot++) {
+			if (_flags[slot] & FlagFree) {
+				continue;
+			}
+			_Recalculate(slot, _ParentSlot(slot));
+		}
+	}
+
+	void TransformSystem::CalculateTRS(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale, glm::mat4& outTransform, glm::mat4& outInverse) {
+		const glm::mat3 rot = glm::mat3_cast(rotation);
+		const glm::vec3 invScale = 1.0f / scale;
+
+		// M = T * R * S, so the columns of the upper 3x3 are the rotation's columns scaled
+		outTransform[0] = glm::vec4(rot[0] * scale.x, 0.0f);
+		outTransform[1] = glm::vec4(rot[1] * scale.y, 0.0f);
+		outTransform[2] = glm::vec4(rot[2] * scale.z, 0.0f);
+		outTransform[3] = glm::vec4(position, 1.0f);
+
+		// M^-1 = S^-1 * R^T * T^-1, so the upper 3x3 is the transposed rotation with it's rows
+		// scaled, and the translation is the negated position pushed through that
+		glm::mat3 inv;
+		inv[0] = glm::vec3(rot[0].x, rot[1].x, rot[2].x) * invScale;
+		inv[1] = glm::vec3(rot[0].y, rot[1].y, rot[2].y) * invScale;
+		inv[2] = glm::vec3(rot[0].z, rot[1].z, rot[2].z) * invScale;
+		outInverse[0] = glm::vec4(inv[0], 0.0f);
+		outInverse[1] = glm::vec4(inv[1], 0.0f);
+		outInverse[2] = glm::vec4(inv[2], 0.0f);
+		outInverse[3] = glm::vec4(-(inv * position), 1.0f);
+	}
+
+	uint32_t TransformSystem::_ParentSlot(uint32_t slot) const {
+		Handle parent = _parents[slot];
+		return parent == InvalidHandle ? InvalidHandle : _handleToSlot[parent];
+	}
+
+	void TransformSystem::_Recalculate(uint32_t slot, uint32_t parentSlot) {
+		uint8_t& flags = _flags[slot];
+
+		bool changed = (flags & FlagWorldDirty) != 0;
+
+		// Our parent was destroyed, so we're a root now
+		if (parentSlot == InvalidHandle && _parents[slot] != InvalidHandle) {
+			_parents[slot] = InvalidHandle;
+			changed = true;
+		}
+		if (flags & FlagLocalDirty) {
+			CalculateTRS(_positions[slot], _rotations[slot], _scales[slot], _localTransforms[slot], _inverseLocalTransforms[slot]);
+			changed = true;
+		}
+
+		if (parentSlot != InvalidHandle) {
+			changed |= _parentVersions[slot] != _worldVersions[parentSlot];
+			if (changed) {
+				// Since both transforms are affine, (P * L)^-1 = L^-1 * P^-1, so we never need
+				// a general inverse here
+				_worldTransforms[slot] = _worldTransforms[parentSlot] * _localTransforms[slot];
+				_inverseWorldTransforms[slot] = _inverseLocalTransforms[slot] * _inverseWorldTransforms[parentSlot];
+				_parentVersions[slot] = _worldVersions[parentSlot];
+			}
+		} else if (changed) {
+			_worldTransforms[slot] = _localTransforms[slot];
+			_inverseWorldTransforms[slot] = _inverseLocalTransforms[slot];
+		}
+
+		if (changed) {
+			_worldVersions[slot]++;
+		}
+		flags &= ~(FlagLocalDirty | FlagWorldDirty);
+	}
+
+	void TransformSystem::_UpdateWorld(uint32_t slot) {
+		// Outside of the batch update, we make sure our ancestors are up to date first. This
+		// keeps transforms correct when they are queried in the middle of a frame
+		uint32_t parentSlot = _ParentSlot(slot);
+		if (parentSlot != InvalidHandle) {
+			_UpdateWorld(parentSlot);
+		}
+		_Recalculate(slot, parentSlot);
+	}
+
+	void TransformSystem::_Rebuild() {
+		const uint32_t count = static_cast<uint32_t>(_slotToHandle.size());
+
+		// Children of destroyed transforms become roots, now that nothing references the
+		// pending handles we can safely re-use them
+		for (uint32_t slot = 0; slot < count; slot++) {
+			if (_parents[slot] != InvalidHandle && _handleToSlot[_parents[slot]] == InvalidHandle) {
+				_parents[slot] = InvalidHandle;
+				_flags[slot] |= FlagWorldDirty;
+			}
+		}
+		_freeHandles.insert(_freeHandles.end(), _pendingFree.begin(), _pendingFree.end());
+		_pendingFree.clear();
+
+		// Calculate the depth of every live slot, caching as we go so each slot is only visited once
+		static constexpr uint32_t Unknown = 0xFFFFFFFF;
+		std::vector<uint32_t> depths(count, Unknown);
+		std::vector<uint32_t> stack;
+		for (uint32_t slot = 0; slot < count; slot++) {
+			if (_flags[slot] & FlagFree) {
+				continue;
+			}
+			uint32_t current = slot;
+			while (depths[current] == Unknown) {
+				uint32_t parentSlot = _ParentSlot(current);
+				if (parentSlot == InvalidHandle) {
+					depths[current] = 0;
+					break;
+				}
+				// Guard against hierarchy loops, we just treat the loop as a root
+				if (std::find(stack.begin(), stack.end(), parentSlot) != stack.end()) {
+					depths[current] = 0;
+					break;
+				}
+				stack.push_back(current);
+				current = parentSlot;
+			}
+			while (!stack.empty()) {
+				depths[stack.back()] = depths[current] + 1;
+				current = stack.back();
+				stack.pop_back();
+			}
+		}
+
+		// Stable sort by depth, so that siblings keep their relative order
+		std::vector<uint32_t> order;
+		order.reserve(count);
+		for (uint32_t slot = 0; slot < count; slot++) {
+			if (!(_flags[slot] & FlagFree)) {
+				order.push_back(slot);
+			}
+		}
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+			return depths[a] < depths[b];
+		});
+
+		// Permute all our arrays into the new order
+		auto permute = [&](auto& source) {
+			typename std::remove_reference<decltype(source)>::type result;
+			result.reserve(order.size());
+			for (uint32_t slot : order) {
+				result.push_back(source[slot]);
+			}
+			source.swap(result);
+		};
+		permute(_positions);
+		permute(_rotations);
+		permute(_scales);
+		permute(_localTransforms);
+		permute(_inverseLocalTransforms);
+		permute(_worldTransforms);
+		permute(_inverseWorldTransforms);
+		permute(_parents);
+		permute(_flags);
+		permute(_worldVersions);
+		permute(_parentVersions);
+		permute(_slotToHandle);
+
+		for (uint32_t slot = 0; slot < _slotToHandle.size(); slot++) {
+			_handleToSlot[_slotToHandle[slot]] = slot;
+		}
+
+		_orderDirty = false;
+	}
+}
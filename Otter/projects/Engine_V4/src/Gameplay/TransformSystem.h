@@ -0,0 +1,130 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "GLM/glm.hpp"
+#include "GLM/gtc/quaternion.hpp"
+
+namespace Gameplay {
+	/// <summary>
+	/// Stores the transforms for a scene's game objects in structure-of-arrays form, sorted so
+	/// that parents always come before their children. This lets us update every dirty transform
+	/// in a single linear pass, instead of each object pulling it's parent's transform through
+	/// the hierarchy
+	///
+	/// Objects refer to their transforms by handle, which stays stable while the underlying
+	/// storage is sorted and compacted
+	/// </summary>
+	class TransformSystem {
+	public:
+		typedef uint32_t Handle;
+		static constexpr Handle InvalidHandle = 0xFFFFFFFF;
+
+		TransformSystem();
+		~TransformSystem() = default;
+
+		/// <summary>
+		/// Creates a new root transform with the given local TRS values
+		/// </summary>
+		Handle Create(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+		/// <summary>
+		/// Destroys the transform with the given handle, any children will become root transforms
+		/// </summary>
+		void Destroy(Handle handle);
+		/// <summary>
+		/// Removes all transforms from the system
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// Sets the parent of a transform, or InvalidHandle to make it a root transform
+		/// </summary>
+		void SetParent(Handle child, Handle parent);
+
+		/// <summary>
+		/// Sets the local position, rotation and scale of the transform
+		/// </summary>
+		void SetLocal(Handle handle, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+
+		/// <summary>
+		/// Gets the local transform (local -> parent space), recalculating if required
+		/// The matrices returned by the getters are only good until the next transform is created
+		/// </summary>
+		const glm::mat4& GetLocalTransform(Handle handle);
+		/// <summary>
+		/// Gets the inverse local transform (parent -> local space), recalculating if required
+		/// </summary>
+		const glm::mat4& GetInverseLocalTransform(Handle handle);
+		/// <summary>
+		/// Gets the world transform (local -> world space), recalculating the transform and it's
+		/// parents if required
+		/// </summary>
+		const glm::mat4& GetWorldTransform(Handle handle);
+		/// <summary>
+		/// Gets the inverse world transform (world -> local space), recalculating the transform and
+		/// it's parents if required
+		/// </summary>
+		const glm::mat4& GetInverseWorldTransform(Handle handle);
+
+		/// <summary>
+		/// Re-sorts the transforms if the hierarchy has changed, and recalculates all dirty
+		/// transforms in a single pass
+		/// </summary>
+		void Update();
+
+		/// <summary>
+		/// Gets the number of live transforms in the system
+		/// </summary>
+		size_t Size() const { return _handleToSlot.size() - _freeHandles.size() - _pendingFree.size(); }
+
+		/// <summary>
+		/// Calculates the inverse of a translate * rotate * scale matrix without needing a
+		/// general 4x4 matrix inverse
+		/// </summary>
+		static void CalculateTRS(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale, glm::mat4& outTransform, glm::mat4& outInverse);
+
+	private:
+		enum Flags : uint8_t {
+			FlagNone       = 0,
+			FlagLocalDirty = 1 << 0,
+			FlagWorldDirty = 1 << 1,
+			FlagFree       = 1 << 2
+		};
+
+		// Local TRS values, indexed by slot
+		std::vector<glm::vec3> _positions;
+		std::vector<glm::quat> _rotations;
+		std::vector<glm::vec3> _scales;
+
+		// Cached matrices, indexed by slot
+		std::vector<glm::mat4> _localTransforms;
+		std::vector<glm::mat4> _inverseLocalTransforms;
+		std::vector<glm::mat4> _worldTransforms;
+		std::vector<glm::mat4> _inverseWorldTransforms;
+
+		// Hierarchy and dirty state, indexed by slot
+		std::vector<Handle>    _parents;
+		std::vector<uint8_t>   _flags;
+		// Bumped every time the world transform is recalculated, children compare against the
+		// version they last saw to know when they need to be updated
+		std::vector<uint32_t>  _worldVersions;
+		std::vector<uint32_t>  _parentVersions;
+		std::vector<Handle>    _slotToHandle;
+
+		// Maps handles to their current slot
+		std::vector<uint32_t>  _handleToSlot;
+		// Handles that can be re-used
+		std::vector<Handle>    _freeHandles;
+		// Destroyed handles that can't be re-used until any children referencing them are fixed up
+		std::vector<Handle>    _pendingFree;
+
+		// True when the hierarchy has changed and the storage needs to be re-sorted
+		bool _orderDirty;
+
+		uint32_t _ParentSlot(uint32_t slot) const;
+		void _Recalculate(uint32_t slot, uint32_t parentSlot);
+		void _UpdateWorld(uint32_t slot);
+		void _Rebuild();
+	};
+}
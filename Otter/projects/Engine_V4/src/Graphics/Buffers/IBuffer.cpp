@@ -59,6 +59,16 @@ void IBuffer::UpdateData(const void* data, uint32_t elementSize, uint32_t elemen
 	}
 }
 
+void IBuffer::AllocateStorage(const void* data, uint32_t elementSize, uint32_t elementCount, BufferMapMode mapMode) {
+	// Only the mapping flags are valid for storage, the rest only make sense when mapping
+	const GLbitfield storageFlags = *mapMode & (GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+	glNamedBufferStorage(_rendererId, (GLsizeiptr)elementSize * elementCount, data, storageFlags);
+
+	_elementCount = elementCount;
+	_elementSize = elementSize;
+	_size = elementCount * elementSize;
+}
+
 void* IBuffer::Map(BufferMapMode mode) {
 	return glMapNamedBufferRange(_rendererId, 0, _size, *mode);
 }
@@ -76,6 +86,11 @@ void IBuffer::Bind(uint32_t slot) const
 	glBindBufferBase((GLenum)_type, slot, _rendererId);
 }
 
+void IBuffer::BindRange(uint32_t slot, uint32_t offset, uint32_t size) const
+{
+	glBindBufferRange((GLenum)_type, slot, _rendererId, (GLintptr)offset, (GLsizeiptr)size);
+}
+
 void IBuffer::UnBind(BufferType type) {
 	glBindBuffer((GLenum)type, 0);
 }
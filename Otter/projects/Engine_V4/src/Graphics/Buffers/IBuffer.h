@@ -52,6 +52,17 @@ public:
 	/// <param name="allowResize">True if resizing the buffer is allowed, otherwise an assertion is thrown for oversized writes</param>
 	virtual void UpdateData(const void* data, uint32_t elementSize, uint32_t elementCount, bool allowResize = true);
 
+	/// <summary>
+	/// Allocates immutable storage for this buffer using glNamedBufferStorage. This is needed for
+	/// buffers that stay mapped while the GPU is using them (BufferMapMode::Persistent), note that
+	/// the buffer can't be resized or re-loaded afterwards
+	/// </summary>
+	/// <param name="data">The initial data for the buffer, or nullptr to leave it uninitialized</param>
+	/// <param name="elementSize">The size of a single element, in bytes</param>
+	/// <param name="elementCount">The number of elements to allocate</param>
+	/// <param name="mapMode">The ways the buffer will be mapped, ex Write | Persistent | Coherent</param>
+	void AllocateStorage(const void* data, uint32_t elementSize, uint32_t elementCount, BufferMapMode mapMode);
+
 	/// <summary>
 	/// Loads an array of data into this buffer, using the bindless method glNamedBufferData
 	/// </summary>
@@ -107,6 +118,15 @@ public:
 	/// <param name="slot">The buffer slot to bind to, for the vast majority of cases this should be 0</param>
 	virtual void Bind(uint32_t slot) const;
 	/// <summary>
+	/// Binds a sub-range of this buffer to an indexed slot for the type returned by GetType()
+	/// Note that offset must respect the alignment requirements for the buffer type
+	/// (ex: GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT)
+	/// </summary>
+	/// <param name="slot">The buffer slot to bind to</param>
+	/// <param name="offset">The offset into the buffer in bytes</param>
+	/// <param name="size">The size of the range to bind in bytes</param>
+	void BindRange(uint32_t slot, uint32_t offset, uint32_t size) const;
+	/// <summary>
 	/// Unbinds the buffer bound to the slot given by type
 	/// </summary>
 	/// <param name="type">The type or slot of buffer to unbind (ex: GL_ARRAY_BUFFER, GL_ARRAY_ELEMENT_BUFFER)</param>
@@ -0,0 +1,215 @@
+#include "StreamingBuffer.h"
+#include "Logging.h"
+
+#include <algorithm>
+#include <cstring>
+
+// The flags our storage is created and mapped with, coherent means we don't need to flush our writes
+static const BufferMapMode StreamingMapMode = BufferMapMode::Write | BufferMapMode::Persistent | BufferMapMode::Coherent;
+
+static uint32_t NextPowerOfTwo(uint32_t value) {
+	uint32_t result = 1;
+	while (result < value) {
+		result <<= 1;
+	}
+	return result;
+}
+
+StreamingBuffer::StreamingBuffer(uint32_t regionSize, uint32_t regionCount) :
+	IBuffer(BufferType::Vertex, BufferUsage::StreamDraw),
+	_regionSize(NextPowerOfTwo(std::max(regionSize, 256u))),
+	_regionCount(std::max(regionCount, 2u)),
+	_mapped(nullptr),
+	_region(0),
+	_offset(0),
+	_frame(0),
+	_fences(std::vector<GLsync>()),
+	_regionFrames(std::vector<uint64_t>()),
+	_retired(std::vector<GLuint>()),
+	_stats(Stats()),
+	_lastStats(Stats())
+{
+	_CreateStorage();
+}
+
+StreamingBuffer::~StreamingBuffer() {
+	for (GLsync& fence : _fences) {
+		if (fence != nullptr) {
+			glDeleteSync(fence);
+		}
+	}
+	if (!_retired.empty()) {
+		glDeleteBuffers(static_cast<GLsizei>(_retired.size()), _retired.data());
+	}
+	if (_mapped != nullptr) {
+		Unmap();
+		_mapped = nullptr;
+	}
+}
+
+void StreamingBuffer::_CreateStorage() {
+	AllocateStorage(nullptr, _regionSize, _regionCount, StreamingMapMode);
+	_mapped = static_cast<uint8_t*>(Map(StreamingMapMode));
+	LOG_ASSERT(_mapped != nullptr, "Failed to map streaming buffer");
+
+	_fences.assign(_regionCount, nullptr);
+	_regionFrames.assign(_regionCount, _frame - 1);
+	_region = 0;
+	_offset = 0;
+	_regionFrames[_region] = _frame;
+}
+
+void StreamingBuffer::_NextRegion() {
+	uint32_t next = (_region + 1) % _regionCount;
+
+	// This frame has already written to the next region, and some of that data could still be bound
+	if (_regionFrames[next] == _frame) {
+		_Grow(_regionSize * 2);
+		return;
+	}
+
+	_region = next;
+	_offset = 0;
+	_regionFrames[_region] = _frame;
+	_stats.RegionsUsed++;
+
+	// If the GPU is still reading from the region, we have to wait for it
+	GLsync& fence = _fences[_region];
+	if (fence != nullptr) {
+		GLenum result = glClientWaitSync(fence, 0, 0);
+		if (result == GL_TIMEOUT_EXPIRED) {
+			_stats.Stalls++;
+			do {
+				// Make sure the fence actually gets submitted, otherwise we could wait forever
+				result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+			} while (result == GL_TIMEOUT_EXPIRED);
+		}
+		if (result == GL_WAIT_FAILED) {
+			LOG_WARN("Failed to wait on streaming buffer fence");
+		}
+		glDeleteSync(fence);
+		fence = nullptr;
+	}
+}
+
+void StreamingBuffer::_Grow(uint32_t regionSize) {
+	regionSize = NextPowerOfTwo(regionSize);
+	LOG_INFO("Expanding streaming buffer regions from {} bytes to {} bytes", _regionSize, regionSize);
+
+	// The old buffer sticks around until next frame, so that anything that's already bound to it can still draw
+	for (GLsync& fence : _fences) {
+		if (fence != nullptr) {
+			glDeleteSync(fence);
+		}
+	}
+	Unmap();
+	_retired.push_back(_rendererId);
+	GLuint handle = 0;
+	glCreateBuffers(1, &handle);
+	_SetRenderId(handle);
+
+	_regionSize = regionSize;
+	_CreateStorage();
+	_stats.RegionsUsed++;
+}
+
+void StreamingBuffer::BeginFrame() {
+	// Anything bound to our old buffers has been re-bound by now
+	if (!_retired.empty()) {
+		glDeleteBuffers(static_cast<GLsizei>(_retired.size()), _retired.data());
+		_retired.clear();
+	}
+
+	// Fence off everything the last frame wrote to, the GPU could be reading from any of it until the frame is done
+	for (uint32_t ix = 0; ix < _regionCount; ix++) {
+		if (_regionFrames[ix] == _frame && (ix != _region || _offset > 0)) {
+			if (_fences[ix] != nullptr) {
+				glDeleteSync(_fences[ix]);
+			}
+			_fences[ix] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
+	}
+
+	_lastStats = _stats;
+	_stats.Reset();
+	_frame++;
+
+	// Each frame starts in it's own region, so the regions line up with the frames in flight
+	if (_offset > 0) {
+		_NextRegion();
+	} else {
+		_regionFrames[_region] = _frame;
+	}
+}
+
+StreamingBuffer::Allocation StreamingBuffer::Allocate(uint32_t size, uint32_t alignment) {
+	LOG_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, "Alignment must be a power of two");
+
+	uint32_t offset = (_offset + alignment - 1) & ~(alignment - 1);
+	if (offset + size > _regionSize) {
+		if (size > _regionSize) {
+			_Grow(size);
+		} else {
+			_NextRegion();
+		}
+		offset = 0;
+	}
+
+	Allocation result;
+	result.Buffer = _rendererId;
+	result.Offset = _region * _regionSize + offset;
+	result.Size = size;
+	result.Data = _mapped + result.Offset;
+	result.Frame = _frame;
+
+	_offset = offset + size;
+	_stats.BytesUsed += size;
+	_stats.Allocations++;
+	return result;
+}
+
+StreamingBuffer::Allocation StreamingBuffer::Upload(const void* data, uint32_t size, uint32_t alignment) {
+	Allocation result = Allocate(size, alignment);
+	if (data != nullptr && size > 0) {
+		memcpy(result.Data, data, size);
+	}
+	return result;
+}
+
+bool StreamingBuffer::IsCurrentFrame(const Allocation& allocation) const {
+	return allocation.IsValid() && allocation.Frame == _frame;
+}
+
+void StreamingBuffer::BindRange(BufferType type, uint32_t slot, const Allocation& allocation) {
+	glBindBufferRange((GLenum)type, slot, allocation.Buffer, (GLintptr)allocation.Offset, (GLsizeiptr)std::max(allocation.Size, 1u));
+}
+
+StreamingBuffer& StreamingBuffer::Get() {
+	if (__Instance == nullptr) {
+		__Instance = new StreamingBuffer();
+	}
+	return *__Instance;
+}
+
+void StreamingBuffer::Uninitialize() {
+	delete __Instance;
+	__Instance = nullptr;
+}
+
+uint32_t StreamingBuffer::GetUniformAlignment() {
+	static GLint alignment = 0;
+	if (alignment == 0) {
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		alignment = std::max(alignment, 1);
+	}
+	return static_cast<uint32_t>(alignment);
+}
+
+uint32_t StreamingBuffer::GetStorageAlignment() {
+	static GLint alignment = 0;
+	if (alignment == 0) {
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		alignment = std::max(alignment, 1);
+	}
+	return static_cast<uint32_t>(alignment);
+}
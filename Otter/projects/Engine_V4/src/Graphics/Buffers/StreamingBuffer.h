@@ -0,0 +1,148 @@
+#pragma once
+#include "IBuffer.h"
+#include <memory>
+#include <vector>
+
+/// <summary>
+/// A persistently mapped ring buffer for data that is re-uploaded every frame (uniforms, instance
+/// data, UI and debug geometry). The buffer is split into regions, usually one per frame in flight,
+/// and the regions a frame wrote to are fenced off at the start of the next frame. We only wait on a
+/// region's fence when we come back around to it, so writing into the buffer never has to sync with
+/// the GPU like glNamedBufferSubData can
+///
+/// A frame never wraps around into a region it has already used, since that data may still be bound,
+/// if a frame runs out of room the buffer is re-created with bigger regions instead
+///
+/// Allocations are only good for the frame they were made in, so anything streamed through here
+/// needs to be written and bound again every frame
+/// </summary>
+class StreamingBuffer : public IBuffer
+{
+public:
+	typedef std::shared_ptr<StreamingBuffer> Sptr;
+
+	/// <summary>
+	/// A range of the buffer that can be written to for the current frame
+	/// </summary>
+	struct Allocation {
+		// Where to write the data, in mapped memory
+		void*    Data       = nullptr;
+		// The GL buffer the range is in, the buffer can be re-created when it grows so this is
+		// not always the streaming buffer's current handle
+		GLuint   Buffer     = 0;
+		// The offset of the range from the start of the buffer, in bytes
+		uint32_t Offset     = 0;
+		uint32_t Size       = 0;
+		// The frame the allocation was made in, see IsCurrentFrame
+		uint64_t Frame      = 0;
+
+		bool IsValid() const { return Data != nullptr; }
+	};
+
+	/// <summary>
+	/// Counters for how much of the buffer is being used
+	/// </summary>
+	struct Stats {
+		// Bytes allocated since the start of the frame
+		uint32_t BytesUsed     = 0;
+		// Number of allocations since the start of the frame
+		uint32_t Allocations   = 0;
+		// Times we had to wait for the GPU to finish with a region since the start of the frame
+		uint32_t Stalls        = 0;
+		// Regions we moved through since the start of the frame
+		uint32_t RegionsUsed   = 0;
+
+		void Reset() { *this = Stats(); }
+	};
+
+	/// <summary>
+	/// Creates a new streaming buffer, the total size will be regionSize * regionCount
+	/// </summary>
+	/// <param name="regionSize">The size of a single region in bytes, rounded up to a power of two</param>
+	/// <param name="regionCount">The number of regions, this should be at least the number of frames the GPU can be behind by</param>
+	StreamingBuffer(uint32_t regionSize = 4 * 1024 * 1024, uint32_t regionCount = 3);
+	virtual ~StreamingBuffer();
+
+	/// <summary>
+	/// Fences off the last frame's regions and moves on to a fresh one, should be called once at
+	/// the start of each frame
+	/// </summary>
+	void BeginFrame();
+
+	/// <summary>
+	/// Reserves a range of the buffer to write into. If the current region is full, we move on to
+	/// the next one, and if that's not possible the buffer is re-created bigger
+	/// </summary>
+	/// <param name="size">The size of the allocation in bytes</param>
+	/// <param name="alignment">The alignment of the offset, must be a power of two</param>
+	Allocation Allocate(uint32_t size, uint32_t alignment = 16);
+	/// <summary>
+	/// Allocates a range and copies the given data into it
+	/// </summary>
+	Allocation Upload(const void* data, uint32_t size, uint32_t alignment = 16);
+
+	/// <summary>
+	/// Returns true if the allocation was made since the last call to BeginFrame. Only these can be
+	/// bound safely, the fence for an older allocation's region was placed at the end of the frame
+	/// that wrote it, so it won't cover draws that read from the region later on
+	/// </summary>
+	bool IsCurrentFrame(const Allocation& allocation) const;
+
+	/// <summary>
+	/// Binds an allocation to an indexed slot, the type can be anything that supports glBindBufferRange
+	/// (ex: BufferType::Uniform or BufferType::ShaderStorage)
+	/// </summary>
+	static void BindRange(BufferType type, uint32_t slot, const Allocation& allocation);
+
+	uint32_t GetRegionSize() const { return _regionSize; }
+	uint32_t GetRegionCount() const { return _regionCount; }
+	/// <summary>
+	/// Gets the counters for the last frame, see BeginFrame
+	/// </summary>
+	const Stats& GetStats() const { return _lastStats; }
+
+	/// <summary>
+	/// Gets the streaming buffer that is shared by all per-frame uploads, creating it if needed
+	/// </summary>
+	static StreamingBuffer& Get();
+	/// <summary>
+	/// Releases the shared streaming buffer, must be called while the GL context is still around
+	/// </summary>
+	static void Uninitialize();
+
+	/// <summary>
+	/// Gets the required offset alignment for uniform buffer ranges (GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT)
+	/// </summary>
+	static uint32_t GetUniformAlignment();
+	/// <summary>
+	/// Gets the required offset alignment for shader storage ranges (GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT)
+	/// </summary>
+	static uint32_t GetStorageAlignment();
+
+protected:
+	uint32_t _regionSize;
+	uint32_t _regionCount;
+	uint8_t* _mapped;
+
+	// The region we're writing into, and how far into it we are
+	uint32_t _region;
+	uint32_t _offset;
+	uint64_t _frame;
+
+	// Fences for the GPU's use of each region, null if the region is free
+	std::vector<GLsync> _fences;
+	// The last frame that wrote to each region
+	std::vector<uint64_t> _regionFrames;
+	// Buffers that have been replaced by a bigger one, deleted at the start of the next frame. Allocations
+	// made before the buffer grew still point at these, so they need to stay around until then
+	std::vector<GLuint> _retired;
+
+	Stats _stats;
+	Stats _lastStats;
+
+	inline static StreamingBuffer* __Instance = nullptr;
+
+	void _CreateStorage();
+	void _NextRegion();
+	void _Grow(uint32_t regionSize);
+};
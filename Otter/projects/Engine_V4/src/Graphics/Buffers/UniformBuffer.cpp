@@ -3,16 +3,29 @@
 
 AbstractUniformBuffer::~AbstractUniformBuffer() {
 	delete[] _rawData;
+
+	// Make sure no one thinks we still own a slot
+	for (const AbstractUniformBuffer*& owner : __SlotOwners) {
+		if (owner == this) {
+			owner = nullptr;
+		}
+	}
 }
 
 AbstractUniformBuffer::AbstractUniformBuffer(uint32_t sizeInBytes, BufferUsage usage /*= BufferUsage::DynamicDraw*/) :
 	IBuffer(BufferType::Uniform, usage),
-	_rawData(nullptr)
+	_rawData(nullptr),
+	_streamed(usage == BufferUsage::DynamicDraw || usage == BufferUsage::StreamDraw),
+	_allocation(StreamingBuffer::Allocation()),
+	_boundSlot(-1)
 {
 	_rawData = new uint8_t[sizeInBytes];
 	_size = sizeInBytes;
 	memset(_rawData, 0, sizeInBytes);
-	glNamedBufferData(_rendererId, _size, _rawData, (GLenum)_usage);
+	// Streamed buffers never read from their own storage
+	if (!_streamed) {
+		glNamedBufferData(_rendererId, _size, _rawData, (GLenum)_usage);
+	}
 }
 
 void AbstractUniformBuffer::LoadData(const void* data, uint32_t elementSize, uint32_t elementCount) {
@@ -21,15 +34,48 @@ void AbstractUniformBuffer::LoadData(const void* data, uint32_t elementSize, uin
 	// Copy data from the data given to our internal buffer
 	memcpy(_rawData, data, dataSize);
 	// Upload data to the OpenGL buffer
-	glNamedBufferSubData(_rendererId, 0, dataSize, _rawData);
+	_Sync();
 }
 
 void AbstractUniformBuffer::Bind() const {
-	glBindBufferBase(GL_UNIFORM_BUFFER, 0, _rendererId);
+	Bind(0);
 }
 
 void AbstractUniformBuffer::Bind(int slot) const
 {
-	glBindBufferBase(GL_UNIFORM_BUFFER, slot, _rendererId);
+	if (slot >= static_cast<int>(__SlotOwners.size())) {
+		__SlotOwners.resize(slot + 1, nullptr);
+	}
+	__SlotOwners[slot] = this;
+	_boundSlot = slot;
+
+	if (_streamed) {
+		// A copy from an earlier frame may still be intact, but the GPU's use of it is only fenced
+		// up to the end of that frame, so anything bound after that needs a fresh copy
+		StreamingBuffer& stream = StreamingBuffer::Get();
+		if (!stream.IsCurrentFrame(_allocation)) {
+			_allocation = stream.Upload(_rawData, _size, StreamingBuffer::GetUniformAlignment());
+		}
+		stream.BindRange(BufferType::Uniform, slot, _allocation);
+	} else {
+		glBindBufferBase(GL_UNIFORM_BUFFER, slot, _rendererId);
+	}
 }
 
+void AbstractUniformBuffer::_Sync() const
+{
+	if (!_streamed) {
+		glNamedBufferSubData(_rendererId, 0, _size, _rawData);
+		return;
+	}
+
+	// Every update gets a new range, so draws that have already been issued still see the old data
+	StreamingBuffer& stream = StreamingBuffer::Get();
+	_allocation = stream.Upload(_rawData, _size, StreamingBuffer::GetUniformAlignment());
+
+	// Shaders read from whatever range is bound to the slot, so point it at our new data. If
+	// someone else has bound to the slot since, it's theirs now
+	if (_boundSlot >= 0 && __SlotOwners[_boundSlot] == this) {
+		stream.BindRange(BufferType::Uniform, _boundSlot, _allocation);
+	}
+}
@@ -1,12 +1,18 @@
 #pragma once
 #include "IBuffer.h"
+#include "StreamingBuffer.h"
 #include <memory>
+#include <vector>
 
 /// <summary>
 /// A uniform buffer that operates on raw data
 /// Since this is a base class for the typed Uniform Buffers,
 /// we can use the shared ptr to store uniform buffers with
 /// different structures
+///
+/// Buffers with a dynamic or stream usage are written through the shared StreamingBuffer
+/// instead of their own storage, each update gets a fresh range that's re-bound to the
+/// buffer's slot. These need to be bound or updated every frame that they're used
 /// </summary>
 class AbstractUniformBuffer : public IBuffer {
 public :
@@ -41,10 +47,28 @@ public :
 	/// <param name="slot">The buffer binding slot to bind to</param>
 	void Bind(int slot) const;
 
+	/// <summary>
+	/// Returns true if updates go through the shared streaming buffer
+	/// </summary>
+	bool IsStreamed() const { return _streamed; }
+
 protected:
 	// Will contain the backing data store for the buffer
 	uint8_t* _rawData;
 	uint32_t _size;
+
+	bool _streamed;
+	// Where our data was last streamed to, and the slot we were last bound to
+	mutable StreamingBuffer::Allocation _allocation;
+	mutable int _boundSlot;
+
+	// Which buffer each uniform slot was last bound to, so we know if we can re-bind our slot on update
+	inline static std::vector<const AbstractUniformBuffer*> __SlotOwners;
+
+	/// <summary>
+	/// Sends our raw data to OpenGL
+	/// </summary>
+	void _Sync() const;
 };
 
 /// <summary>
@@ -107,6 +131,6 @@ public:
 	/// a resync with the GL side buffer
 	/// </summary>
 	void Update() {
-		glNamedBufferSubData(_rendererId, 0, sizeof(Structure), _rawData);
+		_Sync();
 	}
 };
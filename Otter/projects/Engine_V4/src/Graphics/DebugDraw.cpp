@@ -1,4 +1,5 @@
 #include "Graphics/DebugDraw.h"
+#include "Graphics/Buffers/StreamingBuffer.h"
 
 DebugDrawer::DebugDrawer() :
 	_colorStack(std::stack<glm::vec3>()),
@@ -7,15 +8,11 @@ DebugDrawer::DebugDrawer() :
 	_lineOffset(0),
 	_triangleOffset(0)
 {
-	_linesVBO = VertexBuffer::Create(BufferUsage::DynamicDraw);
-	_linesVBO->LoadData<VertexPosCol>(nullptr, LINE_BATCH_SIZE * 2);
 	_linesVAO = VertexArrayObject::Create();
-	_linesVAO->AddVertexBuffer(_linesVBO, VertexPosCol::V_DECL);
+	_linesBinding = _linesVAO->AddStreamedVertexBuffer(VertexPosCol::V_DECL);
 
-	_trisVBO = VertexBuffer::Create(BufferUsage::DynamicDraw);
-	_trisVBO->LoadData<VertexPosCol>(nullptr, TRI_BATCH_SIZE * 3);
 	_trisVAO = VertexArrayObject::Create();
-	_trisVAO->AddVertexBuffer(_trisVBO, VertexPosCol::V_DECL);
+	_trisBinding = _trisVAO->AddStreamedVertexBuffer(VertexPosCol::V_DECL);
 
 	_colorStack.push(glm::vec3(1.0f));
 	_transformStack.push(glm::mat4(1.0f));
@@ -74,10 +71,11 @@ void DebugDrawer::FlushLines()
 		glLineWidth(2.0f);
 		glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &restorePoint);
 		VertexArrayObject::Unbind();
-		_linesVBO->LoadData<VertexPosCol>(_lineBuffer, LINE_BATCH_SIZE * 2);
-		_linesVAO->Bind();
-		_linesVAO->Draw(DrawMode::LineList);
-		_linesVAO->Unbind();
+		// Only send the lines we've actually added
+		StreamingBuffer& stream = StreamingBuffer::Get();
+		StreamingBuffer::Allocation vertices = stream.Upload(_lineBuffer, static_cast<uint32_t>(_lineOffset * sizeof(VertexPosCol)));
+		_linesVAO->SetVertexBufferRange(_linesBinding, vertices);
+		_linesVAO->DrawRange(static_cast<uint32_t>(_lineOffset), DrawMode::LineList);
 		_lineOffset = 0;
 		if (restorePoint != 0) {
 			glBindVertexArray(restorePoint);
@@ -117,10 +115,10 @@ void DebugDrawer::FlushTris()
 		int restorePoint = 0;
 		glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &restorePoint);
 		VertexArrayObject::Unbind();
-		_trisVBO->LoadData<VertexPosCol>(_triBuffer, TRI_BATCH_SIZE * 3);
-		_trisVAO->Bind();
-		_trisVAO->Draw(DrawMode::LineList);
-		_trisVAO->Unbind();
+		StreamingBuffer& stream = StreamingBuffer::Get();
+		StreamingBuffer::Allocation vertices = stream.Upload(_triBuffer, static_cast<uint32_t>(_triangleOffset * sizeof(VertexPosCol)));
+		_trisVAO->SetVertexBufferRange(_trisBinding, vertices);
+		_trisVAO->DrawRange(static_cast<uint32_t>(_triangleOffset), DrawMode::LineList);
 		_triangleOffset = 0;
 		if (restorePoint != 0) {
 			glBindVertexArray(restorePoint);
@@ -138,9 +138,10 @@ protected:
 	size_t       _triangleOffset;
 	VertexPosCol _triBuffer[TRI_BATCH_SIZE * 3];
 
-	VertexBuffer::Sptr _linesVBO;
+	// Our vertices are streamed through StreamingBuffer when we flush, these get pointed at them
+	VertexArrayObject::VertexBufferBinding* _linesBinding;
 	VertexArrayObject::Sptr _linesVAO;
-	VertexBuffer::Sptr _trisVBO;
+	VertexArrayObject::VertexBufferBinding* _trisBinding;
 	VertexArrayObject::Sptr _trisVAO;
 
 	inline static DebugDrawer* __Instance = nullptr;
@@ -193,11 +193,18 @@ void Font::Bake() {
 	uint32_t index = 0;
 	for (uint32_t codepoint : codePoints) {
 		_glyphMap[codepoint] = __CreateGlyph(index);
+		_glyphMap[codepoint].GlyphIndex = stbtt_FindGlyphIndex(&_fontInfo, codepoint);
 		index++;
 
 		if (codepoint == 0xE000u)
 			_defaultGlyph = _glyphMap[codepoint];
 	}
+
+	// Copy the low codepoints into a flat table, so the common characters don't need a map lookup
+	_glyphTable.assign(FLAT_GLYPH_COUNT, _defaultGlyph);
+	for (auto it = _glyphMap.begin(); it != _glyphMap.end() && it->first < FLAT_GLYPH_COUNT; it++) {
+		_glyphTable[it->first] = it->second;
+	}
 }
 
 const Texture2D::Sptr& Font::GetAtlas() {
@@ -205,9 +212,7 @@ const Texture2D::Sptr& Font::GetAtlas() {
 }
 
 GlyphInfo Font::GetGlyph(uint32_t codePoint, float offsetX, float offsetY) const {
-	// Try and get glyph info from the codepoint, otherwise grab the default glyph
-	auto it = _glyphMap.find(codePoint);		
-	GlyphInfo result = it == _glyphMap.end() ? _defaultGlyph : it->second;
+	GlyphInfo result = FindGlyph(codePoint);
 
 	result.OffsetX += offsetX;
 	result.OffsetY += offsetY;
@@ -215,10 +220,24 @@ GlyphInfo Font::GetGlyph(uint32_t codePoint, float offsetX, float offsetY) const
 	return result;
 }
 
+const GlyphInfo& Font::FindGlyph(uint32_t codePoint) const {
+	if (codePoint < _glyphTable.size()) {
+		return _glyphTable[codePoint];
+	}
+
+	// Try and get glyph info from the codepoint, otherwise grab the default glyph
+	auto it = _glyphMap.find(codePoint);
+	return it == _glyphMap.end() ? _defaultGlyph : it->second;
+}
+
 float Font::GetKerning(int char1, int char2) const {
 	return stbtt_GetCodepointKernAdvance(&_fontInfo, char1, char2) * _pixelHeightScale;
 }
 
+float Font::GetKerning(const GlyphInfo& left, const GlyphInfo& right) const {
+	return stbtt_GetGlyphKernAdvance(&_fontInfo, left.GlyphIndex, right.GlyphIndex) * _pixelHeightScale;
+}
+
 float Font::GetLineHeight() const {
 	return (_ascent - _descent + _lineGap) * _pixelHeightScale;
 }
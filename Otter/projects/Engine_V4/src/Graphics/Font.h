@@ -9,6 +9,8 @@
 		glm::vec2 Positions[4];
 		glm::vec2 UVs[4];
 		float OffsetX, OffsetY;
+		// The glyph's index in the truetype font, for kerning lookups
+		int GlyphIndex;
 		bool IsPacked;
 	};
 
@@ -62,6 +64,13 @@
 		/// <param name="offsetY">The y position of the glyph</param>
 		GlyphInfo GetGlyph(uint32_t codePoint, float offsetX, float offsetY) const;
 		/// <summary>
+		/// Gets the glyph info for a codepoint without copying it, the offsets will be the
+		/// advance from the start of the glyph. Returns the default glyph if the codepoint
+		/// was not baked into the font
+		/// </summary>
+		/// <param name="codePoint">The unicode codepoint to attempt to lookup</param>
+		const GlyphInfo& FindGlyph(uint32_t codePoint) const;
+		/// <summary>
 		/// Gets the kerning (horizontal space) between 2 unicode characters
 		/// </summary>
 		/// <param name="char1">The left character</param>
@@ -69,6 +78,14 @@
 		/// <returns>The space between characters</returns>
 		float  GetKerning(int char1, int char2) const;
 		/// <summary>
+		/// Gets the kerning between 2 glyphs returned by FindGlyph, this skips looking up
+		/// the glyph indices like GetKerning does
+		/// </summary>
+		/// <param name="left">The left glyph</param>
+		/// <param name="right">The right glyph</param>
+		/// <returns>The space between the glyphs</returns>
+		float  GetKerning(const GlyphInfo& left, const GlyphInfo& right) const;
+		/// <summary>
 		/// Returns the vertical height of a line of text for this font
 		/// </summary>
 		float  GetLineHeight() const;
@@ -93,8 +110,13 @@
 		static Font::Sptr FromJson(const nlohmann::json& data);
 
 	protected:
+		// Codepoints below this are looked up directly in _glyphTable, covers the Latin-1 and Latin
+		// Extended-A/B blocks. Anything above falls back to _glyphMap
+		static constexpr uint32_t FLAT_GLYPH_COUNT = 0x250;
+
 		std::vector<glm::uvec2> _glyphRanges;
 		std::map<uint32_t, GlyphInfo> _glyphMap;
+		std::vector<GlyphInfo>        _glyphTable;
 		GlyphInfo                     _defaultGlyph;
 		Texture2D::Sptr   _atlas;
 		std::string       _fontPath;
@@ -748,7 +748,8 @@ ENUM(BlendEquation, uint32_t,
 ENUM(BufferType, GLenum,
 	Vertex  = GL_ARRAY_BUFFER,
 	Index   = GL_ELEMENT_ARRAY_BUFFER,
-	Uniform = GL_UNIFORM_BUFFER
+	Uniform = GL_UNIFORM_BUFFER,
+	ShaderStorage = GL_SHADER_STORAGE_BUFFER
 )
 
 /// <summary>
@@ -811,6 +812,7 @@ ENUM(AttributeType, GLenum,
 	 Int     = GL_INT,
 	 UInt    = GL_UNSIGNED_INT,
 	 Float   = GL_FLOAT,
+	 HalfFloat = GL_HALF_FLOAT,
 	 Double  = GL_DOUBLE,
 	 Unknown = GL_NONE
 )
@@ -2,26 +2,36 @@
 #include <GLM/gtc/matrix_transform.hpp>
 #include <GLM/gtc/matrix_inverse.hpp>
 #include "Utils/ResourceManager/ResourceManager.h"
+#include "Graphics/Buffers/StreamingBuffer.h"
 #include <locale>
 #include <codecvt>
+#include <limits>
 
 
-std::unordered_map<Texture2D*, GuiBatcher::MeshData> GuiBatcher::_meshBuilders;
+MeshBuilder<VertexPosColTex> GuiBatcher::__mesh;
+std::vector<GuiBatcher::DrawCommand> GuiBatcher::__commands;
+TextureAtlas GuiBatcher::__atlas;
+bool GuiBatcher::__atlasEnabled = true;
+GuiBatcher::Stats GuiBatcher::__stats;
 
 VertexArrayObject::Sptr GuiBatcher::__vao = nullptr;
-IndexBuffer::Sptr GuiBatcher::__ibo = nullptr;
+VertexArrayObject::VertexBufferBinding* GuiBatcher::__vertexBinding = nullptr;
 
 Texture2D::Sptr GuiBatcher::__defaultUITexture = nullptr;
 int GuiBatcher::__defaultEdgeRadius = 0;
 
-VertexBuffer::Sptr GuiBatcher::__vbo = nullptr;
+std::unordered_map<std::string, GuiBatcher::TextCacheEntry> GuiBatcher::__textCache;
+uint32_t GuiBatcher::__textCacheGeneration = 0;
+size_t GuiBatcher::__textCacheLimit = 1024;
+bool GuiBatcher::__textCacheEnabled = true;
+
 ShaderProgram::Sptr GuiBatcher::__shader = nullptr;
 ShaderProgram::Sptr GuiBatcher::__fontShader = nullptr;
 glm::ivec2 GuiBatcher::__windowSize = {0, 0};
 glm::mat4 GuiBatcher::__projection = glm::mat4(1.0f);
 glm::mat3 GuiBatcher::__model = glm::mat3(1.0f);
 std::vector<glm::mat3> GuiBatcher::__modelTransformStack = std::vector<glm::mat3>();
-std::vector<GuiBatcher::IRect> GuiBatcher::__scissorRects = std::vector<GuiBatcher::IRect>();
+std::vector<GuiBatcher::ScissorRect> GuiBatcher::__scissorRects = std::vector<GuiBatcher::ScissorRect>();
 
 void GuiBatcher::PushRect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color, const Texture2D::Sptr& tex, const glm::vec2 uvMin, const glm::vec2 uvMax) {
 	// Create vertices and transform positions
@@ -30,28 +40,34 @@ void GuiBatcher::PushRect(const glm::vec2& min, const glm::vec2& max, const glm:
 	verts[1].Position = __model * glm::vec3(min.x, max.y, 1.0f);
 	verts[2].Position = __model * glm::vec3(max.x, max.y, 1.0f);
 	verts[3].Position = __model * glm::vec3(max.x, min.y, 1.0f);
-		
-	// Grab mesh info for the texture batch
-	MeshData& mesh = _meshBuilders[tex.get()];
-	// We can use the vertex count for depth, so that things drawn later have a bit of spacing
-	float depth = mesh.Builder.GetVertexCount() / 1000.0f;
 
-	// Copy in all color and set depth 
+	// Copy in all color, the command list keeps things in order so we don't need depth
 	for (int ix = 0; ix < 4; ix++) {
 		verts[ix].Color = color;
-		verts[ix].Position.z = depth;
+		verts[ix].Position.z = 0.0f;
 	}
 
-	// Copy over UV coords
-	verts[0].UV = glm::vec2(uvMin.x, uvMax.y);
-	verts[1].UV = glm::vec2(uvMin.x, uvMin.y);
-	verts[2].UV = glm::vec2(uvMax.x, uvMin.y);
-	verts[3].UV = glm::vec2(uvMax.x, uvMax.y);
+	// UVs outside of 0-1 rely on the texture wrapping, which we can't do from inside an atlas
+	const TextureAtlas::Region* region = nullptr;
+	if (glm::all(glm::greaterThanEqual(glm::min(uvMin, uvMax), glm::vec2(0.0f))) &&
+		glm::all(glm::lessThanEqual(glm::max(uvMin, uvMax), glm::vec2(1.0f)))) {
+		region = __FindInAtlas(tex, false);
+	}
+	glm::vec2 uvLow  = region != nullptr ? region->ToPage(uvMin) : uvMin;
+	glm::vec2 uvHigh = region != nullptr ? region->ToPage(uvMax) : uvMax;
 
-	// Add vertices and indices to range
-	uint32_t ix = mesh.Builder.AddVertexRange(verts, 4);
-	mesh.Builder.AddIndexTri(ix + 0, ix + 2, ix + 1);
-	mesh.Builder.AddIndexTri(ix + 0, ix + 3, ix + 2);
+	// Copy over UV coords
+	verts[0].UV = glm::vec2(uvLow.x, uvHigh.y);
+	verts[1].UV = glm::vec2(uvLow.x, uvLow.y);
+	verts[2].UV = glm::vec2(uvHigh.x, uvLow.y);
+	verts[3].UV = glm::vec2(uvHigh.x, uvHigh.y);
+
+	// Add vertices and indices to the batch
+	DrawCommand& command = __GetCommand(region != nullptr ? region->Page : tex, false);
+	uint32_t ix = __mesh.AddVertexRange(verts, 4);
+	__mesh.AddIndexTri(ix + 0, ix + 2, ix + 1);
+	__mesh.AddIndexTri(ix + 0, ix + 3, ix + 2);
+	command.IndexCount += 6;
 }
 
 void GuiBatcher::PushRect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color, const Texture2D::Sptr& tex, int edgeRadius)
@@ -98,21 +114,43 @@ void GuiBatcher::SetProjection(const glm::mat4& projection) {
 }
 
 void GuiBatcher::RenderText(const std::wstring& text, const Font::Sptr& font, const glm::vec2& position, const glm::vec4& color, float scale /*= 1.0f*/) {
-	// How many characters we have
-	size_t length = text.size();
+	if (!__textCacheEnabled) {
+		RenderText(*TextLayout::Create(text, font, scale), position, color);
+		return;
+	}
 
-	// Tracks the offset of the character
-	glm::vec2 offset = glm::vec2(0.0f);
+	TextLayout::Sptr& layout = __GetCachedText(font, scale, text.data(), text.size() * sizeof(wchar_t), true);
+	if (layout == nullptr) {
+		layout = TextLayout::Create(text, font, scale);
+	}
+	RenderText(*layout, position, color);
+}
 
-	// Transform the origin based off the model transform
-	glm::vec2 origin = position;
+void GuiBatcher::RenderText(const std::string& text, const Font::Sptr& font, const glm::vec2& position, const glm::vec4& color, float scale /*= 1.0f*/)
+{
+	static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+	if (!__textCacheEnabled) {
+		RenderText(converter.from_bytes(text), font, position, color, scale);
+		return;
+	}
 
-	// Gets the texture used to render the font
-	Texture2D::Sptr atlas = font->GetAtlas();
+	// We only need to convert the string if we haven't seen it before
+	TextLayout::Sptr& layout = __GetCachedText(font, scale, text.data(), text.size(), false);
+	if (layout == nullptr) {
+		layout = TextLayout::Create(converter.from_bytes(text), font, scale);
+	}
+	RenderText(*layout, position, color);
+}
+
+void GuiBatcher::RenderText(const TextLayout& layout, const glm::vec2& position, const glm::vec4& color) {
+	if (layout.GetQuads().empty()) {
+		return;
+	}
 
-	// Grab the mesh builder and make sure it's a texture batch
-	MeshData& mesh = _meshBuilders[atlas.get()];
-	mesh.IsFont = true;
+	// Atlased glyphs are stored as white with the coverage in alpha, so they can share a draw
+	// with everything else. Otherwise we need the font shader to read the coverage from red
+	const TextureAtlas::Region* region = __FindInAtlas(layout.GetAtlas(), true);
+	DrawCommand& command = __GetCommand(region != nullptr ? region->Page : layout.GetAtlas(), region == nullptr);
 
 	// Allocate some space for the vertices
 	VertexPosColTex verts[4];
@@ -121,94 +159,221 @@ void GuiBatcher::RenderText(const std::wstring& text, const Font::Sptr& font, co
 	verts[2].Color = color;
 	verts[3].Color = color;
 
-	float depth = mesh.Builder.GetVertexCount() / 1000.0f;
+	// The glyphs have already been placed, we just need to move them into position
+	for (const TextLayout::Quad& quad : layout.GetQuads()) {
+		for (int ix = 0; ix < 4; ix++) {
+			verts[ix].Position = __model * glm::vec3(position + quad.Positions[ix], 1.0f);
+			verts[ix].Position.z = 0.0f;
+			verts[ix].UV = region != nullptr ? region->ToPage(quad.UVs[ix]) : quad.UVs[ix];
+		}
 
-	// Iterate over all characters in string
-	for (int i = 0; i < length; i++) {
-		// Grab the glyph data for the character
-		GlyphInfo glyph = font->GetGlyph(text[i], offset.x, offset.y);
+		uint32_t ix = __mesh.AddVertexRange(verts, 4);
+		__mesh.AddIndexTri(ix + 0, ix + 1, ix + 2);
+		__mesh.AddIndexTri(ix + 0, ix + 2, ix + 3);
+		command.IndexCount += 6;
+	}
+}
 
-		// A newline will advance to the next line and return to the start of the line
-		if (text[i] == '\n') {
-			offset.y  += font->GetLineHeight() * scale;
-			offset.x = 0;
-		}
-		// A return character simply returns to the start of the line
-		else if (text[i] == '\r') {
-			offset.x = 0;
-		}
-		// A tab character is 4 spaces
-		else if (text[i] == '\t') {
-			float xOffTemp{ 0 }, yOffTemp{ 0 };
-			glyph = font->GetGlyph(' ', xOffTemp, yOffTemp);
-			offset.x += glyph.OffsetX * 4;
+GuiBatcher::DrawCommand& GuiBatcher::__GetCommand(const Texture2D::Sptr& texture, bool isFont) {
+	const bool scissored = !__scissorRects.empty();
+	__stats.Commands++;
+
+	// If nothing has changed since the last command, we can just keep adding to it
+	if (!__commands.empty()) {
+		DrawCommand& last = __commands.back();
+		if (last.Texture == texture && last.IsFont == isFont && last.Scissored == scissored &&
+			(!scissored || last.Scissor == __scissorRects.back())) {
+			return last;
 		}
-		// All other characters get rendered
-		else {
-			verts[0].Position = __model * glm::vec3(origin + (offset + glyph.Positions[0]) * scale, 1.0f);
-			verts[1].Position = __model * glm::vec3(origin + (offset + glyph.Positions[1]) * scale, 1.0f);
-			verts[2].Position = __model * glm::vec3(origin + (offset + glyph.Positions[2]) * scale, 1.0f);
-			verts[3].Position = __model * glm::vec3(origin + (offset + glyph.Positions[3]) * scale, 1.0f);
-			verts[0].UV = glyph.UVs[0];
-			verts[1].UV = glyph.UVs[1];
-			verts[2].UV = glyph.UVs[2];
-			verts[3].UV = glyph.UVs[3];
-
-			verts[0].Position.z = verts[1].Position.z = verts[2].Position.z = verts[3].Position.z = depth;
-
-			uint32_t ix = mesh.Builder.AddVertexRange(verts, 4);
-			mesh.Builder.AddIndexTri(ix + 0, ix + 1, ix + 2);
-			mesh.Builder.AddIndexTri(ix + 0, ix + 2, ix + 3);
-
-			// Advance the offset based on the size of the glyph
-			offset.x = glyph.OffsetX;
-			offset.y = glyph.OffsetY;
-
-			// If we have more characters, see if there's any kerning between the
-			// current and next character and add it to the x offset
-			if (i < length - 1) {
-				float kerning = font->GetKerning(text[i], text[i + 1]);
-				offset.x += kerning;
+	}
+
+	DrawCommand command;
+	command.Texture = texture;
+	command.IsFont = isFont;
+	command.Scissored = scissored;
+	command.Scissor = scissored ? __scissorRects.back() : ScissorRect{ glm::vec2(-1.0f), glm::vec2(1.0f) };
+	command.FirstIndex = static_cast<uint32_t>(__mesh.GetIndexCount());
+	command.IndexCount = 0;
+	__commands.push_back(command);
+	return __commands.back();
+}
+
+const TextureAtlas::Region* GuiBatcher::__FindInAtlas(const Texture2D::Sptr& texture, bool coverage) {
+	if (!__atlasEnabled || texture == nullptr) {
+		return nullptr;
+	}
+	return __atlas.Get(texture, coverage);
+}
+
+TextLayout::Sptr& GuiBatcher::__GetCachedText(const Font::Sptr& font, float scale, const void* text, size_t size, bool wide) {
+	// Build the key in a buffer we hang on to, so cache hits don't need to allocate
+	static std::string key;
+	const Font* fontPtr = font.get();
+	key.clear();
+	key.append(reinterpret_cast<const char*>(&fontPtr), sizeof(fontPtr));
+	key.append(reinterpret_cast<const char*>(&scale), sizeof(scale));
+	key.push_back(wide ? 'w' : 'a');
+	key.append(static_cast<const char*>(text), size);
+
+	auto it = __textCache.find(key);
+	if (it == __textCache.end()) {
+		if (__textCache.size() >= __textCacheLimit) {
+			// Drop everything that hasn't been drawn since the last trim
+			for (auto entry = __textCache.begin(); entry != __textCache.end();) {
+				if (entry->second.LastUsed != __textCacheGeneration) {
+					entry = __textCache.erase(entry);
+				} else {
+					entry++;
+				}
+			}
+			__textCacheGeneration++;
+
+			// If most of the cache is still in use, give it more room so we're not trimming constantly
+			if (__textCache.size() >= __textCacheLimit / 2) {
+				__textCacheLimit *= 2;
 			}
 		}
+		it = __textCache.emplace(key, TextCacheEntry{ nullptr, 0 }).first;
+	}
+	it->second.LastUsed = __textCacheGeneration;
 
+	// The font may have been deleted, and a new one created at the same address
+	if (it->second.Layout != nullptr && !it->second.Layout->IsFor(font)) {
+		it->second.Layout = nullptr;
 	}
+	return it->second.Layout;
+}
 
+void GuiBatcher::SetTextCacheEnabled(bool value) {
+	__textCacheEnabled = value;
 }
 
-void GuiBatcher::RenderText(const std::string& text, const Font::Sptr& font, const glm::vec2& position, const glm::vec4& color, float scale /*= 1.0f*/)
-{
-	static std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-	RenderText(converter.from_bytes(text), font, position, color, scale);
+bool GuiBatcher::GetTextCacheEnabled() {
+	return __textCacheEnabled;
+}
+
+size_t GuiBatcher::GetTextCacheSize() {
+	return __textCache.size();
+}
+
+void GuiBatcher::ClearTextCache() {
+	__textCache.clear();
 }
 
 void GuiBatcher::Flush()
 {
 	__StaticInit();
 
-	// Iterate over each texture and it's mesh
-	for (auto&[key, value] : _meshBuilders) {
-		Texture2D* tex = key;
-		// If the texture exists and the mesh has data
-		if (tex != nullptr && value.Builder.GetIndexCount() > 0) {
-			// Update the VAO and it's buffers
-			__vao->Bind();
-			__vbo->UpdateData(value.Builder.GetVertexDataPtr(), sizeof(VertexPosColTex), value.Builder.GetVertexCount(), true);
-			__ibo->UpdateData(value.Builder.GetIndexDataPtr(), sizeof(uint32_t), value.Builder.GetIndexCount(), true);
-
-			// Bind texture, send uniforms to shader
-			tex->Bind(0);
-			ShaderProgram::Sptr shader = value.IsFont ? __fontShader : __shader;
-			shader->Bind();
-			shader->SetUniformMatrix(0, &__projection, 1, false);
-
-			// Draw geometry
-			__vao->Draw();
-
-			// Clear mesh
-			value.Builder.Reset();
+	if (__mesh.GetIndexCount() > 0) {
+		// The whole batch goes up in one upload, the commands draw ranges of it
+		StreamingBuffer& stream = StreamingBuffer::Get();
+		StreamingBuffer::Allocation vertices = stream.Upload(__mesh.GetVertexDataPtr(), static_cast<uint32_t>(__mesh.GetVertexCount() * sizeof(VertexPosColTex)));
+		StreamingBuffer::Allocation indices = stream.Upload(__mesh.GetIndexDataPtr(), static_cast<uint32_t>(__mesh.GetIndexCount() * sizeof(uint32_t)), sizeof(uint32_t));
+		__vao->SetVertexBufferRange(__vertexBinding, vertices);
+
+		// Scissor rects are stored in NDC, so we map them to whatever viewport we're drawing to
+		glm::ivec4 viewport;
+		glGetIntegerv(GL_VIEWPORT, &viewport.x);
+		glm::ivec4 prevScissor;
+		glGetIntegerv(GL_SCISSOR_BOX, &prevScissor.x);
+		const bool wasScissored = glIsEnabled(GL_SCISSOR_TEST);
+
+		// Draw the commands in order, only changing state when we need to
+		ShaderProgram* boundShader = nullptr;
+		Texture2D*     boundTexture = nullptr;
+		bool           scissorEnabled = wasScissored;
+		glm::ivec4     boundScissor = prevScissor;
+		for (const DrawCommand& command : __commands) {
+			if (command.Texture == nullptr || command.IndexCount == 0) {
+				continue;
+			}
+
+			ShaderProgram* shader = command.IsFont ? __fontShader.get() : __shader.get();
+			if (shader != boundShader) {
+				shader->Bind();
+				shader->SetUniformMatrix(0, &__projection, 1, false);
+				boundShader = shader;
+			}
+			if (command.Texture.get() != boundTexture) {
+				command.Texture->Bind(0);
+				boundTexture = command.Texture.get();
+				__stats.TextureChanges++;
+			}
+
+			if (command.Scissored) {
+				glm::vec2 size = glm::vec2(viewport.z, viewport.w);
+				glm::ivec2 min = glm::ivec2(glm::floor((command.Scissor.Min + 1.0f) * 0.5f * size));
+				glm::ivec2 max = glm::ivec2(glm::ceil((command.Scissor.Max + 1.0f) * 0.5f * size));
+				glm::ivec4 box = glm::ivec4(viewport.x + min.x, viewport.y + min.y, glm::max(max - min, glm::ivec2(0)));
+
+				if (!scissorEnabled) {
+					glEnable(GL_SCISSOR_TEST);
+					scissorEnabled = true;
+					__stats.ScissorChanges++;
+				}
+				if (box != boundScissor) {
+					glScissor(box.x, box.y, box.z, box.w);
+					boundScissor = box;
+					__stats.ScissorChanges++;
+				}
+			} else if (scissorEnabled) {
+				glDisable(GL_SCISSOR_TEST);
+				scissorEnabled = false;
+				__stats.ScissorChanges++;
+			}
+
+			__vao->DrawIndexedRange(indices, command.FirstIndex * sizeof(uint32_t), command.IndexCount, IndexType::UInt);
+			__stats.DrawCalls++;
 		}
+
+		// Put the scissor state back the way we found it
+		if (scissorEnabled != wasScissored) {
+			if (wasScissored) {
+				glEnable(GL_SCISSOR_TEST);
+			} else {
+				glDisable(GL_SCISSOR_TEST);
+			}
+		}
+		glScissor(prevScissor.x, prevScissor.y, prevScissor.z, prevScissor.w);
+
+		__stats.Vertices += static_cast<uint32_t>(__mesh.GetVertexCount());
 	}
+
+	DiscardBatch();
+}
+
+void GuiBatcher::DiscardBatch()
+{
+	__mesh.Reset();
+	__commands.clear();
+}
+
+void GuiBatcher::SetAtlasEnabled(bool value) {
+	__atlasEnabled = value;
+}
+
+bool GuiBatcher::GetAtlasEnabled() {
+	return __atlasEnabled;
+}
+
+TextureAtlas& GuiBatcher::GetAtlas() {
+	return __atlas;
+}
+
+void GuiBatcher::InvalidateTexture(const Texture2D::Sptr& texture) {
+	__atlas.Invalidate(texture);
+}
+
+void GuiBatcher::ExcludeFromAtlas(const Texture2D::Sptr& texture) {
+	__atlas.Exclude(texture);
+}
+
+const GuiBatcher::Stats& GuiBatcher::GetStats() {
+	return __stats;
+}
+
+void GuiBatcher::ResetStats() {
+	__stats.Reset();
 }
 
 void GuiBatcher::PushModelTransform(const glm::mat3& transform) {
@@ -292,18 +457,14 @@ void GuiBatcher::__StaticInit()
 
 					void main() {
 						float fontPow = texture(s_Texture, inUV).r;
-						outColor = vec4(inColor.rgb, fontPow);
+						outColor = vec4(inColor.rgb, inColor.a * fontPow);
 					}
 				)LIT" , ShaderPartType::Fragment);
 
 		__fontShader->Link();
 
-		__vbo = VertexBuffer::Create(BufferUsage::DynamicDraw);
-		__ibo = IndexBuffer::Create(BufferUsage::DynamicDraw, IndexType::UInt);
-
 		__vao = VertexArrayObject::Create();
-		__vao->AddVertexBuffer(__vbo, VertexPosColTex::V_DECL);
-		__vao->SetIndexBuffer(__ibo);
+		__vertexBinding = __vao->AddStreamedVertexBuffer(VertexPosColTex::V_DECL);
 
 		// Generate a simple white texture with a black border
 		if (__defaultUITexture == nullptr) {
@@ -334,44 +495,29 @@ void GuiBatcher::__StaticInit()
 }
 
 void GuiBatcher::PushScissorRect(const glm::vec2& min, const glm::vec2& max) {
-	// Convert input to the current space
-	glm::vec2 modelMin = __model * glm::vec3(min, 1.0f);
-	glm::vec2 modelMax = __model * glm::vec3(max, 1.0f);
-
-	// Project the values, will be in Normalized Device Coordinates ([-1,1])
-	glm::vec2 minNDC = __projection * glm::vec4(modelMin, 0.0f, 1.0f);
-	glm::vec2 maxNDC = __projection * glm::vec4(modelMax, 0.0f, 1.0f);
-
-	// Convert NDC to screenspace
-	glm::ivec2 minWin = glm::floor(((minNDC + 1.0f) / 2.0f) * (glm::vec2)__windowSize);
-	glm::ivec2 maxWin = glm::ceil(((maxNDC + 1.0f) / 2.0f)  * (glm::vec2)__windowSize);
-
-	// Store the bounds
-	__scissorRects.push_back({ minWin, maxWin });
+	// Transform the corners into Normalized Device Coordinates ([-1,1]), the model transform
+	// may be rotated so we take the bounds of all four
+	const glm::vec2 corners[4] = { min, glm::vec2(min.x, max.y), max, glm::vec2(max.x, min.y) };
+	glm::vec2 minNDC = glm::vec2(std::numeric_limits<float>::max());
+	glm::vec2 maxNDC = glm::vec2(std::numeric_limits<float>::lowest());
+	for (const glm::vec2& corner : corners) {
+		glm::vec2 ndc = __projection * glm::vec4(glm::vec2(__model * glm::vec3(corner, 1.0f)), 0.0f, 1.0f);
+		minNDC = glm::min(minNDC, ndc);
+		maxNDC = glm::max(maxNDC, ndc);
+	}
 
-	// Calculate the actual size
-	int width  = glm::max(maxWin.x, minWin.x) - glm::min(maxWin.x, minWin.x);
-	int height = glm::max(maxWin.y, minWin.y) - glm::min(maxWin.y, minWin.y);
+	// Nested regions are clipped to their parent
+	if (!__scissorRects.empty()) {
+		minNDC = glm::max(minNDC, __scissorRects.back().Min);
+		maxNDC = glm::min(maxNDC, __scissorRects.back().Max);
+	}
 
-	// Draw current geo with the current scissor, then update it
-	Flush();
-	glScissor(minWin.x, maxWin.y, width, height);
+	__scissorRects.push_back({ minNDC, maxNDC });
 }
 
 void GuiBatcher::PopScissorRect() {
 	LOG_ASSERT(__scissorRects.size() > 0, "Scissor rect push/pop mismatch!");
 	__scissorRects.pop_back();
-
-	// Grab the last scissor rect, or just use window bounds if none left
-	IRect bounds = __scissorRects.size() > 0 ? __scissorRects.back() : IRect{ { 0, 0 }, { __windowSize.x, __windowSize.y } };
-
-	// Calculate the actual size
-	int width  = glm::max(bounds.Min.x, bounds.Max.x) - glm::min(bounds.Min.x, bounds.Max.x);
-	int height = glm::max(bounds.Min.y, bounds.Max.y) - glm::min(bounds.Min.y, bounds.Max.y);
-
-	// Draw current geo with the current scissor, then update it
-	Flush();
-	glScissor(glm::min(bounds.Min.x, bounds.Max.x), glm::min(bounds.Min.y, bounds.Max.y), width, height);
 }
 
 void GuiBatcher::SetDefaultTexture(const Texture2D::Sptr& value) {
@@ -7,15 +7,36 @@
 #include "Graphics/VertexArrayObject.h"
 #include "Graphics/VertexTypes.h"
 #include "Graphics/Font.h"
+#include "Graphics/TextLayout.h"
+#include "Graphics/Textures/TextureAtlas.h"
 #include "Utils/MeshBuilder.h"
 #include <unordered_map>
 
 	/// <summary>
 	/// The GUI Batcher class provides utilities for drawing rectangles and
 	/// fonts to the screen in a 2D fashion
+	///
+	/// Geometry is recorded into a single mesh along with a list of draw commands, so
+	/// things are drawn in the order they were added. Small textures and font atlases are
+	/// copied into shared atlas pages, so runs of different textures (and the scissor
+	/// rect they were drawn with) can usually be merged into a single draw
 	/// </summary>
 	class GuiBatcher {
 	public:
+		/// <summary>
+		/// Counters for the work done by Flush, since the last call to ResetStats
+		/// </summary>
+		struct Stats {
+			// Number of commands recorded, before merging
+			uint32_t Commands       = 0;
+			uint32_t DrawCalls      = 0;
+			uint32_t TextureChanges = 0;
+			uint32_t ScissorChanges = 0;
+			uint32_t Vertices       = 0;
+
+			void Reset() { *this = Stats(); }
+		};
+
 		/// <summary>
 		/// Adds a rectangle to the GUI batch, with a given border radius in pixels.
 		/// This can be used with textures to create rounded borders
@@ -38,7 +59,9 @@
 		/// <param name="uvMin">The maximum coord of the UV range</param>
 		static void PushRect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color, const Texture2D::Sptr& tex, const glm::vec2 uvMin, const glm::vec2 uvMax);
 		/// <summary>
-		/// Renders a left-aligned line of text at the given position using a font
+		/// Renders a left-aligned line of text at the given position using a font. The layout
+		/// is cached by font, text and scale, so strings that are drawn every frame are only
+		/// laid out once
 		/// </summary>
 		/// <param name="text">The unicode text to render</param>
 		/// <param name="font">The font to render with</param>
@@ -47,7 +70,8 @@
 		/// <param name="scale">The scaling to apply to the text</param>
 		static void RenderText(const std::wstring& text, const Font::Sptr& font, const glm::vec2& position, const glm::vec4& color, float scale = 1.0f);
 		/// <summary>
-		/// Renders a left-aligned line of text at the given position using a font
+		/// Renders a left-aligned line of text at the given position using a font. The layout
+		/// is cached the same as for unicode strings, so hits skip the UTF-8 conversion as well
 		/// </summary>
 		/// <param name="text">The ASCII text to render</param>
 		/// <param name="font">The font to render with</param>
@@ -55,6 +79,29 @@
 		/// <param name="color">The color of the text</param>
 		/// <param name="scale">The scaling to apply to the text</param>
 		static void RenderText(const std::string& text, const Font::Sptr& font, const glm::vec2& position, const glm::vec4& color, float scale = 1.0f);
+		/// <summary>
+		/// Renders text that has already been laid out at the given position, for text that
+		/// holds on to it's own layout (see GuiText)
+		/// </summary>
+		/// <param name="layout">The laid out text to render</param>
+		/// <param name="position">The position of the text in model space</param>
+		/// <param name="color">The color of the text</param>
+		static void RenderText(const TextLayout& layout, const glm::vec2& position, const glm::vec4& color);
+
+		/// <summary>
+		/// Sets whether the string overloads of RenderText cache their layouts, when disabled
+		/// the text is laid out on every call
+		/// </summary>
+		static void SetTextCacheEnabled(bool value);
+		static bool GetTextCacheEnabled();
+		/// <summary>
+		/// Gets the number of layouts in the text cache
+		/// </summary>
+		static size_t GetTextCacheSize();
+		/// <summary>
+		/// Removes all layouts from the text cache
+		/// </summary>
+		static void ClearTextCache();
 
 		/// <summary>
 		/// Sets the projection matrix to use for rendering, should ideally be an orthographic
@@ -69,6 +116,10 @@
 		/// Draws all geometry to the screen and prepares for the next batch
 		/// </summary>
 		static void Flush();
+		/// <summary>
+		/// Throws away all geometry added since the last flush without drawing it
+		/// </summary>
+		static void DiscardBatch();
 
 		/// <summary>
 		/// Push a new transform to the stack, this will be multiplied with the
@@ -82,17 +133,43 @@
 		static void PopModelTransform();
 
 		/// <summary>
-		/// Sets a new scissor region in model space. Note that this will invoke a 
-		/// flush
+		/// Sets a new scissor region in model space, clipped to the current region.
+		/// Everything added until the matching pop is clipped to it when flushed
 		/// </summary>
 		/// <param name="min">The minimum bounds of the scissor rectangle</param>
 		/// <param name="min">The maximum bounds of the scissor rectangle</param>
 		static void PushScissorRect(const glm::vec2& min, const glm::vec2& max);
 		/// <summary>
-		/// Pops the last scissor region, not that this will invoke a flush
+		/// Pops the last scissor region
 		/// </summary>
 		static void PopScissorRect();
 
+		/// <summary>
+		/// Sets whether textures are packed into shared atlas pages, when disabled every
+		/// texture change needs it's own draw
+		/// </summary>
+		static void SetAtlasEnabled(bool value);
+		static bool GetAtlasEnabled();
+		/// <summary>
+		/// Gets the atlas that UI textures and font atlases are packed into
+		/// </summary>
+		static TextureAtlas& GetAtlas();
+		/// <summary>
+		/// Re-copies a texture into the atlas the next time it is drawn, should be called
+		/// after changing the contents of a texture that is used by the GUI
+		/// </summary>
+		static void InvalidateTexture(const Texture2D::Sptr& texture);
+		/// <summary>
+		/// Stops a texture from being atlased, for textures that change every frame (ex: render targets)
+		/// </summary>
+		static void ExcludeFromAtlas(const Texture2D::Sptr& texture);
+
+		/// <summary>
+		/// Gets the counters for all flushes since the last call to ResetStats
+		/// </summary>
+		static const Stats& GetStats();
+		static void ResetStats();
+
 		/// <summary>
 		/// Sets the default texture to use for the background of GUI objects
 		/// </summary>
@@ -113,30 +190,73 @@
 		static int GetDefaultBorderRadius();
 
 	private:
-		struct IRect {
-			glm::ivec2 Min;
-			glm::ivec2 Max;
+		// Scissor bounds are kept in normalized device coordinates, so they can be mapped to
+		// whatever viewport is bound when we flush
+		struct ScissorRect {
+			glm::vec2 Min;
+			glm::vec2 Max;
+
+			bool operator ==(const ScissorRect& other) const { return Min == other.Min && Max == other.Max; }
 		};
 
-		struct MeshData {
-			MeshBuilder<VertexPosColTex> Builder;
-			bool IsFont;
+		/// <summary>
+		/// A range of the batch's indices that draws with the same state
+		/// </summary>
+		struct DrawCommand {
+			// Either an atlas page, or a texture that could not be atlased
+			Texture2D::Sptr Texture;
+			bool            IsFont;
+			bool            Scissored;
+			ScissorRect     Scissor;
+			uint32_t        FirstIndex;
+			uint32_t        IndexCount;
 		};
 
 		static glm::ivec2 __windowSize;
 		static glm::mat4 __projection;
 		static glm::mat3 __model;
 		static std::vector<glm::mat3> __modelTransformStack;
-		static std::vector<IRect> __scissorRects;
+		static std::vector<ScissorRect> __scissorRects;
 		static ShaderProgram::Sptr __shader;
 		static ShaderProgram::Sptr __fontShader;
-		static std::unordered_map<Texture2D*, MeshData> _meshBuilders;
+		static MeshBuilder<VertexPosColTex> __mesh;
+		static std::vector<DrawCommand> __commands;
+		static TextureAtlas __atlas;
+		static bool __atlasEnabled;
+		static Stats __stats;
 		static VertexArrayObject::Sptr __vao;
-		static VertexBuffer::Sptr __vbo;
-		static IndexBuffer::Sptr __ibo;
+		// Vertices and indices are streamed through StreamingBuffer, this binding gets pointed at them
+		static VertexArrayObject::VertexBufferBinding* __vertexBinding;
 
 		static Texture2D::Sptr __defaultUITexture;
 		static int __defaultEdgeRadius;
 
+		struct TextCacheEntry {
+			TextLayout::Sptr Layout;
+			// The value of __textCacheGeneration when the entry was last drawn
+			uint32_t         LastUsed;
+		};
+		// Keyed on the font, scale and raw bytes of the text, see __GetCachedText
+		static std::unordered_map<std::string, TextCacheEntry> __textCache;
+		static uint32_t __textCacheGeneration;
+		// The cache is trimmed down to the entries used since the last trim when it hits this size
+		static size_t __textCacheLimit;
+		static bool __textCacheEnabled;
+
+		/// <summary>
+		/// Finds the cache slot for some text, the layout will be null if it needs to be created
+		/// </summary>
+		static TextLayout::Sptr& __GetCachedText(const Font::Sptr& font, float scale, const void* text, size_t size, bool wide);
+
+		/// <summary>
+		/// Gets the command that the next indices should be added to, starting a new one if
+		/// the texture or scissor has changed since the last command
+		/// </summary>
+		static DrawCommand& __GetCommand(const Texture2D::Sptr& texture, bool isFont);
+		/// <summary>
+		/// Finds where a texture is in the atlas, or nullptr if it should be drawn on it's own
+		/// </summary>
+		static const TextureAtlas::Region* __FindInAtlas(const Texture2D::Sptr& texture, bool coverage);
+
 		static void __StaticInit();
 	};
@@ -88,21 +88,25 @@ bool ShaderProgram::LoadShaderPartFromFile(const char* path, ShaderPartType type
 		// Load the source from the file, using our helper that will
 		// resolve #include directives
 		std::string source = FileHelpers::ReadResolveIncludes(path);
-		// Pass off to LoadShaderPart
-		bool result =  LoadShaderPart(source.c_str(), type);
-		_fileSourceMap[type].IsFilePath = true;
-		_fileSourceMap[type].Source = path;
-		if (result == false) {
-			LOG_ERROR("Source File: {}", path);
-		}
-		glObjectLabel(GL_SHADER, _handles[type], -1, path);
-		return result; 
+		return _LoadShaderPartFromFileSource(source, path, type);
 	} else {
 		LOG_WARN("Could not open file at \"{}\"", path);
 		return false;
 	}
 }
 
+bool ShaderProgram::_LoadShaderPartFromFileSource(const std::string& source, const char* path, ShaderPartType type) {
+	// Pass off to LoadShaderPart
+	bool result =  LoadShaderPart(source.c_str(), type);
+	_fileSourceMap[type].IsFilePath = true;
+	_fileSourceMap[type].Source = path;
+	if (result == false) {
+		LOG_ERROR("Source File: {}", path);
+	}
+	glObjectLabel(GL_SHADER, _handles[type], -1, path);
+	return result; 
+}
+
 bool ShaderProgram::Link() {
 
 	LOG_TRACE("Starting shader link:");
@@ -341,24 +345,48 @@ nlohmann::json ShaderProgram::ToJson() const {
 }
 
 ShaderProgram::Sptr ShaderProgram::FromJson(const nlohmann::json& data) {
-	ShaderProgram::Sptr result = std::make_shared<ShaderProgram>();
-	result->SetDebugName(JsonGet(data, "name", result->_debugName));
+	return FromDecoded(data, DecodeFromJson(data));
+}
+
+std::shared_ptr<ShaderProgram::DecodedData> ShaderProgram::DecodeFromJson(const nlohmann::json& data) {
+	std::shared_ptr<DecodedData> result = std::make_shared<DecodedData>();
+	result->Name = JsonGet<std::string>(data, "name", "");
 	for (auto& [key, blob] : data.items()) {
 		// Get the shader part type from the key
 		ShaderPartType type = ParseShaderPartType(key, ShaderPartType::Unknown);
 		// As long as the type is valid
 		if (type != ShaderPartType::Unknown) {
-			// If it has a file, we load from file
+			// If it has a file, we read the file
 			if (blob.contains("path")) {
-				result->LoadShaderPartFromFile(blob["path"].get<std::string>().c_str(), type);
+				std::string path = blob["path"].get<std::string>();
+				if (std::filesystem::exists(path)) {
+					result->Parts.push_back({ type, path, FileHelpers::ReadResolveIncludes(path) });
+				} else {
+					LOG_WARN("Could not open file at \"{}\"", path);
+				}
 			}
-			// Otherwise we see if there's a source and load that instead
+			// Otherwise we see if there's a source and use that instead
 			else if (blob.contains("source")) {
-				result->LoadShaderPart(blob["source"].get<std::string>().c_str(), type);
+				result->Parts.push_back({ type, "", blob["source"].get<std::string>() });
 			}
 			// Otherwise do nothing
 		}
 	}
+	return result;
+}
+
+ShaderProgram::Sptr ShaderProgram::FromDecoded(const nlohmann::json& data, const std::shared_ptr<DecodedData>& decoded) {
+	ShaderProgram::Sptr result = std::make_shared<ShaderProgram>();
+	if (!decoded->Name.empty()) {
+		result->SetDebugName(decoded->Name);
+	}
+	for (const auto& part : decoded->Parts) {
+		if (!part.Path.empty()) {
+			result->_LoadShaderPartFromFileSource(part.Source, part.Path.c_str(), part.Type);
+		} else {
+			result->LoadShaderPart(part.Source.c_str(), part.Type);
+		}
+	}
 	result->Link();
 	return result;
 }
@@ -366,6 +394,36 @@ ShaderProgram::Sptr ShaderProgram::FromJson(const nlohmann::json& data) {
 void ShaderProgram::_Introspect() {
 	_IntrospectUniforms();
 	_IntrospectUnifromBlocks();
+	_IntrospectStorageBlocks();
+}
+
+int ShaderProgram::GetStorageBlockBinding(const std::string& name) const {
+	auto it = _storageBlocks.find(name);
+	return it != _storageBlocks.end() ? it->second : -1;
+}
+
+void ShaderProgram::_IntrospectStorageBlocks() {
+	_storageBlocks.clear();
+
+	// Query program for the number of shader storage blocks
+	int numBlocks = 0;
+	glGetProgramInterfaceiv(_rendererId, GL_SHADER_STORAGE_BLOCK, GL_ACTIVE_RESOURCES, &numBlocks);
+
+	for (int ix = 0; ix < numBlocks; ix++) {
+		// We only need the binding and the name for storage blocks
+		static GLenum pNamesBlockProperties[] ={
+			GL_BUFFER_BINDING,
+			GL_NAME_LENGTH
+		};
+		int results[2];
+		glGetProgramResourceiv(_rendererId, GL_SHADER_STORAGE_BLOCK, ix, 2, pNamesBlockProperties, 2, NULL, results);
+
+		std::string name;
+		name.resize(results[1] - 1);
+		glGetProgramResourceName(_rendererId, GL_SHADER_STORAGE_BLOCK, ix, results[1], NULL, &name[0]);
+
+		_storageBlocks[name] = results[0];
+	}
 }
 
 void ShaderProgram::_IntrospectUniforms() {
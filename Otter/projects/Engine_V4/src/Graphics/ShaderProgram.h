@@ -108,6 +108,12 @@ public:
 	static void Unbind();
 
 	const std::unordered_map<std::string, UniformInfo>& GetUniforms() const { return _uniforms; }
+	/// <summary>
+	/// Gets the binding slot of the shader storage block with the given name, or -1 if the
+	/// program has no active storage block with that name
+	/// </summary>
+	/// <param name="name">The name of the block, as declared in GLSL</param>
+	int GetStorageBlockBinding(const std::string& name) const;
 
 	// Inherited from IGraphicsResource
 
@@ -118,6 +124,29 @@ public:
 	virtual nlohmann::json ToJson() const override;
 	static ShaderProgram::Sptr FromJson(const nlohmann::json& data);
 
+	/// <summary>
+	/// Shader sources that have been read from disk, but not yet compiled
+	/// </summary>
+	struct DecodedData {
+		struct Part {
+			ShaderPartType Type;
+			// The path to the source file, or empty if the source was embedded in the JSON
+			std::string    Path;
+			std::string    Source;
+		};
+		std::string       Name;
+		std::vector<Part> Parts;
+	};
+	/// <summary>
+	/// Reads the shader sources (resolving includes) from a JSON blob, without touching OpenGL so
+	/// it is safe to call from any thread
+	/// </summary>
+	static std::shared_ptr<DecodedData> DecodeFromJson(const nlohmann::json& data);
+	/// <summary>
+	/// Compiles and links the shader from data produced by DecodeFromJson, must be called on the main thread
+	/// </summary>
+	static ShaderProgram::Sptr FromDecoded(const nlohmann::json& data, const std::shared_ptr<DecodedData>& decoded);
+
 public:
 	bool FindUniform(const std::string& name, UniformInfo* out);
 
@@ -188,6 +217,8 @@ protected:
 	// Map access to look up uniform locations and blocks
 	std::unordered_map<std::string, UniformInfo> _uniforms;
 	std::unordered_map<std::string, UniformBlockInfo> _uniformBlocks;
+	// Maps the names of active shader storage blocks to their binding slots
+	std::unordered_map<std::string, int> _storageBlocks;
 
 	// Stores information about the source of our shader parts
 	// EX: if a VS shader is loaded from a file, will contain
@@ -198,6 +229,11 @@ protected:
 	};
 	std::unordered_map<ShaderPartType, ShaderSource> _fileSourceMap;
 
+	/// <summary>
+	/// Compiles a shader part that was read from a file, and records the file as it's source
+	/// </summary>
+	bool _LoadShaderPartFromFileSource(const std::string& source, const char* path, ShaderPartType type);
+
 	/// <summary>
 	/// Performs program introspection, where we examine the uniforms that
 	/// the program contains
@@ -212,6 +248,11 @@ protected:
 	/// fed data from a uniform buffer
 	/// </summary>
 	void _IntrospectUnifromBlocks();
+	/// <summary>
+	/// Introspects shader storage blocks, so we can tell which buffers a program
+	/// expects to be bound
+	/// </summary>
+	void _IntrospectStorageBlocks();
 
 	int __GetUniformLocation(const std::string& name);
 };
\ No newline at end of file
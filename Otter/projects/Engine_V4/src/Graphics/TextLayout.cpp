@@ -0,0 +1,69 @@
+#include "Graphics/TextLayout.h"
+#include "Logging.h"
+
+TextLayout::TextLayout() :
+	_quads(std::vector<Quad>()),
+	_font(Font::Wptr()),
+	_atlas(nullptr),
+	_size(glm::vec2(0.0f)),
+	_scale(1.0f)
+{ }
+
+TextLayout::Sptr TextLayout::Create(const std::wstring& text, const Font::Sptr& font, float scale /*= 1.0f*/) {
+	LOG_ASSERT(font != nullptr, "Cannot lay out text without a font");
+
+	TextLayout::Sptr result = std::make_shared<TextLayout>();
+	result->_font = font;
+	result->_atlas = font->GetAtlas();
+	result->_scale = scale;
+	result->_size = font->MeausureString(text, scale);
+	result->_quads.reserve(text.size());
+
+	// Tracks the offset of the character, in font space
+	glm::vec2 offset = glm::vec2(0.0f);
+
+	const size_t length = text.size();
+	for (size_t i = 0; i < length; i++) {
+		// A newline will advance to the next line and return to the start of the line
+		if (text[i] == '\n') {
+			offset.y += font->GetLineHeight();
+			offset.x = 0;
+		}
+		// A return character simply returns to the start of the line
+		else if (text[i] == '\r') {
+			offset.x = 0;
+		}
+		// A tab character is 4 spaces
+		else if (text[i] == '\t') {
+			offset.x += font->FindGlyph(' ').OffsetX * 4;
+		}
+		// All other characters get a quad
+		else {
+			const GlyphInfo& glyph = font->FindGlyph(text[i]);
+
+			Quad quad;
+			for (int ix = 0; ix < 4; ix++) {
+				quad.Positions[ix] = (offset + glyph.Positions[ix]) * scale;
+				quad.UVs[ix] = glyph.UVs[ix];
+			}
+			result->_quads.push_back(quad);
+
+			// Advance the offset based on the size of the glyph
+			offset.x += glyph.OffsetX;
+			offset.y += glyph.OffsetY;
+
+			// If we have more characters, see if there's any kerning between the
+			// current and next character and add it to the x offset
+			if (i < length - 1) {
+				offset.x += font->GetKerning(glyph, font->FindGlyph(text[i + 1]));
+			}
+		}
+	}
+
+	return result;
+}
+
+bool TextLayout::IsFor(const Font::Sptr& font) const {
+	// Compare against the live font rather than an address, since a new font could end up where a deleted one was
+	return font != nullptr && _font.lock() == font;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include <GLM/glm.hpp>
+
+#include "Graphics/Font.h"
+
+/// <summary>
+/// A string that has been laid out with a font ahead of time, so that the GuiBatcher can draw it
+/// without looking up glyphs or kerning every frame. Layouts don't change once they're created,
+/// make a new one when the text, font or scale changes
+/// </summary>
+class TextLayout {
+public:
+	typedef std::shared_ptr<TextLayout> Sptr;
+
+	/// <summary>
+	/// A single glyph's quad, relative to the position the text is drawn at (scale already applied)
+	/// </summary>
+	struct Quad {
+		glm::vec2 Positions[4];
+		glm::vec2 UVs[4];
+	};
+
+	/// <summary>
+	/// Lays out a unicode string with the given font
+	/// </summary>
+	/// <param name="text">The text to lay out</param>
+	/// <param name="font">The font to lay the text out with, must have been baked</param>
+	/// <param name="scale">The scaling to apply to the text, as a multiple of the font size</param>
+	static Sptr Create(const std::wstring& text, const Font::Sptr& font, float scale = 1.0f);
+
+	TextLayout();
+	~TextLayout() = default;
+
+	/// <summary>
+	/// Returns true if this layout was made with the given font, and that font is still around
+	/// </summary>
+	bool IsFor(const Font::Sptr& font) const;
+
+	const std::vector<Quad>& GetQuads() const { return _quads; }
+	/// <summary>
+	/// Gets the font atlas that the quads' UVs point into
+	/// </summary>
+	const Texture2D::Sptr& GetAtlas() const { return _atlas; }
+	/// <summary>
+	/// Gets the size of the text, as measured by Font::MeausureString
+	/// </summary>
+	const glm::vec2& GetSize() const { return _size; }
+	float GetScale() const { return _scale; }
+
+protected:
+	std::vector<Quad> _quads;
+	// Weak so that cached layouts don't keep fonts alive
+	Font::Wptr        _font;
+	Texture2D::Sptr   _atlas;
+	glm::vec2         _size;
+	float             _scale;
+};
@@ -47,8 +47,26 @@ nlohmann::json Texture2D::ToJson() const {
 
 Texture2D::Sptr Texture2D::FromJson(const nlohmann::json& data)
 {
-	Texture2DDescription descr = Texture2DDescription();
-	descr.Filename = data["filename"];
+	return FromDecoded(data, DecodeFromJson(data));
+}
+
+Texture2D::DecodedData::DecodedData() :
+	Description(Texture2DDescription()),
+	Width(0), Height(0), NumChannels(0),
+	Pixels(nullptr)
+{ }
+
+Texture2D::DecodedData::~DecodedData() {
+	if (Pixels != nullptr) {
+		stbi_image_free(Pixels);
+		Pixels = nullptr;
+	}
+}
+
+std::shared_ptr<Texture2D::DecodedData> Texture2D::DecodeFromJson(const nlohmann::json& data) {
+	std::shared_ptr<DecodedData> result = std::make_shared<DecodedData>();
+	Texture2DDescription& descr = result->Description;
+	descr.Filename = JsonGet<std::string>(data, "filename", "");
 	descr.HorizontalWrap = JsonParseEnum(WrapMode, data, "wrap_s", WrapMode::ClampToEdge);
 	descr.VerticalWrap   = JsonParseEnum(WrapMode, data, "wrap_t", WrapMode::ClampToEdge);
 	descr.MinificationFilter  = JsonParseEnum(MinFilter, data, "filter_min", MinFilter::NearestMipNearest);
@@ -56,10 +74,22 @@ Texture2D::Sptr Texture2D::FromJson(const nlohmann::json& data)
 	descr.MaxAnisotropic      = JsonGet(data, "anisotropic", 0.0f);
 	descr.GenerateMipMaps     = JsonGet(data, "generate_mipmaps", false);
 
+	_DecodeFile(*result);
+	return result;
+}
+
+Texture2D::Sptr Texture2D::FromDecoded(const nlohmann::json& data, const std::shared_ptr<DecodedData>& decoded) {
+	// Create the texture without a filename, so the constructor doesn't load the file a second time
+	Texture2DDescription descr = decoded->Description;
+	descr.Filename = "";
 	Texture2D::Sptr result = std::make_shared<Texture2D>(descr);
 
+	if (!decoded->Description.Filename.empty()) {
+		result->_description.Filename = decoded->Description.Filename;
+		result->_LoadDecodedData(*decoded);
+	}
 	// If we embedded data into the JSON, load it now
-	if (descr.Filename.empty() && data.contains("data") && data["data"].is_string()) {
+	else if (data.contains("data") && data["data"].is_string()) {
 		PixelType type = JsonParseEnum(PixelType, data, "pixel_type", PixelType::Unknown);
 		try {
 			std::string rawData = Base64::Decode(data['data'].get<std::string>());
@@ -150,52 +180,68 @@ void Texture2D::_LoadDataFromFile() {
 	LOG_ASSERT(_description.Width + _description.Height == 0, "This texture has already been configured with a size! Cannot re-allocate memory!");
 
 	if (!_description.Filename.empty()) {
-		// Variables that will store properties about our image
-		int width, height, numChannels;
-		const int targetChannels = GetTexelComponentCount(_description.FormatHint);
-
-		// Use STBI to load the image
-		stbi_set_flip_vertically_on_load(true);
-		uint8_t* data = stbi_load(_description.Filename.c_str(), &width, &height, &numChannels, targetChannels);
-
-		// If we could not load any data, warn and return null
-		if (data == nullptr) {
-			LOG_WARN("STBI Failed to load image from \"{}\"", _description.Filename);
-			return ;
-		}
+		DecodedData decoded;
+		decoded.Description = _description;
+		_DecodeFile(decoded);
+		_LoadDecodedData(decoded);
+	}
+}
+
+void Texture2D::_DecodeFile(DecodedData& decoded) {
+	if (decoded.Description.Filename.empty()) {
+		return;
+	}
+
+	// Variables that will store properties about our image
+	int width, height, numChannels;
+	const int targetChannels = GetTexelComponentCount(decoded.Description.FormatHint);
 
-		// We should estimate a good format for our data
+	// Use STBI to load the image. Note that the flip flag is global in this version of STBI, but every
+	// loader in the engine sets it to the same value so it's safe to decode on multiple threads
+	stbi_set_flip_vertically_on_load(true);
+	uint8_t* data = stbi_load(decoded.Description.Filename.c_str(), &width, &height, &numChannels, targetChannels);
 
-		// numChannels will store the number of channels in the image on disk, if we overrode that we should use the override value
-		if (targetChannels != 0)
-			numChannels = targetChannels;
+	// If we could not load any data, warn and return null
+	if (data == nullptr) {
+		LOG_WARN("STBI Failed to load image from \"{}\"", decoded.Description.Filename);
+		return;
+	}
 
+	// numChannels will store the number of channels in the image on disk, if we overrode that we should use the override value
+	if (targetChannels != 0)
+		numChannels = targetChannels;
+
+	decoded.Width = width;
+	decoded.Height = height;
+	decoded.NumChannels = numChannels;
+	decoded.Pixels = data;
+}
+
+void Texture2D::_LoadDecodedData(const DecodedData& decoded) {
+	if (decoded.Pixels != nullptr) {
 		// We'll determine a recommended format for the image based on number of channels
 		// We hinted that we wanted a certain number of channels, but we're not guaranteed
 		// that all those channels exist (ex: loading an RGB image but requesting RGBA)
-		InternalFormat internal_format = GetInternalFormatForChannels8(numChannels);
-		PixelFormat    image_format = GetPixelFormatForChannels(numChannels);
+		InternalFormat internal_format = GetInternalFormatForChannels8(decoded.NumChannels);
+		PixelFormat    image_format = GetPixelFormatForChannels(decoded.NumChannels);
 
 		// This is one of those poorly documented things in OpenGL
-		if ((numChannels * width) % 4 != 0) {
+		if ((decoded.NumChannels * decoded.Width) % 4 != 0) {
 			LOG_WARN("The alignment of a horizontal line is not a multiple of 4, this will require a call to glPixelStorei(GL_PACK_ALIGNMENT)");
 		}
 
 		// Update our description to match what we loaded
 		_description.Format = internal_format;
-		_description.Width = width;
-		_description.Height = height;
+		_description.Width = decoded.Width;
+		_description.Height = decoded.Height;
 
 		// Allocates our memory
 		_SetTextureParams();
 
 		// Upload data to our texture
-		LoadData(width, height, image_format, PixelType::UByte, data);
-
-		// We now have data in the image, we can clear the STBI data
-		stbi_image_free(data);
+		LoadData(decoded.Width, decoded.Height, image_format, PixelType::UByte, decoded.Pixels);
 	}
-	
+
 	SetDebugName(_description.Filename);
 }
 
@@ -147,13 +147,49 @@ public:
 	/// </summary>
 	const Texture2DDescription& GetDescription() const { return _description; }
 
+	/// <summary>
+	/// Image data that has been read and decoded from disk, but not yet uploaded to OpenGL. This
+	/// allows the slow part of loading a texture to happen on a worker thread
+	/// </summary>
+	struct DecodedData {
+		Texture2DDescription Description;
+		int                  Width;
+		int                  Height;
+		int                  NumChannels;
+		// The pixel data from STBI, or nullptr if there is no file or it failed to load
+		uint8_t*             Pixels;
+
+		DecodedData();
+		~DecodedData();
+		DecodedData(const DecodedData&) = delete;
+		DecodedData& operator=(const DecodedData&) = delete;
+	};
+
 	virtual nlohmann::json ToJson() const override;
 	static Texture2D::Sptr FromJson(const nlohmann::json& data);
+	/// <summary>
+	/// Reads the description from a JSON blob and decodes the image file it refers to, does not
+	/// touch OpenGL so it is safe to call from any thread
+	/// </summary>
+	static std::shared_ptr<DecodedData> DecodeFromJson(const nlohmann::json& data);
+	/// <summary>
+	/// Creates the texture from data produced by DecodeFromJson, must be called on the main thread
+	/// </summary>
+	static Texture2D::Sptr FromDecoded(const nlohmann::json& data, const std::shared_ptr<DecodedData>& decoded);
 
 protected:
 	Texture2DDescription _description;
 	PixelType _pixelType;
 
+	/// <summary>
+	/// Decodes an image file using STBI, without touching OpenGL
+	/// </summary>
+	static void _DecodeFile(DecodedData& decoded);
+	/// <summary>
+	/// Allocates this texture to match a decoded image and uploads it's pixels
+	/// </summary>
+	void _LoadDecodedData(const DecodedData& decoded);
+
 	/// <summary>
 	/// Loads this texture from the file specified in the description
 	/// Will overwrite description size
@@ -0,0 +1,220 @@
+#include "Graphics/Textures/TextureAtlas.h"
+
+#include <algorithm>
+
+#include "Logging.h"
+
+TextureAtlas::TextureAtlas(int pageSize, int maxPages) :
+	_pageSize(AtlasAllocator(pageSize, 1).GetSize()),
+	_maxPages(std::max(maxPages, 1)),
+	_pages(std::vector<Page>()),
+	_entries(std::unordered_map<const Texture2D*, Entry>())
+{ }
+
+bool TextureAtlas::CanAtlas(const Texture2D& texture, bool coverage, int pageSize) {
+	const Texture2DDescription& desc = texture.GetDescription();
+	if (desc.MultisampleCount != 1 || desc.Width == 0 || desc.Height == 0) {
+		return false;
+	}
+
+	// We only handle 8 bit formats that we can copy without any conversion, sRGB would need
+	// the pages to be sRGB as well
+	if (coverage ? desc.Format != InternalFormat::R8 : (desc.Format != InternalFormat::RGBA8 && desc.Format != InternalFormat::RGB8)) {
+		return false;
+	}
+
+	// Anything that would take more than a quarter of a page is big enough to be drawn on it's own
+	int size = (int)std::max(desc.Width, desc.Height) + Padding * 2;
+	return size <= pageSize / 2;
+}
+
+const TextureAtlas::Region* TextureAtlas::Get(const Texture2D::Sptr& texture, bool coverage) {
+	if (texture == nullptr) {
+		return nullptr;
+	}
+
+	auto it = _entries.find(texture.get());
+	if (it != _entries.end()) {
+		Entry& entry = it->second;
+		// The texture may have been deleted, and a new one created at the same address
+		if (entry.Texture.lock() != texture) {
+			_Release(entry);
+			_entries.erase(it);
+		} else if (entry.Excluded || entry.Coverage != coverage) {
+			return nullptr;
+		} else {
+			return &entry.Placement;
+		}
+	}
+
+	// Textures without any storage yet may still be loading, so we don't remember them
+	if (!CanAtlas(*texture, coverage, _pageSize)) {
+		if (texture->GetWidth() > 0 && texture->GetHeight() > 0) {
+			Entry& entry = _entries[texture.get()];
+			entry.Texture = texture;
+			entry.Excluded = true;
+		}
+		return nullptr;
+	}
+
+	Entry& entry = _entries[texture.get()];
+	entry.Texture = texture;
+	entry.Coverage = coverage;
+	if (!_Pack(texture, entry)) {
+		// We're out of room, so we don't keep trying to pack it every time it's drawn
+		entry.Excluded = true;
+		return nullptr;
+	}
+	return &entry.Placement;
+}
+
+void TextureAtlas::Invalidate(const Texture2D::Sptr& texture) {
+	auto it = _entries.find(texture.get());
+	if (it != _entries.end()) {
+		_Release(it->second);
+		_entries.erase(it);
+	}
+}
+
+void TextureAtlas::Exclude(const Texture2D::Sptr& texture) {
+	if (texture == nullptr) {
+		return;
+	}
+	Entry& entry = _entries[texture.get()];
+	_Release(entry);
+	entry.Texture = texture;
+	entry.Excluded = true;
+}
+
+void TextureAtlas::Clear() {
+	_entries.clear();
+	_pages.clear();
+}
+
+size_t TextureAtlas::GetTextureCount() const {
+	size_t result = 0;
+	for (const auto& [key, entry] : _entries) {
+		if (entry.PageIndex >= 0) {
+			result++;
+		}
+	}
+	return result;
+}
+
+float TextureAtlas::GetUsage() const {
+	if (_pages.empty()) {
+		return 0.0f;
+	}
+	float result = 0.0f;
+	for (const Page& page : _pages) {
+		result += page.Allocator.GetUsage();
+	}
+	return result / _pages.size();
+}
+
+bool TextureAtlas::_Pack(const Texture2D::Sptr& texture, Entry& entry) {
+	const int width = (int)texture->GetWidth();
+	const int height = (int)texture->GetHeight();
+	const int paddedWidth = width + Padding * 2;
+	const int paddedHeight = height + Padding * 2;
+	const bool nearest = texture->GetMagFilter() == MagFilter::Nearest;
+
+	int pageIndex = -1;
+	AtlasAllocator::Tile tile = _AllocateTile(std::max(paddedWidth, paddedHeight), nearest, pageIndex);
+	if (!tile.IsValid()) {
+		return false;
+	}
+
+	// Read the texture back once, this only happens the first time a texture is packed
+	const int channels = entry.Coverage ? 1 : 4;
+	std::vector<uint8_t> source((size_t)width * height * channels);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glGetTextureImage(texture->GetHandle(), 0, entry.Coverage ? GL_RED : GL_RGBA, GL_UNSIGNED_BYTE, (GLsizei)source.size(), source.data());
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+	// Copy into the padded image, clamping to the edges of the source so the border repeats
+	std::vector<glm::u8vec4> padded((size_t)paddedWidth * paddedHeight);
+	for (int y = 0; y < paddedHeight; y++) {
+		const int sy = glm::clamp(y - Padding, 0, height - 1);
+		for (int x = 0; x < paddedWidth; x++) {
+			const int sx = glm::clamp(x - Padding, 0, width - 1);
+			const size_t ix = ((size_t)sy * width + sx) * channels;
+			padded[(size_t)y * paddedWidth + x] = entry.Coverage ?
+				glm::u8vec4(255, 255, 255, source[ix]) :
+				glm::u8vec4(source[ix], source[ix + 1], source[ix + 2], source[ix + 3]);
+		}
+	}
+
+	Page& page = _pages[pageIndex];
+	page.Texture->LoadData(paddedWidth, paddedHeight, PixelFormat::RGBA, PixelType::UByte, padded.data(), tile.Position.x, tile.Position.y);
+
+	entry.PageIndex = pageIndex;
+	entry.Tile = tile;
+	entry.Placement.Page = page.Texture;
+	entry.Placement.UvOffset = glm::vec2(tile.Position + glm::ivec2(Padding)) / (float)_pageSize;
+	entry.Placement.UvScale = glm::vec2(width, height) / (float)_pageSize;
+	return true;
+}
+
+AtlasAllocator::Tile TextureAtlas::_AllocateTile(int size, bool nearest, int& pageIndex) {
+	// Try the pages we already have, then see if anything has been freed up, and then make a new page
+	for (int pass = 0; pass < 2; pass++) {
+		for (int ix = 0; ix < (int)_pages.size(); ix++) {
+			if (_pages[ix].Nearest == nearest) {
+				AtlasAllocator::Tile tile = _pages[ix].Allocator.Allocate(size);
+				if (tile.IsValid()) {
+					pageIndex = ix;
+					return tile;
+				}
+			}
+		}
+		if (pass == 0) {
+			_ReleaseExpired();
+		}
+	}
+
+	if ((int)_pages.size() >= _maxPages) {
+		LOG_WARN("Texture atlas is out of pages, textures will be drawn without it");
+		return AtlasAllocator::Tile();
+	}
+
+	Texture2DDescription desc;
+	desc.Width = _pageSize;
+	desc.Height = _pageSize;
+	desc.Format = InternalFormat::RGBA8;
+	desc.MinificationFilter = nearest ? MinFilter::Nearest : MinFilter::Linear;
+	desc.MagnificationFilter = nearest ? MagFilter::Nearest : MagFilter::Linear;
+	desc.HorizontalWrap = WrapMode::ClampToEdge;
+	desc.VerticalWrap = WrapMode::ClampToEdge;
+	// Mips would blend neighbouring textures together, and need regenerating every time we pack
+	desc.GenerateMipMaps = false;
+
+	Page page;
+	page.Texture = std::make_shared<Texture2D>(desc);
+	page.Allocator.Reset(_pageSize, 16);
+	page.Nearest = nearest;
+	_pages.push_back(page);
+
+	pageIndex = (int)_pages.size() - 1;
+	return _pages.back().Allocator.Allocate(size);
+}
+
+void TextureAtlas::_Release(Entry& entry) {
+	if (entry.PageIndex >= 0 && entry.PageIndex < (int)_pages.size()) {
+		_pages[entry.PageIndex].Allocator.Free(entry.Tile);
+	}
+	entry.PageIndex = -1;
+	entry.Tile = AtlasAllocator::Tile();
+	entry.Placement = Region();
+}
+
+void TextureAtlas::_ReleaseExpired() {
+	for (auto it = _entries.begin(); it != _entries.end();) {
+		if (it->second.Texture.expired()) {
+			_Release(it->second);
+			it = _entries.erase(it);
+		} else {
+			it++;
+		}
+	}
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "GLM/glm.hpp"
+
+#include "Graphics/Textures/Texture2D.h"
+#include "Utils/AtlasAllocator.h"
+
+/// <summary>
+/// Copies small textures into shared RGBA8 pages, so that things that draw with lots of
+/// different textures (like the GUI) can draw with only a few. Textures are copied in the
+/// first time they are requested, with their edge pixels repeated around them so that
+/// filtering doesn't bleed in their neighbours
+///
+/// The copy is made once, so textures whose contents change after they have been packed need
+/// to be invalidated or excluded (ex: render targets)
+/// </summary>
+class TextureAtlas {
+public:
+	typedef std::shared_ptr<TextureAtlas> Sptr;
+
+	/// <summary>
+	/// Where a texture ended up in the atlas
+	/// </summary>
+	struct Region {
+		Texture2D::Sptr Page;
+		// Maps the texture's 0-1 UVs to the page, uv * UvScale + UvOffset
+		glm::vec2       UvOffset = glm::vec2(0.0f);
+		glm::vec2       UvScale  = glm::vec2(1.0f);
+
+		glm::vec2 ToPage(const glm::vec2& uv) const { return UvOffset + uv * UvScale; }
+	};
+
+	/// <summary>
+	/// Creates a new atlas, pages are only created once something is packed into them
+	/// </summary>
+	/// <param name="pageSize">The width and height of the pages, rounded up to a power of two</param>
+	/// <param name="maxPages">The most pages to create, once they are full textures will not be atlased</param>
+	TextureAtlas(int pageSize = 2048, int maxPages = 4);
+	~TextureAtlas() = default;
+
+	/// <summary>
+	/// Gets the region of the atlas holding a texture, packing it in if it is not there yet
+	/// </summary>
+	/// <param name="texture">The texture to look up</param>
+	/// <param name="coverage">True if the texture is a single channel mask (ex: a font atlas), it will be packed as white with the mask in alpha</param>
+	/// <returns>The region, or nullptr if the texture can't be atlased and should be drawn on it's own</returns>
+	const Region* Get(const Texture2D::Sptr& texture, bool coverage = false);
+
+	/// <summary>
+	/// Removes a texture from the atlas, it will be copied in again the next time it is requested.
+	/// Should be called after changing the contents of a texture that has been atlased
+	/// </summary>
+	void Invalidate(const Texture2D::Sptr& texture);
+	/// <summary>
+	/// Stops a texture from ever being atlased
+	/// </summary>
+	void Exclude(const Texture2D::Sptr& texture);
+	/// <summary>
+	/// Removes all textures and pages from the atlas
+	/// </summary>
+	void Clear();
+
+	size_t GetPageCount() const { return _pages.size(); }
+	size_t GetTextureCount() const;
+	/// <summary>
+	/// Gets the fraction of all pages that is in use, between 0 and 1
+	/// </summary>
+	float GetUsage() const;
+
+	/// <summary>
+	/// Returns true if a texture can be copied into an atlas with the given page size
+	/// </summary>
+	static bool CanAtlas(const Texture2D& texture, bool coverage, int pageSize);
+
+protected:
+	// How many pixels of each texture's edge are repeated around it
+	static constexpr int Padding = 2;
+
+	struct Page {
+		Texture2D::Sptr Texture;
+		AtlasAllocator  Allocator;
+		// Pages are filtered like the textures in them, so pixel art stays crisp
+		bool            Nearest;
+	};
+
+	struct Entry {
+		// Used to tell if the texture has been deleted, and another created at the same address
+		std::weak_ptr<Texture2D> Texture;
+		int                      PageIndex = -1;
+		AtlasAllocator::Tile     Tile;
+		Region                   Placement;
+		bool                     Coverage  = false;
+		bool                     Excluded  = false;
+	};
+
+	int _pageSize;
+	int _maxPages;
+	std::vector<Page> _pages;
+	std::unordered_map<const Texture2D*, Entry> _entries;
+
+	bool _Pack(const Texture2D::Sptr& texture, Entry& entry);
+	AtlasAllocator::Tile _AllocateTile(int size, bool nearest, int& pageIndex);
+	void _Release(Entry& entry);
+	void _ReleaseExpired();
+};
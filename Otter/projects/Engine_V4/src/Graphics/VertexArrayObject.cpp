@@ -8,7 +8,9 @@ VertexArrayObject::VertexArrayObject() :
 	_handle(0),
 	_vertexCount(0),
 	_elementCount(0),
-	_vertexBuffers(std::vector<VertexBufferBinding*>())
+	_vertexBuffers(std::vector<VertexBufferBinding*>()),
+	_bounds(AABB()),
+	_subMeshes(std::vector<SubMesh>())
 {
 	glCreateVertexArrays(1, &_handle);
 }
@@ -101,6 +103,32 @@ void VertexArrayObject::ReplaceVertexBuffer(VertexBufferBinding* binding, const
 
 }
 
+VertexArrayObject::VertexBufferBinding* VertexArrayObject::AddStreamedVertexBuffer(const std::vector<BufferAttribute>& attributes, bool instanced) {
+	VertexBufferBinding* binding = new VertexBufferBinding();
+	binding->Buffer = nullptr;
+	binding->Attributes = attributes;
+	binding->Instanced = instanced;
+	_vertexBuffers.push_back(binding);
+
+	// Each attribute gets it's own buffer binding point with a matching index (same as glVertexAttribPointer
+	// does), so that SetVertexBufferRange can point them at the data with the attribute's offset baked in
+	for (const BufferAttribute& attrib : attributes) {
+		glEnableVertexArrayAttrib(_handle, attrib.Slot);
+		glVertexArrayAttribFormat(_handle, attrib.Slot, attrib.Size, (GLenum)attrib.Type, attrib.Normalized, 0);
+		glVertexArrayAttribBinding(_handle, attrib.Slot, attrib.Slot);
+		glVertexArrayBindingDivisor(_handle, attrib.Slot, instanced ? 1 : 0);
+	}
+
+	return binding;
+}
+
+void VertexArrayObject::SetVertexBufferRange(VertexBufferBinding* binding, const StreamingBuffer::Allocation& vertices) {
+	LOG_ASSERT(binding != nullptr && binding->Buffer == nullptr, "Only streamed bindings can be pointed at a buffer range");
+	for (const BufferAttribute& attrib : binding->Attributes) {
+		glVertexArrayVertexBuffer(_handle, attrib.Slot, vertices.Buffer, (GLintptr)vertices.Offset + attrib.Offset, attrib.Stride);
+	}
+}
+
 void VertexArrayObject::Draw(DrawMode mode) {
 	Bind();
 	if (_indexBuffer == nullptr) {
@@ -128,6 +156,21 @@ void VertexArrayObject::DrawInstanced(uint32_t instanceCount, DrawMode mode /*=
 	
 }
 
+void VertexArrayObject::DrawRange(uint32_t count, DrawMode mode /*= DrawMode::TriangleList*/)
+{
+	Bind();
+	glDrawArrays((GLenum)mode, 0, count);
+	Unbind();
+}
+
+void VertexArrayObject::DrawIndexedRange(const StreamingBuffer::Allocation& indices, uint32_t offset, uint32_t count, IndexType type, DrawMode mode /*= DrawMode::TriangleList*/)
+{
+	glVertexArrayElementBuffer(_handle, indices.Buffer);
+	Bind();
+	glDrawElements((GLenum)mode, count, (GLenum)type, (void*)((size_t)indices.Offset + offset));
+	Unbind();
+}
+
 void VertexArrayObject::Bind() {
 	glBindVertexArray(_handle);
 }
@@ -173,10 +216,16 @@ VertexArrayObject::Sptr VertexArrayObject::Clone() const
 	}
 
 	for (const auto& binding : _vertexBuffers) {
-		result->AddVertexBuffer(binding->Buffer, binding->Attributes, binding->Instanced);
+		if (binding->Buffer != nullptr) {
+			result->AddVertexBuffer(binding->Buffer, binding->Attributes, binding->Instanced);
+		} else {
+			result->AddStreamedVertexBuffer(binding->Attributes, binding->Instanced);
+		}
 	}
 
 	result->SetVDecl(_vDecl);
+	result->SetBounds(_bounds);
+	result->SetSubMeshes(_subMeshes);
 
 	return result;
 }
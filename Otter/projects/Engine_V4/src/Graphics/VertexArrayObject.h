@@ -7,8 +7,10 @@
 
 #include "Graphics/Buffers/VertexBuffer.h"
 #include "Graphics/Buffers/IndexBuffer.h"
+#include "Graphics/Buffers/StreamingBuffer.h"
 #include "Graphics/GlEnums.h"
 #include "Graphics/IGraphicsResource.h"
+#include "Utils/AABB.h"
 
 /// <summary>
 /// This structure will represent the parameters passed to the glVertexAttribPointer commands
@@ -63,7 +65,19 @@ public:
 		return std::make_shared<VertexArrayObject>();
 	}
 
-	// Helper structure to store a buffer and the attributes
+	/// <summary>
+	/// Describes a range of the index buffer (or of the vertices if the VAO is not indexed)
+	/// that makes up one part of the mesh, such as an object or material group in an OBJ file
+	/// </summary>
+	struct SubMesh {
+		uint32_t IndexOffset;
+		uint32_t IndexCount;
+		// Object-space bounds of the vertices used by this range
+		AABB     Bounds;
+	};
+
+	// Helper structure to store a buffer and the attributes, the buffer will be null for
+	// streamed bindings (see AddStreamedVertexBuffer)
 	struct VertexBufferBinding {
 		const VertexBuffer::Sptr& GetBuffer() const { return Buffer; }
 		const std::vector<BufferAttribute>& GetAttributes() const { return Attributes; }
@@ -112,6 +126,21 @@ public:
 
 	void ReplaceVertexBuffer(VertexBufferBinding* binding, const VertexBuffer::Sptr& buffer);
 
+	/// <summary>
+	/// Adds a vertex buffer binding that isn't attached to any buffer yet, used for vertices that are
+	/// streamed to a different place every frame. Attach the data with SetVertexBufferRange, and draw
+	/// with DrawRange or DrawIndexedRange since the VAO will not know how many vertices there are
+	/// </summary>
+	/// <param name="attributes">A list of vertex attributes that will be fed by this binding</param>
+	/// <param name="instanced">True if the buffer should contain one set of data per instance, false for per vertex</param>
+	VertexBufferBinding* AddStreamedVertexBuffer(const std::vector<BufferAttribute>& attributes, bool instanced = false);
+	/// <summary>
+	/// Points a streamed binding's attributes at the data in a streaming buffer allocation
+	/// </summary>
+	/// <param name="binding">The binding, as returned by AddStreamedVertexBuffer</param>
+	/// <param name="vertices">The allocation containing the vertex data</param>
+	void SetVertexBufferRange(VertexBufferBinding* binding, const StreamingBuffer::Allocation& vertices);
+
 	/// <summary>
 	/// Gets the buffer binding that has an attribute with the given usage
 	/// We can use this for extracting info from a VBO at a later time
@@ -134,6 +163,24 @@ public:
 	/// <param name="mode">The primitive mode for rendering the mesh</param>
 	void DrawInstanced(uint32_t instanceCount, DrawMode mode = DrawMode::TriangleList);
 
+	/// <summary>
+	/// Renders the first count vertices of this VAO without indices, for VAOs whose vertex count
+	/// changes from frame to frame
+	/// </summary>
+	/// <param name="count">The number of vertices to render</param>
+	/// <param name="mode">The primitive mode for rendering the mesh</param>
+	void DrawRange(uint32_t count, DrawMode mode = DrawMode::TriangleList);
+	/// <summary>
+	/// Renders this VAO using indices from a streaming buffer allocation. Note that this replaces
+	/// the VAO's index buffer binding, so it should not be mixed with SetIndexBuffer
+	/// </summary>
+	/// <param name="indices">The allocation containing the indices</param>
+	/// <param name="offset">The offset in bytes from the start of the allocation to the first index</param>
+	/// <param name="count">The number of indices to render</param>
+	/// <param name="type">The type of the indices</param>
+	/// <param name="mode">The primitive mode for rendering the mesh</param>
+	void DrawIndexedRange(const StreamingBuffer::Allocation& indices, uint32_t offset, uint32_t count, IndexType type, DrawMode mode = DrawMode::TriangleList);
+
 	/// <summary>
 	/// Binds this VAO as the source of data for draw operations
 	/// </summary>
@@ -151,6 +198,24 @@ public:
 	void SetVDecl(const VertexDeclaration& vDecl);
 	const VertexDeclaration& GetVDecl();
 
+	/// <summary>
+	/// Sets the object-space bounds of the vertices in this VAO, used for culling
+	/// </summary>
+	void SetBounds(const AABB& bounds) { _bounds = bounds; }
+	/// <summary>
+	/// Gets the object-space bounds of this VAO, will be invalid if the bounds are not known
+	/// </summary>
+	const AABB& GetBounds() const { return _bounds; }
+
+	/// <summary>
+	/// Sets the list of sub-meshes that make up this VAO
+	/// </summary>
+	void SetSubMeshes(const std::vector<SubMesh>& subMeshes) { _subMeshes = subMeshes; }
+	/// <summary>
+	/// Gets the sub-meshes that make up this VAO, may be empty if the mesh was not split into parts
+	/// </summary>
+	const std::vector<SubMesh>& GetSubMeshes() const { return _subMeshes; }
+
 protected:
 	
 	// The index buffer bound to this VAO
@@ -165,6 +230,11 @@ protected:
 	uint32_t _vertexCount;
 	uint32_t _elementCount;
 
+	// The object-space bounds of the mesh, if known
+	AABB _bounds;
+	// The ranges of the mesh that make up separate parts, if any
+	std::vector<SubMesh> _subMeshes;
+
 	// The underlying OpenGL handle that this class is wrapping around
 	GLuint _handle;
 
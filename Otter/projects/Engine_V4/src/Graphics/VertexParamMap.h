@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <vector>
 #include <GLM/glm.hpp>
+#include <GLM/gtc/type_ptr.hpp>
 #include "Graphics/VertexArrayObject.h"
 
 /// <summary>
@@ -0,0 +1,83 @@
+#pragma once
+#include <cfloat>
+#include "GLM/glm.hpp"
+
+/// <summary>
+/// An axis aligned bounding box, stored as it's minimum and maximum corners
+///
+/// A default constructed box is empty (min > max), encapsulating points or other
+/// boxes will grow it to fit
+/// </summary>
+struct AABB {
+	glm::vec3 Min;
+	glm::vec3 Max;
+
+	AABB() :
+		Min(glm::vec3(FLT_MAX)), Max(glm::vec3(-FLT_MAX)) { }
+	AABB(const glm::vec3& min, const glm::vec3& max) :
+		Min(min), Max(max) { }
+
+	/// <summary>
+	/// Returns true if this box contains at least one point
+	/// </summary>
+	bool IsValid() const { return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z; }
+
+	glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+	glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+
+	/// <summary>
+	/// Gets the surface area of the box, used as a cost heuristic when building trees
+	/// </summary>
+	float GetSurfaceArea() const {
+		glm::vec3 size = Max - Min;
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	/// <summary>
+	/// Grows this box to contain the given point
+	/// </summary>
+	void Encapsulate(const glm::vec3& point) {
+		Min = glm::min(Min, point);
+		Max = glm::max(Max, point);
+	}
+	/// <summary>
+	/// Grows this box to contain the given box
+	/// </summary>
+	void Encapsulate(const AABB& other) {
+		Min = glm::min(Min, other.Min);
+		Max = glm::max(Max, other.Max);
+	}
+
+	/// <summary>
+	/// Returns true if the other box is entirely inside of this box
+	/// </summary>
+	bool Contains(const AABB& other) const {
+		return glm::all(glm::lessThanEqual(Min, other.Min)) && glm::all(glm::greaterThanEqual(Max, other.Max));
+	}
+
+	/// <summary>
+	/// Returns a copy of this box, grown by the given amount on all sides
+	/// </summary>
+	AABB Expanded(const glm::vec3& amount) const {
+		return AABB(Min - amount, Max + amount);
+	}
+
+	/// <summary>
+	/// Gets the box that contains this box after it has been transformed by an affine matrix. Rather
+	/// than transforming all 8 corners, we transform the center and use the absolute value of the
+	/// matrix to project the extents
+	/// </summary>
+	AABB Transformed(const glm::mat4& transform) const {
+		glm::vec3 center = glm::vec3(transform * glm::vec4(GetCenter(), 1.0f));
+		glm::mat3 absRot = glm::mat3(glm::abs(glm::vec3(transform[0])), glm::abs(glm::vec3(transform[1])), glm::abs(glm::vec3(transform[2])));
+		glm::vec3 extents = absRot * GetExtents();
+		return AABB(center - extents, center + extents);
+	}
+
+	/// <summary>
+	/// Returns the union of two boxes
+	/// </summary>
+	static AABB Union(const AABB& a, const AABB& b) {
+		return AABB(glm::min(a.Min, b.Min), glm::max(a.Max, b.Max));
+	}
+};
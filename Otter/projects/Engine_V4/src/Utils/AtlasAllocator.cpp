@@ -0,0 +1,125 @@
+#include "Utils/AtlasAllocator.h"
+
+#include <algorithm>
+
+#include "Logging.h"
+
+static int NextPowerOfTwo(int value) {
+	int result = 1;
+	while (result < value) {
+		result <<= 1;
+	}
+	return result;
+}
+
+AtlasAllocator::AtlasAllocator(int size, int minTileSize) :
+	_size(0),
+	_minTileSize(0),
+	_usedArea(0),
+	_freeBlocks(std::vector<std::vector<glm::ivec2>>())
+{
+	Reset(size, minTileSize);
+}
+
+void AtlasAllocator::Reset(int size, int minTileSize) {
+	LOG_ASSERT(size > 0 && minTileSize > 0, "Atlas and tile sizes must be > 0");
+	_size = NextPowerOfTwo(size);
+	_minTileSize = std::min(NextPowerOfTwo(minTileSize), _size);
+	Clear();
+}
+
+void AtlasAllocator::Clear() {
+	_freeBlocks.clear();
+	_freeBlocks.resize(_GetLevel(_minTileSize) + 1);
+	_freeBlocks[0].push_back(glm::ivec2(0));
+	_usedArea = 0;
+}
+
+int AtlasAllocator::GetTileSize(int size) const {
+	return glm::clamp(NextPowerOfTwo(size), _minTileSize, _size);
+}
+
+float AtlasAllocator::GetUsage() const {
+	return static_cast<float>(static_cast<double>(_usedArea) / (static_cast<double>(_size) * _size));
+}
+
+int AtlasAllocator::_GetLevel(int tileSize) const {
+	int level = 0;
+	while ((_size >> level) > tileSize) {
+		level++;
+	}
+	return level;
+}
+
+AtlasAllocator::Tile AtlasAllocator::Allocate(int size) {
+	Tile result;
+	result.Size = GetTileSize(size);
+	const int level = _GetLevel(result.Size);
+
+	// Find the smallest free block that our tile fits in
+	int source = level;
+	while (source >= 0 && _freeBlocks[source].empty()) {
+		source--;
+	}
+	if (source < 0) {
+		return Tile();
+	}
+
+	// Take the block closest to the top left, so that tiles stay packed together
+	std::vector<glm::ivec2>& blocks = _freeBlocks[source];
+	auto best = std::min_element(blocks.begin(), blocks.end(), [](const glm::ivec2& a, const glm::ivec2& b) {
+		return a.y != b.y ? a.y < b.y : a.x < b.x;
+	});
+	glm::ivec2 position = *best;
+	blocks.erase(best);
+
+	// Split it down to the size we want, keeping the top left quarter each time
+	for (int split = source + 1; split <= level; split++) {
+		const int half = _size >> split;
+		_freeBlocks[split].push_back(position + glm::ivec2(half, 0));
+		_freeBlocks[split].push_back(position + glm::ivec2(0, half));
+		_freeBlocks[split].push_back(position + glm::ivec2(half, half));
+	}
+
+	result.Position = position;
+	_usedArea += static_cast<uint64_t>(result.Size) * result.Size;
+	return result;
+}
+
+void AtlasAllocator::Free(const Tile& tile) {
+	if (!tile.IsValid()) {
+		return;
+	}
+	_usedArea -= static_cast<uint64_t>(tile.Size) * tile.Size;
+
+	glm::ivec2 position = tile.Position;
+	int level = _GetLevel(tile.Size);
+
+	// Merge with our siblings for as long as they're all free
+	while (level > 0) {
+		const int size = _size >> level;
+		const glm::ivec2 parent = position - glm::ivec2(position.x % (size * 2), position.y % (size * 2));
+		const glm::ivec2 siblings[4] = {
+			parent, parent + glm::ivec2(size, 0), parent + glm::ivec2(0, size), parent + glm::ivec2(size, size)
+		};
+
+		std::vector<glm::ivec2>& blocks = _freeBlocks[level];
+		int freeSiblings = 0;
+		for (const glm::ivec2& sibling : siblings) {
+			if (sibling == position || std::find(blocks.begin(), blocks.end(), sibling) != blocks.end()) {
+				freeSiblings++;
+			}
+		}
+		if (freeSiblings < 4) {
+			break;
+		}
+
+		blocks.erase(std::remove_if(blocks.begin(), blocks.end(), [&](const glm::ivec2& block) {
+			return block.x >= parent.x && block.x < parent.x + size * 2 && block.y >= parent.y && block.y < parent.y + size * 2;
+		}), blocks.end());
+		position = parent;
+		level--;
+	}
+
+	_freeBlocks[level].push_back(position);
+}
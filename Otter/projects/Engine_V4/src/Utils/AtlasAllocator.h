@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "GLM/glm.hpp"
+
+/// <summary>
+/// Hands out square, power of two sized tiles from a square atlas, by recursively splitting the
+/// atlas into quarters (a quadtree buddy allocator). Freed tiles are merged back together with
+/// their siblings, so the atlas doesn't fragment over time
+///
+/// This only tracks which parts of the atlas are in use, it doesn't own any textures
+/// </summary>
+class AtlasAllocator {
+public:
+	/// <summary>
+	/// A square region of the atlas, in pixels
+	/// </summary>
+	struct Tile {
+		glm::ivec2 Position = glm::ivec2(0);
+		int        Size     = 0;
+
+		bool IsValid() const { return Size > 0; }
+	};
+
+	/// <summary>
+	/// Creates a new allocator, both sizes are rounded up to a power of two
+	/// </summary>
+	/// <param name="size">The width and height of the atlas in pixels</param>
+	/// <param name="minTileSize">The smallest tile that can be allocated</param>
+	AtlasAllocator(int size = 4096, int minTileSize = 64);
+	~AtlasAllocator() = default;
+
+	/// <summary>
+	/// Resizes the atlas, freeing all of the tiles
+	/// </summary>
+	void Reset(int size, int minTileSize);
+	/// <summary>
+	/// Frees all of the tiles
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// Allocates a tile, the size will be rounded up to the next power of two that fits in the atlas
+	/// </summary>
+	/// <returns>The new tile, or an invalid tile if there was no room</returns>
+	Tile Allocate(int size);
+	/// <summary>
+	/// Returns a tile to the atlas, tiles must only be freed once
+	/// </summary>
+	void Free(const Tile& tile);
+
+	/// <summary>
+	/// Rounds a size to the tile size that Allocate would hand out
+	/// </summary>
+	int GetTileSize(int size) const;
+
+	int GetSize() const { return _size; }
+	int GetMinTileSize() const { return _minTileSize; }
+	/// <summary>
+	/// Gets the fraction of the atlas that is currently allocated, between 0 and 1
+	/// </summary>
+	float GetUsage() const;
+
+private:
+	int      _size;
+	int      _minTileSize;
+	uint64_t _usedArea;
+	// Free blocks for each level of the quadtree, level 0 is the whole atlas
+	std::vector<std::vector<glm::ivec2>> _freeBlocks;
+
+	int _GetLevel(int tileSize) const;
+};
@@ -0,0 +1,324 @@
+#include "Utils/BoundingVolumeHierarchy.h"
+
+#include <algorithm>
+#include "Logging.h"
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy() :
+	_nodes(std::vector<Node>()),
+	_root(NullNode),
+	_freeList(NullNode),
+	_proxyCount(0)
+{ }
+
+int BoundingVolumeHierarchy::CreateProxy(const AABB& bounds, void* userData) {
+	int proxyId = _AllocateNode();
+	Node& node = _nodes[proxyId];
+	node.Bounds = _Fatten(bounds);
+	node.UserData = userData;
+	node.Height = 0;
+	node.Stamp = 0;
+
+	_InsertLeaf(proxyId);
+	_proxyCount++;
+	return proxyId;
+}
+
+void BoundingVolumeHierarchy::DestroyProxy(int proxyId) {
+	LOG_ASSERT(IsValidProxy(proxyId), "Attempting to destroy an invalid proxy");
+	_RemoveLeaf(proxyId);
+	_FreeNode(proxyId);
+	_proxyCount--;
+}
+
+bool BoundingVolumeHierarchy::MoveProxy(int proxyId, const AABB& bounds) {
+	Node& node = _nodes[proxyId];
+
+	// If we're still inside our fat box, and the fat box isn't way too loose, we don't need to do anything
+	if (node.Bounds.Contains(bounds)) {
+		AABB fat = _Fatten(bounds);
+		glm::vec3 looseness = (node.Bounds.Max - node.Bounds.Min) - (fat.Max - fat.Min) * 2.0f;
+		if (!glm::any(glm::greaterThan(looseness, glm::vec3(0.0f)))) {
+			return false;
+		}
+	}
+
+	_RemoveLeaf(proxyId);
+	_nodes[proxyId].Bounds = _Fatten(bounds);
+	_InsertLeaf(proxyId);
+	return true;
+}
+
+bool BoundingVolumeHierarchy::IsValidProxy(int proxyId) const {
+	return proxyId >= 0 && proxyId < (int)_nodes.size() && _nodes[proxyId].Height == 0;
+}
+
+int BoundingVolumeHierarchy::DestroyUnstamped(uint32_t stamp, const std::function<void(const AABB& bounds)>& onDestroy) {
+	int removed = 0;
+	for (int ix = 0; ix < (int)_nodes.size(); ix++) {
+		if (_nodes[ix].Height == 0 && _nodes[ix].Stamp != stamp) {
+			if (onDestroy) {
+				onDestroy(_nodes[ix].Bounds);
+			}
+			DestroyProxy(ix);
+			removed++;
+		}
+	}
+	return removed;
+}
+
+void BoundingVolumeHierarchy::Clear() {
+	_nodes.clear();
+	_root = NullNode;
+	_freeList = NullNode;
+	_proxyCount = 0;
+}
+
+int BoundingVolumeHierarchy::_AllocateNode() {
+	int nodeId;
+	if (_freeList != NullNode) {
+		nodeId = _freeList;
+		_freeList = _nodes[nodeId].Parent;
+	} else {
+		nodeId = static_cast<int>(_nodes.size());
+		_nodes.emplace_back();
+	}
+
+	Node& node = _nodes[nodeId];
+	node.Parent = NullNode;
+	node.Child1 = NullNode;
+	node.Child2 = NullNode;
+	node.Height = 0;
+	node.UserData = nullptr;
+	node.Stamp = 0;
+	return nodeId;
+}
+
+void BoundingVolumeHierarchy::_FreeNode(int nodeId) {
+	_nodes[nodeId].Parent = _freeList;
+	_nodes[nodeId].Height = -1;
+	_nodes[nodeId].UserData = nullptr;
+	_freeList = nodeId;
+}
+
+AABB BoundingVolumeHierarchy::_Fatten(const AABB& bounds) {
+	// Grow by a fixed amount plus a fraction of the object's size, so that both small and
+	// large objects get some room to move around
+	return bounds.Expanded(glm::vec3(0.1f) + (bounds.Max - bounds.Min) * 0.1f);
+}
+
+void BoundingVolumeHierarchy::_InsertLeaf(int leaf) {
+	if (_root == NullNode) {
+		_root = leaf;
+		_nodes[_root].Parent = NullNode;
+		return;
+	}
+
+	// Find the best sibling for the new leaf, by walking down the tree and picking the
+	// child that would increase the total surface area the least
+	const AABB leafBounds = _nodes[leaf].Bounds;
+	int index = _root;
+	while (!_nodes[index].IsLeaf()) {
+		const Node& node = _nodes[index];
+		const float area = node.Bounds.GetSurfaceArea();
+		const float combinedArea = AABB::Union(node.Bounds, leafBounds).GetSurfaceArea();
+
+		// Cost of making a new parent for this node and the new leaf
+		const float cost = 2.0f * combinedArea;
+		// Minimum cost of pushing the leaf further down the tree
+		const float inheritanceCost = 2.0f * (combinedArea - area);
+
+		auto childCost = [&](int child) {
+			AABB combined = AABB::Union(leafBounds, _nodes[child].Bounds);
+			if (_nodes[child].IsLeaf()) {
+				return combined.GetSurfaceArea() + inheritanceCost;
+			}
+			return (combined.GetSurfaceArea() - _nodes[child].Bounds.GetSurfaceArea()) + inheritanceCost;
+		};
+		const float cost1 = childCost(node.Child1);
+		const float cost2 = childCost(node.Child2);
+
+		if (cost < cost1 && cost < cost2) {
+			break;
+		}
+		index = cost1 < cost2 ? node.Child1 : node.Child2;
+	}
+	const int sibling = index;
+
+	// Create a new parent for the sibling and the leaf
+	const int oldParent = _nodes[sibling].Parent;
+	const int newParent = _AllocateNode();
+	_nodes[newParent].Parent = oldParent;
+	_nodes[newParent].Bounds = AABB::Union(leafBounds, _nodes[sibling].Bounds);
+	_nodes[newParent].Height = _nodes[sibling].Height + 1;
+	_nodes[newParent].Child1 = sibling;
+	_nodes[newParent].Child2 = leaf;
+	_nodes[sibling].Parent = newParent;
+	_nodes[leaf].Parent = newParent;
+
+	if (oldParent != NullNode) {
+		if (_nodes[oldParent].Child1 == sibling) {
+			_nodes[oldParent].Child1 = newParent;
+		} else {
+			_nodes[oldParent].Child2 = newParent;
+		}
+	} else {
+		_root = newParent;
+	}
+
+	// Walk back up the tree fixing heights and bounds
+	index = _nodes[leaf].Parent;
+	while (index != NullNode) {
+		index = _Balance(index);
+
+		const int child1 = _nodes[index].Child1;
+		const int child2 = _nodes[index].Child2;
+		_nodes[index].Height = 1 + std::max(_nodes[child1].Height, _nodes[child2].Height);
+		_nodes[index].Bounds = AABB::Union(_nodes[child1].Bounds, _nodes[child2].Bounds);
+
+		index = _nodes[index].Parent;
+	}
+}
+
+void BoundingVolumeHierarchy::_RemoveLeaf(int leaf) {
+	if (leaf == _root) {
+		_root = NullNode;
+		return;
+	}
+
+	const int parent = _nodes[leaf].Parent;
+	const int grandParent = _nodes[parent].Parent;
+	const int sibling = _nodes[parent].Child1 == leaf ? _nodes[parent].Child2 : _nodes[parent].Child1;
+
+	if (grandParent != NullNode) {
+		// Destroy the parent and connect the sibling to the grand parent
+		if (_nodes[grandParent].Child1 == parent) {
+			_nodes[grandParent].Child1 = sibling;
+		} else {
+			_nodes[grandParent].Child2 = sibling;
+		}
+		_nodes[sibling].Parent = grandParent;
+		_FreeNode(parent);
+
+		// Adjust the ancestor bounds
+		int index = grandParent;
+		while (index != NullNode) {
+			index = _Balance(index);
+
+			const int child1 = _nodes[index].Child1;
+			const int child2 = _nodes[index].Child2;
+			_nodes[index].Bounds = AABB::Union(_nodes[child1].Bounds, _nodes[child2].Bounds);
+			_nodes[index].Height = 1 + std::max(_nodes[child1].Height, _nodes[child2].Height);
+
+			index = _nodes[index].Parent;
+		}
+	} else {
+		_root = sibling;
+		_nodes[sibling].Parent = NullNode;
+		_FreeNode(parent);
+	}
+}
+
+int BoundingVolumeHierarchy::_Balance(int iA) {
+	// Performs a left or right rotation if node A is imbalanced, returns the new root of the subtree
+	Node& A = _nodes[iA];
+	if (A.IsLeaf() || A.Height < 2) {
+		return iA;
+	}
+
+	const int iB = A.Child1;
+	const int iC = A.Child2;
+	Node& B = _nodes[iB];
+	Node& C = _nodes[iC];
+
+	const int balance = C.Height - B.Height;
+
+	// Rotate C up
+	if (balance > 1) {
+		const int iF = C.Child1;
+		const int iG = C.Child2;
+		Node& F = _nodes[iF];
+		Node& G = _nodes[iG];
+
+		// Swap A and C
+		C.Child1 = iA;
+		C.Parent = A.Parent;
+		A.Parent = iC;
+
+		// A's old parent should point to C
+		if (C.Parent != NullNode) {
+			if (_nodes[C.Parent].Child1 == iA) {
+				_nodes[C.Parent].Child1 = iC;
+			} else {
+				_nodes[C.Parent].Child2 = iC;
+			}
+		} else {
+			_root = iC;
+		}
+
+		// Rotate
+		if (F.Height > G.Height) {
+			C.Child2 = iF;
+			A.Child2 = iG;
+			G.Parent = iA;
+			A.Bounds = AABB::Union(B.Bounds, G.Bounds);
+			C.Bounds = AABB::Union(A.Bounds, F.Bounds);
+			A.Height = 1 + std::max(B.Height, G.Height);
+			C.Height = 1 + std::max(A.Height, F.Height);
+		} else {
+			C.Child2 = iG;
+			A.Child2 = iF;
+			F.Parent = iA;
+			A.Bounds = AABB::Union(B.Bounds, F.Bounds);
+			C.Bounds = AABB::Union(A.Bounds, G.Bounds);
+			A.Height = 1 + std::max(B.Height, F.Height);
+			C.Height = 1 + std::max(A.Height, G.Height);
+		}
+		return iC;
+	}
+
+	// Rotate B up
+	if (balance < -1) {
+		const int iD = B.Child1;
+		const int iE = B.Child2;
+		Node& D = _nodes[iD];
+		Node& E = _nodes[iE];
+
+		// Swap A and B
+		B.Child1 = iA;
+		B.Parent = A.Parent;
+		A.Parent = iB;
+
+		// A's old parent should point to B
+		if (B.Parent != NullNode) {
+			if (_nodes[B.Parent].Child1 == iA) {
+				_nodes[B.Parent].Child1 = iB;
+			} else {
+				_nodes[B.Parent].Child2 = iB;
+			}
+		} else {
+			_root = iB;
+		}
+
+		// Rotate
+		if (D.Height > E.Height) {
+			B.Child2 = iD;
+			A.Child1 = iE;
+			E.Parent = iA;
+			A.Bounds = AABB::Union(C.Bounds, E.Bounds);
+			B.Bounds = AABB::Union(A.Bounds, D.Bounds);
+			A.Height = 1 + std::max(C.Height, E.Height);
+			B.Height = 1 + std::max(A.Height, D.Height);
+		} else {
+			B.Child2 = iE;
+			A.Child1 = iD;
+			D.Parent = iA;
+			A.Bounds = AABB::Union(C.Bounds, D.Bounds);
+			B.Bounds = AABB::Union(A.Bounds, E.Bounds);
+			A.Height = 1 + std::max(C.Height, D.Height);
+			B.Height = 1 + std::max(A.Height, E.Height);
+		}
+		return iB;
+	}
+
+	return iA;
+}
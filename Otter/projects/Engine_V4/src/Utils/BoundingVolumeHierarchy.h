@@ -0,0 +1,158 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+#include "Utils/AABB.h"
+#include "Utils/Frustum.h"
+
+/// <summary>
+/// A dynamic bounding volume hierarchy (binary AABB tree) for spatial queries
+///
+/// Each proxy is stored with a slightly enlarged ("fat") box, so that objects that move a
+/// little don't need the tree to change at all. When an object leaves it's fat box, only
+/// that leaf is removed and re-inserted, and the tree is rebalanced along the way. This
+/// keeps updates incremental instead of rebuilding the whole tree every frame
+/// </summary>
+class BoundingVolumeHierarchy {
+public:
+	static constexpr int NullNode = -1;
+
+	BoundingVolumeHierarchy();
+	~BoundingVolumeHierarchy() = default;
+
+	/// <summary>
+	/// Creates a new proxy with the given bounds, returning it's ID
+	/// </summary>
+	/// <param name="bounds">The tight bounds of the object</param>
+	/// <param name="userData">The data to return from queries</param>
+	int CreateProxy(const AABB& bounds, void* userData);
+	/// <summary>
+	/// Removes a proxy from the tree, the ID may be re-used after this
+	/// </summary>
+	void DestroyProxy(int proxyId);
+	/// <summary>
+	/// Updates the bounds of a proxy, the tree will only be modified if the bounds have
+	/// moved outside of the proxy's fat bounds
+	/// </summary>
+	/// <returns>True if the proxy was re-inserted</returns>
+	bool MoveProxy(int proxyId, const AABB& bounds);
+
+	/// <summary>
+	/// Returns true if the ID refers to a live proxy
+	/// </summary>
+	bool IsValidProxy(int proxyId) const;
+	/// <summary>
+	/// Gets the user data for a proxy
+	/// </summary>
+	void* GetUserData(int proxyId) const { return _nodes[proxyId].UserData; }
+	/// <summary>
+	/// Gets the fat bounds stored for a proxy
+	/// </summary>
+	const AABB& GetFatBounds(int proxyId) const { return _nodes[proxyId].Bounds; }
+
+	/// <summary>
+	/// Stamps a proxy with a value, used by callers to track which proxies are still alive
+	/// </summary>
+	void SetStamp(int proxyId, uint32_t stamp) { _nodes[proxyId].Stamp = stamp; }
+	/// <summary>
+	/// Destroys all proxies who's stamp does not match the given value
+	/// </summary>
+	/// <param name="stamp">The stamp that proxies need to keep</param>
+	/// <param name="onDestroy">Optional callback with the fat bounds of each proxy, invoked before it is removed</param>
+	/// <returns>The number of proxies that were removed</returns>
+	int DestroyUnstamped(uint32_t stamp, const std::function<void(const AABB& bounds)>& onDestroy = nullptr);
+
+	/// <summary>
+	/// Removes all proxies from the tree
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// Gets the number of live proxies in the tree
+	/// </summary>
+	int GetProxyCount() const { return _proxyCount; }
+	/// <summary>
+	/// Gets the height of the tree, for debugging
+	/// </summary>
+	int GetHeight() const { return _root == NullNode ? 0 : _nodes[_root].Height; }
+
+	/// <summary>
+	/// Invokes the callback with the user data of every proxy who's bounds intersect the frustum.
+	/// Subtrees that are entirely inside the frustum are accepted without testing their children
+	/// </summary>
+	/// <typeparam name="Func">A callable that takes a void* user data</typeparam>
+	template <typename Func>
+	void Query(const Frustum& frustum, Func&& callback) const {
+		if (_root == NullNode) {
+			return;
+		}
+		_stack.clear();
+		_stack.push_back(_root);
+		while (!_stack.empty()) {
+			int nodeId = _stack.back();
+			_stack.pop_back();
+
+			const Node& node = _nodes[nodeId];
+			FrustumTest result = frustum.Test(node.Bounds);
+			if (result == FrustumTest::Outside) {
+				continue;
+			}
+			if (node.IsLeaf()) {
+				callback(node.UserData);
+			} else if (result == FrustumTest::Inside) {
+				_CollectLeaves(nodeId, callback);
+			} else {
+				_stack.push_back(node.Child1);
+				_stack.push_back(node.Child2);
+			}
+		}
+	}
+
+private:
+	struct Node {
+		AABB     Bounds;
+		void*    UserData;
+		// The parent node, or the next free node when this node is unused
+		int      Parent;
+		int      Child1;
+		int      Child2;
+		// Leaves have a height of 0, free nodes have a height of -1
+		int      Height;
+		uint32_t Stamp;
+
+		bool IsLeaf() const { return Child1 == NullNode; }
+	};
+
+	std::vector<Node> _nodes;
+	int _root;
+	int _freeList;
+	int _proxyCount;
+
+	// Scratch space for traversals, so queries don't allocate
+	mutable std::vector<int> _stack;
+	mutable std::vector<int> _leafStack;
+
+	int  _AllocateNode();
+	void _FreeNode(int nodeId);
+	void _InsertLeaf(int leaf);
+	void _RemoveLeaf(int leaf);
+	int  _Balance(int nodeId);
+	static AABB _Fatten(const AABB& bounds);
+
+	template <typename Func>
+	void _CollectLeaves(int nodeId, Func& callback) const {
+		_leafStack.clear();
+		_leafStack.push_back(nodeId);
+		while (!_leafStack.empty()) {
+			const Node& node = _nodes[_leafStack.back()];
+			_leafStack.pop_back();
+			if (node.IsLeaf()) {
+				callback(node.UserData);
+			} else {
+				_leafStack.push_back(node.Child1);
+				_leafStack.push_back(node.Child2);
+			}
+		}
+	}
+};
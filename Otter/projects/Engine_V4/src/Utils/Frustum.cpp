@@ -0,0 +1,99 @@
+#include "Utils/Frustum.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUSTUM_USE_SSE
+#include <emmintrin.h>
+#endif
+
+Frustum::Frustum() {
+	for (int ix = 0; ix < PaddedPlaneCount; ix++) {
+		_planeX[ix] = 0.0f;
+		_planeY[ix] = 0.0f;
+		_planeZ[ix] = 0.0f;
+		_planeW[ix] = 0.0f;
+	}
+}
+
+Frustum Frustum::FromViewProjection(const glm::mat4& viewProjection) {
+	// GLM matrices are column major, so grab the rows to do the Gribb-Hartmann extraction
+	const glm::vec4 row0 = glm::vec4(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+	const glm::vec4 row1 = glm::vec4(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+	const glm::vec4 row2 = glm::vec4(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+	const glm::vec4 row3 = glm::vec4(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+	const glm::vec4 planes[6] = {
+		row3 + row0, // Left
+		row3 - row0, // Right
+		row3 + row1, // Bottom
+		row3 - row1, // Top
+		row3 + row2, // Near
+		row3 - row2  // Far
+	};
+
+	Frustum result;
+	for (int ix = 0; ix < PaddedPlaneCount; ix++) {
+		// Normalize so that plane distances are in world units
+		glm::vec4 plane = planes[ix % 6];
+		plane /= glm::length(glm::vec3(plane));
+
+		result._planeX[ix] = plane.x;
+		result._planeY[ix] = plane.y;
+		result._planeZ[ix] = plane.z;
+		result._planeW[ix] = plane.w;
+	}
+	return result;
+}
+
+glm::vec4 Frustum::GetPlane(int index) const {
+	return glm::vec4(_planeX[index], _planeY[index], _planeZ[index], _planeW[index]);
+}
+
+FrustumTest Frustum::Test(const AABB& box) const {
+	const glm::vec3 center = box.GetCenter();
+	const glm::vec3 extents = box.GetExtents();
+
+	// For each plane, d is the signed distance from the box's center, and r is the projected
+	// radius of the box onto the plane's normal. If d + r < 0 the box is entirely behind the
+	// plane, if d - r < 0 the box straddles it
+#ifdef FRUSTUM_USE_SSE
+	const __m128 cx = _mm_set1_ps(center.x);
+	const __m128 cy = _mm_set1_ps(center.y);
+	const __m128 cz = _mm_set1_ps(center.z);
+	const __m128 ex = _mm_set1_ps(extents.x);
+	const __m128 ey = _mm_set1_ps(extents.y);
+	const __m128 ez = _mm_set1_ps(extents.z);
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+	const __m128 zero = _mm_setzero_ps();
+
+	int intersecting = 0;
+	for (int ix = 0; ix < PaddedPlaneCount; ix += 4) {
+		const __m128 px = _mm_load_ps(_planeX + ix);
+		const __m128 py = _mm_load_ps(_planeY + ix);
+		const __m128 pz = _mm_load_ps(_planeZ + ix);
+		const __m128 pw = _mm_load_ps(_planeW + ix);
+
+		__m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, cx), _mm_mul_ps(py, cy)), _mm_add_ps(_mm_mul_ps(pz, cz), pw));
+		__m128 r = _mm_add_ps(_mm_add_ps(
+			_mm_mul_ps(_mm_and_ps(px, absMask), ex),
+			_mm_mul_ps(_mm_and_ps(py, absMask), ey)),
+			_mm_mul_ps(_mm_and_ps(pz, absMask), ez));
+
+		if (_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(d, r), zero)) != 0) {
+			return FrustumTest::Outside;
+		}
+		intersecting |= _mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(d, r), zero));
+	}
+	return intersecting != 0 ? FrustumTest::Intersects : FrustumTest::Inside;
+#else
+	bool intersecting = false;
+	for (int ix = 0; ix < 6; ix++) {
+		float d = _planeX[ix] * center.x + _planeY[ix] * center.y + _planeZ[ix] * center.z + _planeW[ix];
+		float r = glm::abs(_planeX[ix]) * extents.x + glm::abs(_planeY[ix]) * extents.y + glm::abs(_planeZ[ix]) * extents.z;
+		if (d + r < 0.0f) {
+			return FrustumTest::Outside;
+		}
+		intersecting |= d - r < 0.0f;
+	}
+	return intersecting ? FrustumTest::Intersects : FrustumTest::Inside;
+#endif
+}
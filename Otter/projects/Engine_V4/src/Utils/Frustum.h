@@ -0,0 +1,52 @@
+#pragma once
+#include "GLM/glm.hpp"
+#include "Utils/AABB.h"
+
+/// <summary>
+/// The result of testing a volume against a frustum
+/// </summary>
+enum class FrustumTest {
+	Outside,
+	Intersects,
+	Inside
+};
+
+/// <summary>
+/// Represents a view frustum as 6 inward-facing planes, extracted from a view-projection matrix
+///
+/// The planes are stored in structure-of-arrays form, so that a box can be tested against
+/// 4 planes at a time using SSE
+/// </summary>
+class Frustum {
+public:
+	Frustum();
+
+	/// <summary>
+	/// Extracts the frustum planes from a view-projection matrix (OpenGL clip space conventions)
+	/// </summary>
+	/// <param name="viewProjection">The combined projection * view matrix</param>
+	static Frustum FromViewProjection(const glm::mat4& viewProjection);
+
+	/// <summary>
+	/// Tests whether a box is outside, intersecting, or entirely inside the frustum
+	/// </summary>
+	FrustumTest Test(const AABB& box) const;
+	/// <summary>
+	/// Returns true if any part of the box may be inside the frustum
+	/// </summary>
+	bool Intersects(const AABB& box) const { return Test(box) != FrustumTest::Outside; }
+
+	/// <summary>
+	/// Gets one of the 6 planes (left, right, bottom, top, near, far) as (normal, distance)
+	/// </summary>
+	glm::vec4 GetPlane(int index) const;
+
+private:
+	// We pad to 8 planes so we can do 2 full SIMD iterations, the padding planes are
+	// copies of real planes so they don't affect the results
+	static constexpr int PaddedPlaneCount = 8;
+	alignas(16) float _planeX[PaddedPlaneCount];
+	alignas(16) float _planeY[PaddedPlaneCount];
+	alignas(16) float _planeZ[PaddedPlaneCount];
+	alignas(16) float _planeW[PaddedPlaneCount];
+};
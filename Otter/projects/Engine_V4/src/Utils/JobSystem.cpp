@@ -0,0 +1,253 @@
+#include "Utils/JobSystem.h"
+
+#include <algorithm>
+
+#include "Logging.h"
+
+std::vector<std::unique_ptr<JobSystem::WorkDeque>> JobSystem::_deques;
+std::vector<std::thread> JobSystem::_workers;
+std::deque<JobSystem::JobEntry*> JobSystem::_sharedQueue;
+std::mutex JobSystem::_sharedMutex;
+std::atomic<int> JobSystem::_queuedJobs = 0;
+std::mutex JobSystem::_sleepMutex;
+std::condition_variable JobSystem::_sleepCondition;
+std::atomic_bool JobSystem::_running = false;
+
+// Which deque belongs to the current thread, -1 if it doesn't have one
+static thread_local int CurrentThreadIndex = -1;
+
+JobSystem::WorkDeque::WorkDeque() :
+	_top(0),
+	_bottom(0),
+	_jobs(std::make_unique<std::atomic<JobEntry*>[]>(Capacity))
+{ }
+
+bool JobSystem::WorkDeque::Push(JobEntry* job) {
+	const int64_t bottom = _bottom.load(std::memory_order_relaxed);
+	const int64_t top = _top.load(std::memory_order_acquire);
+	if (bottom - top >= Capacity) {
+		return false;
+	}
+
+	_jobs[bottom & (Capacity - 1)].store(job, std::memory_order_relaxed);
+	// Release, so the job is visible to thieves by the time they see the new bottom
+	_bottom.store(bottom + 1, std::memory_order_release);
+	return true;
+}
+
+JobSystem::JobEntry* JobSystem::WorkDeque::Pop() {
+	const int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+	_bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t top = _top.load(std::memory_order_relaxed);
+
+	if (top > bottom) {
+		// Deque was already empty, put bottom back
+		_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	JobEntry* result = _jobs[bottom & (Capacity - 1)].load(std::memory_order_relaxed);
+	if (top == bottom) {
+		// This is the last job, so we need to race any thieves for it
+		if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			result = nullptr;
+		}
+		_bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+	return result;
+}
+
+JobSystem::JobEntry* JobSystem::WorkDeque::Steal() {
+	int64_t top = _top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	const int64_t bottom = _bottom.load(std::memory_order_acquire);
+
+	if (top >= bottom) {
+		return nullptr;
+	}
+
+	JobEntry* result = _jobs[top & (Capacity - 1)].load(std::memory_order_relaxed);
+	// If this fails, the owner or another thief got to it first
+	if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+		return nullptr;
+	}
+	return result;
+}
+
+void JobSystem::Init(int workerCount) {
+	if (_running) {
+		LOG_WARN("Job system has already been started");
+		return;
+	}
+
+	if (workerCount < 0) {
+		workerCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency())) - 1;
+	}
+
+	_deques.clear();
+	for (int ix = 0; ix <= workerCount; ix++) {
+		_deques.push_back(std::make_unique<WorkDeque>());
+	}
+
+	CurrentThreadIndex = 0;
+	_running = true;
+	for (int ix = 1; ix <= workerCount; ix++) {
+		_workers.emplace_back(&JobSystem::_WorkerMain, ix);
+	}
+
+	LOG_INFO("Started job system with {} workers", workerCount);
+}
+
+void JobSystem::Cleanup() {
+	if (!_running) {
+		return;
+	}
+
+	// Workers drain the queues before they exit
+	{
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+		_running = false;
+	}
+	_sleepCondition.notify_all();
+	for (std::thread& worker : _workers) {
+		worker.join();
+	}
+	_workers.clear();
+
+	// Anything left over was queued by the main thread, so only we can get at it
+	while (JobEntry* job = _FindJob(0)) {
+		_Execute(job);
+	}
+	_deques.clear();
+	CurrentThreadIndex = -1;
+}
+
+int JobSystem::GetThreadIndex() {
+	return CurrentThreadIndex;
+}
+
+void JobSystem::Run(Job job, Counter* counter) {
+	if (!_running) {
+		job();
+		return;
+	}
+
+	if (counter != nullptr) {
+		counter->Pending.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	JobEntry* entry = new JobEntry{ std::move(job), counter };
+	const int threadIndex = CurrentThreadIndex;
+	if (threadIndex < 0 || !_deques[threadIndex]->Push(entry)) {
+		std::lock_guard<std::mutex> lock(_sharedMutex);
+		_sharedQueue.push_back(entry);
+	}
+
+	// Taking the lock means a worker can't miss the wakeup between checking the count and sleeping
+	_queuedJobs.fetch_add(1, std::memory_order_release);
+	{
+		std::lock_guard<std::mutex> lock(_sleepMutex);
+	}
+	_sleepCondition.notify_one();
+}
+
+void JobSystem::Wait(const Counter& counter) {
+	while (!counter.IsDone()) {
+		if (!TryRunOne()) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+bool JobSystem::TryRunOne() {
+	if (!_running) {
+		return false;
+	}
+
+	JobEntry* job = _FindJob(CurrentThreadIndex);
+	if (job != nullptr) {
+		_Execute(job);
+		return true;
+	}
+	return false;
+}
+
+void JobSystem::ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& func) {
+	if (count == 0) {
+		return;
+	}
+
+	// A few chunks per thread, so that threads that finish early can steal the leftovers
+	const size_t threads = static_cast<size_t>(GetWorkerCount()) + 1;
+	const size_t chunks = std::max<size_t>(1, std::min((count + grainSize - 1) / std::max<size_t>(grainSize, 1), threads * 4));
+	const size_t chunkSize = (count + chunks - 1) / chunks;
+
+	Counter counter;
+	for (size_t begin = chunkSize; begin < count; begin += chunkSize) {
+		const size_t end = std::min(begin + chunkSize, count);
+		Run([&func, begin, end]() { func(begin, end); }, &counter);
+	}
+
+	// The first chunk is done on this thread
+	func(0, std::min(chunkSize, count));
+	Wait(counter);
+}
+
+void JobSystem::_WorkerMain(int threadIndex) {
+	CurrentThreadIndex = threadIndex;
+
+	while (true) {
+		JobEntry* job = _FindJob(threadIndex);
+		if (job != nullptr) {
+			_Execute(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(_sleepMutex);
+		_sleepCondition.wait(lock, []() { return _queuedJobs.load(std::memory_order_acquire) > 0 || !_running; });
+		if (!_running && _queuedJobs.load(std::memory_order_acquire) == 0) {
+			break;
+		}
+	}
+}
+
+JobSystem::JobEntry* JobSystem::_FindJob(int threadIndex) {
+	JobEntry* result = nullptr;
+
+	// Newest job from our own deque first, since it's data is most likely to still be in cache
+	if (threadIndex >= 0 && threadIndex < static_cast<int>(_deques.size())) {
+		result = _deques[threadIndex]->Pop();
+	}
+
+	// Then try stealing the oldest job from everyone else, starting with our neighbour so that
+	// thieves spread out
+	const int dequeCount = static_cast<int>(_deques.size());
+	for (int ix = 1; ix <= dequeCount && result == nullptr; ix++) {
+		const int victim = (std::max(threadIndex, 0) + ix) % dequeCount;
+		if (victim != threadIndex) {
+			result = _deques[victim]->Steal();
+		}
+	}
+
+	if (result == nullptr) {
+		std::lock_guard<std::mutex> lock(_sharedMutex);
+		if (!_sharedQueue.empty()) {
+			result = _sharedQueue.front();
+			_sharedQueue.pop_front();
+		}
+	}
+
+	if (result != nullptr) {
+		_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+	}
+	return result;
+}
+
+void JobSystem::_Execute(JobEntry* job) {
+	job->Func();
+	if (job->Tracker != nullptr) {
+		job->Tracker->Pending.fetch_sub(1, std::memory_order_release);
+	}
+	delete job;
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <condition_variable>
+
+/// <summary>
+/// A fixed pool of worker threads that run small jobs, with a work stealing deque per thread
+///
+/// Jobs pushed from the main thread or a worker go onto that thread's own deque, where the owner
+/// takes the newest job and idle threads steal the oldest. Jobs pushed from any other thread go
+/// through a shared queue. Waiting on a counter never blocks, the waiting thread keeps running
+/// jobs until the ones it's waiting on are done, so jobs can safely wait on jobs they spawn
+/// </summary>
+class JobSystem {
+public:
+	typedef std::function<void()> Job;
+
+	/// <summary>
+	/// Tracks a group of jobs, pass it to Run and then Wait on it to block until they are done
+	/// </summary>
+	struct Counter {
+		std::atomic<int> Pending = 0;
+		bool IsDone() const { return Pending.load(std::memory_order_acquire) == 0; }
+	};
+
+	/// <summary>
+	/// Starts the worker threads, should be called from the main thread
+	/// </summary>
+	/// <param name="workerCount">The number of workers to start, or -1 to use one per core besides the main thread</param>
+	static void Init(int workerCount = -1);
+	/// <summary>
+	/// Finishes any jobs that are still queued and stops the workers
+	/// </summary>
+	static void Cleanup();
+
+	static bool IsInitialized() { return _running.load(); }
+	/// <summary>
+	/// Gets the number of worker threads, not including the main thread
+	/// </summary>
+	static int GetWorkerCount() { return static_cast<int>(_workers.size()); }
+	/// <summary>
+	/// Gets the index of the calling thread, 0 for the main thread, 1 and up for workers, and -1
+	/// for any other thread
+	/// </summary>
+	static int GetThreadIndex();
+
+	/// <summary>
+	/// Queues a job to be run on any thread. If the job system has not been started, the job is
+	/// run immediately on the calling thread
+	/// </summary>
+	/// <param name="job">The job to run</param>
+	/// <param name="counter">An optional counter to track the job with, must outlive the job</param>
+	static void Run(Job job, Counter* counter = nullptr);
+	/// <summary>
+	/// Runs queued jobs on the calling thread until all the jobs tracked by the counter are done
+	/// </summary>
+	static void Wait(const Counter& counter);
+	/// <summary>
+	/// Runs a single queued job on the calling thread, if there are any
+	/// </summary>
+	/// <returns>True if a job was run</returns>
+	static bool TryRunOne();
+
+	/// <summary>
+	/// Splits a range into chunks and processes them across all threads, returns once every chunk is done
+	/// </summary>
+	/// <param name="count">The number of items to process</param>
+	/// <param name="grainSize">The minimum number of items in each chunk</param>
+	/// <param name="func">Invoked with the [begin, end) range of each chunk</param>
+	static void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t begin, size_t end)>& func);
+
+protected:
+	JobSystem() = default;
+
+	struct JobEntry {
+		Job      Func;
+		Counter* Tracker;
+	};
+
+	/// <summary>
+	/// A fixed size Chase-Lev deque. Only the owning thread may push and pop, any thread may steal
+	/// </summary>
+	class WorkDeque {
+	public:
+		static constexpr int64_t Capacity = 4096;
+
+		WorkDeque();
+
+		/// <summary>
+		/// Pushes a job onto the bottom of the deque
+		/// </summary>
+		/// <returns>False if the deque was full</returns>
+		bool Push(JobEntry* job);
+		/// <summary>
+		/// Takes the newest job from the bottom of the deque
+		/// </summary>
+		JobEntry* Pop();
+		/// <summary>
+		/// Takes the oldest job from the top of the deque
+		/// </summary>
+		JobEntry* Steal();
+
+	private:
+		alignas(64) std::atomic<int64_t> _top;
+		alignas(64) std::atomic<int64_t> _bottom;
+		std::unique_ptr<std::atomic<JobEntry*>[]> _jobs;
+	};
+
+	// One deque for the main thread (index 0), and one for each worker
+	static std::vector<std::unique_ptr<WorkDeque>> _deques;
+	static std::vector<std::thread>                _workers;
+
+	// Jobs pushed from threads that don't own a deque, or when their deque is full
+	static std::deque<JobEntry*> _sharedQueue;
+	static std::mutex            _sharedMutex;
+
+	// Idle workers sleep until there is something queued
+	static std::atomic<int>        _queuedJobs;
+	static std::mutex              _sleepMutex;
+	static std::condition_variable _sleepCondition;
+	static std::atomic_bool        _running;
+
+	static void _WorkerMain(int threadIndex);
+	static JobEntry* _FindJob(int threadIndex);
+	static void _Execute(JobEntry* job);
+};
@@ -0,0 +1,281 @@
+#include "Utils/LightClusterGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Utils/JobSystem.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LIGHT_CLUSTERS_USE_SSE
+#include <emmintrin.h>
+#endif
+
+LightClusterGrid::LightClusterGrid(const glm::uvec3& dimensions) :
+	_dimensions(glm::max(dimensions, glm::uvec3(1))),
+	_projection(glm::mat4(0.0f)),
+	_zNear(0.1f),
+	_zFar(100.0f),
+	_sliceScale(0.0f),
+	_sliceBias(0.0f),
+	_boundsDirty(true),
+	_clusterMin(std::vector<glm::vec3>()),
+	_clusterMax(std::vector<glm::vec3>()),
+	_slices(std::vector<SliceData>()),
+	_clusters(std::vector<ClusterRange>()),
+	_lightIndices(std::vector<uint32_t>()),
+	_maxLightsPerCluster(0)
+{ }
+
+void LightClusterGrid::SetDimensions(const glm::uvec3& dimensions) {
+	const glm::uvec3 value = glm::max(dimensions, glm::uvec3(1));
+	if (value != _dimensions) {
+		_dimensions = value;
+		_boundsDirty = true;
+	}
+}
+
+void LightClusterGrid::SetProjection(const glm::mat4& projection, float zNear, float zFar) {
+	if (projection != _projection || zNear != _zNear || zFar != _zFar) {
+		_projection = projection;
+		_zNear = zNear;
+		_zFar = zFar;
+		_boundsDirty = true;
+	}
+}
+
+uint32_t LightClusterGrid::GetSlice(float depth) const {
+	const float slice = std::log(std::max(depth, _zNear)) * _sliceScale + _sliceBias;
+	return std::min(static_cast<uint32_t>(std::max(slice, 0.0f)), _dimensions.z - 1);
+}
+
+void LightClusterGrid::Build(const LightBounds* lights, uint32_t count, bool parallel) {
+	if (_boundsDirty) {
+		_RebuildBounds();
+	}
+
+	_slices.resize(_dimensions.z);
+	if (parallel && JobSystem::IsInitialized()) {
+		JobSystem::ParallelFor(_dimensions.z, 1, [&](size_t begin, size_t end) {
+			for (size_t slice = begin; slice < end; slice++) {
+				_BinSlice(static_cast<uint32_t>(slice), lights, count);
+			}
+		});
+	} else {
+		for (uint32_t slice = 0; slice < _dimensions.z; slice++) {
+			_BinSlice(slice, lights, count);
+		}
+	}
+
+	// Stitch the slices together in order, so the results don't depend on how the work was split up
+	size_t indexCount = 0;
+	for (const SliceData& slice : _slices) {
+		indexCount += slice.Indices.size();
+	}
+
+	_clusters.resize(GetClusterCount());
+	_lightIndices.resize(indexCount);
+	_maxLightsPerCluster = 0;
+
+	uint32_t offset = 0;
+	uint32_t cluster = 0;
+	for (const SliceData& slice : _slices) {
+		for (const ClusterRange& range : slice.Clusters) {
+			_clusters[cluster].Offset = offset + range.Offset;
+			_clusters[cluster].Count = range.Count;
+			_maxLightsPerCluster = std::max(_maxLightsPerCluster, range.Count);
+			cluster++;
+		}
+		std::copy(slice.Indices.begin(), slice.Indices.end(), _lightIndices.begin() + offset);
+		offset += static_cast<uint32_t>(slice.Indices.size());
+	}
+}
+
+void LightClusterGrid::_RebuildBounds() {
+	_boundsDirty = false;
+
+	const float depthRatio = std::log(_zFar / _zNear);
+	_sliceScale = _dimensions.z / depthRatio;
+	_sliceBias = -(_dimensions.z * std::log(_zNear)) / depthRatio;
+
+	_clusterMin.resize(GetClusterCount());
+	_clusterMax.resize(GetClusterCount());
+
+	// Work out where the rays through the corners of each tile hit the near and far planes, this
+	// handles both perspective and orthographic projections
+	const glm::mat4 inverseProjection = glm::inverse(_projection);
+	auto unproject = [&](float x, float y, float z) {
+		glm::vec4 result = inverseProjection * glm::vec4(x, y, z, 1.0f);
+		return glm::vec3(result) / result.w;
+	};
+
+	const glm::uvec3& dims = _dimensions;
+	std::vector<glm::vec3> nearCorners((dims.x + 1) * (dims.y + 1));
+	std::vector<glm::vec3> farCorners((dims.x + 1) * (dims.y + 1));
+	for (uint32_t y = 0; y <= dims.y; y++) {
+		for (uint32_t x = 0; x <= dims.x; x++) {
+			const float ndcX = -1.0f + 2.0f * x / dims.x;
+			const float ndcY = -1.0f + 2.0f * y / dims.y;
+			nearCorners[x + y * (dims.x + 1)] = unproject(ndcX, ndcY, -1.0f);
+			farCorners[x + y * (dims.x + 1)] = unproject(ndcX, ndcY, 1.0f);
+		}
+	}
+
+	for (uint32_t z = 0; z < dims.z; z++) {
+		// Slices are spaced exponentially, so they look roughly the same size on screen
+		const float sliceNear = _zNear * std::pow(_zFar / _zNear, static_cast<float>(z) / dims.z);
+		const float sliceFar = _zNear * std::pow(_zFar / _zNear, static_cast<float>(z + 1) / dims.z);
+
+		for (uint32_t y = 0; y < dims.y; y++) {
+			for (uint32_t x = 0; x < dims.x; x++) {
+				glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+				glm::vec3 max = glm::vec3(std::numeric_limits<float>::lowest());
+
+				for (uint32_t corner = 0; corner < 4; corner++) {
+					const uint32_t ix = (x + (corner & 1)) + (y + (corner >> 1)) * (dims.x + 1);
+					const glm::vec3& nearPoint = nearCorners[ix];
+					const glm::vec3& farPoint = farCorners[ix];
+					const float rayLength = farPoint.z - nearPoint.z;
+
+					for (float depth : { sliceNear, sliceFar }) {
+						const float t = (-depth - nearPoint.z) / rayLength;
+						const glm::vec3 point = nearPoint + (farPoint - nearPoint) * t;
+						min = glm::min(min, point);
+						max = glm::max(max, point);
+					}
+				}
+
+				const uint32_t cluster = GetClusterIndex(x, y, z);
+				_clusterMin[cluster] = min;
+				_clusterMax[cluster] = max;
+			}
+		}
+	}
+}
+
+void LightClusterGrid::LightList::Clear() {
+	X.clear();
+	Y.clear();
+	Z.clear();
+	RadiusSq.clear();
+	Lights.clear();
+}
+
+void LightClusterGrid::LightList::Add(uint32_t light, const glm::vec3& position, float radiusSq) {
+	X.push_back(position.x);
+	Y.push_back(position.y);
+	Z.push_back(position.z);
+	RadiusSq.push_back(radiusSq);
+	Lights.push_back(light);
+}
+
+void LightClusterGrid::LightList::Pad() {
+	// A negative radius can never pass the test
+	while (X.size() % 4 != 0) {
+		X.push_back(0.0f);
+		Y.push_back(0.0f);
+		Z.push_back(0.0f);
+		RadiusSq.push_back(-1.0f);
+	}
+}
+
+template <typename Func>
+void LightClusterGrid::_ForEachLightInBox(const LightList& lights, const glm::vec3& min, const glm::vec3& max, Func onHit) {
+	// Sphere vs AABB, using the squared distance from the light to the closest point in the box
+#ifdef LIGHT_CLUSTERS_USE_SSE
+	const __m128 minX = _mm_set1_ps(min.x);
+	const __m128 minY = _mm_set1_ps(min.y);
+	const __m128 minZ = _mm_set1_ps(min.z);
+	const __m128 maxX = _mm_set1_ps(max.x);
+	const __m128 maxY = _mm_set1_ps(max.y);
+	const __m128 maxZ = _mm_set1_ps(max.z);
+	const __m128 zero = _mm_setzero_ps();
+
+	for (size_t ix = 0; ix < lights.X.size(); ix += 4) {
+		const __m128 x = _mm_loadu_ps(lights.X.data() + ix);
+		const __m128 y = _mm_loadu_ps(lights.Y.data() + ix);
+		const __m128 z = _mm_loadu_ps(lights.Z.data() + ix);
+		const __m128 radiusSq = _mm_loadu_ps(lights.RadiusSq.data() + ix);
+
+		const __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minX, x), _mm_sub_ps(x, maxX)), zero);
+		const __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minY, y), _mm_sub_ps(y, maxY)), zero);
+		const __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minZ, z), _mm_sub_ps(z, maxZ)), zero);
+		const __m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+		const int mask = _mm_movemask_ps(_mm_cmple_ps(distSq, radiusSq));
+		if (mask != 0) {
+			for (int lane = 0; lane < 4; lane++) {
+				if (mask & (1 << lane)) {
+					onHit(ix + lane);
+				}
+			}
+		}
+	}
+#else
+	for (size_t ix = 0; ix < lights.Lights.size(); ix++) {
+		const float dx = std::max(std::max(min.x - lights.X[ix], lights.X[ix] - max.x), 0.0f);
+		const float dy = std::max(std::max(min.y - lights.Y[ix], lights.Y[ix] - max.y), 0.0f);
+		const float dz = std::max(std::max(min.z - lights.Z[ix], lights.Z[ix] - max.z), 0.0f);
+		if (dx * dx + dy * dy + dz * dz <= lights.RadiusSq[ix]) {
+			onHit(ix);
+		}
+	}
+#endif
+}
+
+void LightClusterGrid::_BinSlice(uint32_t z, const LightBounds* lights, uint32_t count) {
+	SliceData& slice = _slices[z];
+	slice.SliceLights.Clear();
+	slice.Indices.clear();
+
+	const uint32_t firstCluster = GetClusterIndex(0, 0, z);
+	slice.Clusters.resize(_dimensions.x * _dimensions.y);
+
+	// Bounds of the whole slice, so we only test the lights that can touch it against each row
+	glm::vec3 sliceMin = _clusterMin[firstCluster];
+	glm::vec3 sliceMax = _clusterMax[firstCluster];
+	for (uint32_t tile = 1; tile < _dimensions.x * _dimensions.y; tile++) {
+		sliceMin = glm::min(sliceMin, _clusterMin[firstCluster + tile]);
+		sliceMax = glm::max(sliceMax, _clusterMax[firstCluster + tile]);
+	}
+
+	for (uint32_t ix = 0; ix < count; ix++) {
+		const LightBounds& light = lights[ix];
+		const glm::vec3 offset = glm::clamp(light.Position, sliceMin, sliceMax) - light.Position;
+		const float radiusSq = light.Radius * light.Radius;
+		if (glm::dot(offset, offset) <= radiusSq) {
+			slice.SliceLights.Add(ix, light.Position, radiusSq);
+		}
+	}
+	slice.SliceLights.Pad();
+
+	const LightList& sliceLights = slice.SliceLights;
+	LightList& rowLights = slice.RowLights;
+	for (uint32_t y = 0; y < _dimensions.y; y++) {
+		// Narrow the list down to a row of tiles first, most lights only cover a few rows
+		const uint32_t rowStart = GetClusterIndex(0, y, z);
+		glm::vec3 rowMin = _clusterMin[rowStart];
+		glm::vec3 rowMax = _clusterMax[rowStart];
+		for (uint32_t x = 1; x < _dimensions.x; x++) {
+			rowMin = glm::min(rowMin, _clusterMin[rowStart + x]);
+			rowMax = glm::max(rowMax, _clusterMax[rowStart + x]);
+		}
+
+		rowLights.Clear();
+		_ForEachLightInBox(sliceLights, rowMin, rowMax, [&](size_t ix) {
+			rowLights.Add(sliceLights.Lights[ix], glm::vec3(sliceLights.X[ix], sliceLights.Y[ix], sliceLights.Z[ix]), sliceLights.RadiusSq[ix]);
+		});
+		rowLights.Pad();
+
+		for (uint32_t x = 0; x < _dimensions.x; x++) {
+			const uint32_t start = static_cast<uint32_t>(slice.Indices.size());
+			_ForEachLightInBox(rowLights, _clusterMin[rowStart + x], _clusterMax[rowStart + x], [&](size_t ix) {
+				slice.Indices.push_back(rowLights.Lights[ix]);
+			});
+
+			ClusterRange& range = slice.Clusters[x + y * _dimensions.x];
+			range.Offset = start;
+			range.Count = static_cast<uint32_t>(slice.Indices.size()) - start;
+		}
+	}
+}
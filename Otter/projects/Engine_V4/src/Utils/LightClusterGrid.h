@@ -0,0 +1,131 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "GLM/glm.hpp"
+
+/// <summary>
+/// Splits the view frustum into a grid of clusters (froxels), with screen space tiles in X and Y
+/// and exponentially spaced depth slices in Z, and works out which lights touch each cluster.
+/// This lets a lighting shader only loop over the handful of lights that can affect a pixel,
+/// instead of every light in the scene
+///
+/// Binning is done on the CPU in view space, one depth slice per job, with lights tested 4 at a
+/// time against each cluster using SSE. There's no OpenGL in here, uploading the results is up to
+/// the caller
+/// </summary>
+class LightClusterGrid {
+public:
+	/// <summary>
+	/// A light's sphere of influence, in view space
+	/// </summary>
+	struct LightBounds {
+		glm::vec3 Position;
+		float     Radius;
+	};
+
+	/// <summary>
+	/// The lights for a single cluster, as a range in the light index list. Matches a uvec2 in std430
+	/// </summary>
+	struct ClusterRange {
+		uint32_t Offset;
+		uint32_t Count;
+	};
+
+	LightClusterGrid(const glm::uvec3& dimensions = glm::uvec3(16, 9, 24));
+	~LightClusterGrid() = default;
+
+	/// <summary>
+	/// Sets how many clusters the grid has along each axis, X and Y are screen tiles and Z is depth slices
+	/// </summary>
+	void SetDimensions(const glm::uvec3& dimensions);
+	const glm::uvec3& GetDimensions() const { return _dimensions; }
+	uint32_t GetClusterCount() const { return _dimensions.x * _dimensions.y * _dimensions.z; }
+
+	/// <summary>
+	/// Sets the projection that the grid covers, cluster bounds are only rebuilt if something changed
+	/// </summary>
+	/// <param name="projection">The camera's projection matrix</param>
+	/// <param name="zNear">The distance to the camera's near plane</param>
+	/// <param name="zFar">The distance to the camera's far plane</param>
+	void SetProjection(const glm::mat4& projection, float zNear, float zFar);
+
+	/// <summary>
+	/// Bins the given lights into the clusters, replacing the results of the last build
+	/// </summary>
+	/// <param name="lights">The view space bounds of every light, the index list refers to lights by their index in this array</param>
+	/// <param name="count">The number of lights</param>
+	/// <param name="parallel">True to spread the depth slices across the job system</param>
+	void Build(const LightBounds* lights, uint32_t count, bool parallel = true);
+	void Build(const std::vector<LightBounds>& lights, bool parallel = true) { Build(lights.data(), static_cast<uint32_t>(lights.size()), parallel); }
+
+	/// <summary>
+	/// Gets the index of the cluster at the given grid coordinates
+	/// </summary>
+	uint32_t GetClusterIndex(uint32_t x, uint32_t y, uint32_t z) const { return x + (y + z * _dimensions.y) * _dimensions.x; }
+	/// <summary>
+	/// Gets the depth slice that a view space distance falls into
+	/// </summary>
+	uint32_t GetSlice(float depth) const;
+	/// <summary>
+	/// Gets the values the shaders need to find the depth slice for a fragment, where
+	/// slice = log(depth) * x + y
+	/// </summary>
+	glm::vec2 GetSliceParams() const { return glm::vec2(_sliceScale, _sliceBias); }
+
+	/// <summary>
+	/// Gets the light range for every cluster, indexed by GetClusterIndex
+	/// </summary>
+	const std::vector<ClusterRange>& GetClusters() const { return _clusters; }
+	/// <summary>
+	/// Gets the list of light indices that the cluster ranges point into
+	/// </summary>
+	const std::vector<uint32_t>& GetLightIndices() const { return _lightIndices; }
+	/// <summary>
+	/// Gets the most lights that landed in a single cluster during the last build
+	/// </summary>
+	uint32_t GetMaxLightsPerCluster() const { return _maxLightsPerCluster; }
+
+private:
+	// A list of lights in SoA form, padded to a multiple of 4 so they can be tested with SSE
+	struct LightList {
+		std::vector<float>    X, Y, Z, RadiusSq;
+		// The index of each light in the array passed to Build
+		std::vector<uint32_t> Lights;
+
+		void Clear();
+		void Add(uint32_t light, const glm::vec3& position, float radiusSq);
+		void Pad();
+	};
+
+	// Scratch space and results for a single depth slice, kept between builds to avoid allocations
+	struct SliceData {
+		// The lights that touch the whole slice, and the lights that touch the row of tiles being binned
+		LightList SliceLights;
+		LightList RowLights;
+		// Cluster ranges and light indices, relative to the start of the slice
+		std::vector<ClusterRange> Clusters;
+		std::vector<uint32_t>     Indices;
+	};
+
+	glm::uvec3 _dimensions;
+	glm::mat4  _projection;
+	float      _zNear, _zFar;
+	float      _sliceScale, _sliceBias;
+	bool       _boundsDirty;
+
+	// View space bounds of each cluster, indexed by GetClusterIndex
+	std::vector<glm::vec3> _clusterMin;
+	std::vector<glm::vec3> _clusterMax;
+
+	std::vector<SliceData>    _slices;
+	std::vector<ClusterRange> _clusters;
+	std::vector<uint32_t>     _lightIndices;
+	uint32_t                  _maxLightsPerCluster;
+
+	void _RebuildBounds();
+	void _BinSlice(uint32_t slice, const LightBounds* lights, uint32_t count);
+
+	// Invokes onHit with the position in the list of every light that touches the box, in order
+	template <typename Func>
+	static void _ForEachLightInBox(const LightList& lights, const glm::vec3& min, const glm::vec3& max, Func onHit);
+};
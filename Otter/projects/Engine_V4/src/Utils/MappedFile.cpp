@@ -0,0 +1,99 @@
+#include "Utils/MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+MappedFile::MappedFile() :
+	_data(nullptr),
+	_size(0),
+	_fileHandle(nullptr),
+	_mappingHandle(nullptr)
+{ }
+
+MappedFile::~MappedFile() {
+	Close();
+}
+
+bool MappedFile::Open(const std::string& filename) {
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) {
+		CloseHandle(file);
+		return false;
+	}
+
+	void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	_fileHandle = file;
+	_mappingHandle = mapping;
+	_data = static_cast<const uint8_t*>(data);
+	_size = static_cast<size_t>(size.QuadPart);
+#else
+	int file = open(filename.c_str(), O_RDONLY);
+	if (file < 0) {
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(file, &info) != 0 || info.st_size == 0) {
+		close(file);
+		return false;
+	}
+
+	void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	// The mapping keeps the file alive, so we don't need the descriptor anymore
+	close(file);
+	if (data == MAP_FAILED) {
+		return false;
+	}
+
+	_data = static_cast<const uint8_t*>(data);
+	_size = static_cast<size_t>(info.st_size);
+#endif
+	return true;
+}
+
+void MappedFile::Close() {
+	if (_data == nullptr) {
+		return;
+	}
+
+#ifdef _WIN32
+	UnmapViewOfFile(_data);
+	CloseHandle(static_cast<HANDLE>(_mappingHandle));
+	CloseHandle(static_cast<HANDLE>(_fileHandle));
+#else
+	munmap(const_cast<uint8_t*>(_data), _size);
+#endif
+
+	_data = nullptr;
+	_size = 0;
+	_fileHandle = nullptr;
+	_mappingHandle = nullptr;
+}
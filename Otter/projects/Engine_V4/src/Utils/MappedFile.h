@@ -0,0 +1,48 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/// <summary>
+/// A read-only view of a file that has been mapped into memory. The OS pages the data in
+/// as it is touched, so we can hand pointers into the file directly to other APIs without
+/// reading it into our own buffers first
+/// </summary>
+class MappedFile {
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile& other) = delete;
+	MappedFile& operator=(const MappedFile& other) = delete;
+
+	/// <summary>
+	/// Maps the given file into memory, closing any file that was previously open
+	/// </summary>
+	/// <param name="filename">The path of the file to map</param>
+	/// <returns>True if the file was mapped successfully</returns>
+	bool Open(const std::string& filename);
+	/// <summary>
+	/// Unmaps the file, any pointers into the data become invalid
+	/// </summary>
+	void Close();
+
+	bool IsOpen() const { return _data != nullptr; }
+
+	/// <summary>
+	/// Gets a pointer to the start of the file's data, or nullptr if no file is mapped
+	/// </summary>
+	const uint8_t* GetData() const { return _data; }
+	/// <summary>
+	/// Gets the size of the mapped file in bytes
+	/// </summary>
+	size_t GetSize() const { return _size; }
+
+private:
+	const uint8_t* _data;
+	size_t         _size;
+
+	// Platform handles for the file and mapping objects
+	void*          _fileHandle;
+	void*          _mappingHandle;
+};
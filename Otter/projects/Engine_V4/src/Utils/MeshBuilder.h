@@ -138,6 +138,13 @@ public:
 		// Store our vertex type in the VAO's vertex declaration
 		result->SetVDecl(VertType::V_DECL);
 
+		// Calculate the bounds of the mesh so it can be culled
+		AABB bounds;
+		for (const VertType& vertex : _vertices) {
+			bounds.Encapsulate(vertex.Position);
+		}
+		result->SetBounds(bounds);
+
 		return result;
 	}
 	
@@ -0,0 +1,541 @@
+#include "Utils/ObjParser.h"
+
+#include <charconv>
+#include <algorithm>
+#include <cstring>
+
+#include "Utils/MappedFile.h"
+#include "Utils/JobSystem.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OBJ_PARSER_USE_SSE
+#include <emmintrin.h>
+#endif
+
+namespace {
+	// Chunks smaller than this aren't worth handing to another thread
+	constexpr size_t MinChunkSize = 256 * 1024;
+
+	// A single corner of a face, as read from the file. Indices are 1-based, with 0 meaning the
+	// attribute is missing. Negative indices in the file are relative to the attributes read so
+	// far, so we store those relative to the start of the chunk and fix them up after merging
+	struct Corner {
+		int32_t Index[3];
+		uint8_t RelativeMask;
+	};
+
+	// Everything we read from a single line-aligned chunk of the file
+	struct Chunk {
+		const char* Begin = nullptr;
+		const char* End   = nullptr;
+
+		std::vector<glm::vec3> Positions;
+		std::vector<glm::vec3> Normals;
+		std::vector<glm::vec2> UVs;
+		std::vector<Corner>    Corners;
+		// The number of corners in each face
+		std::vector<uint8_t>   FaceSizes;
+		// The face counts (within this chunk) at which a new group starts
+		std::vector<uint32_t>  GroupFaces;
+	};
+
+	inline bool IsSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+	inline const char* SkipSpaces(const char* ptr, const char* end) {
+		while (ptr < end && IsSpace(*ptr)) { ptr++; }
+		return ptr;
+	}
+
+	inline const char* SkipLine(const char* ptr, const char* end) {
+		while (ptr < end && *ptr != '\n') { ptr++; }
+		return ptr < end ? ptr + 1 : end;
+	}
+
+	// Reads a float, returning false if there was no number at the pointer
+	inline bool ReadFloat(const char*& ptr, const char* end, float& result) {
+		ptr = SkipSpaces(ptr, end);
+		// from_chars doesn't accept a leading plus
+		if (ptr < end && *ptr == '+') { ptr++; }
+		std::from_chars_result parsed = std::from_chars(ptr, end, result);
+		if (parsed.ec != std::errc()) {
+			return false;
+		}
+		ptr = parsed.ptr;
+		return true;
+	}
+
+	inline bool ReadInt(const char*& ptr, const char* end, int32_t& result) {
+		std::from_chars_result parsed = std::from_chars(ptr, end, result);
+		if (parsed.ec != std::errc()) {
+			return false;
+		}
+		ptr = parsed.ptr;
+		return true;
+	}
+
+	// Parses a face corner in any of the v, v/t, v//n or v/t/n forms
+	inline bool ReadCorner(const char*& ptr, const char* end, const Chunk& chunk, Corner& corner) {
+		corner.Index[0] = corner.Index[1] = corner.Index[2] = 0;
+		corner.RelativeMask = 0;
+
+		if (!ReadInt(ptr, end, corner.Index[0])) {
+			return false;
+		}
+		if (ptr < end && *ptr == '/') {
+			ptr++;
+			if (ptr < end && *ptr != '/') {
+				ReadInt(ptr, end, corner.Index[1]);
+			}
+			if (ptr < end && *ptr == '/') {
+				ptr++;
+				ReadInt(ptr, end, corner.Index[2]);
+			}
+		}
+
+		// Resolve negative indices against what we've read in this chunk so far
+		const int32_t counts[3] = {
+			static_cast<int32_t>(chunk.Positions.size()),
+			static_cast<int32_t>(chunk.UVs.size()),
+			static_cast<int32_t>(chunk.Normals.size())
+		};
+		for (int ix = 0; ix < 3; ix++) {
+			if (corner.Index[ix] < 0) {
+				corner.Index[ix] = counts[ix] + 1 + corner.Index[ix];
+				corner.RelativeMask |= 1 << ix;
+			}
+		}
+		return true;
+	}
+
+	void ParseChunk(Chunk& chunk) {
+		const char* ptr = chunk.Begin;
+		const char* end = chunk.End;
+
+		while (ptr < end) {
+			ptr = SkipSpaces(ptr, end);
+			if (ptr >= end) {
+				break;
+			}
+
+			const char c = *ptr;
+			const char next = ptr + 1 < end ? ptr[1] : '\0';
+
+			// v, vt and vn commands
+			if (c == 'v') {
+				if (IsSpace(next)) {
+					ptr += 1;
+					glm::vec3 value;
+					if (ReadFloat(ptr, end, value.x) && ReadFloat(ptr, end, value.y) && ReadFloat(ptr, end, value.z)) {
+						chunk.Positions.push_back(value);
+					}
+				} else if (next == 'n') {
+					ptr += 2;
+					glm::vec3 value;
+					if (ReadFloat(ptr, end, value.x) && ReadFloat(ptr, end, value.y) && ReadFloat(ptr, end, value.z)) {
+						chunk.Normals.push_back(value);
+					}
+				} else if (next == 't') {
+					ptr += 2;
+					glm::vec2 value;
+					if (ReadFloat(ptr, end, value.x) && ReadFloat(ptr, end, value.y)) {
+						chunk.UVs.push_back(value);
+					}
+				}
+			}
+			// The f command defines a polygon in the mesh
+			else if (c == 'f' && IsSpace(next)) {
+				ptr += 1;
+				uint8_t count = 0;
+				while (count < 255) {
+					ptr = SkipSpaces(ptr, end);
+					if (ptr >= end || *ptr == '\n') {
+						break;
+					}
+					Corner corner;
+					if (!ReadCorner(ptr, end, chunk, corner)) {
+						break;
+					}
+					chunk.Corners.push_back(corner);
+					count++;
+				}
+
+				// Anything that isn't at least a triangle gets thrown out
+				if (count >= 3) {
+					chunk.FaceSizes.push_back(count);
+				} else {
+					chunk.Corners.resize(chunk.Corners.size() - count);
+				}
+			}
+			// Objects, groups and material changes start a new group
+			else if ((c == 'o' || c == 'g') && IsSpace(next)) {
+				chunk.GroupFaces.push_back(static_cast<uint32_t>(chunk.FaceSizes.size()));
+			}
+			else if (c == 'u' && (end - ptr) > 6 && memcmp(ptr, "usemtl", 6) == 0) {
+				chunk.GroupFaces.push_back(static_cast<uint32_t>(chunk.FaceSizes.size()));
+			}
+
+			// Comments and anything we don't understand are ignored
+			ptr = SkipLine(ptr, end);
+		}
+	}
+
+	/// <summary>
+	/// An open addressing hash map from an attribute index triplet to a vertex index, much faster than
+	/// std::unordered_map since all the entries live in one flat array and are found with a linear probe
+	/// </summary>
+	class VertexDedupMap {
+	public:
+		static constexpr uint32_t Empty = 0xFFFFFFFF;
+
+		explicit VertexDedupMap(size_t expectedCount) :
+			_entries(),
+			_mask(0),
+			_count(0)
+		{
+			size_t capacity = 16;
+			while (capacity < expectedCount * 2) { capacity <<= 1; }
+			_entries.resize(capacity);
+			_mask = capacity - 1;
+		}
+
+		/// <summary>
+		/// Gets the vertex for the given key, or inserts one with the given value if none exists
+		/// </summary>
+		/// <returns>The vertex index associated with the key</returns>
+		uint32_t FindOrInsert(const glm::ivec3& key, uint32_t value) {
+			if ((_count + 1) * 2 > _entries.size()) {
+				_Grow();
+			}
+			size_t slot = _Hash(key) & _mask;
+			while (true) {
+				Entry& entry = _entries[slot];
+				if (entry.Value == Empty) {
+					entry.Key = key;
+					entry.Value = value;
+					_count++;
+					return value;
+				}
+				if (entry.Key == key) {
+					return entry.Value;
+				}
+				slot = (slot + 1) & _mask;
+			}
+		}
+
+	private:
+		struct Entry {
+			glm::ivec3 Key;
+			uint32_t   Value = Empty;
+		};
+		std::vector<Entry> _entries;
+		size_t _mask;
+		size_t _count;
+
+		static size_t _Hash(const glm::ivec3& key) {
+			uint32_t hash = static_cast<uint32_t>(key.x) * 0x9E3779B1u;
+			hash ^= static_cast<uint32_t>(key.y) * 0x85EBCA77u;
+			hash ^= static_cast<uint32_t>(key.z) * 0xC2B2AE3Du;
+			hash ^= hash >> 15;
+			hash *= 0x2C1B3C6Du;
+			hash ^= hash >> 12;
+			return hash;
+		}
+
+		void _Grow() {
+			std::vector<Entry> old = std::move(_entries);
+			_entries = std::vector<Entry>(old.size() * 2);
+			_mask = _entries.size() - 1;
+			for (const Entry& entry : old) {
+				if (entry.Value != Empty) {
+					size_t slot = _Hash(entry.Key) & _mask;
+					while (_entries[slot].Value != Empty) {
+						slot = (slot + 1) & _mask;
+					}
+					_entries[slot] = entry;
+				}
+			}
+		}
+	};
+}
+
+void ObjParseResult::Clear() {
+	Positions.clear();
+	Normals.clear();
+	UVs.clear();
+	Vertices.clear();
+	Indices.clear();
+	GroupStarts.clear();
+}
+
+bool ObjParser::Parse(const std::string& filename, ObjParseResult& result, int threadCount) {
+	MappedFile file;
+	if (!file.Open(filename)) {
+		return false;
+	}
+	Parse(reinterpret_cast<const char*>(file.GetData()), file.GetSize(), result, threadCount);
+	return true;
+}
+
+void ObjParser::Parse(const char* data, size_t size, ObjParseResult& result, int threadCount) {
+	result.Clear();
+
+	// Figure out how many chunks to split the file into, one per job system thread by default
+	if (threadCount <= 0) {
+		threadCount = JobSystem::IsInitialized() ? JobSystem::GetWorkerCount() + 1 : 1;
+	}
+	size_t chunkCount = std::max<size_t>(1, std::min<size_t>(threadCount, size / MinChunkSize));
+
+	// Split the file on line boundaries
+	std::vector<Chunk> chunks(chunkCount);
+	const char* end = data + size;
+	const char* cursor = data;
+	for (size_t ix = 0; ix < chunkCount; ix++) {
+		chunks[ix].Begin = cursor;
+		if (ix == chunkCount - 1) {
+			cursor = end;
+		} else {
+			cursor = std::max(cursor, data + (size * (ix + 1)) / chunkCount);
+			while (cursor < end && *cursor != '\n') { cursor++; }
+			if (cursor < end) { cursor++; }
+		}
+		chunks[ix].End = cursor;
+	}
+
+	// Parse all the chunks across the job system, if it isn't running they are parsed in order
+	// on this thread
+	JobSystem::ParallelFor(chunkCount, 1, [&chunks](size_t begin, size_t end) {
+		for (size_t ix = begin; ix < end; ix++) {
+			ParseChunk(chunks[ix]);
+		}
+	});
+
+	// Merge the attributes in file order, remembering where each chunk's attributes start
+	// so that relative indices can be fixed up
+	std::vector<glm::ivec3> attribOffsets(chunkCount);
+	size_t cornerCount = 0;
+	size_t triangleCount = 0;
+	glm::ivec3 totals = glm::ivec3(0);
+	for (size_t ix = 0; ix < chunkCount; ix++) {
+		attribOffsets[ix] = totals;
+		totals += glm::ivec3((int)chunks[ix].Positions.size(), (int)chunks[ix].UVs.size(), (int)chunks[ix].Normals.size());
+		cornerCount += chunks[ix].Corners.size();
+		for (uint8_t faceSize : chunks[ix].FaceSizes) {
+			triangleCount += faceSize - 2;
+		}
+	}
+	result.Positions.reserve(totals.x);
+	result.UVs.reserve(totals.y);
+	result.Normals.reserve(totals.z);
+	for (const Chunk& chunk : chunks) {
+		result.Positions.insert(result.Positions.end(), chunk.Positions.begin(), chunk.Positions.end());
+		result.UVs.insert(result.UVs.end(), chunk.UVs.begin(), chunk.UVs.end());
+		result.Normals.insert(result.Normals.end(), chunk.Normals.begin(), chunk.Normals.end());
+	}
+
+	// De-duplicate vertices and build our triangles. This is done in file order so the vertex
+	// ordering is the same as a single threaded parse
+	VertexDedupMap vertexMap = VertexDedupMap(std::max(result.Positions.size(), cornerCount / 6));
+	result.Indices.reserve(triangleCount * 3);
+	std::vector<uint32_t> faceVertices;
+	for (size_t chunkIx = 0; chunkIx < chunkCount; chunkIx++) {
+		const Chunk& chunk = chunks[chunkIx];
+		const glm::ivec3& offset = attribOffsets[chunkIx];
+		size_t cornerIx = 0;
+		size_t groupIx = 0;
+
+		for (size_t faceIx = 0; faceIx < chunk.FaceSizes.size(); faceIx++) {
+			while (groupIx < chunk.GroupFaces.size() && chunk.GroupFaces[groupIx] == faceIx) {
+				result.GroupStarts.push_back(static_cast<uint32_t>(result.Indices.size()));
+				groupIx++;
+			}
+
+			const uint8_t faceSize = chunk.FaceSizes[faceIx];
+			faceVertices.clear();
+			for (uint8_t ix = 0; ix < faceSize; ix++, cornerIx++) {
+				const Corner& corner = chunk.Corners[cornerIx];
+				// Convert to 0-based global indices, with -1 for missing attributes
+				glm::ivec3 key;
+				for (int attrib = 0; attrib < 3; attrib++) {
+					int32_t value = corner.Index[attrib];
+					if (corner.RelativeMask & (1 << attrib)) {
+						value += offset[attrib];
+					}
+					key[attrib] = value - 1;
+				}
+
+				uint32_t vertex = vertexMap.FindOrInsert(key, static_cast<uint32_t>(result.Vertices.size()));
+				if (vertex == result.Vertices.size()) {
+					result.Vertices.push_back(key);
+				}
+				faceVertices.push_back(vertex);
+			}
+
+			// Fan out the polygon into triangles
+			for (uint8_t ix = 1; ix + 1 < faceSize; ix++) {
+				result.Indices.push_back(faceVertices[0]);
+				result.Indices.push_back(faceVertices[ix]);
+				result.Indices.push_back(faceVertices[ix + 1]);
+			}
+		}
+
+		// Groups that start after the last face in this chunk
+		for (; groupIx < chunk.GroupFaces.size(); groupIx++) {
+			result.GroupStarts.push_back(static_cast<uint32_t>(result.Indices.size()));
+		}
+	}
+
+	// Validate the attribute indices, anything out of range is treated as missing
+	const glm::ivec3 limits = glm::ivec3((int)result.Positions.size(), (int)result.UVs.size(), (int)result.Normals.size());
+	for (glm::ivec3& vertex : result.Vertices) {
+		for (int attrib = 0; attrib < 3; attrib++) {
+			if (vertex[attrib] >= limits[attrib] || vertex[attrib] < 0) {
+				vertex[attrib] = -1;
+			}
+		}
+	}
+}
+
+void ObjParser::CalculateTangents(const glm::vec3* positions, const glm::vec2* uvs, size_t vertexCount,
+	const uint32_t* indices, size_t indexCount,
+	glm::vec3* outTangents, glm::vec3* outBiTangents)
+{
+	// Per-vertex sums in structure-of-arrays form, so we can normalize them 4 at a time
+	std::vector<float> sums[6];
+	for (auto& sum : sums) {
+		sum.assign(vertexCount + 4, 0.0f);
+	}
+
+	// Adds a triangle's tangent and bitangent into the sums for it's vertices
+	auto accumulate = [&](size_t triangle, float tx, float ty, float tz, float bx, float by, float bz) {
+		for (int corner = 0; corner < 3; corner++) {
+			const uint32_t vertex = indices[triangle * 3 + corner];
+			sums[0][vertex] += tx; sums[1][vertex] += ty; sums[2][vertex] += tz;
+			sums[3][vertex] += bx; sums[4][vertex] += by; sums[5][vertex] += bz;
+		}
+	};
+
+	// Calculates the tangent frame for a single triangle
+	// https://learnopengl.com/Advanced-Lighting/Normal-Mapping
+	auto solveTriangle = [&](size_t triangle) {
+		const uint32_t i0 = indices[triangle * 3 + 0];
+		const uint32_t i1 = indices[triangle * 3 + 1];
+		const uint32_t i2 = indices[triangle * 3 + 2];
+
+		const glm::vec3 deltaP1 = positions[i1] - positions[i0];
+		const glm::vec3 deltaP2 = positions[i2] - positions[i0];
+		const glm::vec2 deltaT1 = uvs[i1] - uvs[i0];
+		const glm::vec2 deltaT2 = uvs[i2] - uvs[i0];
+
+		const float det = deltaT1.x * deltaT2.y - deltaT1.y * deltaT2.x;
+		if (glm::abs(det) <= 1e-12f) {
+			return;
+		}
+		const float r = 1.0f / det;
+		glm::vec3 tangent   = (deltaP1 * deltaT2.y - deltaP2 * deltaT1.y) * r;
+		glm::vec3 biTangent = (deltaP2 * deltaT1.x - deltaP1 * deltaT2.x) * r;
+		const float tLength = glm::length(tangent);
+		const float bLength = glm::length(biTangent);
+		tangent   = tLength > 0.0f ? tangent / tLength : glm::vec3(0.0f);
+		biTangent = bLength > 0.0f ? biTangent / bLength : glm::vec3(0.0f);
+		accumulate(triangle, tangent.x, tangent.y, tangent.z, biTangent.x, biTangent.y, biTangent.z);
+	};
+
+	const size_t triangleCount = indexCount / 3;
+	size_t triangle = 0;
+
+#ifdef OBJ_PARSER_USE_SSE
+	// Reciprocal square root, with zero length vectors staying zero
+	auto normalize = [](__m128& x, __m128& y, __m128& z) {
+		__m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+		__m128 valid = _mm_cmpgt_ps(lengthSq, _mm_setzero_ps());
+		__m128 scale = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSq)), valid);
+		x = _mm_mul_ps(x, scale);
+		y = _mm_mul_ps(y, scale);
+		z = _mm_mul_ps(z, scale);
+	};
+
+	// Solve 4 triangles at a time, gathering their corners into SSE registers
+	alignas(16) float p[3][3][4];
+	alignas(16) float t[3][2][4];
+	alignas(16) float out[6][4];
+	for (; triangle + 4 <= triangleCount; triangle += 4) {
+		for (int lane = 0; lane < 4; lane++) {
+			for (int corner = 0; corner < 3; corner++) {
+				const uint32_t vertex = indices[(triangle + lane) * 3 + corner];
+				p[corner][0][lane] = positions[vertex].x;
+				p[corner][1][lane] = positions[vertex].y;
+				p[corner][2][lane] = positions[vertex].z;
+				t[corner][0][lane] = uvs[vertex].x;
+				t[corner][1][lane] = uvs[vertex].y;
+			}
+		}
+
+		const __m128 dP1x = _mm_sub_ps(_mm_load_ps(p[1][0]), _mm_load_ps(p[0][0]));
+		const __m128 dP1y = _mm_sub_ps(_mm_load_ps(p[1][1]), _mm_load_ps(p[0][1]));
+		const __m128 dP1z = _mm_sub_ps(_mm_load_ps(p[1][2]), _mm_load_ps(p[0][2]));
+		const __m128 dP2x = _mm_sub_ps(_mm_load_ps(p[2][0]), _mm_load_ps(p[0][0]));
+		const __m128 dP2y = _mm_sub_ps(_mm_load_ps(p[2][1]), _mm_load_ps(p[0][1]));
+		const __m128 dP2z = _mm_sub_ps(_mm_load_ps(p[2][2]), _mm_load_ps(p[0][2]));
+		const __m128 dT1x = _mm_sub_ps(_mm_load_ps(t[1][0]), _mm_load_ps(t[0][0]));
+		const __m128 dT1y = _mm_sub_ps(_mm_load_ps(t[1][1]), _mm_load_ps(t[0][1]));
+		const __m128 dT2x = _mm_sub_ps(_mm_load_ps(t[2][0]), _mm_load_ps(t[0][0]));
+		const __m128 dT2y = _mm_sub_ps(_mm_load_ps(t[2][1]), _mm_load_ps(t[0][1]));
+
+		// Triangles with degenerate UVs contribute nothing
+		const __m128 det = _mm_sub_ps(_mm_mul_ps(dT1x, dT2y), _mm_mul_ps(dT1y, dT2x));
+		const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		const __m128 valid = _mm_cmpgt_ps(_mm_and_ps(det, absMask), _mm_set1_ps(1e-12f));
+		const __m128 r = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), det), valid);
+
+		__m128 tx = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(dP1x, dT2y), _mm_mul_ps(dP2x, dT1y)), r);
+		__m128 ty = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(dP1y, dT2y), _mm_mul_ps(dP2y, dT1y)), r);
+		__m128 tz = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(dP1z, dT2y), _mm_mul_ps(dP2z, dT1y)), r);
+		__m128 bx = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(dP2x, dT1x), _mm_mul_ps(dP1x, dT2x)), r);
+		__m128 by = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(dP2y, dT1x), _mm_mul_ps(dP1y, dT2x)), r);
+		__m128 bz = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(dP2z, dT1x), _mm_mul_ps(dP1z, dT2x)), r);
+		normalize(tx, ty, tz);
+		normalize(bx, by, bz);
+
+		_mm_store_ps(out[0], tx); _mm_store_ps(out[1], ty); _mm_store_ps(out[2], tz);
+		_mm_store_ps(out[3], bx); _mm_store_ps(out[4], by); _mm_store_ps(out[5], bz);
+		for (int lane = 0; lane < 4; lane++) {
+			accumulate(triangle + lane, out[0][lane], out[1][lane], out[2][lane], out[3][lane], out[4][lane], out[5][lane]);
+		}
+	}
+#endif
+
+	// Handle whatever is left over
+	for (; triangle < triangleCount; triangle++) {
+		solveTriangle(triangle);
+	}
+
+	// Normalize the sums to get the averaged frames
+	size_t vertex = 0;
+#ifdef OBJ_PARSER_USE_SSE
+	for (; vertex + 4 <= vertexCount; vertex += 4) {
+		__m128 tx = _mm_loadu_ps(sums[0].data() + vertex);
+		__m128 ty = _mm_loadu_ps(sums[1].data() + vertex);
+		__m128 tz = _mm_loadu_ps(sums[2].data() + vertex);
+		__m128 bx = _mm_loadu_ps(sums[3].data() + vertex);
+		__m128 by = _mm_loadu_ps(sums[4].data() + vertex);
+		__m128 bz = _mm_loadu_ps(sums[5].data() + vertex);
+		normalize(tx, ty, tz);
+		normalize(bx, by, bz);
+
+		_mm_store_ps(out[0], tx); _mm_store_ps(out[1], ty); _mm_store_ps(out[2], tz);
+		_mm_store_ps(out[3], bx); _mm_store_ps(out[4], by); _mm_store_ps(out[5], bz);
+		for (int lane = 0; lane < 4; lane++) {
+			outTangents[vertex + lane]   = glm::vec3(out[0][lane], out[1][lane], out[2][lane]);
+			outBiTangents[vertex + lane] = glm::vec3(out[3][lane], out[4][lane], out[5][lane]);
+		}
+	}
+#endif
+	for (; vertex < vertexCount; vertex++) {
+		glm::vec3 tangent   = glm::vec3(sums[0][vertex], sums[1][vertex], sums[2][vertex]);
+		glm::vec3 biTangent = glm::vec3(sums[3][vertex], sums[4][vertex], sums[5][vertex]);
+		const float tLength = glm::length(tangent);
+		const float bLength = glm::length(biTangent);
+		outTangents[vertex]   = tLength > 0.0f ? tangent / tLength : glm::vec3(0.0f);
+		outBiTangents[vertex] = bLength > 0.0f ? biTangent / bLength : glm::vec3(0.0f);
+	}
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "GLM/glm.hpp"
+#include "Graphics/VertexParamMap.h"
+#include "Utils/MeshBuilder.h"
+
+/// <summary>
+/// The contents of an OBJ file after parsing, with vertices de-duplicated so that every unique
+/// combination of position, UV and normal appears once
+/// </summary>
+struct ObjParseResult {
+	std::vector<glm::vec3>  Positions;
+	std::vector<glm::vec3>  Normals;
+	std::vector<glm::vec2>  UVs;
+	// Unique vertices, stored as 0-based indices into Positions, UVs and Normals (-1 if missing)
+	std::vector<glm::ivec3> Vertices;
+	// Triangle list indices into Vertices, polygons are fanned into triangles
+	std::vector<uint32_t>   Indices;
+	// The index offsets at which each object, group or material change begins
+	std::vector<uint32_t>   GroupStarts;
+
+	void Clear();
+};
+
+/// <summary>
+/// A fast OBJ parser. The file is memory mapped and split into line-aligned chunks that are
+/// parsed in parallel on the job system using std::from_chars, then merged in file order so the results are
+/// always the same no matter how many threads were used
+/// </summary>
+class ObjParser {
+public:
+	/// <summary>
+	/// Parses an OBJ file from disk
+	/// </summary>
+	/// <param name="filename">The path to the OBJ file</param>
+	/// <param name="result">The parsed data will be stored here</param>
+	/// <param name="threadCount">The number of chunks to split the file into, or 0 for one per job system thread</param>
+	/// <returns>True if the file could be opened</returns>
+	static bool Parse(const std::string& filename, ObjParseResult& result, int threadCount = 0);
+	/// <summary>
+	/// Parses OBJ data that is already in memory
+	/// </summary>
+	static void Parse(const char* data, size_t size, ObjParseResult& result, int threadCount = 0);
+
+	/// <summary>
+	/// Calculates per-vertex tangents and bitangents for an indexed triangle list, by averaging the
+	/// tangent frames of every triangle that uses a vertex. Triangles are processed 4 at a time with SSE
+	/// </summary>
+	static void CalculateTangents(const glm::vec3* positions, const glm::vec2* uvs, size_t vertexCount,
+		const uint32_t* indices, size_t indexCount,
+		glm::vec3* outTangents, glm::vec3* outBiTangents);
+
+	/// <summary>
+	/// Fills a mesh builder with the vertices and indices from a parse result
+	/// </summary>
+	/// <typeparam name="VertexType">The type of vertex to store in the mesh</typeparam>
+	/// <param name="data">The parsed OBJ data</param>
+	/// <param name="mesh">The mesh to add vertices and indices to</param>
+	/// <param name="calcTangents">True if tangents and bitangents should be calculated, if the vertex type has them</param>
+	/// <param name="color">The color to give every vertex</param>
+	template <typename VertexType>
+	static void BuildMesh(const ObjParseResult& data, MeshBuilder<VertexType>& mesh, bool calcTangents = true, const glm::vec4& color = glm::vec4(1.0f));
+
+protected:
+	ObjParser() = default;
+	~ObjParser() = default;
+};
+
+template <typename VertexType>
+void ObjParser::BuildMesh(const ObjParseResult& data, MeshBuilder<VertexType>& mesh, bool calcTangents, const glm::vec4& color) {
+	// We'll use a vertex param mapper for our attributes
+	VertexParamMap vMap = VertexParamMap(VertexType::V_DECL);
+
+	// Gather the attributes for each unique vertex
+	const size_t vertexCount = data.Vertices.size();
+	std::vector<glm::vec3> positions(vertexCount);
+	std::vector<glm::vec2> uvs(vertexCount);
+	for (size_t ix = 0; ix < vertexCount; ix++) {
+		const glm::ivec3& vertexIndices = data.Vertices[ix];
+		positions[ix] = vertexIndices.x >= 0 ? data.Positions[vertexIndices.x] : glm::vec3(0.0f);
+		uvs[ix]       = vertexIndices.y >= 0 ? data.UVs[vertexIndices.y] : glm::vec2(0.0f);
+	}
+
+	// Only bother with tangents if the vertex can store them
+	std::vector<glm::vec3> tangents;
+	std::vector<glm::vec3> biTangents;
+	const bool hasTangents = vMap.TangentOffset != (uint32_t)-1 || vMap.BiTangentOffset != (uint32_t)-1;
+	if (calcTangents && hasTangents && data.Indices.size() > 0) {
+		tangents.resize(vertexCount);
+		biTangents.resize(vertexCount);
+		CalculateTangents(positions.data(), uvs.data(), vertexCount, data.Indices.data(), data.Indices.size(), tangents.data(), biTangents.data());
+	}
+
+	mesh.ReserveVertexSpace(vertexCount);
+	for (size_t ix = 0; ix < vertexCount; ix++) {
+		const glm::ivec3& vertexIndices = data.Vertices[ix];
+
+		// Construct a new vertex using the indices for the vertex
+		VertexType vertex;
+		vMap.SetPosition(vertex, positions[ix]);
+		vMap.SetTexture(vertex, uvs[ix]);
+		vMap.SetNormal(vertex, vertexIndices.z >= 0 ? data.Normals[vertexIndices.z] : glm::vec3(0.0f, 0.0f, 1.0f));
+		vMap.SetColor(vertex, color);
+		if (!tangents.empty()) {
+			vMap.SetTangent(vertex, tangents[ix]);
+			vMap.SetBiTangent(vertex, biTangents[ix]);
+		}
+
+		mesh.AddVertex(vertex);
+	}
+
+	mesh.ReserveIndexSpace(data.Indices.size());
+	for (uint32_t ix : data.Indices) {
+		mesh.AddIndex(ix);
+	}
+}
@@ -1,16 +1,22 @@
 #include "Utils/OptimizedObjLoader.h"
 
 #include "ObjLoader.h"
+#include "Utils/ObjParser.h"
 
 #include <string>
 #include <sstream>
 #include <fstream>
 #include <iostream>
 #include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
 
 #include "Utils/StringUtils.h"
+#include "Utils/MappedFile.h"
 #include "GLFW/glfw3.h"
 #include "Logging.h"
+#include "GLM/gtc/packing.hpp"
 
 const char HEADER_BYTES[4] = { 'B', 'O', 'B', 'J' };
 const std::string binaryExtension = ".bin";
@@ -45,12 +51,7 @@ VertexArrayObject::Sptr OptimizedObjLoader::LoadFromFile(const std::string& file
 	}
 }
 
-void OptimizedObjLoader::ConvertToBinary(const std::string& inFile, const std::string& outFile) {
-	// Load in the input file
-	MeshBuilder<VertexPosNormTexColTangents>* mesh = _LoadFromObjFile(inFile);
-
-	float startTime = static_cast<float>(glfwGetTime());
-
+void OptimizedObjLoader::ConvertToBinary(const std::string& inFile, const std::string& outFile, BinaryMeshFlags flags) {
 	// If we didn't get an output path, just take the input and replace the extension
 	std::string outFileName = outFile;
 	if (outFileName.empty()) { 
@@ -62,8 +63,46 @@ void OptimizedObjLoader::ConvertToBinary(const std::string& inFile, const std::s
 		outFileName = path.string();
 	}
 
+	std::string extension = fs::path(inFile).extension().string();
+	StringTools::ToLower(extension);
+
+	// Upgrading an existing binary file to the latest version
+	if (extension == binaryExtension) {
+		MappedFile file;
+		if (!file.Open(inFile)) {
+			throw std::runtime_error("Failed to open file");
+		}
+
+		BinaryMeshView view;
+		if (!_ReadBinary(file.GetData(), file.GetSize(), inFile, view)) {
+			return;
+		}
+
+		// Grab copies of everything we need, since we may be overwriting the input file
+		std::vector<uint8_t>  vertices(view.Vertices, view.Vertices + view.NumVertices * (size_t)view.VertexStride);
+		std::vector<uint32_t> indices(view.NumIndices);
+		for (uint32_t ix = 0; ix < view.NumIndices; ix++) {
+			switch (view.IndicesType) {
+				case IndexType::UByte:  indices[ix] = view.Indices[ix]; break;
+				case IndexType::UShort: { uint16_t value; memcpy(&value, view.Indices + ix * sizeof(uint16_t), sizeof(uint16_t)); indices[ix] = value; } break;
+				default:                memcpy(&indices[ix], view.Indices + ix * sizeof(uint32_t), sizeof(uint32_t)); break;
+			}
+		}
+		file.Close();
+
+		_WriteBinaryFile(outFileName, vertices.data(), view.NumVertices, view.VertexStride, view.VertexDeclaration, indices.data(), view.NumIndices, view.SubMeshes, flags);
+		LOG_TRACE("Upgraded binary mesh \"{}\" from version {}", inFile, view.Version);
+		return;
+	}
+
+	// Load in the input file
+	std::vector<VertexArrayObject::SubMesh> subMeshes;
+	MeshBuilder<VertexPosNormTexColTangents>* mesh = _LoadFromObjFile(inFile, &subMeshes);
+
+	float startTime = static_cast<float>(glfwGetTime());
+
 	// Save the mesh to the file
-	SaveBinaryFile(*mesh, outFileName);
+	SaveBinaryFile(*mesh, outFileName, flags, subMeshes);
 
 	float endTime = static_cast<float>(glfwGetTime());
 	LOG_TRACE("Converted OBJ file to binary \"{}\" in {} seconds ({} vertices, {} indices)", inFile, endTime - startTime, mesh->GetVertexCount(), mesh->GetIndexCount());
@@ -72,257 +111,405 @@ void OptimizedObjLoader::ConvertToBinary(const std::string& inFile, const std::s
 	delete mesh;
 }
 
-MeshBuilder<VertexPosNormTexColTangents>* OptimizedObjLoader::_LoadFromObjFile(const std::string& filename) {
-	// Open our file in binary mode
-	std::ifstream file;
-	file.open(filename, std::ios::binary);
+MeshBuilder<VertexPosNormTexColTangents>* OptimizedObjLoader::_LoadFromObjFile(const std::string& filename, std::vector<VertexArrayObject::SubMesh>* subMeshes) {
+	float startTime = static_cast<float>(glfwGetTime());
 
+	// Parse the file across all our cores
+	ObjParseResult data;
 	// If our file fails to open, we will throw an error
-	if (!file) {
+	if (!ObjParser::Parse(filename, data)) {
 		throw std::runtime_error("Failed to open file");
 	}
 
-	// Could also take this in as a parameter
-	glm::vec4 color = glm::vec4(1.0f);
-
-	// Our attributes
-	std::vector<glm::vec3>  positions;
-	std::vector<glm::vec3>  normals;
-	std::vector<glm::vec2>  uvs;
-	std::vector<glm::ivec3> vertices;
-	std::vector<uint32_t>   indices;
-
-	// Maps a key generated from obj indices to a vertex index that
-	// has been added to the mesh already
-	std::unordered_map<uint64_t, uint32_t> vertexMap;
-
 	// We'll use the mesh builder since it supports easily adding
-	// vertices and indices
+	// vertices and indices, this will also calculate our tangents
 	MeshBuilder<VertexPosNormTexColTangents>* mesh = new MeshBuilder<VertexPosNormTexColTangents>();
-
-	// Storage for temporary data
-	std::string line;
-	glm::vec3 vecData;
-	glm::ivec3 vertexIndices;
-
-	float startTime = static_cast<float>(glfwGetTime());
-
-	// Read and process the entire file
-	while (file.peek() != EOF) {
-		// Read in the first part of the line (ex: f, v, vn, etc...)
-		std::string command;
-		file >> command;
-
-		// We will ignore the rest of the line for comment lines
-		if (command == "#") {
-			std::getline(file, line);
-		}
-
-		// The v command defines a vertex's position
-		else if (command == "v") {
-			// Read in and store a position
-			file >> vecData.x >> vecData.y >> vecData.z;
-			positions.push_back(vecData);
-		}
-		// TODO: handle normals and textures
-		else if (command == "vn") {
-			// Read in and store a position
-			file >> vecData.x >> vecData.y >> vecData.z;
-			normals.push_back(vecData);
-		} else if (command == "vt") {
-			// Read in and store a position
-			file >> vecData.x >> vecData.y;
-			uvs.push_back(vecData);
-		}
-
-		// The f command defines a polygon in the mesh
-		// NOTE: make sure you triangulate in blender, otherwise it will
-		// output quads instead of triangles
-		else if (command == "f") {
-			// Read the rest of the line from the file
-			std::getline(file, line);
-			// Trim whitespace from either end of the line
-			StringTools::Trim(line);
-			// Create a string stream so we can use streaming operators on it
-			std::stringstream stream = std::stringstream(line);
-
-			uint32_t edges[4];
-			int ix = 0;
-			// Iterate over up to 4 sets of attributes
-			for (; ix < 4; ix++) {
-				if (stream.peek() != EOF) {
-					// Load in the faces, split up by slashes
-					char tempChar;
-					vertexIndices = glm::ivec3(0);
-					stream >> vertexIndices.x >> tempChar >> vertexIndices.y >> tempChar >> vertexIndices.z;
-					// The OBJ format can have negative values, which are a reference from the last added attributes
-					if (vertexIndices.x < 0) { vertexIndices.x = positions.size() + 1 + vertexIndices.x; }
-					if (vertexIndices.y < 0) { vertexIndices.y = uvs.size()       + 1 + vertexIndices.y; }
-					if (vertexIndices.z < 0) { vertexIndices.z = normals.size()   + 1 + vertexIndices.z; }
-
-					// We can construct a key using a bitmask of the attribute indices
-					// This let's us quickly look up a combination of attributes to see if it's already been added
-					// Note that this limits us to 2,097,150 unique attributes for positions, normals and textures
-					const uint64_t mask = 0b0'000000000000000000000'000000000000000000000'111111111111111111111;
-					uint64_t key = ((vertexIndices.x & mask) << 42) | ((vertexIndices.y & mask) << 21) | (vertexIndices.z & mask);
-
-					// Find the index associated with the combination of attributes
-					auto it = vertexMap.find(key);
-
-					// If it exists, we push the index to our indices
-					if (it != vertexMap.end()) {
-						edges[ix] = it->second;
-					} else {
-						vertices.push_back(vertexIndices - glm::ivec3(1));
-						uint32_t index = static_cast<uint32_t>(vertices.size()) - 1;
-
-						// Cache the index based on our key
-						vertexMap[key] = index;
-						// Add index to mesh, and add to edges list for if we are using quads
-						edges[ix] = index;
-					}
-				}
-				// We've reached the end of the line, break out of the loop
-				else { break; }
-			}
-
-			// Handling for triangle faces
-			if (ix == 3) {
-				indices.push_back(edges[0]);
-				indices.push_back(edges[1]);
-				indices.push_back(edges[2]);
-			}
-			// Handling for quad faces
-			else if (ix == 4) {
-				indices.push_back(edges[0]);
-				indices.push_back(edges[1]);
-				indices.push_back(edges[2]);
-
-				indices.push_back(edges[0]);
-				indices.push_back(edges[2]);
-				indices.push_back(edges[3]);
+	ObjParser::BuildMesh(data, *mesh);
+
+	// Each object, group or material change becomes a sub-mesh
+	if (subMeshes != nullptr) {
+		uint32_t groupStart = 0;
+		for (size_t ix = 0; ix <= data.GroupStarts.size(); ix++) {
+			uint32_t groupEnd = ix < data.GroupStarts.size() ? data.GroupStarts[ix] : static_cast<uint32_t>(data.Indices.size());
+			if (groupEnd > groupStart) {
+				VertexArrayObject::SubMesh subMesh;
+				subMesh.IndexOffset = groupStart;
+				subMesh.IndexCount = groupEnd - groupStart;
+				subMeshes->push_back(subMesh);
 			}
+			groupStart = groupEnd;
 		}
 	}
 
-	mesh->ReserveVertexSpace(vertices.size());
-	for (const auto& vertexIndices : vertices) {
-		// Construct a new vertex using the indices for the vertex
-		VertexPosNormTexColTangents vertex;
-		vertex.Position = positions[vertexIndices.x];
-		vertex.UV       = vertexIndices.y != 0 ? uvs[vertexIndices.y] : glm::vec2(0.0f);
-		vertex.Normal   = vertexIndices.z != 0 ? normals[vertexIndices.z] : glm::vec3(0.0f, 0.0f, 1.0f);
-		vertex.Color    = color;
-
-		// Add to the mesh, get index of the added vertex
-		mesh->AddVertex(vertex);
-	}
-	mesh->ReserveIndexSpace(indices.size());
-	for (uint32_t ix : indices) {
-		mesh->AddIndex(ix);
-	}
-
-	// Calculate our tangents
-	MeshFactory::CalculateTBN(*mesh);
-
 	// Calculate and trace out how long it took us to load
 	float endTime = static_cast<float>(glfwGetTime());
 	LOG_TRACE("Loaded OBJ file \"{}\" in {} seconds ({} vertices, {} indices)", filename, endTime - startTime, mesh->GetVertexCount(), mesh->GetIndexCount());
 
-	// Move our data into a VAO and return it
 	return mesh;
 }
 
 VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFile(const std::string& filename) {
+	float startTime = static_cast<float>(glfwGetTime());
 
-	// Open the output file
-	std::ifstream file(filename, std::ios::binary);
+	// Map the file into memory, so that we can give OpenGL pointers straight into the file
+	// instead of reading it into buffers first
+	MappedFile file;
 	// If our file fails to open, we will throw an error
-	if (!file) { throw std::runtime_error("Failed to open file"); }
+	if (!file.Open(filename)) { throw std::runtime_error("Failed to open file"); }
 
-	float startTime = static_cast<float>(glfwGetTime());
+	BinaryMeshView view;
+	if (!_ReadBinary(file.GetData(), file.GetSize(), filename, view)) {
+		return nullptr;
+	}
+
+	// If we have index data, load it
+	IndexBuffer::Sptr indices = nullptr;
+	if (view.NumIndices > 0) {
+		indices = IndexBuffer::Create(BufferUsage::StaticDraw);
+		indices->LoadData(view.Indices, (uint32_t)GetIndexTypeSize(view.IndicesType), view.NumIndices, view.IndicesType);
+	}
+
+	// Create a new VBO
+	VertexBuffer::Sptr vertices = VertexBuffer::Create(BufferUsage::StaticDraw);
+	vertices->LoadData(view.Vertices, view.VertexStride, view.NumVertices);
+
+	// Create the VAO and attach our index and vertex buffers
+	VertexArrayObject::Sptr result = VertexArrayObject::Create();
+	result->SetIndexBuffer(indices);
+	result->AddVertexBuffer(vertices, view.VertexDeclaration);
+
+	// Copy in the vertex declaration we loaded
+	result->SetVDecl(view.VertexDeclaration);
+	result->SetBounds(view.Bounds);
+	result->SetSubMeshes(view.SubMeshes);
+
+	// Calculate and trace out how long it took us to load
+	float endTime = static_cast<float>(glfwGetTime());
+	LOG_TRACE("Loaded binary mesh \"{}\" (v{}) in {} seconds ({} vertices, {} indices)", filename, view.Version, endTime - startTime, view.NumVertices, view.NumIndices);
+
+	return result;
+}
 
-	// Get the file size so we can avoid reading past the end
-	file.seekg(0, std::ios::end);
-	size_t size = file.tellg();
-	file.seekg(0, std::ios::beg);
+bool OptimizedObjLoader::_ReadBinary(const uint8_t* data, size_t size, const std::string& filename, BinaryMeshView& result) {
+	// All versions start with the header bytes and a version code
+	if (size < sizeof(BinaryHeader) || memcmp(data, HEADER_BYTES, sizeof(HEADER_BYTES)) != 0) {
+		LOG_ERROR("\"{}\" is not a binary mesh file!", filename);
+		return false;
+	}
+	memcpy(&result.Version, data + offsetof(BinaryHeader, Version), sizeof(uint16_t));
+
+	// Handle our version
+	switch (result.Version) {
+		case 0x01: return _ReadBinaryV1(data, size, filename, result);
+		case 0x02: return _ReadBinaryV2(data, size, filename, result);
+		default:
+			LOG_ERROR("Unknown binary mesh version {} in \"{}\"", result.Version, filename);
+			return false;
+	}
+}
 
+bool OptimizedObjLoader::_ReadBinaryV1(const uint8_t* data, size_t size, const std::string& filename, BinaryMeshView& result) {
 	// Read the header from the file
 	BinaryHeader header = BinaryHeader();
-	if (size >= sizeof(BinaryHeader)) {
-		file.read(reinterpret_cast<char*>(&header), sizeof(BinaryHeader));
-	} else {
-		LOG_ERROR("Not enough data in the file!");
-		return nullptr;
+	memcpy(&header, data, sizeof(BinaryHeader));
+
+	// Determine how many bytes we need in the file
+	size_t requiredBytes =
+		sizeof(BinaryHeader) +
+		(header.NumAttributes * sizeof(BufferAttribute)) +
+		(header.VertexStride * (size_t)header.NumVertices) +
+		(header.NumIndices * GetIndexTypeSize(header.IndicesType));
+
+	// Make sure there's enough data in the file
+	if (size < requiredBytes) {
+		LOG_ERROR("Not enough data in the file \"{}\"!", filename);
+		return false;
 	}
 
-	// TODO: validate header
-
-	// Handle our version
-	if (header.Version == 0x01) {
-		// Determine how many bytes we need in the file
-		size_t requiredBytes =
-			sizeof(BinaryHeader) +
-			(header.NumAttributes * sizeof(BufferAttribute)) +
-			(header.VertexStride * (size_t)header.NumVertices) +
-			(header.NumIndices * GetIndexTypeSize(header.IndicesType));
-
-		// Make sure there's enough data in the file
-		if (size < requiredBytes) {
-			LOG_ERROR("Not enough data in the file!");
-			return nullptr;
+	// Read all attributes from the file, this is basically our VDECL
+	const uint8_t* cursor = data + sizeof(BinaryHeader);
+	result.VertexDeclaration.resize(header.NumAttributes);
+	memcpy(result.VertexDeclaration.data(), cursor, header.NumAttributes * sizeof(BufferAttribute));
+	cursor += header.NumAttributes * sizeof(BufferAttribute);
+
+	// Indices come before the vertices
+	result.Indices = cursor;
+	result.NumIndices = header.NumIndices;
+	result.IndicesType = header.IndicesType;
+	cursor += header.NumIndices * GetIndexTypeSize(header.IndicesType);
+
+	result.Vertices = cursor;
+	result.NumVertices = header.NumVertices;
+	result.VertexStride = header.VertexStride;
+
+	// Version 1 files did not store bounds, so we need to walk the positions
+	result.Bounds = AABB();
+	for (const BufferAttribute& attrib : result.VertexDeclaration) {
+		if (attrib.Usage == AttribUsage::Position && attrib.Type == AttributeType::Float && attrib.Size >= 3) {
+			for (size_t ix = 0; ix < header.NumVertices; ix++) {
+				glm::vec3 position;
+				memcpy(&position, result.Vertices + ix * header.VertexStride + attrib.Offset, sizeof(glm::vec3));
+				result.Bounds.Encapsulate(position);
+			}
+			break;
 		}
+	}
+	result.SubMeshes.clear();
 
-		// Read all attributes from the file, this is basically our VDECL
-		std::vector<BufferAttribute> vertexDeclaration;
-		vertexDeclaration.resize(header.NumAttributes);
-		for (int ix = 0; ix < header.NumAttributes; ix++) {
-			file.read(reinterpret_cast<char*>(&vertexDeclaration[ix]), sizeof(BufferAttribute));
-		}
+	return true;
+}
+
+bool OptimizedObjLoader::_ReadBinaryV2(const uint8_t* data, size_t size, const std::string& filename, BinaryMeshView& result) {
+	if (size < sizeof(BinaryHeaderV2)) {
+		LOG_ERROR("Not enough data in the file \"{}\"!", filename);
+		return false;
+	}
 
-		// These will have the buffer pointers
-		IndexBuffer::Sptr indices = nullptr;
-		VertexBuffer::Sptr vertices = nullptr;
-
-		// If we have index data, load it
-		if (header.NumIndices > 0) {
-			// Create index buffer
-			indices = IndexBuffer::Create(BufferUsage::StaticDraw);
-
-			// Create memory to store indices, then read from the file
-			void* dataStore = malloc(header.NumIndices * GetIndexTypeSize(header.IndicesType));
-			file.read(reinterpret_cast<char*>(dataStore), header.NumIndices * GetIndexTypeSize(header.IndicesType));
-			
-			// Load data into OpenGL and free the CPU memory we allocated
-			indices->LoadData(dataStore, GetIndexTypeSize(header.IndicesType), header.NumIndices, header.IndicesType);
-			free(dataStore);
+	BinaryHeaderV2 header = BinaryHeaderV2();
+	memcpy(&header, data, sizeof(BinaryHeaderV2));
+
+	// Make sure all the sections are aligned and fit inside the file
+	auto checkSection = [&](uint64_t offset, uint64_t length) {
+		return (offset % 16) == 0 && offset <= size && length <= size - offset;
+	};
+	const size_t indexSize = GetIndexTypeSize(header.IndicesType);
+	if (!checkSection(header.AttributesOffset, header.NumAttributes * (uint64_t)sizeof(BufferAttribute)) ||
+		!checkSection(header.SubMeshesOffset, header.NumSubMeshes * (uint64_t)sizeof(BinarySubMesh)) ||
+		!checkSection(header.IndicesOffset, header.NumIndices * (uint64_t)indexSize) ||
+		!checkSection(header.VerticesOffset, header.NumVertices * (uint64_t)header.VertexStride) ||
+		(header.NumIndices > 0 && indexSize == 0)) {
+		LOG_ERROR("Binary mesh \"{}\" is corrupt or truncated!", filename);
+		return false;
+	}
+
+	// Submeshes become draw ranges, so they need to stay inside the index data
+	const BinarySubMesh* subMeshes = reinterpret_cast<const BinarySubMesh*>(data + header.SubMeshesOffset);
+	for (uint32_t ix = 0; ix < header.NumSubMeshes; ix++) {
+		if ((uint64_t)subMeshes[ix].IndexOffset + (uint64_t)subMeshes[ix].IndexCount > (uint64_t)header.NumIndices) {
+			LOG_WARN("Binary mesh \"{}\" has a submesh with indices {} - {} outside of it's {} indices", filename,
+				subMeshes[ix].IndexOffset, (uint64_t)subMeshes[ix].IndexOffset + subMeshes[ix].IndexCount, header.NumIndices);
+			return false;
 		}
+	}
 
-		// Create a new VBO
-		vertices = VertexBuffer::Create(BufferUsage::StaticDraw);
+	// The vertex declaration is small, so we take a copy of it
+	result.VertexDeclaration.resize(header.NumAttributes);
+	memcpy(result.VertexDeclaration.data(), data + header.AttributesOffset, header.NumAttributes * sizeof(BufferAttribute));
+
+	// Index and vertex data are left in place
+	result.Indices = data + header.IndicesOffset;
+	result.NumIndices = header.NumIndices;
+	result.IndicesType = header.IndicesType;
+	result.Vertices = data + header.VerticesOffset;
+	result.NumVertices = header.NumVertices;
+	result.VertexStride = header.VertexStride;
+
+	// Bounds are precomputed by the converter
+	result.Bounds = AABB(
+		glm::vec3(header.BoundsMin[0], header.BoundsMin[1], header.BoundsMin[2]),
+		glm::vec3(header.BoundsMax[0], header.BoundsMax[1], header.BoundsMax[2]));
+
+	result.SubMeshes.resize(header.NumSubMeshes);
+	for (uint32_t ix = 0; ix < header.NumSubMeshes; ix++) {
+		result.SubMeshes[ix].IndexOffset = subMeshes[ix].IndexOffset;
+		result.SubMeshes[ix].IndexCount  = subMeshes[ix].IndexCount;
+		result.SubMeshes[ix].Bounds = AABB(
+			glm::vec3(subMeshes[ix].BoundsMin[0], subMeshes[ix].BoundsMin[1], subMeshes[ix].BoundsMin[2]),
+			glm::vec3(subMeshes[ix].BoundsMax[0], subMeshes[ix].BoundsMax[1], subMeshes[ix].BoundsMax[2]));
+	}
 
-		// Create memory to store vertices and load from file
-		void* vertexStore = malloc(header.NumVertices * (size_t)header.VertexStride);
-		file.read(reinterpret_cast<char*>(vertexStore), header.NumVertices * (size_t)header.VertexStride);
+	return true;
+}
 
-		// Load data into OpenGL and free the CPU copy
-		vertices->LoadData(vertexStore, header.VertexStride, header.NumVertices);
-		free(vertexStore);
+// Gets the size in bytes of a single component of an attribute
+static size_t GetAttributeTypeSize(AttributeType type) {
+	switch (type) {
+		case AttributeType::Byte:
+		case AttributeType::UByte:     return 1;
+		case AttributeType::Short:
+		case AttributeType::UShort:
+		case AttributeType::HalfFloat: return 2;
+		case AttributeType::Int:
+		case AttributeType::UInt:
+		case AttributeType::Float:     return 4;
+		case AttributeType::Double:    return 8;
+		default:                       return 0;
+	}
+}
 
-		// Create the VAO and attach our index and vertex buffers
-		VertexArrayObject::Sptr result = VertexArrayObject::Create();
-		result->SetIndexBuffer(indices);
-		result->AddVertexBuffer(vertices, vertexDeclaration);
+// Rounds a value up to the next multiple of alignment
+static size_t AlignTo(size_t value, size_t alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
 
-		// Copy in the vertex declaration we loaded
-		result->SetVDecl(vertexDeclaration);
+void OptimizedObjLoader::_WriteBinaryFile(const std::string& outFilename,
+	const uint8_t* vertexData, uint32_t numVertices, uint16_t vertexStride, const VertexArrayObject::VertexDeclaration& vDecl,
+	const uint32_t* indices, uint32_t numIndices,
+	const std::vector<VertexArrayObject::SubMesh>& subMeshes, BinaryMeshFlags flags)
+{
+	// Work out the output layout, quantizing attributes if we've been asked to. Each attribute
+	// is kept 4 byte aligned, since some drivers are very slow with unaligned attributes
+	enum class Encoding { Copy, Snorm16, Half };
+	std::vector<BufferAttribute> outDecl = vDecl;
+	std::vector<Encoding> encodings(vDecl.size(), Encoding::Copy);
+	size_t outStride = 0;
+	for (size_t ix = 0; ix < vDecl.size(); ix++) {
+		const BufferAttribute& attrib = vDecl[ix];
+		BufferAttribute& outAttrib = outDecl[ix];
+		const bool isFloat = attrib.Type == AttributeType::Float && !attrib.Normalized;
+
+		if (*(flags & BinaryMeshFlags::QuantizeNormals) && isFloat && attrib.Size == 3 &&
+			(attrib.Usage == AttribUsage::Normal || attrib.Usage == AttribUsage::Tangent || attrib.Usage == AttribUsage::BiTangent)) {
+			// Padded out to 4 components to keep things aligned, the shader will ignore the W
+			encodings[ix] = Encoding::Snorm16;
+			outAttrib.Type = AttributeType::Short;
+			outAttrib.Size = 4;
+			outAttrib.Normalized = true;
+		}
+		else if (*(flags & BinaryMeshFlags::QuantizeUVs) && isFloat &&
+			(attrib.Usage == AttribUsage::Texture || attrib.Usage == AttribUsage::Texture1 || attrib.Usage == AttribUsage::Texture2 || attrib.Usage == AttribUsage::Texture3)) {
+			encodings[ix] = Encoding::Half;
+			outAttrib.Type = AttributeType::HalfFloat;
+		}
 
-		// Calculate and trace out how long it took us to load
-		float endTime = static_cast<float>(glfwGetTime());
-		LOG_TRACE("Loaded OBJ file \"{}\" in {} seconds ({} vertices, {} indices)", filename, endTime - startTime, header.NumVertices, header.NumIndices);
+		outAttrib.Offset = static_cast<GLsizei>(outStride);
+		outStride = AlignTo(outStride + outAttrib.Size * GetAttributeTypeSize(outAttrib.Type), 4);
+	}
+	if (outStride == 0 || outStride > UINT16_MAX) {
+		LOG_ERROR("Cannot save mesh to \"{}\", invalid vertex layout", outFilename);
+		return;
+	}
+	for (BufferAttribute& attrib : outDecl) {
+		attrib.Stride = static_cast<GLsizei>(outStride);
+	}
 
+	// Find our positions so we can calculate bounds
+	int positionAttrib = -1;
+	for (size_t ix = 0; ix < vDecl.size(); ix++) {
+		if (vDecl[ix].Usage == AttribUsage::Position && vDecl[ix].Type == AttributeType::Float && vDecl[ix].Size >= 3) {
+			positionAttrib = static_cast<int>(ix);
+			break;
+		}
+	}
+	auto getPosition = [&](uint32_t vertex) {
+		glm::vec3 result;
+		memcpy(&result, vertexData + vertex * (size_t)vertexStride + vDecl[positionAttrib].Offset, sizeof(glm::vec3));
 		return result;
+	};
+
+	// Re-encode the vertices into the output layout
+	std::vector<uint8_t> outVertices(outStride * numVertices, 0);
+	AABB bounds;
+	for (uint32_t vert = 0; vert < numVertices; vert++) {
+		const uint8_t* source = vertexData + vert * (size_t)vertexStride;
+		uint8_t* dest = outVertices.data() + vert * outStride;
+
+		for (size_t ix = 0; ix < vDecl.size(); ix++) {
+			const uint8_t* attribSource = source + vDecl[ix].Offset;
+			uint8_t* attribDest = dest + outDecl[ix].Offset;
+
+			switch (encodings[ix]) {
+				case Encoding::Snorm16:
+					for (int c = 0; c < 3; c++) {
+						float value;
+						memcpy(&value, attribSource + c * sizeof(float), sizeof(float));
+						uint16_t packed = glm::packSnorm1x16(value);
+						memcpy(attribDest + c * sizeof(uint16_t), &packed, sizeof(uint16_t));
+					}
+					break;
+				case Encoding::Half:
+					for (int c = 0; c < vDecl[ix].Size; c++) {
+						float value;
+						memcpy(&value, attribSource + c * sizeof(float), sizeof(float));
+						uint16_t packed = glm::packHalf1x16(value);
+						memcpy(attribDest + c * sizeof(uint16_t), &packed, sizeof(uint16_t));
+					}
+					break;
+				case Encoding::Copy:
+				default:
+					memcpy(attribDest, attribSource, vDecl[ix].Size * GetAttributeTypeSize(vDecl[ix].Type));
+					break;
+			}
+		}
+
+		if (positionAttrib >= 0) {
+			bounds.Encapsulate(getPosition(vert));
+		}
 	}
 
-	return nullptr;
+	// Calculate the bounds of each sub-mesh
+	std::vector<BinarySubMesh> outSubMeshes;
+	outSubMeshes.reserve(subMeshes.size());
+	for (const VertexArrayObject::SubMesh& subMesh : subMeshes) {
+		AABB subBounds;
+		const uint32_t count = numIndices > 0 ? numIndices : numVertices;
+		const uint32_t end = std::min(subMesh.IndexOffset + subMesh.IndexCount, count);
+		for (uint32_t ix = subMesh.IndexOffset; positionAttrib >= 0 && ix < end; ix++) {
+			subBounds.Encapsulate(getPosition(numIndices > 0 ? indices[ix] : ix));
+		}
+		if (!subBounds.IsValid()) {
+			subBounds = AABB(glm::vec3(0.0f), glm::vec3(0.0f));
+		}
+
+		BinarySubMesh outSubMesh;
+		outSubMesh.IndexOffset = subMesh.IndexOffset;
+		outSubMesh.IndexCount = subMesh.IndexCount;
+		memcpy(outSubMesh.BoundsMin, &subBounds.Min, sizeof(glm::vec3));
+		memcpy(outSubMesh.BoundsMax, &subBounds.Max, sizeof(glm::vec3));
+		outSubMeshes.push_back(outSubMesh);
+	}
+
+	// Narrow the indices if we can
+	const bool shortIndices = *(flags & BinaryMeshFlags::ShortIndices) && numVertices <= UINT16_MAX;
+	std::vector<uint16_t> indices16;
+	if (shortIndices) {
+		indices16.resize(numIndices);
+		for (uint32_t ix = 0; ix < numIndices; ix++) {
+			indices16[ix] = static_cast<uint16_t>(indices[ix]);
+		}
+	}
+	const size_t indexSize = shortIndices ? sizeof(uint16_t) : sizeof(uint32_t);
+
+	// Lay out all the sections at 16 byte boundaries
+	BinaryHeaderV2 header = BinaryHeaderV2();
+	header.Flags = *flags;
+	header.NumVertices = numVertices;
+	header.NumIndices = numIndices;
+	header.IndicesType = numIndices > 0 ? (shortIndices ? IndexType::UShort : IndexType::UInt) : IndexType::Unknown;
+	header.VertexStride = static_cast<uint16_t>(outStride);
+	header.NumAttributes = static_cast<uint8_t>(outDecl.size());
+	header.NumSubMeshes = static_cast<uint32_t>(outSubMeshes.size());
+	if (!bounds.IsValid()) {
+		bounds = AABB(glm::vec3(0.0f), glm::vec3(0.0f));
+	}
+	memcpy(header.BoundsMin, &bounds.Min, sizeof(glm::vec3));
+	memcpy(header.BoundsMax, &bounds.Max, sizeof(glm::vec3));
+	header.AttributesOffset = sizeof(BinaryHeaderV2);
+	header.SubMeshesOffset = AlignTo(header.AttributesOffset + outDecl.size() * sizeof(BufferAttribute), 16);
+	header.IndicesOffset = AlignTo(header.SubMeshesOffset + outSubMeshes.size() * sizeof(BinarySubMesh), 16);
+	header.VerticesOffset = AlignTo(header.IndicesOffset + numIndices * indexSize, 16);
+
+	// Open the output file
+	std::ofstream file(outFilename, std::ios::binary);
+	if (!file) {
+		throw std::runtime_error("Failed to open output file");
+	}
+
+	// Writes a section, padding the file up to the section's offset first
+	auto writeSection = [&](uint64_t offset, const void* sectionData, size_t length) {
+		static const char padding[16] = { 0 };
+		size_t position = static_cast<size_t>(file.tellp());
+		if (offset > position) {
+			file.write(padding, offset - position);
+		}
+		if (length > 0) {
+			file.write(reinterpret_cast<const char*>(sectionData), length);
+		}
+	};
+
+	writeSection(0, &header, sizeof(BinaryHeaderV2));
+	writeSection(header.AttributesOffset, outDecl.data(), outDecl.size() * sizeof(BufferAttribute));
+	writeSection(header.SubMeshesOffset, outSubMeshes.data(), outSubMeshes.size() * sizeof(BinarySubMesh));
+	writeSection(header.IndicesOffset, shortIndices ? (const void*)indices16.data() : (const void*)indices, numIndices * indexSize);
+	writeSection(header.VerticesOffset, outVertices.data(), outVertices.size());
 }
@@ -13,9 +13,28 @@
 
 #include "Utils/MeshBuilder.h"
 
+/// <summary>
+/// Options for how mesh data is stored in version 2 binary mesh files
+/// </summary>
+ENUM_FLAGS(BinaryMeshFlags, uint16_t,
+	None            = 0,
+	// Store normals, tangents and bitangents as normalized 16 bit integers
+	QuantizeNormals = 1 << 0,
+	// Store texture coordinates as half floats
+	QuantizeUVs     = 1 << 1,
+	// Store indices as 16 bit integers when the mesh has few enough vertices
+	ShortIndices    = 1 << 2,
+
+	Default         = ShortIndices
+);
+
 /// <summary>
 /// An optimized OBJ loader that can convert an OBJ file to a binary representation
 /// that we can load significantly faster
+///
+/// Version 2 binary files have every section aligned to 16 bytes, and are memory mapped
+/// when loaded so that the vertex and index data can be handed straight to OpenGL. Version
+/// 1 files can still be loaded, and can be upgraded with ConvertToBinary
 /// </summary>
 class OptimizedObjLoader {
 public:
@@ -27,23 +46,27 @@ public:
 	/// <returns>A VAO loaded from disk</returns>
 	static VertexArrayObject::Sptr LoadFromFile(const std::string& filename);
 	/// <summary>
-	/// Manually converts an OBJ file into a binary mesh file
+	/// Manually converts an OBJ file into a binary mesh file. If the input is a binary mesh file, it
+	/// will be re-written in the latest version of the format
 	/// </summary>
-	/// <param name="inFile">The path to OBJ file to convert</param>
+	/// <param name="inFile">The path to OBJ or bin file to convert</param>
 	/// <param name="outFile">The output path for the bin file, or empty to use the inFile path and replace the extension with .bin</param>
-	static void ConvertToBinary(const std::string& inFile, const std::string& outFile = "");
+	/// <param name="flags">Options for how the data should be stored</param>
+	static void ConvertToBinary(const std::string& inFile, const std::string& outFile = "", BinaryMeshFlags flags = BinaryMeshFlags::Default);
 
 	/// <summary>
 	/// Saves a mesh builder of the given type to a binary file
 	/// </summary>
-	/// <typeparam name="VertexType"></typeparam>
-	/// <param name="mesh"></param>
-	/// <param name="outFilename"></param>
+	/// <typeparam name="VertexType">The type of vertex stored in the mesh</typeparam>
+	/// <param name="mesh">The mesh to save</param>
+	/// <param name="outFilename">The path to write the file to</param>
+	/// <param name="flags">Options for how the data should be stored</param>
+	/// <param name="subMeshes">The ranges of indices that make up separate parts of the mesh, bounds will be calculated when saving</param>
 	template <typename VertexType>
-	static void SaveBinaryFile(MeshBuilder<VertexType>& mesh, const std::string& outFilename);
+	static void SaveBinaryFile(MeshBuilder<VertexType>& mesh, const std::string& outFilename, BinaryMeshFlags flags = BinaryMeshFlags::Default, const std::vector<VertexArrayObject::SubMesh>& subMeshes = {});
 
 protected:
-	// Will be put at the start of the binary file, contains info about the contents of the file
+	// Will be put at the start of version 1 binary files, contains info about the contents of the file
 	struct BinaryHeader {
 		// A check value so we can ensure that we're loading in the right file type
 		char      HeaderBytes[4] ={ 'B', 'O', 'B', 'J' };
@@ -61,42 +84,82 @@ protected:
 		uint8_t   NumAttributes = 0;
 	};
 
+	// Header for version 2 binary files. The magic bytes and version are in the same place as in
+	// version 1, and every section is stored at a 16 byte aligned offset from the start of the file
+	struct BinaryHeaderV2 {
+		char      HeaderBytes[4] ={ 'B', 'O', 'B', 'J' };
+		uint16_t  Version = 0x02;
+		// A combination of BinaryMeshFlags
+		uint16_t  Flags = 0;
+		uint32_t  NumVertices = 0;
+		uint32_t  NumIndices = 0;
+		IndexType IndicesType = IndexType::Unknown;
+		uint16_t  VertexStride = 0;
+		uint8_t   NumAttributes = 0;
+		uint8_t   Reserved0 = 0;
+		uint32_t  NumSubMeshes = 0;
+		uint32_t  Reserved1 = 0;
+		// Object-space bounds of the whole mesh
+		float     BoundsMin[3] ={ 0.0f, 0.0f, 0.0f };
+		float     BoundsMax[3] ={ 0.0f, 0.0f, 0.0f };
+		// Byte offsets from the start of the file to each section
+		uint64_t  AttributesOffset = 0;
+		uint64_t  SubMeshesOffset = 0;
+		uint64_t  IndicesOffset = 0;
+		uint64_t  VerticesOffset = 0;
+		uint64_t  Reserved2 = 0;
+	};
+	static_assert(sizeof(BinaryHeaderV2) % 16 == 0, "Binary header must keep sections aligned");
+
+	// A sub-mesh entry as it is stored in version 2 files
+	struct BinarySubMesh {
+		uint32_t IndexOffset;
+		uint32_t IndexCount;
+		float    BoundsMin[3];
+		float    BoundsMax[3];
+	};
+
 	OptimizedObjLoader() = default;
 	~OptimizedObjLoader() = default;
 
-	static MeshBuilder<VertexPosNormTexColTangents>* _LoadFromObjFile(const std::string& filename);
+	static MeshBuilder<VertexPosNormTexColTangents>* _LoadFromObjFile(const std::string& filename, std::vector<VertexArrayObject::SubMesh>* subMeshes = nullptr);
 	static VertexArrayObject::Sptr _LoadFromBinFile(const std::string& filename);
-};
 
-template <typename VertexType>
-void OptimizedObjLoader::SaveBinaryFile(MeshBuilder<VertexType>& mesh, const std::string& outFilename) {
-	// Open the output file
-	std::ofstream file(outFilename, std::ios::binary);
-	if (!file) {
-		throw std::runtime_error("Failed to open output file");
-	}
-
-	// Create the fixed size header for our output file
-	BinaryHeader header  = BinaryHeader();
-	header.Version       = 0x01; // This is version 1! Update this and implement different readers if changes to format are made
-	header.NumIndices    = mesh.GetIndexCount();
-	header.IndicesType   = IndexType::UInt;
-	header.NumVertices   = mesh.GetVertexCount();
-	header.VertexStride  = sizeof(VertexType);
-	header.NumAttributes = VertexType::V_DECL.size();
+	// Points into the contents of a binary mesh file that has been loaded into memory
+	struct BinaryMeshView {
+		uint16_t                                Version = 0;
+		std::vector<BufferAttribute>            VertexDeclaration;
+		const uint8_t*                          Indices = nullptr;
+		uint32_t                                NumIndices = 0;
+		IndexType                               IndicesType = IndexType::Unknown;
+		const uint8_t*                          Vertices = nullptr;
+		uint32_t                                NumVertices = 0;
+		uint16_t                                VertexStride = 0;
+		AABB                                    Bounds;
+		std::vector<VertexArrayObject::SubMesh> SubMeshes;
+	};
 
-	// Write header bytes to the stream
-	file.write(reinterpret_cast<const char*>(&header), sizeof(BinaryHeader));
+	/// <summary>
+	/// Validates a binary mesh file of any version, and finds where all the data is
+	/// </summary>
+	/// <returns>True if the file is valid</returns>
+	static bool _ReadBinary(const uint8_t* data, size_t size, const std::string& filename, BinaryMeshView& result);
+	static bool _ReadBinaryV1(const uint8_t* data, size_t size, const std::string& filename, BinaryMeshView& result);
+	static bool _ReadBinaryV2(const uint8_t* data, size_t size, const std::string& filename, BinaryMeshView& result);
 
-	// Write which attributes we have to the stream
-	for (int ix = 0; ix < VertexType::V_DECL.size(); ix++) {
-		file.write(reinterpret_cast<const char*>(&VertexType::V_DECL[ix]), sizeof(BufferAttribute));
-	}
-	// Write any index data to the file
-	if (mesh.GetIndexCount() > 0) {
-		file.write(reinterpret_cast<const char*>(mesh.GetIndexDataPtr()), mesh.GetIndexCount() * sizeof(uint32_t));
-	}
+	/// <summary>
+	/// Writes raw mesh data to a version 2 binary file, quantizing attributes as requested by the flags
+	/// </summary>
+	static void _WriteBinaryFile(const std::string& outFilename,
+		const uint8_t* vertexData, uint32_t numVertices, uint16_t vertexStride, const VertexArrayObject::VertexDeclaration& vDecl,
+		const uint32_t* indices, uint32_t numIndices,
+		const std::vector<VertexArrayObject::SubMesh>& subMeshes, BinaryMeshFlags flags);
+};
 
-	// Write vertex data to file
-	file.write(reinterpret_cast<const char*>(mesh.GetVertexDataPtr()), mesh.GetVertexCount() * sizeof(VertexType));
+template <typename VertexType>
+void OptimizedObjLoader::SaveBinaryFile(MeshBuilder<VertexType>& mesh, const std::string& outFilename, BinaryMeshFlags flags, const std::vector<VertexArrayObject::SubMesh>& subMeshes) {
+	_WriteBinaryFile(outFilename,
+		reinterpret_cast<const uint8_t*>(mesh.GetVertexDataPtr()), static_cast<uint32_t>(mesh.GetVertexCount()), sizeof(VertexType), VertexType::V_DECL,
+		mesh.GetIndexDataPtr(), static_cast<uint32_t>(mesh.GetIndexCount()),
+		subMeshes, flags);
 }
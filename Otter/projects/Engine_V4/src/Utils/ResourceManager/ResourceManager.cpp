@@ -3,12 +3,28 @@
 #include "Utils/ObjLoader.h"
 #include "Utils/FileHelpers.h"
 #include "Utils/StringUtils.h"
+#include "Logging.h"
 
-std::map<std::type_index, std::map<Guid, IResource::Sptr>> ResourceManager::_resources;
+#include <chrono>
+#include <limits>
+
+std::deque<ResourceManager::TypeStore> ResourceManager::_stores;
 std::map<std::string, std::function<Guid(const nlohmann::json&)>> ResourceManager::_typeLoaders;
 
 nlohmann::ordered_json ResourceManager::_manifest;
 
+std::map<std::string, ResourceManager::AsyncTypeLoader> ResourceManager::_asyncLoaders;
+std::map<Guid, ResourceManager::PendingLoad::Sptr> ResourceManager::_pendingLoads;
+
+std::vector<std::thread> ResourceManager::_workers;
+std::deque<ResourceManager::PendingLoad::Sptr> ResourceManager::_jobQueue;
+std::mutex ResourceManager::_jobMutex;
+std::condition_variable ResourceManager::_jobCondition;
+std::deque<ResourceManager::PendingLoad::Sptr> ResourceManager::_uploadQueue;
+std::mutex ResourceManager::_uploadMutex;
+std::condition_variable ResourceManager::_uploadCondition;
+std::atomic_bool ResourceManager::_workersRunning = false;
+
 void ResourceManager::Init() {
 	// TODO: initialize the resource manager once it's a bit more complex
 	//_manifest["textures"]  = std::vector<nlohmann::json>();
@@ -21,40 +37,288 @@ const nlohmann::ordered_json& ResourceManager::GetManifest() {
 	return _manifest;
 }
 
-void ResourceManager::LoadManifest(const std::string& path, bool preloadAssets) {
+void ResourceManager::LoadManifest(const std::string& path, bool preloadAssets, bool blockUntilLoaded) {
 	std::string contents = FileHelpers::ReadFile(path);
 	nlohmann::ordered_json blob = nlohmann::ordered_json::parse(contents);
 	_manifest = blob;
 
 	if (preloadAssets) {
+		// Types are stored in the order they were registered, so dependencies get queued (and thus
+		// uploaded) first. If a resource needs one that isn't ready yet, Get will finish it on the spot
 		for (auto& [typeName, items] : blob.items()) {
-			auto& func = _typeLoaders[typeName];
-			if (func) {
-				for (auto& [guid, blob] : items.items()) {
-					func(blob);
+			if (_asyncLoaders.find(typeName) == _asyncLoaders.end()) {
+				continue;
+			}
+			for (auto& [guid, item] : items.items()) {
+				Guid id = Guid(guid);
+				if (_pendingLoads.find(id) == _pendingLoads.end()) {
+					_QueueLoad(typeName, id, item);
 				}
 			}
 		}
+
+		if (blockUntilLoaded) {
+			WaitForPendingLoads();
+		}
+	}
+}
+
+uint32_t ResourceManager::_AddTypeStore(const std::string& typeName) {
+	_stores.emplace_back();
+	_stores.back().Name = typeName;
+	return static_cast<uint32_t>(_stores.size() - 1);
+}
+
+bool ResourceManager::_LoadMissing(uint32_t typeId, const Guid& id) {
+	// If the asset is currently being loaded in the background, finish it now
+	if (_FinishPendingLoad(id)) {
+		return true;
+	}
+
+	// If the manifest has an entry, we can load it! Note that we use find here, so that
+	// misses don't add anything to the manifest
+	const std::string& typeName = _stores[typeId].Name;
+	auto manifestType = _manifest.find(typeName);
+	if (manifestType == _manifest.end()) {
+		return false;
+	}
+	auto item = manifestType->find(id.str());
+	auto loader = _typeLoaders.find(typeName);
+	if (item == manifestType->end() || loader == _typeLoaders.end()) {
+		return false;
+	}
+
+	// Invoke the loader function with the manifest data
+	loader->second(*item);
+	return true;
+}
+
+int ResourceManager::ProcessUploads(double budgetMs) {
+	using Clock = std::chrono::high_resolution_clock;
+	Clock::time_point start = Clock::now();
+
+	int processed = 0;
+	while (true) {
+		PendingLoad::Sptr load = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(_uploadMutex);
+			if (_uploadQueue.empty()) {
+				break;
+			}
+			load = _uploadQueue.front();
+			_uploadQueue.pop_front();
+		}
+
+		// The load may have already been finished early by a call to Get
+		auto it = _pendingLoads.find(load->Id);
+		if (it != _pendingLoads.end() && it->second == load) {
+			_Upload(load);
+			processed++;
+		}
+
+		std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+		if (elapsed.count() >= budgetMs) {
+			break;
+		}
+	}
+	return processed;
+}
+
+void ResourceManager::WaitForPendingLoads() {
+	while (!_pendingLoads.empty()) {
+		// Finish everything that's been decoded so far
+		ProcessUploads(std::numeric_limits<double>::max());
+		if (_pendingLoads.empty()) {
+			break;
+		}
+
+		// Wait for the workers to hand us more, we use a timeout as loads may be finished via Get
+		// while we're uploading, without anything being added to the queue
+		std::unique_lock<std::mutex> lock(_uploadMutex);
+		_uploadCondition.wait_for(lock, std::chrono::milliseconds(5), [] { return !_uploadQueue.empty(); });
+	}
+}
+
+size_t ResourceManager::GetPendingLoadCount() {
+	return _pendingLoads.size();
+}
+
+ResourceManager::PendingLoad::Sptr ResourceManager::_QueueLoad(const std::string& typeName, const Guid& id, const nlohmann::json& data) {
+	auto it = _asyncLoaders.find(typeName);
+	if (it == _asyncLoaders.end()) {
+		LOG_WARN("Cannot load \"{}\", type {} has not been registered", id.str(), typeName);
+		return nullptr;
+	}
+
+	PendingLoad::Sptr load = std::make_shared<PendingLoad>(it->second.TypeId);
+	load->TypeName = typeName;
+	load->Id = id;
+	load->Data = data;
+	load->Decode = it->second.Decode;
+	_pendingLoads[id] = load;
+
+	// Types that can't decode off the main thread go straight to the upload queue
+	if (it->second.Decode == nullptr) {
+		load->State = ResourceLoadState::Decoded;
+		std::lock_guard<std::mutex> lock(_uploadMutex);
+		_uploadQueue.push_back(load);
+	} else {
+		_StartWorkers();
+		{
+			std::lock_guard<std::mutex> lock(_jobMutex);
+			_jobQueue.push_back(load);
+		}
+		_jobCondition.notify_one();
+	}
+	return load;
+}
+
+bool ResourceManager::_FinishPendingLoad(const Guid& id) {
+	auto it = _pendingLoads.find(id);
+	if (it == _pendingLoads.end()) {
+		return false;
+	}
+	// Grab a copy, since finishing the load will remove it from the map
+	PendingLoad::Sptr load = it->second;
+	_FinishPendingLoad(load);
+	return true;
+}
+
+void ResourceManager::_FinishPendingLoad(const PendingLoad::Sptr& load) {
+	// Nothing to do if it's already been finished
+	auto it = _pendingLoads.find(load->Id);
+	if (it == _pendingLoads.end() || it->second != load) {
+		return;
+	}
+
+	// If no worker has started on it yet, do the work ourselves instead of waiting in line
+	_Decode(load);
+
+	// Otherwise a worker is busy with it, so wait for it to finish
+	{
+		std::unique_lock<std::mutex> lock(_uploadMutex);
+		_uploadCondition.wait(lock, [&] { return load->State != ResourceLoadState::Decoding; });
+	}
+
+	// The load will also still be in the upload queue, ProcessUploads will skip it
+	_Upload(load);
+}
+
+void ResourceManager::_Decode(const PendingLoad::Sptr& load) {
+	// Only one thread gets to decode a load, whoever moves it out of the queued state first
+	ResourceLoadState expected = ResourceLoadState::Queued;
+	if (!load->State.compare_exchange_strong(expected, ResourceLoadState::Decoding)) {
+		return;
+	}
+
+	ResourceLoadState result = ResourceLoadState::Decoded;
+	try {
+		load->Decoded = load->Decode(load->Data);
+	}
+	catch (const std::exception& e) {
+		LOG_ERROR("Failed to decode {} \"{}\": {}", load->TypeName, load->Id.str(), e.what());
+		result = ResourceLoadState::Failed;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_uploadMutex);
+		load->State = result;
+		_uploadQueue.push_back(load);
+	}
+	_uploadCondition.notify_all();
+}
+
+void ResourceManager::_Upload(const PendingLoad::Sptr& load) {
+	if (load->State == ResourceLoadState::Decoded) {
+		IResource::Sptr resource = _asyncLoaders[load->TypeName].Create(load->Data, load->Decoded);
+		if (resource != nullptr) {
+			resource->OverrideGUID(load->Id);
+			_stores[load->TypeId].Resources.Set(load->Id, resource);
+			load->Resource = resource;
+			load->State = ResourceLoadState::Ready;
+		} else {
+			load->State = ResourceLoadState::Failed;
+		}
+	}
+
+	if (load->State == ResourceLoadState::Failed) {
+		LOG_WARN("Failed to load {} \"{}\"", load->TypeName, load->Id.str());
+	}
+
+	// The decoded data is no longer needed, and the load is no longer pending
+	load->Decoded = nullptr;
+	_pendingLoads.erase(load->Id);
+}
+
+void ResourceManager::_StartWorkers() {
+	if (_workersRunning) {
+		return;
+	}
+	_workersRunning = true;
+
+	// Leave a core for the main thread, which will be busy with uploads
+	const unsigned int cores = std::thread::hardware_concurrency();
+	const unsigned int workerCount = cores > 2 ? cores - 1 : 1;
+	for (unsigned int ix = 0; ix < workerCount; ix++) {
+		_workers.emplace_back(&ResourceManager::_WorkerMain);
+	}
+}
+
+void ResourceManager::_StopWorkers() {
+	{
+		std::lock_guard<std::mutex> lock(_jobMutex);
+		_workersRunning = false;
+		_jobQueue.clear();
+	}
+	_jobCondition.notify_all();
+
+	for (auto& worker : _workers) {
+		worker.join();
+	}
+	_workers.clear();
+}
+
+void ResourceManager::_WorkerMain() {
+	while (true) {
+		PendingLoad::Sptr load = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(_jobMutex);
+			_jobCondition.wait(lock, [] { return !_jobQueue.empty() || !_workersRunning; });
+			if (!_workersRunning) {
+				return;
+			}
+			load = _jobQueue.front();
+			_jobQueue.pop_front();
+		}
+		_Decode(load);
 	}
 }
 
 void ResourceManager::SaveManifest(const std::string& path) {
 	// Update all resources in the manifest so they match their current representation
-	for (auto& [type, map] : _resources) {
-		std::string typeName = StringTools::SanitizeClassName(type.name());
-		for (auto& [guid, res] : map) {
+	for (auto& store : _stores) {
+		store.Resources.Each([&](const Guid& guid, const IResource::Sptr& res) {
 			if (res != nullptr) {
-				_manifest[typeName][guid.str()] = res->ToJson();
-				_manifest[typeName][guid.str()]["guid"] = res->GetGUID().str();
+				_manifest[store.Name][guid.str()] = res->ToJson();
+				_manifest[store.Name][guid.str()]["guid"] = res->GetGUID().str();
 			}
-		}
+		});
 	}
 	FileHelpers::WriteContentsToFile(path, _manifest.dump(1,'\t'));
 }
 
 void ResourceManager::Cleanup() {
-	for (auto& [type, map] : _resources) {
-		map.clear();
+	_StopWorkers();
+	{
+		std::lock_guard<std::mutex> lock(_uploadMutex);
+		_uploadQueue.clear();
+	}
+	_pendingLoads.clear();
+
+	// Note that we keep the stores themselves, since their IDs are cached by type
+	for (auto& store : _stores) {
+		store.Resources.Clear();
+		store.Placeholder = nullptr;
 	}
 }
 
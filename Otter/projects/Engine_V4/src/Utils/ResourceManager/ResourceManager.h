@@ -3,17 +3,68 @@
 #include <json.hpp>
 #include <unordered_map>
 #include <typeindex>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <deque>
+#include <condition_variable>
+#include <EnumToString.h>
 
 #include "Utils/GUID.hpp"
 #include "Utils/ResourceManager/IResource.h"
+#include "Utils/ResourceManager/ResourceTable.h"
 #include "Utils/StringUtils.h"
+#include "Utils/TypeHelpers.h"
+
+/// <summary>
+/// The stages that a resource goes through when loaded via ResourceManager::LoadAsync
+/// </summary>
+ENUM(ResourceLoadState, int,
+	Queued   = 0, // Waiting for a worker thread to pick it up
+	Decoding = 1, // A worker thread is reading and decoding the source data
+	Decoded  = 2, // Waiting in the upload queue for the main thread
+	Ready    = 3, // The resource has been created and stored in the resource manager
+	Failed   = 4  // The resource could not be loaded
+);
+
+template <typename T>
+class ResourceHandle;
 
 /// <summary>
 /// Utility class for managing and loading resources from JSON
 /// manifest files
+/// 
+/// Resources can be loaded in the background via LoadAsync. Resource types that define both
+/// static std::shared_ptr<Type::DecodedData> DecodeFromJson(const nlohmann::json&);
+/// static std::shared_ptr<Type> FromDecoded(const nlohmann::json&, const std::shared_ptr<Type::DecodedData>&);
+/// will have their DecodeFromJson invoked on a worker thread (file IO, image decoding, mesh parsing),
+/// and their FromDecoded invoked on the main thread to create the OpenGL objects. Types without these
+/// are loaded entirely on the main thread via FromJson
 /// </summary>
 class ResourceManager {
 public:
+	/// <summary>
+	/// Tracks a single resource that is being loaded in the background
+	/// </summary>
+	struct PendingLoad {
+		typedef std::shared_ptr<PendingLoad> Sptr;
+
+		uint32_t                       TypeId;
+		std::string                    TypeName;
+		Guid                           Id;
+		// A copy of the manifest entry, so workers never touch the manifest
+		nlohmann::json                 Data;
+		std::atomic<ResourceLoadState> State;
+		// The type's DecodeFromJson, copied here so workers don't need to look it up
+		std::function<std::shared_ptr<void>(const nlohmann::json&)> Decode;
+		// The type-erased result of Decode
+		std::shared_ptr<void>          Decoded;
+		// The loaded resource, only valid once State is Ready
+		IResource::Sptr                Resource;
+
+		PendingLoad(uint32_t typeId) : TypeId(typeId), State(ResourceLoadState::Queued) {}
+	};
+
 	/// <summary>
 	/// Initializes the resource manager and performs any first-time
 	/// setup required
@@ -31,7 +82,8 @@ public:
 	static std::shared_ptr<T> CreateAsset(TArgs&&... args) {
 		// Create and store the asset
 		std::shared_ptr<T> asset = std::make_shared<T>(std::forward<TArgs>(args)...);
-		_resources[std::type_index(typeid(T))][asset->IResource::GetGUID()] = asset;
+		const uint32_t typeId = _TypeId<T>();
+		_stores[typeId].Resources.Set(asset->IResource::GetGUID(), asset);
 
 		// Get the JSON representation of the asset so we can store it in the manifest
 		nlohmann::json data = asset->ToJson();
@@ -41,7 +93,7 @@ public:
 		data["guid"] = guid;
 
 		// Store the JSON data in the resource manifest (based on the type's name)
-		_manifest[StringTools::SanitizeClassName(typeid(T).name())][guid] = data;
+		_manifest[_stores[typeId].Name][guid] = data;
 		return asset;
 	}
 
@@ -53,27 +105,68 @@ public:
 	/// <returns>The resource with the given GUID, or nullptr if none exists</returns>
 	template<typename T, typename = std::enable_if<is_valid_resource<T>()>::type>
 	static std::shared_ptr<T> Get(Guid id) {
-		// Try and grab the asset from the resource pool
-		std::shared_ptr<T> result =  std::dynamic_pointer_cast<T>(_resources[std::type_index(typeid(T))][id]);
+		// Try and grab the asset from the resource pool, each type has it's own table so we
+		// know the resource is a T without needing a dynamic cast
+		const uint32_t typeId = _TypeId<T>();
+		const uint64_t hash = ResourceTable::Hash(id);
+		const IResource::Sptr& result = _stores[typeId].Resources.Find(id, hash);
+		if (result != nullptr) {
+			return std::static_pointer_cast<T>(result);
+		}
 
-		// If the asset is null, we can try finding it in the manifest to load it
-		if (result == nullptr) {
-			// Get the type name it'll be stored under
-			std::string typeName = StringTools::SanitizeClassName(typeid(T).name());
+		// If the asset is null, we may still be able to load it
+		if (_LoadMissing(typeId, id)) {
+			return std::static_pointer_cast<T>(_stores[typeId].Resources.Find(id, hash));
+		}
 
-			// If the manifest has an entry, we can load it!
-			if (_manifest[typeName].contains(id)) {
-				// Invoke the loader function with the manifest data
-				_typeLoaders[typeName](_manifest[typeName][id]);
+		// Couldn't be found in the manifest, return here
+		return nullptr;
+	}
 
-				// Search resources again to get the resource
-				return std::dynamic_pointer_cast<T>(_resources[std::type_index(typeid(T))][id]);
-			}
-		}
+	/// <summary>
+	/// Starts loading the resource with the given type and GUID in the background. File IO and decoding
+	/// happen on worker threads, while the OpenGL objects are created on the main thread during ProcessUploads.
+	/// If the resource is already loaded, the handle will be ready immediately
+	/// </summary>
+	/// <typeparam name="T">The type of resource to load</typeparam>
+	/// <param name="id">The ID of the resource to load, must be in the manifest</param>
+	/// <returns>A handle that can be used to check on the load, or get the resource once it's ready</returns>
+	template<typename T, typename = std::enable_if<is_valid_resource<T>()>::type>
+	static ResourceHandle<T> LoadAsync(Guid id);
 
-		// If result wasn't null, or couldn't be found in the manifest, return here
-		return result;
+	/// <summary>
+	/// Sets the resource that handles of the given type will return while their resource is still loading
+	/// </summary>
+	/// <typeparam name="T">The type of resource to set the placeholder for</typeparam>
+	/// <param name="placeholder">The resource to return, or nullptr to clear the placeholder</param>
+	template<typename T, typename = std::enable_if<is_valid_resource<T>()>::type>
+	static void SetPlaceholder(const std::shared_ptr<T>& placeholder) {
+		_stores[_TypeId<T>()].Placeholder = placeholder;
 	}
+	/// <summary>
+	/// Gets the placeholder resource for the given type, or nullptr if none has been set
+	/// </summary>
+	template<typename T, typename = std::enable_if<is_valid_resource<T>()>::type>
+	static std::shared_ptr<T> GetPlaceholder() {
+		return std::static_pointer_cast<T>(_stores[_TypeId<T>()].Placeholder);
+	}
+
+	/// <summary>
+	/// Creates resources that have finished decoding on worker threads. This must be called from the
+	/// main thread, and will stop once the time budget has been used up (at least one resource will
+	/// always be processed if any are waiting)
+	/// </summary>
+	/// <param name="budgetMs">The maximum time to spend creating resources, in milliseconds</param>
+	/// <returns>The number of resources that were finished</returns>
+	static int ProcessUploads(double budgetMs = 4.0);
+	/// <summary>
+	/// Blocks until all background loads have completed, processing uploads as they arrive
+	/// </summary>
+	static void WaitForPendingLoads();
+	/// <summary>
+	/// Gets the number of resources that are still being loaded in the background
+	/// </summary>
+	static size_t GetPendingLoadCount();
 
 	/// <summary>
 	/// Registers a resource type with the resource manager, only types that have been registered
@@ -84,16 +177,36 @@ public:
 	template <typename T, typename = std::enable_if<is_valid_resource<T>()>::type>
 	static void RegisterType() {
 		// Extract the type name from a sanitized version of they typeid name
-		std::string typeName = StringTools::SanitizeClassName(typeid(T).name());
+		const uint32_t typeId = _TypeId<T>();
+		const std::string& typeName = _stores[typeId].Name;
 
 		// Create the type loader for the type
 		_typeLoaders[typeName] = [](const nlohmann::json& data) {
 			IResource::Sptr res = T::FromJson(data);
 			res->OverrideGUID(Guid(data["guid"]));
-			_resources[std::type_index(typeid(T))][res->GetGUID()] = res;
+			_stores[_TypeId<T>()].Resources.Set(res->GetGUID(), res);
 			return res->GetGUID();
 		};
 
+		// Create the background loader for the type, types that can decode off the main thread
+		// split their loading into two stages
+		AsyncTypeLoader& asyncLoader = _asyncLoaders[typeName];
+		asyncLoader.TypeId = typeId;
+		if constexpr (test_decode_json<T, const nlohmann::json&>::value) {
+			asyncLoader.Decode = [](const nlohmann::json& data) {
+				return std::static_pointer_cast<void>(T::DecodeFromJson(data));
+			};
+			asyncLoader.Create = [](const nlohmann::json& data, const std::shared_ptr<void>& decoded) {
+				typedef typename decltype(T::DecodeFromJson(data))::element_type DecodedType;
+				return std::static_pointer_cast<IResource>(T::FromDecoded(data, std::static_pointer_cast<DecodedType>(decoded)));
+			};
+		} else {
+			asyncLoader.Decode = nullptr;
+			asyncLoader.Create = [](const nlohmann::json& data, const std::shared_ptr<void>&) {
+				return std::static_pointer_cast<IResource>(T::FromJson(data));
+			};
+		}
+
 		// Make sure we haven't registered the type yet, then add an empty object
 		// to the manifest to ensure it can be saved
 		if (!_manifest.contains(typeName)) {
@@ -112,17 +225,13 @@ public:
 		typename = typename std::enable_if<std::is_base_of<IResource, ResourceType>::value>::type>
 		static void Each(std::function<void(const std::shared_ptr<ResourceType>&)> callback, bool includeDisabled = false) {
 
-		// We can use typeid and type_index to get a unique ID for our types
-		std::type_index type = std::type_index(typeid(ResourceType));
-
-		// Iterate over all the resources in the store
-		for (auto& [key, value] : _resources[type]) {
-			// If the pointer is alive and matches our enabled criteria, invoke the callback
+		// Iterate over all the resources in the store for the type
+		_stores[_TypeId<ResourceType>()].Resources.Each([&](const Guid&, const IResource::Sptr& value) {
+			// If the pointer is alive, cast to the resource type and invoke the callback
 			if (value != nullptr) {
-				// Upcast to resource type and invoke the callback
-				callback(std::dynamic_pointer_cast<ResourceType>(value));
+				callback(std::static_pointer_cast<ResourceType>(value));
 			}
-		}
+		});
 	}
 
 	/// <summary>
@@ -131,11 +240,14 @@ public:
 	static const nlohmann::ordered_json& GetManifest();
 	/// <summary>
 	/// Loads a manifest file into the resource manager. Note that this will not perform load on the assets themselves 
-	/// unless preloadAssets is set to true
+	/// unless preloadAssets is set to true. Preloaded assets are decoded in parallel on worker threads, in the order
+	/// that their types were registered so that dependencies (ex: shaders and textures) are created before the
+	/// resources that use them (ex: materials)
 	/// </summary>
 	/// <param name="path">The path to the JSON manifest file</param>
 	/// <param name="preloadAssets">True if all assets should be loaded into memory</param>
-	static void LoadManifest(const std::string& path, bool preloadAssets = false);
+	/// <param name="blockUntilLoaded">If false, preloaded assets will be streamed in via ProcessUploads instead of waiting for them here</param>
+	static void LoadManifest(const std::string& path, bool preloadAssets = false, bool blockUntilLoaded = true);
 	/// <summary>
 	/// Saves the manifest to the given JSON file
 	/// </summary>
@@ -143,17 +255,42 @@ public:
 	static void SaveManifest(const std::string& path);
 
 	/// <summary>
-	/// Releases all resources held by the resource manager
+	/// Releases all resources held by the resource manager, and stops the background loading threads
 	/// </summary>
 	static void Cleanup();
 
 protected:
+	template <typename T>
+	friend class ResourceHandle;
+
+	/// <summary>
+	/// Stores how to load a registered type in the background
+	/// </summary>
+	struct AsyncTypeLoader {
+		uint32_t TypeId = 0;
+		// Invoked on a worker thread, may be null if the type must be loaded on the main thread
+		std::function<std::shared_ptr<void>(const nlohmann::json&)> Decode;
+		// Invoked on the main thread with the result of Decode
+		std::function<IResource::Sptr(const nlohmann::json&, const std::shared_ptr<void>&)> Create;
+	};
+
+
 	/// <summary>
-	/// This is a map of maps
-	/// The top level map uses type_index, so there's a map per resource type
-	/// The inner map handles mapping GUIDs to the corresponding resource
+	/// Stores everything we know about a single type of resource
 	/// </summary>
-	static std::map<std::type_index, std::map<Guid, IResource::Sptr>> _resources;
+	struct TypeStore {
+		// The sanitized type name, used as the type's key in the manifest
+		std::string     Name;
+		// Maps GUIDs to the resources of this type
+		ResourceTable   Resources;
+		// The resource returned from handles while they are still loading
+		IResource::Sptr Placeholder;
+	};
+	/// <summary>
+	/// Stores each type of resource, indexed by the type's ID. We use a deque so that references
+	/// stay valid when new types are added
+	/// </summary>
+	static std::deque<TypeStore> _stores;
 	/// <summary>
 	/// This map stores registered types, so we can load them from JSON files
 	/// </summary>
@@ -164,4 +301,146 @@ protected:
 	/// This allows us to register dependencies before the dependent resource
 	/// </summary>
 	static nlohmann::ordered_json _manifest;
-};
\ No newline at end of file
+
+	// Background loading state, everything except the job and upload queues is main thread only
+	static std::map<std::string, AsyncTypeLoader> _asyncLoaders;
+	static std::map<Guid, PendingLoad::Sptr> _pendingLoads;
+
+	static std::vector<std::thread> _workers;
+	static std::deque<PendingLoad::Sptr> _jobQueue;
+	static std::mutex _jobMutex;
+	static std::condition_variable _jobCondition;
+	static std::deque<PendingLoad::Sptr> _uploadQueue;
+	static std::mutex _uploadMutex;
+	static std::condition_variable _uploadCondition;
+	static std::atomic_bool _workersRunning;
+
+	/// <summary>
+	/// Gets the ID for a resource type, which is an index into _stores. IDs are handed out the
+	/// first time each type is used, and the sanitized type name is cached along with it
+	/// </summary>
+	template <typename T>
+	static uint32_t _TypeId() {
+		static const uint32_t id = _AddTypeStore(StringTools::SanitizeClassName(typeid(T).name()));
+		return id;
+	}
+	static uint32_t _AddTypeStore(const std::string& typeName);
+	/// <summary>
+	/// Handles a lookup that missed the resource table, by finishing a background load or loading
+	/// the resource from the manifest
+	/// </summary>
+	/// <returns>True if the resource was loaded</returns>
+	static bool _LoadMissing(uint32_t typeId, const Guid& id);
+
+	/// <summary>
+	/// Queues a resource from the manifest to be loaded in the background
+	/// </summary>
+	/// <returns>The pending load, or nullptr if the type has not been registered</returns>
+	static PendingLoad::Sptr _QueueLoad(const std::string& typeName, const Guid& id, const nlohmann::json& data);
+	/// <summary>
+	/// Finishes a pending load on the main thread, decoding it here if no worker has picked it up yet
+	/// </summary>
+	/// <returns>True if there was a pending load with the given ID</returns>
+	static bool _FinishPendingLoad(const Guid& id);
+	static void _FinishPendingLoad(const PendingLoad::Sptr& load);
+	/// <summary>
+	/// Decodes a pending load, if it's still queued. Safe to call from any thread
+	/// </summary>
+	static void _Decode(const PendingLoad::Sptr& load);
+	/// <summary>
+	/// Creates the resource for a decoded load, main thread only
+	/// </summary>
+	static void _Upload(const PendingLoad::Sptr& load);
+	static void _StartWorkers();
+	static void _StopWorkers();
+	static void _WorkerMain();
+};
+
+/// <summary>
+/// A handle to a resource that is being loaded in the background via ResourceManager::LoadAsync
+/// </summary>
+/// <typeparam name="T">The type of resource being loaded</typeparam>
+template <typename T>
+class ResourceHandle {
+public:
+	ResourceHandle() : _load(nullptr), _resource(nullptr) {}
+
+	/// <summary>
+	/// Returns true if this handle refers to a resource that exists or is being loaded
+	/// </summary>
+	bool IsValid() const {
+		return _resource != nullptr || (_load != nullptr && _load->State != ResourceLoadState::Failed);
+	}
+	/// <summary>
+	/// Returns true if the resource has finished loading
+	/// </summary>
+	bool IsReady() const {
+		return _resource != nullptr || (_load != nullptr && _load->State == ResourceLoadState::Ready);
+	}
+	/// <summary>
+	/// Gets the current state of the load
+	/// </summary>
+	ResourceLoadState GetState() const {
+		return _resource != nullptr ? ResourceLoadState::Ready : (_load != nullptr ? _load->State.load() : ResourceLoadState::Failed);
+	}
+	/// <summary>
+	/// Gets the loaded resource, or the placeholder for the type if the resource is not ready yet
+	/// </summary>
+	std::shared_ptr<T> Get() {
+		if (_resource == nullptr && _load != nullptr && _load->State == ResourceLoadState::Ready) {
+			_resource = std::static_pointer_cast<T>(_load->Resource);
+			_load = nullptr;
+		}
+		return _resource != nullptr ? _resource : ResourceManager::GetPlaceholder<T>();
+	}
+	/// <summary>
+	/// Blocks until the resource has loaded, finishing it on this thread if needed. Main thread only!
+	/// </summary>
+	/// <returns>The loaded resource, or nullptr if the load failed</returns>
+	std::shared_ptr<T> Wait() {
+		if (_resource == nullptr && _load != nullptr) {
+			ResourceManager::_FinishPendingLoad(_load);
+			_resource = std::static_pointer_cast<T>(_load->Resource);
+			_load = nullptr;
+		}
+		return _resource;
+	}
+
+	operator bool() const { return IsValid(); }
+
+private:
+	friend class ResourceManager;
+	ResourceManager::PendingLoad::Sptr _load;
+	std::shared_ptr<T>                 _resource;
+};
+
+template<typename T, typename>
+ResourceHandle<T> ResourceManager::LoadAsync(Guid id) {
+	ResourceHandle<T> result;
+
+	// If it's already been loaded, we don't need to do anything
+	const uint32_t typeId = _TypeId<T>();
+	const IResource::Sptr& existing = _stores[typeId].Resources.Find(id);
+	if (existing != nullptr) {
+		result._resource = std::static_pointer_cast<T>(existing);
+		return result;
+	}
+
+	// If it's already being loaded, share that load
+	auto pending = _pendingLoads.find(id);
+	if (pending != _pendingLoads.end()) {
+		result._load = pending->second;
+		return result;
+	}
+
+	// Otherwise we need to find it in the manifest to start a new load
+	const std::string& typeName = _stores[typeId].Name;
+	auto manifestType = _manifest.find(typeName);
+	if (manifestType != _manifest.end()) {
+		auto item = manifestType->find(id.str());
+		if (item != manifestType->end()) {
+			result._load = _QueueLoad(typeName, id, *item);
+		}
+	}
+	return result;
+}
\ No newline at end of file
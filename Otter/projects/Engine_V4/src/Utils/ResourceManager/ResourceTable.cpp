@@ -0,0 +1,106 @@
+#include "Utils/ResourceManager/ResourceTable.h"
+
+#include <cstring>
+
+// Returned from Find when there is no match, so we can hand out a reference
+static const IResource::Sptr NullResource = nullptr;
+
+// The number of slots to start with, must be a power of two
+static constexpr size_t InitialCapacity = 16;
+
+ResourceTable::ResourceTable() :
+	_hashes(std::vector<uint64_t>()),
+	_keys(std::vector<Guid>()),
+	_values(std::vector<IResource::Sptr>()),
+	_count(0),
+	_mask(0)
+{ }
+
+uint64_t ResourceTable::Hash(const Guid& id) {
+	uint64_t halves[2];
+	memcpy(halves, id.bytes(), sizeof(halves));
+
+	// Fold the two halves together, then finish with the MurmurHash3 mixer so that every
+	// input bit affects the low bits we use to pick a slot
+	uint64_t hash = halves[0] ^ (halves[1] * 0x9E3779B97F4A7C15ull);
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDull;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ull;
+	hash ^= hash >> 33;
+
+	// 0 is reserved for empty slots
+	return hash != 0 ? hash : 1;
+}
+
+const IResource::Sptr& ResourceTable::Find(const Guid& id, uint64_t hash) const {
+	if (_count == 0) {
+		return NullResource;
+	}
+
+	// The table is never full, so we will always hit an empty slot eventually
+	size_t slot = hash & _mask;
+	while (_hashes[slot] != 0) {
+		if (_hashes[slot] == hash && _keys[slot] == id) {
+			return _values[slot];
+		}
+		slot = (slot + 1) & _mask;
+	}
+	return NullResource;
+}
+
+void ResourceTable::Set(const Guid& id, const IResource::Sptr& resource) {
+	// Keep the load factor under 50% so probe sequences stay short
+	if ((_count + 1) * 2 > _hashes.size()) {
+		_Grow();
+	}
+
+	const uint64_t hash = Hash(id);
+	size_t slot = hash & _mask;
+	while (_hashes[slot] != 0) {
+		if (_hashes[slot] == hash && _keys[slot] == id) {
+			_values[slot] = resource;
+			return;
+		}
+		slot = (slot + 1) & _mask;
+	}
+
+	_hashes[slot] = hash;
+	_keys[slot] = id;
+	_values[slot] = resource;
+	_count++;
+}
+
+void ResourceTable::Clear() {
+	_hashes.clear();
+	_keys.clear();
+	_values.clear();
+	_count = 0;
+	_mask = 0;
+}
+
+void ResourceTable::_Grow() {
+	const size_t newCapacity = _hashes.empty() ? InitialCapacity : _hashes.size() * 2;
+
+	std::vector<uint64_t> oldHashes = std::move(_hashes);
+	std::vector<Guid> oldKeys = std::move(_keys);
+	std::vector<IResource::Sptr> oldValues = std::move(_values);
+
+	_hashes.assign(newCapacity, 0);
+	_keys.resize(newCapacity);
+	_values.resize(newCapacity);
+	_mask = newCapacity - 1;
+
+	// Re-insert everything using the stored hashes, no need to re-hash the GUIDs
+	for (size_t ix = 0; ix < oldHashes.size(); ix++) {
+		if (oldHashes[ix] != 0) {
+			size_t slot = oldHashes[ix] & _mask;
+			while (_hashes[slot] != 0) {
+				slot = (slot + 1) & _mask;
+			}
+			_hashes[slot] = oldHashes[ix];
+			_keys[slot] = oldKeys[ix];
+			_values[slot] = std::move(oldValues[ix]);
+		}
+	}
+}
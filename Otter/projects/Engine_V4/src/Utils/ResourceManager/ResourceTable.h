@@ -0,0 +1,78 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+
+#include "Utils/GUID.hpp"
+#include "Utils/ResourceManager/IResource.h"
+
+/// <summary>
+/// A flat hash table that maps GUIDs to resources, used by the resource manager to store
+/// each type of resource
+///
+/// Uses open addressing with linear probing. The hash of each key is stored next to it,
+/// so probing only needs to touch a tightly packed array of 64 bit hashes, and the full
+/// 128 bit GUID is only compared when the hashes match. Lookups never modify the table
+/// </summary>
+class ResourceTable {
+public:
+	ResourceTable();
+	~ResourceTable() = default;
+
+	/// <summary>
+	/// Hashes all 128 bits of a GUID down to a non-zero 64 bit value
+	/// </summary>
+	static uint64_t Hash(const Guid& id);
+
+	/// <summary>
+	/// Finds the resource stored under the given GUID
+	/// </summary>
+	/// <param name="id">The GUID to search for</param>
+	/// <returns>The resource, or nullptr if it has not been added</returns>
+	const IResource::Sptr& Find(const Guid& id) const { return Find(id, Hash(id)); }
+	/// <summary>
+	/// Finds the resource stored under the given GUID, using a hash that has already been calculated
+	/// </summary>
+	const IResource::Sptr& Find(const Guid& id, uint64_t hash) const;
+
+	/// <summary>
+	/// Stores a resource under the given GUID, replacing any resource that was already there
+	/// </summary>
+	void Set(const Guid& id, const IResource::Sptr& resource);
+
+	/// <summary>
+	/// Removes all resources from the table
+	/// </summary>
+	void Clear();
+
+	/// <summary>
+	/// Gets the number of resources in the table
+	/// </summary>
+	size_t Size() const { return _count; }
+	/// <summary>
+	/// Gets the number of slots in the table
+	/// </summary>
+	size_t Capacity() const { return _hashes.size(); }
+
+	/// <summary>
+	/// Invokes a callback for every resource in the table, in no particular order
+	/// </summary>
+	/// <typeparam name="Func">A callable that takes a const Guid& and a const IResource::Sptr&</typeparam>
+	template <typename Func>
+	void Each(Func&& callback) const {
+		for (size_t ix = 0; ix < _hashes.size(); ix++) {
+			if (_hashes[ix] != 0) {
+				callback(_keys[ix], _values[ix]);
+			}
+		}
+	}
+
+private:
+	// A hash of 0 marks an empty slot
+	std::vector<uint64_t>        _hashes;
+	std::vector<Guid>            _keys;
+	std::vector<IResource::Sptr> _values;
+	size_t                       _count;
+	size_t                       _mask;
+
+	void _Grow();
+};
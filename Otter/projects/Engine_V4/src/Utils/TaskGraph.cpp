@@ -0,0 +1,167 @@
+#include "Utils/TaskGraph.h"
+
+#include <thread>
+
+#include "Utils/JobSystem.h"
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static float MillisecondsBetween(const Clock::time_point& start, const Clock::time_point& end) {
+	return static_cast<float>(std::chrono::duration<double, std::milli>(end - start).count());
+}
+
+TaskGraph::TaskGraph() :
+	_tasks(std::vector<Task>()),
+	_timeline(std::vector<TimelineEntry>()),
+	_pendingTimeline(std::vector<TimelineEntry>()),
+	_remaining(nullptr),
+	_completed(0),
+	_mainThreadQueue(std::deque<int>()),
+	_mainThreadMutex(),
+	_executeStart(),
+	_wallMs(0.0f),
+	_totalTaskMs(0.0f),
+	_criticalPathMs(0.0f),
+	_criticalPath(std::vector<int>())
+{ }
+
+int TaskGraph::AddTask(const std::string& name, FrameResource reads, FrameResource writes, TaskFunc func, bool mainThread) {
+	const int index = static_cast<int>(_tasks.size());
+
+	Task task;
+	task.Name = name;
+	task.Reads = reads;
+	task.Writes = writes;
+	task.Func = std::move(func);
+	task.MainThread = mainThread;
+
+	// We need to wait on earlier tasks that write what we touch, or read what we write
+	for (int ix = 0; ix < index; ix++) {
+		const Task& other = _tasks[ix];
+		if (*(other.Writes & (reads | writes)) != 0 || *(other.Reads & writes) != 0) {
+			task.Dependencies.push_back(ix);
+			_tasks[ix].Dependents.push_back(index);
+		}
+	}
+
+	_tasks.push_back(std::move(task));
+	return index;
+}
+
+void TaskGraph::Execute(bool parallel) {
+	_pendingTimeline.clear();
+	_pendingTimeline.resize(_tasks.size());
+	_executeStart = Clock::now();
+
+	// Tasks only ever depend on tasks added before them, so insertion order is always valid
+	if (!parallel || !JobSystem::IsInitialized()) {
+		for (int ix = 0; ix < static_cast<int>(_tasks.size()); ix++) {
+			_RunTask(ix);
+		}
+	} else {
+		_remaining = std::make_unique<std::atomic<int>[]>(_tasks.size());
+		for (size_t ix = 0; ix < _tasks.size(); ix++) {
+			_remaining[ix].store(static_cast<int>(_tasks[ix].Dependencies.size()), std::memory_order_relaxed);
+		}
+		_completed = 0;
+
+		for (int ix = 0; ix < static_cast<int>(_tasks.size()); ix++) {
+			if (_tasks[ix].Dependencies.empty()) {
+				_Schedule(ix);
+			}
+		}
+
+		// Run main thread tasks as they become ready, and help out with the rest in between
+		const int taskCount = static_cast<int>(_tasks.size());
+		while (_completed.load(std::memory_order_acquire) < taskCount) {
+			int next = -1;
+			{
+				std::lock_guard<std::mutex> lock(_mainThreadMutex);
+				if (!_mainThreadQueue.empty()) {
+					next = _mainThreadQueue.front();
+					_mainThreadQueue.pop_front();
+				}
+			}
+
+			if (next >= 0) {
+				_RunTask(next);
+			} else if (!JobSystem::TryRunOne()) {
+				std::this_thread::yield();
+			}
+		}
+		_remaining = nullptr;
+	}
+
+	// Only swap the timeline in once it's complete, so it can be inspected by the tasks in the next run
+	_timeline.swap(_pendingTimeline);
+	_wallMs = MillisecondsBetween(_executeStart, Clock::now());
+	_CalculateStats();
+}
+
+void TaskGraph::Clear() {
+	_tasks.clear();
+}
+
+void TaskGraph::_Schedule(int task) {
+	if (_tasks[task].MainThread) {
+		std::lock_guard<std::mutex> lock(_mainThreadMutex);
+		_mainThreadQueue.push_back(task);
+	} else {
+		JobSystem::Run([this, task]() { _RunTask(task); });
+	}
+}
+
+void TaskGraph::_RunTask(int task) {
+	TimelineEntry& entry = _pendingTimeline[task];
+	entry.Name = _tasks[task].Name;
+	entry.Thread = JobSystem::GetThreadIndex();
+	entry.StartMs = MillisecondsBetween(_executeStart, Clock::now());
+
+	_tasks[task].Func();
+
+	entry.EndMs = MillisecondsBetween(_executeStart, Clock::now());
+
+	// Only parallel execution tracks dependencies, serial just runs the tasks in order
+	if (_remaining != nullptr) {
+		for (int dependent : _tasks[task].Dependents) {
+			if (_remaining[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				_Schedule(dependent);
+			}
+		}
+		_completed.fetch_add(1, std::memory_order_release);
+	}
+}
+
+void TaskGraph::_CalculateStats() {
+	// Tasks are sorted so that dependencies always come first, so we can find the longest
+	// path through the graph in a single pass
+	std::vector<float> finish(_tasks.size(), 0.0f);
+	std::vector<int>   previous(_tasks.size(), -1);
+	_totalTaskMs = 0.0f;
+	_criticalPathMs = 0.0f;
+	int last = -1;
+
+	for (size_t ix = 0; ix < _tasks.size(); ix++) {
+		const float duration = _timeline[ix].EndMs - _timeline[ix].StartMs;
+		_totalTaskMs += duration;
+
+		float start = 0.0f;
+		for (int dependency : _tasks[ix].Dependencies) {
+			if (finish[dependency] > start) {
+				start = finish[dependency];
+				previous[ix] = dependency;
+			}
+		}
+		finish[ix] = start + duration;
+
+		if (finish[ix] >= _criticalPathMs) {
+			_criticalPathMs = finish[ix];
+			last = static_cast<int>(ix);
+		}
+	}
+
+	_criticalPath.clear();
+	for (int ix = last; ix >= 0; ix = previous[ix]) {
+		_criticalPath.insert(_criticalPath.begin(), ix);
+	}
+}
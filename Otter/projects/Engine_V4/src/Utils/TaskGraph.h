@@ -0,0 +1,141 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <EnumToString.h>
+
+/// <summary>
+/// The shared state that tasks in a frame can read or write, used to work out which tasks
+/// need to wait on each other
+/// </summary>
+ENUM_FLAGS(FrameResource, uint32_t,
+	None       = 0,
+	Input      = 1 << 0, // Keyboard, mouse and window state
+	Scene      = 1 << 1, // Game objects and their components, for anything not covered below
+	Transforms = 1 << 2, // Game object positions, rotations, scales and world matrices
+	Physics    = 1 << 3, // The physics world and the bodies in it
+	Animation  = 1 << 4, // Morph animators, and the animation state of render components
+	Particles  = 1 << 5, // Particle systems and their buffers
+	Audio      = 1 << 6, // The FMOD studio system
+	Render     = 1 << 7, // Render settings, lighting, and anything else the renderer reads
+	Gui        = 1 << 8, // ImGui and the GUI batcher
+
+	All = 0xFFFFFFFF
+);
+
+/// <summary>
+/// A set of tasks for a single frame, where each task declares which frame resources it reads
+/// and writes. A task will wait for every task added before it that writes something it reads
+/// or writes, or reads something it writes, so running the graph gives the same results as
+/// running the tasks in the order they were added
+///
+/// Tasks run on the job system's workers, except for main thread tasks (anything that touches
+/// OpenGL, for instance), which run on the thread that calls Execute. Every task is timed, so
+/// the graph can report the timeline for the frame and it's critical path
+/// </summary>
+class TaskGraph {
+public:
+	typedef std::function<void()> TaskFunc;
+
+	/// <summary>
+	/// When and where a task ran during the last Execute, times are relative to the start of Execute
+	/// </summary>
+	struct TimelineEntry {
+		std::string Name;
+		int         Thread  = 0;
+		float       StartMs = 0.0f;
+		float       EndMs   = 0.0f;
+	};
+
+	TaskGraph();
+	~TaskGraph() = default;
+
+	/// <summary>
+	/// Adds a task to the graph, which will run after any earlier tasks it conflicts with
+	/// </summary>
+	/// <param name="name">A name for the task, for the timeline</param>
+	/// <param name="reads">The resources that the task reads from</param>
+	/// <param name="writes">The resources that the task modifies</param>
+	/// <param name="func">The work to do</param>
+	/// <param name="mainThread">True if the task must run on the thread that calls Execute</param>
+	/// <returns>The index of the new task</returns>
+	int AddTask(const std::string& name, FrameResource reads, FrameResource writes, TaskFunc func, bool mainThread = false);
+
+	/// <summary>
+	/// Runs every task in the graph, returning once they are all done
+	/// </summary>
+	/// <param name="parallel">False to run the tasks one after another on the calling thread, in the order they were added</param>
+	void Execute(bool parallel = true);
+
+	/// <summary>
+	/// Removes all the tasks from the graph, the timeline from the last execute is kept
+	/// </summary>
+	void Clear();
+
+	size_t GetTaskCount() const { return _tasks.size(); }
+	/// <summary>
+	/// Gets the indices of the tasks that a task waits on
+	/// </summary>
+	const std::vector<int>& GetDependencies(int task) const { return _tasks[task].Dependencies; }
+
+	/// <summary>
+	/// Gets when and where each task ran in the last Execute, in the order they were added
+	/// </summary>
+	const std::vector<TimelineEntry>& GetTimeline() const { return _timeline; }
+	/// <summary>
+	/// Gets how long the last Execute took from start to finish, in milliseconds
+	/// </summary>
+	float GetWallMs() const { return _wallMs; }
+	/// <summary>
+	/// Gets the total time spent in tasks during the last Execute, which is roughly what
+	/// Execute would take if everything ran on one thread
+	/// </summary>
+	float GetTotalTaskMs() const { return _totalTaskMs; }
+	/// <summary>
+	/// Gets the length of the longest chain of dependent tasks from the last Execute, the
+	/// fastest the graph could possibly run with unlimited threads
+	/// </summary>
+	float GetCriticalPathMs() const { return _criticalPathMs; }
+	/// <summary>
+	/// Gets the indices of the tasks on the critical path, in the order they ran
+	/// </summary>
+	const std::vector<int>& GetCriticalPath() const { return _criticalPath; }
+
+protected:
+	struct Task {
+		std::string      Name;
+		FrameResource    Reads;
+		FrameResource    Writes;
+		TaskFunc         Func;
+		bool             MainThread;
+		std::vector<int> Dependencies;
+		std::vector<int> Dependents;
+	};
+
+	std::vector<Task>          _tasks;
+	// The timeline from the last Execute, and the one being filled in by the current Execute
+	std::vector<TimelineEntry> _timeline;
+	std::vector<TimelineEntry> _pendingTimeline;
+
+	// State while executing, the number of dependencies each task is still waiting on
+	std::unique_ptr<std::atomic<int>[]> _remaining;
+	std::atomic<int>                    _completed;
+	std::deque<int>                     _mainThreadQueue;
+	std::mutex                          _mainThreadMutex;
+	std::chrono::high_resolution_clock::time_point _executeStart;
+
+	float            _wallMs;
+	float            _totalTaskMs;
+	float            _criticalPathMs;
+	std::vector<int> _criticalPath;
+
+	void _Schedule(int task);
+	void _RunTask(int task);
+	void _CalculateStats();
+};
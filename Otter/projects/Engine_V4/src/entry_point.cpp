@@ -1,5 +1,7 @@
 #define GLM_SWIZZLE 
 #include "Application/Application.h"
+#include "Gameplay/Physics/CollisionMeshCache.h"
+#include "Gameplay/MorphClip.h"
 
 extern "C" {
 	__declspec(dllexport) unsigned long NvOptimusEnablement = 0x01;
@@ -9,7 +11,28 @@ extern "C" {
 int main(int argc, char** args) {
 	Logger::Init();
 
-	// TODO: parse arguments?
+	// Cook collision hulls without starting the engine, ex: --cook-colliders meshes/a.obj meshes/b.obj
+	if (argc > 1 && std::string(args[1]) == "--cook-colliders") {
+		int failures = 0;
+		for (int ix = 2; ix < argc; ix++) {
+			failures += Gameplay::Physics::CollisionMeshCache::CookFile(args[ix]) ? 0 : 1;
+		}
+		Logger::Uninitialize();
+		return failures;
+	}
+
+	// Pack OBJ frame sequences into morph clips, ex: --pack-morph out.morph 0.05 frame1.obj frame2.obj
+	if (argc > 1 && std::string(args[1]) == "--pack-morph") {
+		if (argc < 5) {
+			LOG_ERROR("Usage: --pack-morph <output> <frame time> <frames...>");
+			Logger::Uninitialize();
+			return 1;
+		}
+		std::vector<std::string> frames(args + 4, args + argc);
+		const bool result = Gameplay::MorphClip::Convert(frames, std::stof(args[3]), MorphClipEncoding::Quantized, args[2]);
+		Logger::Uninitialize();
+		return result ? 0 : 1;
+	}
 
 	Application::Start(argc, args);
 